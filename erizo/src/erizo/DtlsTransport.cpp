@@ -22,8 +22,6 @@ DEFINE_LOGGER(TimeoutChecker, "TimeoutChecker");
 
 using std::memcpy;
 
-static std::mutex dtls_mutex;
-
 TimeoutChecker::TimeoutChecker(DtlsTransport* transport, dtls::DtlsSocketContext* ctx)
     : transport_(transport), socket_context_(ctx),
       check_seconds_(kInitialSecsPerTimeoutCheck), max_checks_(kMaxTimeoutChecks),
@@ -56,8 +54,7 @@ void TimeoutChecker::scheduleNext() {
         if (max_checks_-- > 0) {
           ELOG_DEBUG("Handling dtls timeout, checks left: %d", max_checks_);
           if (socket_context_) {
-            std::lock_guard<std::mutex> guard(dtls_mutex);
-            socket_context_->handleTimeout();
+            transport_->handleDtlsTimeout(socket_context_);
           }
           scheduleNext();
         } else {
@@ -73,8 +70,12 @@ DtlsTransport::DtlsTransport(MediaType med, const std::string &transport_name, c
                             const IceConfig& iceConfig, std::string username, std::string password,
                             bool isServer, std::shared_ptr<Worker> worker, std::shared_ptr<IOWorker> io_worker):
   Transport(med, transport_name, connection_id, bundle, rtcp_mux, transport_listener, iceConfig, worker, io_worker),
+  crypto_worker_{DtlsSocketContext::getCryptoWorker()},
   readyRtp(false), readyRtcp(false), isServer_(isServer), dtls_ready_{false} {
     ELOG_DEBUG("%s message: constructor, transportName: %s, isBundle: %d", toLog(), transport_name.c_str(), bundle);
+    if (!crypto_worker_) {
+      crypto_worker_ = worker_;
+    }
     dtlsRtp.reset(new DtlsSocketContext());
 
     int comps = 1;
@@ -85,7 +86,7 @@ DtlsTransport::DtlsTransport(MediaType med, const std::string &transport_name, c
 
       if (!rtcp_mux) {
         comps = 2;
-        dtlsRtcp.reset(new DtlsSocketContext());
+        dtlsRtcp.reset(new DtlsSocketContext(dtlsRtp->getIdentity()));
         dtlsRtcp->createServer();
         dtlsRtcp->setDtlsReceiver(this);
       }
@@ -96,7 +97,7 @@ DtlsTransport::DtlsTransport(MediaType med, const std::string &transport_name, c
 
       if (!rtcp_mux) {
         comps = 2;
-        dtlsRtcp.reset(new DtlsSocketContext());
+        dtlsRtcp.reset(new DtlsSocketContext(dtlsRtp->getIdentity()));
         dtlsRtcp->createClient();
         dtlsRtcp->setDtlsReceiver(this);
       }
@@ -144,12 +145,14 @@ boost::future<void> DtlsTransport::close() {
   }
   std::shared_ptr<DtlsTransport> shared_this = std::dynamic_pointer_cast<DtlsTransport>(shared_from_this());
   return ice_->close().then([shared_this] (boost::future<void>) {
+    shared_this->crypto_worker_->task([shared_this] {
       if (shared_this->dtlsRtp) {
         shared_this->dtlsRtp->close();
       }
       if (shared_this->dtlsRtcp) {
         shared_this->dtlsRtcp->close();
       }
+    });
     shared_this->state_ = TRANSPORT_FINISHED;
     ELOG_DEBUG("%s message: closed", shared_this->toLog());
   });
@@ -175,17 +178,16 @@ void DtlsTransport::onIceData(packetPtr packet) {
   if (DtlsTransport::isDtlsPacket(data, len)) {
     ELOG_DEBUG("%s message: Received DTLS message, transportName: %s, componentId: %u",
                toLog(), transport_name.c_str(), component_id);
-    if (component_id == 1) {
-      std::lock_guard<std::mutex> guard(dtls_mutex);
-      dtlsRtp->read(reinterpret_cast<unsigned char*>(data), len);
-    } else {
-      std::lock_guard<std::mutex> guard(dtls_mutex);
-      dtlsRtcp->read(reinterpret_cast<unsigned char*>(data), len);
+    DtlsSocketContext *context = component_id == 1 ? dtlsRtp.get() : dtlsRtcp.get();
+    if (context != nullptr) {
+      cryptoTask([context, packet]() {
+        context->read(reinterpret_cast<unsigned char*>(packet->data), packet->length);
+      });
     }
     return;
   } else if (this->getTransportState() == TRANSPORT_READY) {
-    std::shared_ptr<DataPacket> unprotect_packet = std::make_shared<DataPacket>(component_id,
-      data, len, VIDEO_PACKET, packet->received_time_ms);
+    // The ICE packet is owned by this transport at this point, so it is decrypted in place
+    std::shared_ptr<DataPacket> unprotect_packet = packet;
 
     if (dtlsRtcp != NULL && component_id == 2) {
       srtp = srtcp_.get();
@@ -214,6 +216,47 @@ void DtlsTransport::onIceData(packetPtr packet) {
   }
 }
 
+void DtlsTransport::onIceDataBatch(const std::vector<packetPtr> &packets) {
+  if (!running_) {
+    return;
+  }
+  for (const packetPtr &packet : packets) {
+    if (packet->length <= 0) {
+      continue;
+    }
+    if (DtlsTransport::isDtlsPacket(packet->data, packet->length) || getTransportState() != TRANSPORT_READY) {
+      // Keep the order with any SRTP packet received before this one
+      unprotectAndDeliver(srtp_.get(), &srtp_batch_);
+      unprotectAndDeliver(srtcp_.get(), &srtcp_batch_);
+      onIceData(packet);
+    } else if (dtlsRtcp != NULL && packet->comp == 2) {
+      // Without rtcp-mux each component has its own channel, runs are flushed so the arrival order is kept
+      unprotectAndDeliver(srtp_.get(), &srtp_batch_);
+      srtcp_batch_.push_back(packet);
+    } else {
+      unprotectAndDeliver(srtcp_.get(), &srtcp_batch_);
+      srtp_batch_.push_back(packet);
+    }
+  }
+  unprotectAndDeliver(srtp_.get(), &srtp_batch_);
+  unprotectAndDeliver(srtcp_.get(), &srtcp_batch_);
+}
+
+void DtlsTransport::unprotectAndDeliver(SrtpChannel *srtp, std::vector<packetPtr> *packets) {
+  if (packets->empty()) {
+    return;
+  }
+  auto listener = getTransportListener().lock();
+  if (srtp != NULL && listener && srtp->unprotectPackets(*packets) > 0) {
+    for (const packetPtr &packet : *packets) {
+      if (packet->length > 0) {
+        listener->onTransportData(packet, this);
+      }
+    }
+  }
+  packets->clear();
+}
+
 void DtlsTransport::onCandidate(const CandidateInfo &candidate, IceConnection *conn) {
   if (auto listener = getTransportListener().lock()) {
     listener->onCandidate(candidate, this);
@@ -267,11 +310,9 @@ void DtlsTransport::onDtlsPacket(DtlsSocketContext *ctx, const unsigned char* da
 
   packetPtr packet = std::make_shared<DataPacket>(component_id, data, len);
 
-  if (is_rtcp) {
-    writeDtlsPacket(dtlsRtcp.get(), packet);
-  } else {
-    writeDtlsPacket(dtlsRtp.get(), packet);
-  }
+  workerTask([this, ctx, packet]() {
+    writeDtlsPacket(ctx, packet);
+  });
 
   ELOG_DEBUG("%s message: Sending DTLS message, transportName: %s, componentId: %d",
              toLog(), transport_name.c_str(), packet->comp);
@@ -286,6 +327,13 @@ void DtlsTransport::writeDtlsPacket(DtlsSocketContext *ctx, packetPtr packet) {
 
 void DtlsTransport::onHandshakeCompleted(DtlsSocketContext *ctx, std::string clientKey, std::string serverKey,
                                          std::string srtp_profile) {
+  workerTask([this, ctx, clientKey, serverKey, srtp_profile]() {
+    onHandshakeCompletedSync(ctx, clientKey, serverKey, srtp_profile);
+  });
+}
+
+void DtlsTransport::onHandshakeCompletedSync(DtlsSocketContext *ctx, std::string clientKey, std::string serverKey,
+                                             std::string srtp_profile) {
   boost::mutex::scoped_lock lock(sessionMutex_);
   std::string temp;
 
@@ -300,9 +348,10 @@ void DtlsTransport::onHandshakeCompleted(DtlsSocketContext *ctx, std::string cli
     ELOG_DEBUG("%s message: swapping keys, isServer: %d", toLog(), isServer_);
     clientKey.swap(serverKey);
   }
+  srtp_profile_t profile = SrtpChannel::profileFromName(srtp_profile);
   if (ctx == dtlsRtp.get()) {
     srtp_.reset(new SrtpChannel());
-    if (srtp_->setRtpParams(clientKey, serverKey)) {
+    if (srtp_->setRtpParams(clientKey, serverKey, profile)) {
       readyRtp = true;
     } else {
       updateTransportState(TRANSPORT_FAILED);
@@ -313,7 +362,7 @@ void DtlsTransport::onHandshakeCompleted(DtlsSocketContext *ctx, std::string cli
   }
   if (ctx == dtlsRtcp.get()) {
     srtcp_.reset(new SrtpChannel());
-    if (srtcp_->setRtpParams(clientKey, serverKey)) {
+    if (srtcp_->setRtpParams(clientKey, serverKey, profile)) {
       readyRtcp = true;
     } else {
       updateTransportState(TRANSPORT_FAILED);
@@ -328,12 +377,42 @@ void DtlsTransport::onHandshakeCompleted(DtlsSocketContext *ctx, std::string cli
 }
 
 void DtlsTransport::onHandshakeFailed(DtlsSocketContext *ctx, const std::string& error) {
+  workerTask([this, ctx, error]() {
+    onHandshakeFailedSync(ctx, error);
+  });
+}
+
+void DtlsTransport::onHandshakeFailedSync(DtlsSocketContext *ctx, const std::string& error) {
   ELOG_WARN("%s message: Handshake failed, transportName:%s, openSSLerror: %s",
             toLog(), transport_name.c_str(), error.c_str());
   running_ = false;
   updateTransportState(TRANSPORT_FAILED);
 }
 
+void DtlsTransport::handleDtlsTimeout(DtlsSocketContext *ctx) {
+  cryptoTask([ctx]() {
+    ctx->handleTimeout();
+  });
+}
+
+void DtlsTransport::cryptoTask(std::function<void()> f) {
+  std::weak_ptr<Transport> weak_transport = Transport::shared_from_this();
+  crypto_worker_->task([weak_transport, f]() {
+    if (auto transport = weak_transport.lock()) {
+      f();
+    }
+  });
+}
+
+void DtlsTransport::workerTask(std::function<void()> f) {
+  std::weak_ptr<Transport> weak_transport = Transport::shared_from_this();
+  worker_->task([weak_transport, f]() {
+    if (auto transport = weak_transport.lock()) {
+      f();
+    }
+  });
+}
+
 std::string DtlsTransport::getMyFingerprint() const {
   return dtlsRtp->getFingerprint();
 }
@@ -371,12 +450,20 @@ void DtlsTransport::updateIceStateSync(IceState state, IceConnection *conn) {
     }
     if (!isServer_ && dtlsRtp && !dtlsRtp->started) {
       ELOG_INFO("%s message: DTLSRTP Start, transportName: %s", toLog(), transport_name.c_str());
-      dtlsRtp->start();
+      DtlsSocketContext *context = dtlsRtp.get();
+      context->started = true;
+      cryptoTask([context]() {
+        context->start();
+      });
       rtp_timeout_checker_->scheduleCheck();
     }
     if (!isServer_ && dtlsRtcp != NULL && !dtlsRtcp->started) {
       ELOG_DEBUG("%s message: DTLSRTCP Start, transportName: %s", toLog(), transport_name.c_str());
-      dtlsRtcp->start();
+      DtlsSocketContext *context = dtlsRtcp.get();
+      context->started = true;
+      cryptoTask([context]() {
+        context->start();
+      });
       rtcp_timeout_checker_->scheduleCheck();
     }
   }
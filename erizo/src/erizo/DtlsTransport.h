@@ -7,7 +7,9 @@
 #include <boost/asio.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
+#include <functional>
 #include <string>
+#include <vector>
 #include "dtls/DtlsSocket.h"
 #include "./IceConnection.h"
 #include "./Transport.h"
@@ -32,6 +34,7 @@ class DtlsTransport : dtls::DtlsReceiver, public Transport {
   boost::future<void> close() override;
   void maybeRestartIce(std::string username, std::string password) override;
   void onIceData(packetPtr packet) override;
+  void onIceDataBatch(const std::vector<packetPtr> &packets) override;
   void onCandidate(const CandidateInfo &candidate, IceConnection *conn) override;
   void write(char* data, int len) override;
   void onDtlsPacket(dtls::DtlsSocketContext *ctx, const unsigned char* data, unsigned int len) override;
@@ -43,9 +46,21 @@ class DtlsTransport : dtls::DtlsReceiver, public Transport {
   void processLocalSdp(SdpInfo *localSdp_) override;
 
   void updateIceStateSync(IceState state, IceConnection *conn);
+  void onHandshakeCompletedSync(dtls::DtlsSocketContext *ctx, std::string clientKey, std::string serverKey,
+                                std::string srtp_profile);
+  void onHandshakeFailedSync(dtls::DtlsSocketContext *ctx, const std::string& error);
+  void handleDtlsTimeout(dtls::DtlsSocketContext *ctx);
+
+ private:
+  void unprotectAndDeliver(SrtpChannel *srtp, std::vector<packetPtr> *packets);
+  // DTLS contexts are only used from crypto_worker_, so handshakes don't delay media in worker_. Their
+  // results come back to worker_.
+  void cryptoTask(std::function<void()> f);
+  void workerTask(std::function<void()> f);
 
  private:
   char protectBuf_[5000];
+  std::shared_ptr<Worker> crypto_worker_;
   boost::scoped_ptr<dtls::DtlsSocketContext> dtlsRtp, dtlsRtcp;
   boost::mutex writeMutex_, sessionMutex_;
   boost::scoped_ptr<SrtpChannel> srtp_, srtcp_;
@@ -54,6 +69,7 @@ class DtlsTransport : dtls::DtlsReceiver, public Transport {
   std::unique_ptr<TimeoutChecker> rtcp_timeout_checker_, rtp_timeout_checker_;
   packetPtr p_;
   bool dtls_ready_;
+  std::vector<packetPtr> srtp_batch_, srtcp_batch_;
 };
 
 class TimeoutChecker {
@@ -11,6 +11,7 @@
 #include "SdpInfo.h"
 #include "lib/Clock.h"
 #include "lib/ClockUtils.h"
+#include "lib/PacketPool.h"
 
 using std::memcpy;
 
@@ -27,11 +28,8 @@ void LibNiceConnection::receive_message(NiceAgent* agent, guint stream_id, guint
   if (user_data == NULL || len == 0) {
     return;
   }
-  packetPtr packet (new DataPacket());
-  memcpy(packet->data, buf, len);
-  packet->comp = component_id;
-  packet->length = len;
-  packet->received_time_ms = ClockUtils::timePointToMs(clock::now());
+  packetPtr packet = PacketPool::create(component_id, buf, len, VIDEO_PACKET,
+                                        ClockUtils::timePointToMs(clock::now()));
   LibNiceConnection* conn = reinterpret_cast<LibNiceConnection*>(user_data);
   conn->async([component_id, packet]
     (std::shared_ptr<LibNiceConnection> conn_ptr) {
@@ -153,29 +151,45 @@ int LibNiceConnection::sendData(unsigned int component_id, const void* buf, int
   if (checkIceState() != IceState::READY) {
     return -1;
   }
-  packetPtr packet (new DataPacket());
+  packetPtr packet = PacketPool::create();
   memcpy(packet->data, buf, len);
+  packet->comp = component_id;
   packet->length = len;
-  async([component_id, packet] (std::shared_ptr<LibNiceConnection> this_ptr) {
-    int val = -1;
-    if (this_ptr->checkIceState() != IceState::READY) {
-      return;
-    }
-    val = this_ptr->lib_nice_->NiceAgentSend(this_ptr->agent_,
-                                  this_ptr->stream_id_,
-                                  component_id,
-                                  packet->length,
-                                  reinterpret_cast<const gchar*>(packet->data));
-    if (val != packet->length) {
-      ELOG_DEBUG("%s message: Sending less data than expected, sent: %d, to_send: %d", this_ptr->toLog(),
-                  val,
-                  packet->length);
-    }
-    return;
-  });
+  if (outgoing_packets_.push(packet)) {
+    async([] (std::shared_ptr<LibNiceConnection> this_ptr) {
+      this_ptr->flushOutgoingPackets();
+    });
+  }
   return len;
 }
 
+void LibNiceConnection::flushOutgoingPackets() {
+  outgoing_packets_.takeAll(&sending_packets_);
+  if (checkIceState() == IceState::READY) {
+    // Consecutive packets of the same component are handed to libnice in a single call
+    size_t first = 0;
+    while (first < sending_packets_.size()) {
+      int component_id = sending_packets_[first]->comp;
+      output_buffers_.clear();
+      output_lengths_.clear();
+      size_t last = first;
+      for (; last < sending_packets_.size() && sending_packets_[last]->comp == component_id; last++) {
+        output_buffers_.push_back(sending_packets_[last]->data);
+        output_lengths_.push_back(sending_packets_[last]->length);
+      }
+      int sent = lib_nice_->NiceAgentSendMessages(agent_, stream_id_, component_id, output_buffers_.data(),
+                                                  output_lengths_.data(), output_buffers_.size());
+      if (sent != static_cast<int>(output_buffers_.size())) {
+        ELOG_DEBUG("%s message: Sending less packets than expected, sent: %d, to_send: %lu", toLog(),
+                    sent,
+                    output_buffers_.size());
+      }
+      first = last;
+    }
+  }
+  sending_packets_.clear();
+}
+
 void LibNiceConnection::async(std::function<void(std::shared_ptr<LibNiceConnection>)> f) {
   std::weak_ptr<LibNiceConnection> weak_this = shared_from_this();
   io_worker_->task([weak_this, f] {
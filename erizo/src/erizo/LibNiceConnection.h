@@ -17,6 +17,7 @@
 #include "./SdpInfo.h"
 #include "./logger.h"
 #include "lib/LibNiceInterface.h"
+#include "lib/PacketBatchQueue.h"
 #include "./thread/Worker.h"
 #include "./thread/IOWorker.h"
 
@@ -72,6 +73,7 @@ class LibNiceConnection : public IceConnection, public std::enable_shared_from_t
   void closeSync();
   void setRemoteCredentialsSync(const std::string& username, const std::string& password);
   void forEachComponent(std::function<void(uint comp_id)> func);
+  void flushOutgoingPackets();
 
 // static callbacks for libnice
   static void receive_message(NiceAgent* agent, guint stream_id, guint component_id,
@@ -104,6 +106,10 @@ class LibNiceConnection : public IceConnection, public std::enable_shared_from_t
   boost::shared_ptr<std::vector<CandidateInfo> > local_candidates;
   bool enable_ice_lite_;
   int stream_id_;
+  PacketBatchQueue outgoing_packets_;
+  std::vector<packetPtr> sending_packets_;
+  std::vector<const char*> output_buffers_;
+  std::vector<unsigned int> output_lengths_;
 };
 
 }  // namespace erizo
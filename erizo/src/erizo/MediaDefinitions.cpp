@@ -0,0 +1,34 @@
+/*
+ * MediaDefinitions.cpp
+ */
+
+#include "./MediaDefinitions.h"
+
+#include "lib/PacketPool.h"
+
+namespace erizo {
+
+std::shared_ptr<DataPacket> MediaSink::copyAudioPacketWithSSRC(const DataPacket &packet, uint32_t ssrc) {
+  std::shared_ptr<DataPacket> copy = PacketPool::clone(packet);
+  RtcpHeader *chead = reinterpret_cast<RtcpHeader*>(copy->data);
+  // Hack to avoid audio drift
+  if (chead->isRtcp() && chead->isSDES()) {
+    chead->setSSRC(ssrc);
+  } else {
+    reinterpret_cast<RtpHeader*>(copy->data)->setSSRC(ssrc);
+  }
+  return copy;
+}
+
+std::shared_ptr<DataPacket> MediaSink::copyVideoPacketWithSSRC(const DataPacket &packet, uint32_t ssrc) {
+  std::shared_ptr<DataPacket> copy = PacketPool::clone(packet);
+  RtcpHeader *chead = reinterpret_cast<RtcpHeader*>(copy->data);
+  if (chead->isRtcp()) {
+    chead->setSSRC(ssrc);
+  } else {
+    reinterpret_cast<RtpHeader*>(copy->data)->setSSRC(ssrc);
+  }
+  return copy;
+}
+
+}  // namespace erizo
@@ -8,9 +8,11 @@
 #include <boost/thread/future.hpp>
 #include <vector>
 #include <algorithm>
+#include <initializer_list>
 
 #include "lib/Clock.h"
 #include "lib/ClockUtils.h"
+#include "lib/StringInterner.h"
 #include "rtp/RtpHeaders.h"
 
 namespace erizo {
@@ -26,63 +28,143 @@ enum packetPriority {
   LOW_PRIORITY
 };
 
+// Set of spatial or temporal layer indexes, kept in a bitmask so packets can be copied without allocations
+class LayerMask {
+ public:
+  static constexpr int kMaxLayers = 8;
+
+  LayerMask() = default;
+  LayerMask(std::initializer_list<int> layers) {  // NOLINT
+    for (int layer : layers) {
+      add(layer);
+    }
+  }
+
+  void add(int layer) {
+    if (layer >= 0 && layer < kMaxLayers) {
+      mask_ |= 1 << layer;
+    }
+  }
+
+  bool contains(int layer) const {
+    return layer >= 0 && layer < kMaxLayers && (mask_ & (1 << layer));
+  }
+
+  bool empty() const { return mask_ == 0; }
+
+  void clear() { mask_ = 0; }
+
+  // Returns -1 when there are no layers
+  int lowest() const { return empty() ? -1 : __builtin_ctz(mask_); }
+
+  template <typename Function>
+  void forEach(Function function) const {
+    for (unsigned int remaining = mask_; remaining != 0; remaining &= remaining - 1) {
+      function(__builtin_ctz(remaining));
+    }
+  }
+
+  bool operator==(const LayerMask &other) const { return mask_ == other.mask_; }
+
+ private:
+  uint8_t mask_ = 0;
+};
+
 struct DataPacket {
   DataPacket() = default;
 
   DataPacket(int comp_, const char *data_, int length_, packetType type_, uint64_t received_time_ms_) :
     comp{comp_}, length{length_}, type{type_}, priority{HIGH_PRIORITY}, received_time_ms{received_time_ms_},
     is_keyframe{false}, ending_of_layer_frame{false}, picture_id{-1}, tl0_pic_idx{-1},
-    rid{"0"}, is_padding{false} {
+    is_padding{false} {
       memcpy(data, data_, length_);
   }
 
   DataPacket(int comp_, const char *data_, int length_, packetType type_) :
     comp{comp_}, length{length_}, type{type_}, priority{HIGH_PRIORITY},
     received_time_ms{ClockUtils::timePointToMs(clock::now())}, is_keyframe{false},
-    ending_of_layer_frame{false}, picture_id{-1}, tl0_pic_idx{-1}, rid{"0"}, is_padding{false} {
+    ending_of_layer_frame{false}, picture_id{-1}, tl0_pic_idx{-1}, is_padding{false} {
       memcpy(data, data_, length_);
   }
 
   DataPacket(int comp_, const unsigned char *data_, int length_) :
     comp{comp_}, length{length_}, type{VIDEO_PACKET}, priority{HIGH_PRIORITY},
     received_time_ms{ClockUtils::timePointToMs(clock::now())}, is_keyframe{false},
-    ending_of_layer_frame{false}, picture_id{-1}, tl0_pic_idx{-1}, rid{"0"}, is_padding{false} {
+    ending_of_layer_frame{false}, picture_id{-1}, tl0_pic_idx{-1}, is_padding{false} {
       memcpy(data, data_, length_);
   }
 
-  bool belongsToSpatialLayer(int spatial_layer_) {
-    std::vector<int>::iterator item = std::find(compatible_spatial_layers.begin(),
-                                              compatible_spatial_layers.end(),
-                                              spatial_layer_);
+  // Copies only the bytes in use, packets are usually much smaller than the data buffer
+  DataPacket(const DataPacket &other) :
+    comp{other.comp}, length{other.length}, type{other.type}, priority{other.priority},
+    received_time_ms{other.received_time_ms}, compatible_spatial_layers{other.compatible_spatial_layers},
+    compatible_temporal_layers{other.compatible_temporal_layers}, is_keyframe{other.is_keyframe},
+    ending_of_layer_frame{other.ending_of_layer_frame}, picture_id{other.picture_id},
+    tl0_pic_idx{other.tl0_pic_idx}, codec{other.codec}, mid{other.mid}, rid{other.rid},
+    clock_rate{other.clock_rate}, is_padding{other.is_padding}, is_retransmission{other.is_retransmission},
+    transport_sequence_number{other.transport_sequence_number} {
+      memcpy(data, other.data, usedBytes(other.length));
+  }
+
+  DataPacket& operator=(const DataPacket &other) {
+    if (this == &other) {
+      return *this;
+    }
+    comp = other.comp;
+    memcpy(data, other.data, usedBytes(other.length));
+    length = other.length;
+    type = other.type;
+    priority = other.priority;
+    received_time_ms = other.received_time_ms;
+    compatible_spatial_layers = other.compatible_spatial_layers;
+    compatible_temporal_layers = other.compatible_temporal_layers;
+    is_keyframe = other.is_keyframe;
+    ending_of_layer_frame = other.ending_of_layer_frame;
+    picture_id = other.picture_id;
+    tl0_pic_idx = other.tl0_pic_idx;
+    codec = other.codec;
+    mid = other.mid;
+    rid = other.rid;
+    clock_rate = other.clock_rate;
+    is_padding = other.is_padding;
+    is_retransmission = other.is_retransmission;
+    transport_sequence_number = other.transport_sequence_number;
+    return *this;
+  }
 
-    return item != compatible_spatial_layers.end();
+  static size_t usedBytes(int length) {
+    return static_cast<size_t>(std::min(std::max(length, 0), static_cast<int>(sizeof(data))));
   }
 
-  bool belongsToTemporalLayer(int temporal_layer_) {
-    std::vector<int>::iterator item = std::find(compatible_temporal_layers.begin(),
-                                              compatible_temporal_layers.end(),
-                                              temporal_layer_);
+  bool belongsToSpatialLayer(int spatial_layer_) const {
+    return compatible_spatial_layers.contains(spatial_layer_);
+  }
 
-    return item != compatible_temporal_layers.end();
+  bool belongsToTemporalLayer(int temporal_layer_) const {
+    return compatible_temporal_layers.contains(temporal_layer_);
   }
 
+  const std::string& getCodecName() const { return StringInterner::lookup(codec); }
+  const std::string& getMidName() const { return StringInterner::lookup(mid); }
+
   int comp;
   char data[1500];
   int length;
   packetType type;
   packetPriority priority;
   uint64_t received_time_ms;
-  std::vector<int> compatible_spatial_layers;
-  std::vector<int> compatible_temporal_layers;
+  LayerMask compatible_spatial_layers;
+  LayerMask compatible_temporal_layers;
   bool is_keyframe;  // Note: It can be just a keyframe first packet in VP8
   bool ending_of_layer_frame;
   int picture_id;
   int tl0_pic_idx;
-  std::string codec;
-  std::string mid;
-  std::string rid;
+  StringId codec = StringInterner::kEmptyId;
+  StringId mid = StringInterner::kEmptyId;
+  int rid = 0;  // Simulcast layer starting at 1, as resolved from the negotiated RIDs. 0 when there is no RID
   unsigned int clock_rate = 0;
   bool is_padding;
+  bool is_retransmission = false;
   std::optional<uint16_t> transport_sequence_number;
 };
 
@@ -141,6 +223,16 @@ class MediaSink: public virtual Monitor {
     int deliverVideoData(std::shared_ptr<DataPacket> data_packet) {
         return deliverVideoData_(data_packet);
     }
+    /**
+     * Deliver a packet that is shared with other sinks. The packet must not be modified, the sink
+     * gets its own copy with the given SSRC when (and where) it actually needs it.
+     */
+    int deliverSharedAudioData(std::shared_ptr<const DataPacket> data_packet, uint32_t ssrc) {
+        return deliverSharedAudioData_(data_packet, ssrc);
+    }
+    int deliverSharedVideoData(std::shared_ptr<const DataPacket> data_packet, uint32_t ssrc) {
+        return deliverSharedVideoData_(data_packet, ssrc);
+    }
     uint32_t getVideoSinkSSRC() {
         boost::mutex::scoped_lock lock(monitor_mutex_);
         return video_sink_ssrc_;
@@ -175,9 +267,19 @@ class MediaSink: public virtual Monitor {
 
     virtual boost::future<void> close() = 0;
 
+ protected:
+    static std::shared_ptr<DataPacket> copyAudioPacketWithSSRC(const DataPacket &packet, uint32_t ssrc);
+    static std::shared_ptr<DataPacket> copyVideoPacketWithSSRC(const DataPacket &packet, uint32_t ssrc);
+
  private:
     virtual int deliverAudioData_(std::shared_ptr<DataPacket> data_packet) = 0;
     virtual int deliverVideoData_(std::shared_ptr<DataPacket> data_packet) = 0;
+    virtual int deliverSharedAudioData_(std::shared_ptr<const DataPacket> data_packet, uint32_t ssrc) {
+        return deliverAudioData_(copyAudioPacketWithSSRC(*data_packet, ssrc));
+    }
+    virtual int deliverSharedVideoData_(std::shared_ptr<const DataPacket> data_packet, uint32_t ssrc) {
+        return deliverVideoData_(copyVideoPacketWithSSRC(*data_packet, ssrc));
+    }
     virtual int deliverEvent_(MediaEventPtr event) = 0;
 };
 
@@ -22,6 +22,7 @@
 #include "rtp/RtpSlideShowHandler.h"
 #include "rtp/RtpTrackMuteHandler.h"
 #include "rtp/FecReceiverHandler.h"
+#include "rtp/FecGeneratorHandler.h"
 #include "rtp/RtcpProcessorHandler.h"
 #include "rtp/RtpRetransmissionHandler.h"
 #include "rtp/RtcpFeedbackGenerationHandler.h"
@@ -39,6 +40,8 @@
 #include "rtp/RtpPaddingGeneratorHandler.h"
 #include "rtp/RtpUtils.h"
 #include "rtp/PacketCodecParser.h"
+#include "lib/PacketPool.h"
+#include "pipeline/StaticPipeline.h"
 
 namespace erizo {
 DEFINE_LOGGER(MediaStream, "MediaStream");
@@ -46,6 +49,34 @@ log4cxx::LoggerPtr MediaStream::statsLogger = log4cxx::Logger::getLogger("Stream
 
 static constexpr auto kStreamStatsPeriod = std::chrono::seconds(120);
 static constexpr uint64_t kInitialBitrate = 300000;
+static constexpr uint32_t kDefaultMaxFecOverhead = 25;
+
+// The default handlers, front to back. They are composed at compile time, see StaticPipeline.
+typedef StaticPipeline<PacketWriter, PacketCodecParser, OutgoingStatsHandler, LayerDetectorHandler,
+    SRPacketHandler, RtpRetransmissionHandler, RtcpFeedbackGenerationHandler, RtpPaddingRemovalHandler,
+    PliPacerHandler, PliPriorityHandler, PeriodicPliHandler, FecGeneratorHandler, RtpPaddingGeneratorHandler,
+    RtpSlideShowHandler, RtpTrackMuteHandler, FakeKeyframeGeneratorHandler, IncomingStatsHandler,
+    QualityFilterHandler, LayerBitrateCalculationHandler, FecReceiverHandler, RtcpProcessorHandler,
+    PacketReader> DefaultPipeline;
+
+// Custom handlers are inserted between the default ones, which needs a dynamic Pipeline
+static Pipeline::Ptr createPipeline(MediaStream *media_stream, const std::vector<std::string> &handler_order) {
+  if (!handler_order.empty()) {
+    return Pipeline::create();
+  }
+  return DefaultPipeline::create(std::make_shared<PacketWriter>(media_stream),
+      std::make_shared<PacketCodecParser>(), std::make_shared<OutgoingStatsHandler>(),
+      std::make_shared<LayerDetectorHandler>(), std::make_shared<SRPacketHandler>(),
+      std::make_shared<RtpRetransmissionHandler>(), std::make_shared<RtcpFeedbackGenerationHandler>(),
+      std::make_shared<RtpPaddingRemovalHandler>(), std::make_shared<PliPacerHandler>(),
+      std::make_shared<PliPriorityHandler>(), std::make_shared<PeriodicPliHandler>(),
+      std::make_shared<FecGeneratorHandler>(), std::make_shared<RtpPaddingGeneratorHandler>(),
+      std::make_shared<RtpSlideShowHandler>(), std::make_shared<RtpTrackMuteHandler>(),
+      std::make_shared<FakeKeyframeGeneratorHandler>(), std::make_shared<IncomingStatsHandler>(),
+      std::make_shared<QualityFilterHandler>(), std::make_shared<LayerBitrateCalculationHandler>(),
+      std::make_shared<FecReceiverHandler>(), std::make_shared<RtcpProcessorHandler>(),
+      std::make_shared<PacketReader>(media_stream));
+}
 
 MediaStream::MediaStream(std::shared_ptr<Worker> worker,
   std::shared_ptr<WebRtcConnection> connection,
@@ -67,7 +98,7 @@ MediaStream::MediaStream(std::shared_ptr<Worker> worker,
     bundle_{false},
     handler_order{handler_order},
     handler_pointer_dic{handler_pointer_dic},
-    pipeline_{Pipeline::create()},
+    pipeline_{createPipeline(this, handler_order)},
     worker_{std::move(worker)},
     audio_muted_{false}, video_muted_{false},
     pipeline_initialized_{false},
@@ -79,13 +110,16 @@ MediaStream::MediaStream(std::shared_ptr<Worker> worker,
     random_generator_{random_device_()},
     target_padding_bitrate_{0},
     periodic_keyframes_requested_{false},
-    periodic_keyframe_interval_{0} {
+    periodic_keyframe_interval_{0},
+    video_sink_rtx_ssrc_{0},
+    max_fec_overhead_{kDefaultMaxFecOverhead} {
   if (is_publisher) {
     setVideoSinkSSRC(kDefaultVideoSinkSSRC);
     setAudioSinkSSRC(kDefaultAudioSinkSSRC);
   } else {
     setAudioSinkSSRC(1000000000 + getRandomValue(0, 999999999));
     setVideoSinkSSRC(1000000000 + getRandomValue(0, 999999999));
+    setVideoSinkRtxSSRC(1000000000 + getRandomValue(0, 999999999));
   }
   ELOG_INFO("%s message: constructor, id: %s, priority: %s",
       toLog(), media_stream_id.c_str(), priority_.c_str() );
@@ -458,6 +492,17 @@ void MediaStream::initializePipeline() {
   pipeline_->addService(quality_manager_);
   pipeline_->addService(packet_buffer_);
 
+  // Otherwise the handlers are already in the StaticPipeline created with the stream
+  if (!handler_order.empty()) {
+    addHandlers();
+  }
+  pipeline_->finalize();
+
+  pipeline_initialized_ = true;
+}
+
+// Same handlers as DefaultPipeline, with the custom ones in their positions
+void MediaStream::addHandlers() {
   pipeline_->addFront(std::make_shared<PacketReader>(this));
   addHandlerInPosition(AFTER_READER, handler_pointer_dic, handler_order);
   pipeline_->addFront(std::make_shared<RtcpProcessorHandler>());
@@ -469,6 +514,7 @@ void MediaStream::initializePipeline() {
   pipeline_->addFront(std::make_shared<RtpTrackMuteHandler>());
   pipeline_->addFront(std::make_shared<RtpSlideShowHandler>());
   pipeline_->addFront(std::make_shared<RtpPaddingGeneratorHandler>());
+  pipeline_->addFront(std::make_shared<FecGeneratorHandler>());
   pipeline_->addFront(std::make_shared<PeriodicPliHandler>());
   pipeline_->addFront(std::make_shared<PliPriorityHandler>());
   addHandlerInPosition(MIDDLE, handler_pointer_dic, handler_order);
@@ -482,21 +528,32 @@ void MediaStream::initializePipeline() {
   pipeline_->addFront(std::make_shared<PacketCodecParser>());
   addHandlerInPosition(BEFORE_WRITER, handler_pointer_dic, handler_order);
   pipeline_->addFront(std::make_shared<PacketWriter>(this));
-  pipeline_->finalize();
-
-  pipeline_initialized_ = true;
 }
 
 int MediaStream::deliverAudioData_(std::shared_ptr<DataPacket> audio_packet) {
   if (audio_enabled_) {
-    sendPacketAsync(std::make_shared<DataPacket>(*audio_packet));
+    sendPacketAsync(PacketPool::clone(*audio_packet));
   }
   return audio_packet->length;
 }
 
 int MediaStream::deliverVideoData_(std::shared_ptr<DataPacket> video_packet) {
   if (video_enabled_) {
-    sendPacketAsync(std::make_shared<DataPacket>(*video_packet));
+    sendPacketAsync(PacketPool::clone(*video_packet));
+  }
+  return video_packet->length;
+}
+
+int MediaStream::deliverSharedAudioData_(std::shared_ptr<const DataPacket> audio_packet, uint32_t ssrc) {
+  if (audio_enabled_) {
+    sendSharedPacketAsync(audio_packet, ssrc, AUDIO_PACKET);
+  }
+  return audio_packet->length;
+}
+
+int MediaStream::deliverSharedVideoData_(std::shared_ptr<const DataPacket> video_packet, uint32_t ssrc) {
+  if (video_enabled_) {
+    sendSharedPacketAsync(video_packet, ssrc, VIDEO_PACKET);
   }
   return video_packet->length;
 }
@@ -556,7 +613,7 @@ void MediaStream::onTransportData(std::shared_ptr<DataPacket> incoming_packet, T
     return;
   }
 
-  std::shared_ptr<DataPacket> packet = std::make_shared<DataPacket>(*incoming_packet);
+  std::shared_ptr<DataPacket> packet = PacketPool::clone(*incoming_packet);
 
   if (transport->mediaType == AUDIO_TYPE) {
     packet->type = AUDIO_PACKET;
@@ -585,28 +642,28 @@ void MediaStream::onTransportData(std::shared_ptr<DataPacket> incoming_packet, T
       // Mid information is only sent at the beginning of the sessions or when the SSRC changes.
       if (stream_ptr->isVideoSourceSSRC(recv_ssrc)) {
         packet->type = VIDEO_PACKET;
-        packet->mid = stream_ptr->video_mid_;
+        packet->mid = stream_ptr->video_mid_id_;
       } else if (stream_ptr->isAudioSourceSSRC(recv_ssrc)) {
         packet->type = AUDIO_PACKET;
-        packet->mid = stream_ptr->audio_mid_;
-      } else if (packet->mid == stream_ptr->audio_mid_) {
+        packet->mid = stream_ptr->audio_mid_id_;
+      } else if (packet->mid != StringInterner::kEmptyId && packet->mid == stream_ptr->audio_mid_id_) {
         packet->type = AUDIO_PACKET;
         stream_ptr->setAudioSourceSSRC(recv_ssrc);
       }
 
       if (packet->type == VIDEO_PACKET) {
-        if (packet->rid != "0") {
+        if (packet->rid != 0) {
           // We learn SSRCs from the packets that are received as they are not
           // sent through the SDP anymore with Simulcast.
-          if (!stream_ptr->isVideoSourceSSRC(recv_ssrc) && packet->mid == stream_ptr->video_mid_) {
+          if (!stream_ptr->isVideoSourceSSRC(recv_ssrc) && packet->mid == stream_ptr->video_mid_id_) {
             // We must preserve the order set by RID
-            stream_ptr->setVideoSourceSSRC(recv_ssrc, stoi(packet->rid) - 1);
+            stream_ptr->setVideoSourceSSRC(recv_ssrc, packet->rid - 1);
           }
         } else {
           // RID = 0 is used when no RID information is sent in the packet.
           int position = stream_ptr->getVideoSourceSSRCPositionInList(recv_ssrc) + 1;
           if (position > 0) {
-            packet->rid = std::to_string(position);
+            packet->rid = position;
           } else {
             ELOG_WARN("%s message: No SSRC and no RID found for video packet", stream_ptr->toLog());
             return;
@@ -726,6 +783,13 @@ void MediaStream::setPeriodicKeyframeRequests(bool activate, uint32_t interval)
   periodic_keyframe_interval_ = interval;
   notifyUpdateToHandlers();
 }
+
+void MediaStream::setMaxFecOverhead(uint32_t percent) {
+  ELOG_DEBUG("%s message: setMaxFecOverhead, percent: %u", toLog(), percent);
+  max_fec_overhead_ = percent;
+  notifyUpdateToHandlers();
+}
+
 // changes the outgoing payload type for in the given data packet
 void MediaStream::sendPacketAsync(std::shared_ptr<DataPacket> packet) {
   if (!sending_) {
@@ -749,6 +813,31 @@ void MediaStream::sendPacketAsync(std::shared_ptr<DataPacket> packet) {
   });
 }
 
+void MediaStream::sendSharedPacketAsync(std::shared_ptr<const DataPacket> packet, uint32_t ssrc,
+    packetType sink_type) {
+  if (!sending_) {
+    return;
+  }
+  auto stream_ptr = shared_from_this();
+  if (packet->comp == -1) {
+    sending_ = false;
+    auto p = std::make_shared<DataPacket>();
+    p->comp = -1;
+    worker_->task([stream_ptr, p]{
+      stream_ptr->sendPacket(p);
+    });
+    return;
+  }
+  // The copy is made in our own worker so the publisher thread only pays for queueing the task
+  worker_->task([stream_ptr, packet, ssrc, sink_type]{
+    std::shared_ptr<DataPacket> own_packet = sink_type == AUDIO_PACKET ?
+      copyAudioPacketWithSSRC(*packet, ssrc) : copyVideoPacketWithSSRC(*packet, ssrc);
+    stream_ptr->changeDeliverPayloadType(own_packet.get(), own_packet->type);
+    stream_ptr->changeDeliverExtensionId(own_packet.get(), own_packet->type);
+    stream_ptr->sendPacket(own_packet);
+  });
+}
+
 void MediaStream::setSlideShowMode(bool state) {
   ELOG_DEBUG("%s slideShowMode: %u", toLog(), state);
   if (slide_show_mode_ == state) {
@@ -36,6 +36,11 @@ class MediaStreamStatsListener {
     virtual ~MediaStreamStatsListener() {
     }
     virtual void notifyStats(const std::string& message) = 0;
+    // Listeners returning true get only the stats changed since the previous report, encoded as a
+    // StatsDelta, through notifyStatsDelta() instead of the whole JSON. notifyStatsDelta() returns false
+    // when the delta was discarded, the next one is then a full snapshot
+    virtual bool wantsStatsDelta() { return false; }
+    virtual bool notifyStatsDelta(const std::string& delta) { return true; }
 };
 
 
@@ -104,6 +109,7 @@ class MediaStream: public MediaSink, public MediaSource, public FeedbackSink,
   virtual void enableSlideShowBelowSpatialLayer(bool enabled, int spatial_layer);
   virtual void enableFallbackBelowMinLayer(bool enabled);
   void setPeriodicKeyframeRequests(bool activate, uint32_t interval_in_ms = 0);
+  void setMaxFecOverhead(uint32_t percent);
 
   WebRTCEvent getCurrentState();
 
@@ -165,11 +171,17 @@ class MediaStream: public MediaSink, public MediaSource, public FeedbackSink,
 
   virtual bool isRequestingPeriodicKeyframes() { return periodic_keyframes_requested_; }
   virtual uint32_t getPeriodicKeyframesRequesInterval() { return periodic_keyframe_interval_; }
+  // Maximum FEC sent to a subscriber, as a percentage of its video packets
+  virtual uint32_t getMaxFecOverhead() { return max_fec_overhead_; }
 
   virtual bool isSimulcast() { return simulcast_; }
   void setSimulcast(bool simulcast) { simulcast_ = simulcast; }
 
   RtpExtensionProcessor& getRtpExtensionProcessor() { return connection_->getRtpExtensionProcessor(); }
+  uint32_t getRtt() { return connection_->getRtt(); }
+  // SSRC used for RTX retransmissions to subscribers, 0 for publishers
+  uint32_t getVideoSinkRtxSSRC() { return video_sink_rtx_ssrc_; }
+  void setVideoSinkRtxSSRC(uint32_t ssrc) { video_sink_rtx_ssrc_ = ssrc; }
   std::shared_ptr<Worker> getWorker() { return worker_; }
 
   std::string getId() { return stream_id_; }
@@ -204,17 +216,23 @@ class MediaStream: public MediaSink, public MediaSource, public FeedbackSink,
 
   virtual PublisherInfo getPublisherInfo() { return publisher_info_; }
 
-  void setVideoMid(std::string mid) { video_mid_ = mid; }
+  void setVideoMid(std::string mid) { video_mid_ = mid; video_mid_id_ = StringInterner::intern(mid); }
   std::string getVideoMid() { return video_mid_; }
-  void setAudioMid(std::string mid) { audio_mid_ = mid; }
+  StringId getVideoMidId() { return video_mid_id_; }
+  void setAudioMid(std::string mid) { audio_mid_ = mid; audio_mid_id_ = StringInterner::intern(mid); }
   std::string getAudioMid() { return audio_mid_; }
+  StringId getAudioMidId() { return audio_mid_id_; }
  private:
   void sendPacket(std::shared_ptr<DataPacket> packet);
   int deliverAudioData_(std::shared_ptr<DataPacket> audio_packet) override;
   int deliverVideoData_(std::shared_ptr<DataPacket> video_packet) override;
+  int deliverSharedAudioData_(std::shared_ptr<const DataPacket> audio_packet, uint32_t ssrc) override;
+  int deliverSharedVideoData_(std::shared_ptr<const DataPacket> video_packet, uint32_t ssrc) override;
+  void sendSharedPacketAsync(std::shared_ptr<const DataPacket> packet, uint32_t ssrc, packetType sink_type);
   int deliverFeedback_(std::shared_ptr<DataPacket> fb_packet) override;
   int deliverEvent_(MediaEventPtr event) override;
   void initializePipeline();
+  void addHandlers();
   void transferLayerStats(std::string spatial, std::string temporal);
   void transferMediaStats(std::string target_node, std::string source_parent, std::string source_node);
 
@@ -281,9 +299,13 @@ class MediaStream: public MediaSink, public MediaSource, public FeedbackSink,
   uint64_t target_padding_bitrate_;
   bool periodic_keyframes_requested_;
   uint32_t periodic_keyframe_interval_;
+  uint32_t video_sink_rtx_ssrc_;
+  std::atomic<uint32_t> max_fec_overhead_;
   PublisherInfo publisher_info_;
   std::string audio_mid_;
   std::string video_mid_;
+  StringId audio_mid_id_ = StringInterner::kEmptyId;
+  StringId video_mid_id_ = StringInterner::kEmptyId;
 
  protected:
   std::shared_ptr<SdpInfo> remote_sdp_;
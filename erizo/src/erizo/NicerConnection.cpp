@@ -36,6 +36,8 @@ extern "C" {
 #include <string>
 #include <vector>
 
+#include "lib/PacketPool.h"
+
 namespace erizo {
 
 DEFINE_LOGGER(NicerConnection, "NicerConnection");
@@ -536,29 +538,36 @@ int NicerConnection::sendData(unsigned int component_id, const void* buf, int le
   if (checkIceState() != IceState::READY) {
     return -1;
   }
-  packetPtr packet (new DataPacket());
+  packetPtr packet = PacketPool::create();
   memcpy(packet->data, buf, len);
+  packet->comp = component_id;
   packet->length = len;
-  async([packet, component_id, len] (std::shared_ptr<NicerConnection> this_ptr) {
-    nr_ice_peer_ctx *peer = this_ptr->peer_;
-    if (this_ptr->checkIceState() != IceState::READY) {
-      return;
-    }
-    nr_ice_media_stream *stream = this_ptr->stream_;
-    std::shared_ptr<NicerInterface> nicer = this_ptr->nicer_;
-    UINT4 r = nicer->IceMediaStreamSend(peer,
-                                        stream,
-                                        component_id,
-                                        reinterpret_cast<unsigned char*>(packet->data),
-                                        len);
-    if (r) {
-      ELOG_WARN("%s message: Couldn't send data on ICE", this_ptr->toLog());
-    }
-  });
+  if (outgoing_packets_.push(packet)) {
+    async([] (std::shared_ptr<NicerConnection> this_ptr) {
+      this_ptr->flushOutgoingPackets();
+    });
+  }
 
   return len;
 }
 
+void NicerConnection::flushOutgoingPackets() {
+  outgoing_packets_.takeAll(&sending_packets_);
+  if (checkIceState() == IceState::READY) {
+    for (const packetPtr &packet : sending_packets_) {
+      UINT4 r = nicer_->IceMediaStreamSend(peer_,
+                                           stream_,
+                                           packet->comp,
+                                           reinterpret_cast<unsigned char*>(packet->data),
+                                           packet->length);
+      if (r) {
+        ELOG_WARN("%s message: Couldn't send data on ICE", toLog());
+      }
+    }
+  }
+  sending_packets_.clear();
+}
+
 std::string getHostTypeFromNicerCandidate(nr_ice_candidate *candidate) {
   switch (candidate->type) {
     case nr_ice_candidate_type::HOST: return "host";
@@ -636,11 +645,8 @@ boost::future<void> NicerConnection::close() {
 void NicerConnection::onData(unsigned int component_id, char* buf, int len) {
   IceState state = this->checkIceState();
   if (state == IceState::READY) {
-    packetPtr packet (new DataPacket());
-    memcpy(packet->data, buf, len);
-    packet->comp = component_id;
-    packet->length = len;
-    packet->received_time_ms = ClockUtils::timePointToMs(clock::now());
+    packetPtr packet = PacketPool::create(component_id, buf, len, VIDEO_PACKET,
+                                          ClockUtils::timePointToMs(clock::now()));
     if (auto listener = getIceListener().lock()) {
       listener->onPacketReceived(packet);
     }
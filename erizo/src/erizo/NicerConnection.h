@@ -26,6 +26,7 @@ extern "C" {
 #include "./logger.h"
 #include "./IceConnection.h"
 #include "lib/NicerInterface.h"
+#include "lib/PacketBatchQueue.h"
 #include "./thread/Worker.h"
 #include "./thread/IOWorker.h"
 
@@ -76,6 +77,7 @@ class NicerConnection : public IceConnection, public std::enable_shared_from_thi
   void startSync();
   void closeSync();
   void async(function<void(std::shared_ptr<NicerConnection>)> f);
+  void flushOutgoingPackets();
   boost::future<void> asyncWithFuture(std::function<void(std::shared_ptr<NicerConnection>)> f);
   void setRemoteCredentialsSync(const std::string& username, const std::string& password);
   void addStreamSync(std::string remote_ufrag, std::string remote_pass);
@@ -111,6 +113,8 @@ class NicerConnection : public IceConnection, public std::enable_shared_from_thi
   std::promise<void> close_promise_;
   std::promise<void> start_promise_;
   std::future<void>  start_future_;
+  PacketBatchQueue outgoing_packets_;
+  std::vector<packetPtr> sending_packets_;
 };
 
 }  // namespace erizo
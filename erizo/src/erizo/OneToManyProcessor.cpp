@@ -4,8 +4,13 @@
 
 #include "OneToManyProcessor.h"
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "./MediaStream.h"
 #include "rtp/RtpHeaders.h"
@@ -13,7 +18,10 @@
 
 namespace erizo {
   DEFINE_LOGGER(OneToManyProcessor, "OneToManyProcessor");
-  OneToManyProcessor::OneToManyProcessor() : feedback_sink_{} {
+
+  OneToManyProcessor::OneToManyProcessor(std::shared_ptr<Clock> the_clock) : feedback_sink_{},
+      subscriber_snapshot_{std::make_shared<const SubscriberSnapshot>()}, clock_{the_clock}, cached_packets_{0},
+      keyframe_cached_{false}, cached_keyframes_{0}, layer_availability_{the_clock} {
     ELOG_DEBUG("OneToManyProcessor constructor");
   }
 
@@ -24,40 +32,21 @@ namespace erizo {
     if (audio_packet->length <= 0)
       return 0;
 
-    boost::unique_lock<boost::mutex> lock(monitor_mutex_);
-    if (subscribers_.empty() || !publisher_) {
+    std::shared_ptr<const SubscriberSnapshot> snapshot = getSubscriberSnapshot();
+    if (snapshot->sinks.empty() || !std::atomic_load(&publisher_)) {
       return 0;
     }
 
-    std::map<std::string, std::shared_ptr<MediaSink>>::iterator it;
-    RtpHeader* head = reinterpret_cast<RtpHeader*>(audio_packet->data);
-    RtcpHeader* chead = reinterpret_cast<RtcpHeader*>(audio_packet->data);
-    for (it = subscribers_.begin(); it != subscribers_.end(); ++it) {
-      if ((*it).second != nullptr) {
-        // Hack to avoid audio drift
-        if (chead->isRtcp() && chead->isSDES()) {
-          chead->setSSRC((*it).second->getAudioSinkSSRC());
-        } else {
-          head->setSSRC((*it).second->getAudioSinkSSRC());
-        }
-        // Note: deliverAudioData must copy the packet inmediately
-        (*it).second->deliverAudioData(audio_packet);
-      }
+    for (const std::shared_ptr<MediaSink> &sink : snapshot->sinks) {
+      // The packet is shared by all subscribers, each one rewrites the SSRC in its own copy
+      sink->deliverSharedAudioData(audio_packet, sink->getAudioSinkSSRC());
     }
 
     return 0;
   }
 
-  bool OneToManyProcessor::isSSRCFromAudio(uint32_t ssrc) {
-    std::map<std::string, std::shared_ptr<MediaSink>>::iterator it;
-    for (it = subscribers_.begin(); it != subscribers_.end(); ++it) {
-      if ((*it).second != nullptr) {
-        if ((*it).second->getAudioSinkSSRC() == ssrc) {
-          return true;
-        }
-      }
-    }
-    return false;
+  bool OneToManyProcessor::isSSRCFromAudio(const SubscriberSnapshot &snapshot, uint32_t ssrc) {
+    return snapshot.audio_sink_ssrcs.find(ssrc) != snapshot.audio_sink_ssrcs.end();
   }
 
   int OneToManyProcessor::deliverVideoData_(std::shared_ptr<DataPacket> video_packet) {
@@ -69,62 +58,231 @@ namespace erizo {
       deliverFeedback_(video_packet);
       return 0;
     }
-    boost::unique_lock<boost::mutex> lock(monitor_mutex_);
-    if (subscribers_.empty() || !publisher_) {
+    if (!std::atomic_load(&publisher_)) {
       return 0;
     }
-    std::map<std::string, std::shared_ptr<MediaSink>>::iterator it;
-    RtpHeader* rhead = reinterpret_cast<RtpHeader*>(video_packet->data);
     // We create a controlled offset to keep having multiple SSRCs in the
     // subscribers.
-    uint32_t ssrc_offset = std::max(stoi(video_packet->rid) - 1, 0);
+    uint32_t ssrc_offset = std::max(video_packet->rid - 1, 0);
 
-    for (it = subscribers_.begin(); it != subscribers_.end(); ++it) {
-      if ((*it).second != nullptr) {
-        uint32_t base_ssrc = (*it).second->getVideoSinkSSRC();
-        if (head->isRtcp()) {
-          head->setSSRC(base_ssrc + ssrc_offset);
-        } else {
-          rhead->setSSRC(base_ssrc + ssrc_offset);
-        }
-        // Note: deliverVideoData must copy the packet inmediately
-        (*it).second->deliverVideoData(video_packet);
-      }
+    std::shared_ptr<const SubscriberSnapshot> snapshot = getSubscriberSnapshot();
+    if (!snapshot->pending_by_video_ssrc.empty()) {
+      // Pending subscribers get the cache before it includes this packet, which they get with the rest
+      primePendingSubscribers(*snapshot);
+      snapshot = getSubscriberSnapshot();
+    }
+    cacheVideoPacket(video_packet, ssrc_offset);
+    updateLayerAvailability(*video_packet);
+
+    for (const std::shared_ptr<MediaSink> &sink : snapshot->video_sinks) {
+      uint32_t base_ssrc = sink->getVideoSinkSSRC();
+      // The packet is shared by all subscribers, each one rewrites the SSRC in its own copy
+      sink->deliverSharedVideoData(video_packet, base_ssrc + ssrc_offset);
     }
     return 0;
   }
 
+  void OneToManyProcessor::cacheVideoPacket(const std::shared_ptr<DataPacket> &video_packet, uint32_t layer) {
+    RtpHeader *head = reinterpret_cast<RtpHeader*>(video_packet->data);
+    CachedLayer &cached_layer = keyframe_cache_[layer];
+    if (video_packet->is_keyframe &&
+        (cached_layer.packets.empty() || cached_layer.keyframe_timestamp != head->getTimestamp())) {
+      cached_layer.keyframe_timestamp = head->getTimestamp();
+      cached_layer.packets.clear();
+      cached_keyframes_++;
+    } else if (cached_layer.packets.empty()) {
+      return;
+    }
+    if (cached_layer.packets.size() == kMaxKeyframeCachePackets) {
+      // The keyframe is too old to prime subscribers with it, wait for the next one
+      ELOG_DEBUG("message: Keyframe cache full, publisher_id: %s, layer: %u", publisher_id_, layer);
+      cached_layer.packets.clear();
+      keyframe_cached_ = std::any_of(keyframe_cache_.begin(), keyframe_cache_.end(),
+          [](const std::pair<const uint32_t, CachedLayer> &entry) { return !entry.second.packets.empty(); });
+      return;
+    }
+    cached_layer.packets.emplace_back(cached_packets_++, video_packet);
+    keyframe_cached_ = true;
+  }
+
+  void OneToManyProcessor::updateLayerAvailability(const DataPacket &video_packet) {
+    layer_availability_.onVideoPacket(video_packet);
+    std::shared_ptr<const LayerAvailability> availability = layer_availability_.maybeUpdate();
+    if (availability) {
+      // Subscribers select their layers with these bitrates instead of measuring them on their own
+      deliverEvent_(std::make_shared<LayerAvailabilityChangedEvent>(availability));
+    }
+  }
+
+  void OneToManyProcessor::primePendingSubscribers(const SubscriberSnapshot &snapshot) {
+    time_point now = clock_->now();
+    bool changed = false;
+    for (const auto &entry : snapshot.pending_by_video_ssrc) {
+      PendingSubscriber *pending = entry.second.get();
+      if (pending->primed) {
+        changed |= now - pending->primed_at > kPrimedRequestGuard;
+      } else if (pending->priming || shouldStartPriming(*pending, now)) {
+        pending->priming = true;
+        primeSubscriber(pending, now);
+        changed |= static_cast<bool>(pending->primed);
+      }
+    }
+    if (!changed) {
+      return;
+    }
+    boost::mutex::scoped_lock lock(monitor_mutex_);
+    for (auto it = pending_subscribers_.begin(); it != pending_subscribers_.end();) {
+      if (it->second->primed && now - it->second->primed_at > kPrimedRequestGuard) {
+        it = pending_subscribers_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    updateSubscriberSnapshot();
+  }
+
+  bool OneToManyProcessor::shouldStartPriming(const PendingSubscriber &pending, time_point now) {
+    // Streams that are ready can decode the cache right away, e.g. when they join an existing connection
+    // and the browser doesn't ask for a keyframe
+    return pending.keyframe_requested || (pending.stream != nullptr && pending.stream->isReady()) ||
+        now - pending.added_at > kMaxPrimingWait;
+  }
+
+  void OneToManyProcessor::primeSubscriber(PendingSubscriber *pending, time_point now) {
+    // Layers are merged back in the order the publisher sent them, starting after what was already sent
+    typedef std::pair<uint64_t, std::shared_ptr<const DataPacket>> CachedPacket;
+    std::vector<std::tuple<uint64_t, uint32_t, std::shared_ptr<const DataPacket>>> packets;
+    for (const auto &layer : keyframe_cache_) {
+      auto first = std::lower_bound(layer.second.packets.begin(), layer.second.packets.end(),
+          pending->next_cached_packet, [](const CachedPacket &cached_packet, uint64_t next_cached_packet) {
+            return cached_packet.first < next_cached_packet;
+          });
+      for (auto it = first; it != layer.second.packets.end(); ++it) {
+        packets.emplace_back(it->first, layer.first, it->second);
+      }
+    }
+    size_t burst = std::min(packets.size(), kMaxPrimingPacketsPerPacket);
+    std::partial_sort(packets.begin(), packets.begin() + burst, packets.end(),
+        [](const auto &first, const auto &second) {
+          return std::get<0>(first) < std::get<0>(second);
+        });
+    uint32_t base_ssrc = pending->sink->getVideoSinkSSRC();
+    for (size_t index = 0; index < burst; index++) {
+      pending->sink->deliverSharedVideoData(std::get<2>(packets[index]), base_ssrc + std::get<1>(packets[index]));
+    }
+    if (burst > 0) {
+      pending->next_cached_packet = std::get<0>(packets[burst - 1]) + 1;
+      pending->primed_packets += burst;
+    }
+    if (packets.size() > burst) {
+      // The rest of the cache, which keeps growing with the live packets, goes with the next publisher packets
+      return;
+    }
+    ELOG_DEBUG("message: Primed subscriber from keyframe cache, publisher_id: %s, packets: %lu",
+        publisher_id_, pending->primed_packets);
+    // The cache may have been dropped while priming, then the subscriber needs a new keyframe too
+    bool cache_dropped = pending->primed_packets > 0 && !keyframe_cached_;
+    if ((pending->primed_packets == 0 && pending->keyframe_requested) || cache_dropped) {
+      if (std::shared_ptr<MediaSource> publisher = getPublisher()) {
+        publisher->sendPLI();
+      }
+    }
+    pending->primed_at = now;
+    pending->primed_keyframe = cached_keyframes_;
+    pending->primed = true;
+  }
+
+  bool OneToManyProcessor::handleKeyframeRequest(const SubscriberSnapshot &snapshot,
+      const std::shared_ptr<DataPacket> &fb_packet) {
+    if (snapshot.pending_by_video_ssrc.empty()) {
+      return false;
+    }
+    bool only_pending_requests = true;
+    uint64_t cached_keyframes = cached_keyframes_;
+    RtpUtils::forEachRtcpBlock(fb_packet, [&snapshot, &only_pending_requests, cached_keyframes](RtcpHeader *chead) {
+      auto pending_it = snapshot.pending_by_video_ssrc.end();
+      if (chead->packettype == RTCP_PS_Feedback_PT && chead->getBlockCount() == RTCP_PLI_FMT) {
+        pending_it = snapshot.pending_by_video_ssrc.find(chead->getSourceSSRC());
+      }
+      if (pending_it == snapshot.pending_by_video_ssrc.end()) {
+        only_pending_requests = false;
+        return;
+      }
+      PendingSubscriber *pending = pending_it->second.get();
+      if (!pending->primed) {
+        pending->keyframe_requested = true;
+      } else if (!pending->keyframe_requested || pending->primed_keyframe != cached_keyframes ||
+          pending->duplicate_request_dropped.exchange(true)) {
+        // Not a repetition of the request priming answered, the publisher has to send a new keyframe
+        only_pending_requests = false;
+      }
+    });
+    // Compound packets still carry feedback the publisher needs
+    return only_pending_requests;
+  }
+
   uint32_t OneToManyProcessor::translateAndMaybeAdaptForSimulcast(uint32_t orig_ssrc) {
-    return orig_ssrc - publisher_->getVideoSourceSSRC();
+    return orig_ssrc - getPublisher()->getVideoSourceSSRC();
   }
 
   void OneToManyProcessor::setPublisher(std::shared_ptr<MediaSource> publisher_stream, std::string publisher_id) {
     boost::mutex::scoped_lock lock(monitor_mutex_);
-    publisher_ = publisher_stream;
-    feedback_sink_ = publisher_->getFeedbackSink();
+    std::atomic_store(&publisher_, publisher_stream);
+    feedback_sink_ = publisher_stream->getFeedbackSink();
     publisher_id_ = publisher_id;
   }
 
   std::shared_ptr<MediaSource> OneToManyProcessor::getPublisher() {
-    return publisher_;
+    return std::atomic_load(&publisher_);
+  }
+
+  std::shared_ptr<const OneToManyProcessor::SubscriberSnapshot> OneToManyProcessor::getSubscriberSnapshot() {
+    return std::atomic_load(&subscriber_snapshot_);
+  }
+
+  void OneToManyProcessor::updateSubscriberSnapshot() {
+    auto snapshot = std::make_shared<SubscriberSnapshot>();
+    snapshot->sinks.reserve(subscribers_.size());
+    for (const auto &subscriber : subscribers_) {
+      if (subscriber.second != nullptr) {
+        snapshot->sinks.push_back(subscriber.second);
+        snapshot->audio_sink_ssrcs.insert(subscriber.second->getAudioSinkSSRC());
+        auto pending_it = pending_subscribers_.find(subscriber.first);
+        if (pending_it != pending_subscribers_.end()) {
+          snapshot->pending_by_video_ssrc[subscriber.second->getVideoSinkSSRC()] = pending_it->second;
+        }
+        if (pending_it == pending_subscribers_.end() || pending_it->second->primed) {
+          snapshot->video_sinks.push_back(subscriber.second);
+        }
+      }
+    }
+    std::atomic_store(&subscriber_snapshot_, std::shared_ptr<const SubscriberSnapshot>(std::move(snapshot)));
   }
 
   int OneToManyProcessor::deliverFeedback_(std::shared_ptr<DataPacket> fb_packet) {
+    std::shared_ptr<MediaSource> publisher = getPublisher();
+    if (!publisher) {
+      return 0;
+    }
     if (auto feedback_sink = feedback_sink_.lock()) {
-      RtpUtils::forEachRtcpBlock(fb_packet, [this](RtcpHeader *chead) {
+      std::shared_ptr<const SubscriberSnapshot> snapshot = getSubscriberSnapshot();
+      if (handleKeyframeRequest(*snapshot, fb_packet)) {
+        return 0;
+      }
+      RtpUtils::forEachRtcpBlock(fb_packet, [&snapshot, &publisher](RtcpHeader *chead) {
         if (chead->isREMB()) {
           for (uint8_t index = 0; index < chead->getREMBNumSSRC(); index++) {
-            if (isSSRCFromAudio(chead->getREMBFeedSSRC(index))) {
-              chead->setREMBFeedSSRC(index, publisher_->getAudioSourceSSRC());
+            if (isSSRCFromAudio(*snapshot, chead->getREMBFeedSSRC(index))) {
+              chead->setREMBFeedSSRC(index, publisher->getAudioSourceSSRC());
             } else {
-              chead->setREMBFeedSSRC(index, publisher_->getVideoSourceSSRC());
+              chead->setREMBFeedSSRC(index, publisher->getVideoSourceSSRC());
             }
           }
         }
-        if (isSSRCFromAudio(chead->getSourceSSRC())) {
-          chead->setSourceSSRC(publisher_->getAudioSourceSSRC());
+        if (isSSRCFromAudio(*snapshot, chead->getSourceSSRC())) {
+          chead->setSourceSSRC(publisher->getAudioSourceSSRC());
         } else {
-          chead->setSourceSSRC(publisher_->getVideoSourceSSRC());
+          chead->setSourceSSRC(publisher->getVideoSourceSSRC());
         }
       });
       feedback_sink->deliverFeedback(fb_packet);
@@ -133,15 +291,12 @@ namespace erizo {
   }
 
   int OneToManyProcessor::deliverEvent_(MediaEventPtr event) {
-    boost::unique_lock<boost::mutex> lock(monitor_mutex_);
-    if (subscribers_.empty() || !publisher_) {
+    std::shared_ptr<const SubscriberSnapshot> snapshot = getSubscriberSnapshot();
+    if (snapshot->sinks.empty() || !std::atomic_load(&publisher_)) {
       return 0;
     }
-    std::map<std::string, std::shared_ptr<MediaSink>>::iterator it;
-    for (it = subscribers_.begin(); it != subscribers_.end(); ++it) {
-      if ((*it).second != nullptr) {
-        (*it).second->deliverEvent(event);
-      }
+    for (const std::shared_ptr<MediaSink> &sink : snapshot->sinks) {
+      sink->deliverEvent(event);
     }
     return 0;
   }
@@ -150,10 +305,12 @@ namespace erizo {
       const std::string& peer_id) {
     ELOG_DEBUG("Adding subscriber");
     boost::mutex::scoped_lock lock(monitor_mutex_);
-    ELOG_DEBUG("From %u, %u ", publisher_->getAudioSourceSSRC(), publisher_->getVideoSourceSSRC());
-    ELOG_DEBUG("Subscribers ssrcs: Audio %u, video, %u from %u, %u ",
-               subscriber_stream->getAudioSinkSSRC(), subscriber_stream->getVideoSinkSSRC(),
-               publisher_->getAudioSourceSSRC() , publisher_->getVideoSourceSSRC());
+    if (std::shared_ptr<MediaSource> publisher = std::atomic_load(&publisher_)) {
+      ELOG_DEBUG("From %u, %u ", publisher->getAudioSourceSSRC(), publisher->getVideoSourceSSRC());
+      ELOG_DEBUG("Subscribers ssrcs: Audio %u, video, %u from %u, %u ",
+                 subscriber_stream->getAudioSinkSSRC(), subscriber_stream->getVideoSinkSSRC(),
+                 publisher->getAudioSourceSSRC() , publisher->getVideoSourceSSRC());
+    }
     std::shared_ptr<FeedbackSource> fbsource = subscriber_stream->getFeedbackSource().lock();
 
     if (fbsource) {
@@ -166,6 +323,15 @@ namespace erizo {
         subscribers_.erase(peer_id);
     }
     subscribers_[peer_id] = subscriber_stream;
+    pending_subscribers_.erase(peer_id);
+    if (keyframe_cached_) {
+      auto pending = std::make_shared<PendingSubscriber>();
+      pending->sink = subscriber_stream;
+      pending->stream = dynamic_cast<MediaStream*>(subscriber_stream.get());
+      pending->added_at = clock_->now();
+      pending_subscribers_[peer_id] = pending;
+    }
+    updateSubscriberSnapshot();
   }
 
   std::shared_ptr<MediaSink> OneToManyProcessor::getSubscriber(const std::string& peer_id) {
@@ -181,6 +347,8 @@ namespace erizo {
     boost::mutex::scoped_lock lock(monitor_mutex_);
     if (subscribers_.find(peer_id) != subscribers_.end()) {
       subscribers_.erase(peer_id);
+      pending_subscribers_.erase(peer_id);
+      updateSubscriberSnapshot();
     }
   }
 
@@ -193,7 +361,7 @@ namespace erizo {
     std::shared_ptr<boost::promise<void>> p = std::make_shared<boost::promise<void>>();
     boost::future<void> f = p->get_future();
     feedback_sink_.reset();
-    publisher_.reset();
+    std::atomic_store(&publisher_, std::shared_ptr<MediaSource>());
     boost::unique_lock<boost::mutex> lock(monitor_mutex_);
     std::map<std::string, std::shared_ptr<MediaSink>>::iterator it = subscribers_.begin();
     while (it != subscribers_.end()) {
@@ -206,6 +374,8 @@ namespace erizo {
       subscribers_.erase(it++);
     }
     subscribers_.clear();
+    pending_subscribers_.clear();
+    updateSubscriberSnapshot();
     p->set_value();
     ELOG_INFO("OneToManyProcessor closed, publisher_id: %s", publisher_id_);
     return f;
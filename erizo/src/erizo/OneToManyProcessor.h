@@ -5,12 +5,20 @@
 #ifndef ERIZO_SRC_ERIZO_ONETOMANYPROCESSOR_H_
 #define ERIZO_SRC_ERIZO_ONETOMANYPROCESSOR_H_
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 #include <boost/thread/future.hpp>
 
 #include "./MediaDefinitions.h"
 #include "media/ExternalOutput.h"
+#include "lib/Clock.h"
+#include "rtp/LayerAvailabilityService.h"
 #include "./logger.h"
 
 namespace erizo {
@@ -20,13 +28,15 @@ class MediaStream;
 /**
 * Represents a One to Many connection.
 * Receives media from one publisher and retransmits it to every subscriber.
+* The last keyframe of every layer and the packets that followed it are kept, so subscribers that join
+* while there is one get it from there instead of asking the publisher for a new one.
 */
 class OneToManyProcessor
     : public MediaSink, public FeedbackSink, public std::enable_shared_from_this<OneToManyProcessor> {
   DECLARE_LOGGER();
 
  public:
-  OneToManyProcessor();
+  explicit OneToManyProcessor(std::shared_ptr<Clock> the_clock = std::make_shared<SteadyClock>());
   virtual ~OneToManyProcessor();
   /**
   * Sets the Publisher
@@ -52,20 +62,84 @@ class OneToManyProcessor
 
   boost::future<void> close() override;
 
+  static constexpr size_t kMaxKeyframeCachePackets = 512;
+  // Cached packets sent to a subscriber being primed per publisher packet, so it catches up without a burst
+  static constexpr size_t kMaxPrimingPacketsPerPacket = 16;
+  // Time a subscriber that is not a ready MediaStream waits for its keyframe request before being primed anyway
+  static constexpr duration kMaxPrimingWait = std::chrono::seconds(2);
+  // Time a subscriber primed after asking for a keyframe may still repeat that request, already answered with
+  // the cache. Only its first repeated request is dropped, and only while no newer keyframe has been forwarded.
+  static constexpr duration kPrimedRequestGuard = std::chrono::seconds(1);
+
  private:
   int deliverAudioData_(std::shared_ptr<DataPacket> audio_packet) override;
   int deliverVideoData_(std::shared_ptr<DataPacket> video_packet) override;
   int deliverFeedback_(std::shared_ptr<DataPacket> fb_packet) override;
   int deliverEvent_(MediaEventPtr event) override;
+  /**
+  * A subscriber that joined while there was a cached keyframe. It gets no video until its stream is ready
+  * or it asks for a keyframe, then it is primed with the cache from the publisher thread, a few packets
+  * with every publisher packet, and the live video follows.
+  */
+  struct PendingSubscriber {
+    std::shared_ptr<MediaSink> sink;
+    MediaStream *stream = nullptr;  // The sink, if it is a MediaStream
+    time_point added_at;
+    std::atomic_bool keyframe_requested{false};
+    std::atomic_bool primed{false};
+    time_point primed_at;
+    uint64_t primed_keyframe = 0;  // Value of cached_keyframes_ when it was primed
+    std::atomic_bool duplicate_request_dropped{false};
+    // Only used from the publisher thread
+    bool priming = false;
+    uint64_t next_cached_packet = 0;
+    size_t primed_packets = 0;
+  };
+  struct CachedLayer {
+    uint32_t keyframe_timestamp = 0;
+    std::vector<std::pair<uint64_t, std::shared_ptr<const DataPacket>>> packets;
+  };
+
+  /**
+  * Immutable view of the subscribers used by the media path. It is rebuilt under monitor_mutex_
+  * whenever subscribers change and published with std::atomic_store, so delivering media never waits
+  * for addSubscriber/removeSubscriber. This is not lock-free: libstdc++ guards the shared_ptr atomics
+  * with a small pool of mutexes, held only while the pointer and its refcount are copied.
+  */
+  struct SubscriberSnapshot {
+    std::vector<std::shared_ptr<MediaSink>> sinks;
+    std::vector<std::shared_ptr<MediaSink>> video_sinks;
+    std::unordered_set<uint32_t> audio_sink_ssrcs;
+    std::unordered_map<uint32_t, std::shared_ptr<PendingSubscriber>> pending_by_video_ssrc;
+  };
+
   boost::future<void> closeAll();
-  bool isSSRCFromAudio(uint32_t ssrc);
+  static bool isSSRCFromAudio(const SubscriberSnapshot &snapshot, uint32_t ssrc);
   uint32_t translateAndMaybeAdaptForSimulcast(uint32_t orig_ssrc);
+  std::shared_ptr<const SubscriberSnapshot> getSubscriberSnapshot();
+  void updateSubscriberSnapshot();
+  void cacheVideoPacket(const std::shared_ptr<DataPacket> &video_packet, uint32_t layer);
+  void updateLayerAvailability(const DataPacket &video_packet);
+  void primePendingSubscribers(const SubscriberSnapshot &snapshot);
+  bool shouldStartPriming(const PendingSubscriber &pending, time_point now);
+  void primeSubscriber(PendingSubscriber *pending, time_point now);
+  bool handleKeyframeRequest(const SubscriberSnapshot &snapshot, const std::shared_ptr<DataPacket> &fb_packet);
 
  private:
   std::weak_ptr<FeedbackSink> feedback_sink_;
   std::map<std::string, std::shared_ptr<MediaSink>> subscribers_;
+  std::shared_ptr<const SubscriberSnapshot> subscriber_snapshot_;
   std::shared_ptr<MediaSource> publisher_;
   std::string publisher_id_;
+  std::shared_ptr<Clock> clock_;
+  std::map<std::string, std::shared_ptr<PendingSubscriber>> pending_subscribers_;
+  // Only used from the publisher thread
+  std::map<uint32_t, CachedLayer> keyframe_cache_;
+  uint64_t cached_packets_;
+  std::atomic_bool keyframe_cached_;
+  // Keyframes that started a new cache, read by the feedback path to match requests with the cached keyframe
+  std::atomic<uint64_t> cached_keyframes_;
+  LayerAvailabilityService layer_availability_;
 };
 
 }  // namespace erizo
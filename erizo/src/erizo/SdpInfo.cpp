@@ -422,6 +422,19 @@ namespace erizo {
     return getAudioExternalPT(internalPT);
   }
 
+  unsigned int SdpInfo::getVideoRtxPT(unsigned int externalPT) {
+    for (const RtpMap& map : payloadVector) {
+      if (map.encoding_name != "rtx") {
+        continue;
+      }
+      auto apt = map.format_parameters.find(kAssociatedPt);
+      if (apt != map.format_parameters.end() && std::strtoul(apt->second.c_str(), nullptr, 10) == externalPT) {
+        return map.payload_type;
+      }
+    }
+    return 0;
+  }
+
   bool SdpInfo::processCandidate(const std::vector<std::string>& pieces, MediaType mediaType, std::string line) {
     CandidateInfo cand;
     static const char* types_str[] = { "host", "srflx", "prflx", "relay" };
@@ -262,6 +262,12 @@ class SdpInfo {
    * @return The external video payload type
    */
   unsigned int getVideoExternalPT(unsigned int internalPT);
+  /**
+   * @brief find the negotiated RTX (RFC 4588) payload type for a video payload type
+   * @param externalPT The video payload type as provided to this source
+   * @return The RTX payload type whose apt is externalPT or 0 if RTX was not negotiated for it
+   */
+  unsigned int getVideoRtxPT(unsigned int externalPT);
 
   RtpMap* getCodecByExternalPayloadType(const unsigned int payload_type);
 
@@ -4,19 +4,23 @@
 
 #include <srtp2/srtp.h>
 
+#include <mutex>  // NOLINT
 #include <string>
 
 #include "SrtpChannel.h"
 #include "lib/Base64.h"
+#include "stats/Metrics.h"
 
 using erizo::Base64;
 
 namespace erizo {
 DEFINE_LOGGER(SrtpChannel, "SrtpChannel");
-bool SrtpChannel::initialized = false;
-boost::mutex SrtpChannel::sessionMutex_;
 
 constexpr int kKeyStringLength = 32;
+// Biggest authentication tag we use (AEAD) plus the SRTCP index
+constexpr int kMaxProtectionOverhead = 16 + 4;
+
+static std::once_flag srtp_init_flag;
 
 uint8_t nibble_to_hex_char(uint8_t nibble) {
   char buf[16] = { '0', '1', '2', '3', '4', '5', '6', '7',
@@ -43,12 +47,10 @@ std::string octet_string_hex_string(const void *s, int length) {
 }
 
 SrtpChannel::SrtpChannel() {
-  boost::mutex::scoped_lock lock(SrtpChannel::sessionMutex_);
-  if (SrtpChannel::initialized != true) {
+  std::call_once(srtp_init_flag, [] {
     int res = srtp_init();
     ELOG_DEBUG("Initialized SRTP library %d", res);
-    SrtpChannel::initialized = true;
-  }
+  });
 
   active_ = false;
   send_session_ = NULL;
@@ -67,10 +69,11 @@ SrtpChannel::~SrtpChannel() {
   }
 }
 
-bool SrtpChannel::setRtpParams(const std::string &sendingKey, const std::string &receivingKey) {
+bool SrtpChannel::setRtpParams(const std::string &sendingKey, const std::string &receivingKey,
+    srtp_profile_t profile) {
   ELOG_DEBUG("Configuring srtp local key %s remote key %s", sendingKey.c_str(), receivingKey.c_str());
-  if (configureSrtpSession(&send_session_,    sendingKey,   SENDING) &&
-      configureSrtpSession(&receive_session_, receivingKey, RECEIVING)) {
+  if (configureSrtpSession(&send_session_,    sendingKey,   SENDING,   profile) &&
+      configureSrtpSession(&receive_session_, receivingKey, RECEIVING, profile)) {
     active_ = true;
     return active_;
   }
@@ -81,6 +84,19 @@ bool SrtpChannel::setRtcpParams(const std::string &sendingKey, const std::string
     return 0;
 }
 
+srtp_profile_t SrtpChannel::profileFromName(const std::string &profile_name) {
+  if (profile_name == "SRTP_AES128_CM_SHA1_80") {
+    return srtp_profile_aes128_cm_sha1_80;
+  } else if (profile_name == "SRTP_AES128_CM_SHA1_32") {
+    return srtp_profile_aes128_cm_sha1_32;
+  } else if (profile_name == "SRTP_AEAD_AES_128_GCM") {
+    return srtp_profile_aead_aes_128_gcm;
+  } else if (profile_name == "SRTP_AEAD_AES_256_GCM") {
+    return srtp_profile_aead_aes_256_gcm;
+  }
+  return srtp_profile_reserved;
+}
+
 int SrtpChannel::protectRtp(char* buffer, int *len) {
   if (!active_) {
     return -1;
@@ -93,6 +109,7 @@ int SrtpChannel::protectRtp(char* buffer, int *len) {
     RtpHeader* headrtp = reinterpret_cast<RtpHeader*>(buffer);
 
     if (val != 10) {  // Do not warn about reply errors
+      WorkerMetrics::current().srtp_protect_errors.add();
       ELOG_DEBUG("Error SrtpChannel::protectRtp %u packettype %d pt %d seqnum %u",
                  val, head->packettype, headrtp->payloadtype, headrtp->seqnum);
     }
@@ -111,6 +128,7 @@ int SrtpChannel::unprotectRtp(char* buffer, int *len) {
     RtcpHeader* head = reinterpret_cast<RtcpHeader*>(buffer);
     RtpHeader* headrtp = reinterpret_cast<RtpHeader*>(buffer);
     if (val != 10) {  // Do not warn about reply errors
+      WorkerMetrics::current().srtp_unprotect_errors.add();
       ELOG_DEBUG("Error SrtpChannel::unprotectRtp %u packettype %d pt %d",
                  val, head->packettype, headrtp->payloadtype);
     }
@@ -128,6 +146,7 @@ int SrtpChannel::protectRtcp(char* buffer, int *len) {
   } else {
     RtcpHeader* head = reinterpret_cast<RtcpHeader*>(buffer);
     if (val != 10) {  // Do not warn about reply errors
+      WorkerMetrics::current().srtp_protect_errors.add();
       ELOG_DEBUG("Error SrtpChannel::protectRtcp %upackettype %d ", val, head->packettype);
     }
     return -1;
@@ -143,17 +162,61 @@ int SrtpChannel::unprotectRtcp(char* buffer, int *len) {
     return 0;
   } else {
     if (val != 10) {  // Do not warn about reply errors
+      WorkerMetrics::current().srtp_unprotect_errors.add();
       ELOG_DEBUG("Error SrtpChannel::unprotectRtcp %u", val);
     }
     return -1;
   }
 }
 
-bool SrtpChannel::configureSrtpSession(srtp_t *session, const std::string &key, enum TransmissionType type) {
+int SrtpChannel::protectPackets(const std::vector<std::shared_ptr<DataPacket>> &packets) {
+  int protected_packets = 0;
+  for (const std::shared_ptr<DataPacket> &packet : packets) {
+    if (packet->length <= 0) {
+      continue;
+    }
+    int result = -1;
+    if (packet->length + kMaxProtectionOverhead <= static_cast<int>(sizeof(packet->data))) {
+      RtcpHeader *chead = reinterpret_cast<RtcpHeader*>(packet->data);
+      result = chead->isRtcp() ? protectRtcp(packet->data, &packet->length) :
+                                 protectRtp(packet->data, &packet->length);
+    }
+    if (result < 0) {
+      packet->length = 0;
+    } else {
+      protected_packets++;
+    }
+  }
+  return protected_packets;
+}
+
+int SrtpChannel::unprotectPackets(const std::vector<std::shared_ptr<DataPacket>> &packets) {
+  int unprotected_packets = 0;
+  for (const std::shared_ptr<DataPacket> &packet : packets) {
+    if (packet->length <= 0) {
+      continue;
+    }
+    RtcpHeader *chead = reinterpret_cast<RtcpHeader*>(packet->data);
+    int result = chead->isRtcp() ? unprotectRtcp(packet->data, &packet->length) :
+                                   unprotectRtp(packet->data, &packet->length);
+    if (result < 0) {
+      packet->length = 0;
+    } else {
+      unprotected_packets++;
+    }
+  }
+  return unprotected_packets;
+}
+
+bool SrtpChannel::configureSrtpSession(srtp_t *session, const std::string &key, enum TransmissionType type,
+    srtp_profile_t profile) {
   srtp_policy_t policy;
   memset(&policy, 0, sizeof(policy));
-  srtp_crypto_policy_set_aes_cm_128_hmac_sha1_80(&policy.rtp);
-  srtp_crypto_policy_set_aes_cm_128_hmac_sha1_80(&policy.rtcp);
+  if (srtp_crypto_policy_set_from_profile_for_rtp(&policy.rtp, profile) != srtp_err_status_ok ||
+      srtp_crypto_policy_set_from_profile_for_rtcp(&policy.rtcp, profile) != srtp_err_status_ok) {
+    ELOG_ERROR("Unsupported SRTP profile %d", profile);
+    return false;
+  }
   if (type == SENDING) {
     policy.ssrc.type = ssrc_any_outbound;
   } else {
@@ -7,10 +7,12 @@
 
 #include <netinet/in.h>
 #include <srtp2/srtp.h>
-#include <boost/thread/mutex.hpp>
 
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "./MediaDefinitions.h"
 #include "rtp/RtpHeaders.h"
 #include "./logger.h"
 
@@ -22,8 +24,6 @@ namespace erizo {
  */
 class SrtpChannel {
   DECLARE_LOGGER();
-  static bool initialized;
-  static boost::mutex sessionMutex_;
 
  public:
   /**
@@ -59,13 +59,31 @@ class SrtpChannel {
    * @return 0 or an error code
    */
   int unprotectRtcp(char* buffer, int *len);
+  /**
+   * Protects a batch of RTP and RTCP packets in place
+   * Packets that can't be protected are left with length 0.
+   * @param packets The packets to protect
+   * @return The number of packets protected
+   */
+  int protectPackets(const std::vector<std::shared_ptr<DataPacket>> &packets);
+  /**
+   * Unprotects a batch of SRTP and SRTCP packets in place
+   * libsrtp has no batch API, so this still calls srtp_unprotect per packet; the batch only saves
+   * the per packet hand off between the transport and the channel.
+   * Packets that can't be unprotected are left with length 0.
+   * @param packets The packets to unprotect
+   * @return The number of packets unprotected
+   */
+  int unprotectPackets(const std::vector<std::shared_ptr<DataPacket>> &packets);
   /**
    * Sets a key pair for the RTP channel
    * @param sendingKey The key for protecting data
    * @param receivingKey The key for unprotecting data
+   * @param profile The SRTP protection profile negotiated for the keys
    * @return true if everything is ok
    */
-  bool setRtpParams(const std::string &sendingKey, const std::string &receivingKey);
+  bool setRtpParams(const std::string &sendingKey, const std::string &receivingKey,
+                    srtp_profile_t profile = srtp_profile_aes128_cm_sha1_80);
   /**
    * Sets a key pair for the RTCP channel
    * @param sendingKey The key for protecting data
@@ -73,13 +91,19 @@ class SrtpChannel {
    * @return true if everything is ok
    */
   bool setRtcpParams(const std::string &sendingKey, const std::string &receivingKey);
+  /**
+   * Translates the name of a DTLS-SRTP protection profile (RFC 5764, RFC 7714)
+   * @return The libsrtp profile, or srtp_profile_reserved if it is not supported
+   */
+  static srtp_profile_t profileFromName(const std::string &profile_name);
 
  private:
   enum TransmissionType {
     SENDING, RECEIVING
   };
 
-  bool configureSrtpSession(srtp_t *session, const std::string &key, enum TransmissionType type);
+  bool configureSrtpSession(srtp_t *session, const std::string &key, enum TransmissionType type,
+                            srtp_profile_t profile);
 
   bool active_;
   srtp_t send_session_;
@@ -14,7 +14,7 @@ namespace erizo {
 
   DEFINE_LOGGER(Stats, "Stats");
 
-  Stats::Stats() : listener_{nullptr} {
+  Stats::Stats() : listener_{nullptr}, ssrc_stats_{&root_} {
   }
 
   Stats::~Stats() {
@@ -24,6 +24,10 @@ namespace erizo {
     return root_;
   }
 
+  SsrcStatsRegistry& Stats::getSsrcStats() {
+    return ssrc_stats_;
+  }
+
   std::string Stats::getStats() {
     return root_.toString();
   }
@@ -31,10 +35,22 @@ namespace erizo {
   void Stats::setStatsListener(MediaStreamStatsListener* listener) {
     boost::mutex::scoped_lock lock(listener_mutex_);
     listener_ = listener;
+    delta_encoder_.reset();
   }
 
   void Stats::sendStats() {
     boost::mutex::scoped_lock lock(listener_mutex_);
-    if (listener_) listener_->notifyStats(getStats());
+    if (!listener_) {
+      return;
+    }
+    if (listener_->wantsStatsDelta()) {
+      std::string delta;
+      delta_encoder_.encode(&root_, &delta);
+      if (!delta.empty() && !listener_->notifyStatsDelta(delta)) {
+        delta_encoder_.reset();
+      }
+    } else {
+      listener_->notifyStats(getStats());
+    }
   }
 }  // namespace erizo
@@ -13,6 +13,8 @@
 #include "lib/Clock.h"
 
 #include "stats/StatNode.h"
+#include "stats/SsrcStatsRegistry.h"
+#include "stats/StatsDelta.h"
 
 namespace erizo {
 
@@ -26,6 +28,7 @@ class Stats : public Service {
   virtual ~Stats();
 
   StatNode& getNode();
+  SsrcStatsRegistry& getSsrcStats();
 
   std::string getStats();
 
@@ -36,6 +39,8 @@ class Stats : public Service {
   boost::mutex listener_mutex_;
   MediaStreamStatsListener* listener_;
   StatNode root_;
+  SsrcStatsRegistry ssrc_stats_;
+  StatsDeltaEncoder delta_encoder_;
 };
 
 }  // namespace erizo
@@ -1,10 +1,12 @@
 #ifndef ERIZO_SRC_ERIZO_TRANSPORT_H_
 #define ERIZO_SRC_ERIZO_TRANSPORT_H_
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <cstdio>
 #include "IceConnection.h"
+#include "lib/PacketBatchQueue.h"
 #include "thread/Worker.h"
 #include "thread/IOWorker.h"
 #include "./logger.h"
@@ -41,6 +43,14 @@ class Transport : public std::enable_shared_from_this<Transport>, public IceConn
   virtual void updateIceState(IceState state, IceConnection *conn) = 0;
   virtual void maybeRestartIce(std::string username, std::string password) = 0;
   virtual void onIceData(packetPtr packet) = 0;
+  // Packets received together from ICE, transports can override it to process all of them at once
+  virtual void onIceDataBatch(const std::vector<packetPtr> &packets) {
+    for (const packetPtr &packet : packets) {
+      if (packet->length > 0) {
+        onIceData(packet);
+      }
+    }
+  }
   virtual void onCandidate(const CandidateInfo &candidate, IceConnection *conn) = 0;
   virtual void write(char* data, int len) = 0;
   virtual void processLocalSdp(SdpInfo *localSdp_) = 0;
@@ -76,16 +86,14 @@ class Transport : public std::enable_shared_from_this<Transport>, public IceConn
   }
 
   void onPacketReceived(packetPtr packet) {
+    // Packets received while the worker has not processed the previous ones go in the same task
+    if (!received_packets_.push(std::move(packet))) {
+      return;
+    }
     std::weak_ptr<Transport> weak_transport = Transport::shared_from_this();
-    worker_->task([weak_transport, packet]() {
+    worker_->task([weak_transport]() {
       if (auto this_ptr = weak_transport.lock()) {
-        if (packet->length > 0) {
-          this_ptr->onIceData(packet);
-        }
-        if (packet->length == -1) {
-          this_ptr->running_ = false;
-          return;
-        }
+        this_ptr->processReceivedPackets();
       }
     });
   }
@@ -101,7 +109,23 @@ class Transport : public std::enable_shared_from_this<Transport>, public IceConn
   }
 
  private:
+  void processReceivedPackets() {
+    received_packets_.takeAll(&processing_packets_);
+    // A packet with length -1 signals the end of the connection, nothing after it is processed
+    auto end_of_connection = std::find_if(processing_packets_.begin(), processing_packets_.end(),
+      [](const packetPtr &packet) { return packet->length == -1; });
+    bool finished = end_of_connection != processing_packets_.end();
+    processing_packets_.erase(end_of_connection, processing_packets_.end());
+    onIceDataBatch(processing_packets_);
+    if (finished) {
+      running_ = false;
+    }
+    processing_packets_.clear();
+  }
+
   std::weak_ptr<TransportListener> transport_listener_;
+  PacketBatchQueue received_packets_;
+  std::vector<packetPtr> processing_packets_;
 
  protected:
   std::string connection_id_;
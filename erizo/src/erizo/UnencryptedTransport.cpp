@@ -73,20 +73,12 @@ void UnencryptedTransport::onIceData(packetPtr packet) {
   if (!running_) {
     return;
   }
-  int len = packet->length;
-  char *data = packet->data;
-  unsigned int component_id = packet->comp;
-
-  int length = len;
   if (this->getTransportState() == TRANSPORT_READY) {
-    std::shared_ptr<DataPacket> unprotect_packet = std::make_shared<DataPacket>(component_id,
-      data, len, VIDEO_PACKET, packet->received_time_ms);
-
-    if (length <= 0) {
+    if (packet->length <= 0) {
       return;
     }
     if (auto listener = getTransportListener().lock()) {
-      listener->onTransportData(unprotect_packet, this);
+      listener->onTransportData(packet, this);
     }
   }
 }
@@ -20,7 +20,9 @@
 #include "rtp/RtpHeaders.h"
 #include "rtp/BandwidthEstimationHandler.h"
 #include "rtp/RtpPaddingManagerHandler.h"
+#include "rtp/PacerHandler.h"
 #include "rtp/RtpUtils.h"
+#include "lib/PacketPool.h"
 
 namespace erizo {
 DEFINE_LOGGER(WebRtcConnection, "WebRtcConnection");
@@ -40,6 +42,8 @@ WebRtcConnection::WebRtcConnection(std::shared_ptr<Worker> worker, std::shared_p
     audio_muted_{false}, video_muted_{false}, first_remote_sdp_processed_{false},
     enable_connection_quality_check_{enable_connection_quality_check}, encrypt_transport_{encrypt_transport},
     connection_target_bw_{0},
+    rtt_ms_{0},
+    sender_bitrate_target_{0},
     pipeline_{Pipeline::create()},
     pipeline_initialized_{false}, latest_mid_{0} {
   stats_ = std::make_shared<Stats>();
@@ -133,6 +137,7 @@ void WebRtcConnection::initializePipeline() {
 
   pipeline_->addFront(std::make_shared<ConnectionPacketReader>(this));
   pipeline_->addFront(std::make_shared<BandwidthEstimationHandler>());
+  pipeline_->addFront(std::make_shared<PacerHandler>(worker_->getClock()));
   pipeline_->addFront(std::make_shared<SenderBandwidthEstimationHandler>());
 
   pipeline_->addFront(std::make_shared<RtpPaddingManagerHandler>());
@@ -243,6 +248,10 @@ bool WebRtcConnection::createOfferSync(bool bundle) {
                 toLog(), media_stream->getId(), media_stream->getAudioSinkSSRC());
     if (!video_ssrc_list.empty()) {
       local_sdp_->video_ssrc_map[media_stream->getLabel()] = video_ssrc_list;
+      if (media_stream->getVideoSinkRtxSSRC() != 0) {
+        local_sdp_->video_rtx_ssrc_map[media_stream->getLabel()] = {
+          {media_stream->getVideoSinkSSRC(), media_stream->getVideoSinkRtxSSRC()}};
+      }
     }
     if (media_stream->getAudioSinkSSRC() != kDefaultAudioSinkSSRC && media_stream->getAudioSinkSSRC() != 0) {
       local_sdp_->audio_ssrc_map[media_stream->getLabel()] = media_stream->getAudioSinkSSRC();
@@ -456,6 +465,7 @@ boost::future<void> WebRtcConnection::removeMediaStream(const std::string& strea
     if (video_it != connection->local_sdp_->video_ssrc_map.end()) {
       connection->local_sdp_->video_ssrc_map.erase(video_it);
     }
+    connection->local_sdp_->video_rtx_ssrc_map.erase(stream->getLabel());
     auto audio_it = connection->local_sdp_->audio_ssrc_map.find(stream->getLabel());
     if (audio_it != connection->local_sdp_->audio_ssrc_map.end()) {
       connection->local_sdp_->audio_ssrc_map.erase(audio_it);
@@ -629,6 +639,10 @@ std::shared_ptr<SdpInfo> WebRtcConnection::getLocalSdpInfoSync() {
                toLog(), media_stream->getId(), media_stream->getAudioSinkSSRC());
     if (!video_ssrc_list.empty()) {
       local_sdp_->video_ssrc_map[media_stream->getLabel()] = video_ssrc_list;
+      if (media_stream->getVideoSinkRtxSSRC() != 0) {
+        local_sdp_->video_rtx_ssrc_map[media_stream->getLabel()] = {
+          {media_stream->getVideoSinkSSRC(), media_stream->getVideoSinkRtxSSRC()}};
+      }
     }
     if (media_stream->getAudioSinkSSRC() != kDefaultAudioSinkSSRC && media_stream->getAudioSinkSSRC() != 0) {
       local_sdp_->audio_ssrc_map[media_stream->getLabel()] = media_stream->getAudioSinkSSRC();
@@ -793,6 +807,7 @@ boost::future<void> WebRtcConnection::processRemoteSdp() {
 
   local_sdp_->setOfferSdp(remote_sdp_);
   extension_processor_.setSdpInfo(local_sdp_);
+  extension_processor_.setNegotiatedMids(remote_sdp_->medias);
   notifyUpdateToHandlers();
   local_sdp_->updateSupportedExtensionMap(extension_processor_.getSupportedExtensionMap());
 
@@ -1010,7 +1025,7 @@ void WebRtcConnection::onRtcpFromTransport(std::shared_ptr<DataPacket> packet, T
       onREMBFromTransport(chead, transport);
       return;
     }
-    std::shared_ptr<DataPacket> rtcp = std::make_shared<DataPacket>(*packet);
+    std::shared_ptr<DataPacket> rtcp = PacketPool::clone(*packet);
     rtcp->length = (ntohs(chead->length) + 1) * 4;
     std::memcpy(rtcp->data, chead, rtcp->length);
     forEachMediaStream([rtcp, transport, ssrc] (const std::shared_ptr<MediaStream> &media_stream) {
@@ -1070,12 +1085,12 @@ void WebRtcConnection::read(std::shared_ptr<DataPacket> packet) {
     RtpHeader *head = reinterpret_cast<RtpHeader*> (buf);
     uint32_t ssrc = head->getSSRC();
     extension_processor_.processRtpExtensions(packet);
-    std::string mid = packet->mid;
+    StringId mid = packet->mid;
     extension_processor_.removeMidAndRidExtensions(packet);
     bool sent = false;
-    forEachMediaStream([packet, transport, ssrc, &mid, &sent] (const std::shared_ptr<MediaStream> &media_stream) {
-      if (!mid.empty()) {
-        if (media_stream->getVideoMid() == mid || media_stream->getAudioMid() == mid) {
+    forEachMediaStream([packet, transport, ssrc, mid, &sent] (const std::shared_ptr<MediaStream> &media_stream) {
+      if (mid != StringInterner::kEmptyId) {
+        if (media_stream->getVideoMidId() == mid || media_stream->getAudioMidId() == mid) {
           sent = true;
           media_stream->onTransportData(packet, transport);
         }
@@ -1085,8 +1100,8 @@ void WebRtcConnection::read(std::shared_ptr<DataPacket> packet) {
       }
     });
     if (!sent) {
-      ELOG_DEBUG("Packet does not belong to a known stream, ssrc: %u, length: %d, mid: %s, rid: %s",
-        ssrc, packet->length, packet->mid, packet->rid);
+      ELOG_DEBUG("Packet does not belong to a known stream, ssrc: %u, length: %d, mid: %s, rid: %d",
+        ssrc, packet->length, packet->getMidName().c_str(), packet->rid);
     }
   }
 }
@@ -1099,6 +1114,22 @@ void WebRtcConnection::maybeNotifyWebRtcConnectionEvent(const WebRTCEvent& event
   conn_event_listener_->notifyEvent(event, message);
 }
 
+void WebRtcConnection::enableHandler(const std::string &name) {
+  asyncTask([name] (std::shared_ptr<WebRtcConnection> connection) {
+    if (connection->pipeline_) {
+      connection->pipeline_->enable(name);
+    }
+  });
+}
+
+void WebRtcConnection::disableHandler(const std::string &name) {
+  asyncTask([name] (std::shared_ptr<WebRtcConnection> connection) {
+    if (connection->pipeline_) {
+      connection->pipeline_->disable(name);
+    }
+  });
+}
+
 boost::future<void> WebRtcConnection::asyncTask(
     std::function<void(std::shared_ptr<WebRtcConnection>)> f) {
   auto task_promise = std::make_shared<boost::promise<void>>();
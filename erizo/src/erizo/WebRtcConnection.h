@@ -142,6 +142,9 @@ class WebRtcConnection: public TransportListener, public LogContext, public Hand
 
   void send(std::shared_ptr<DataPacket> packet);
 
+  void enableHandler(const std::string &name);
+  void disableHandler(const std::string &name);
+
   boost::future<void> asyncTask(std::function<void(std::shared_ptr<WebRtcConnection>)> f);
 
   bool isAudioMuted() { return audio_muted_; }
@@ -170,6 +173,12 @@ class WebRtcConnection: public TransportListener, public LogContext, public Hand
   void setConnectionTargetBw(uint32_t target_bw) {
     connection_target_bw_ = target_bw;
     }
+  // Round trip time measured from the receiver reports of the subscribers, 0 until there is one
+  uint32_t getRtt() { return rtt_ms_.load(); }
+  void setRtt(uint32_t rtt_ms) { rtt_ms_ = rtt_ms; }
+  // Target of the sender side bandwidth estimation, 0 until there is one
+  uint32_t getSenderBitrateTarget() { return sender_bitrate_target_.load(); }
+  void setSenderBitrateTarget(uint32_t target_bitrate) { sender_bitrate_target_ = target_bitrate; }
 
   inline std::string toLog() {
     return "id: " + connection_id_ + ", distributor: "
@@ -246,6 +255,8 @@ class WebRtcConnection: public TransportListener, public LogContext, public Hand
   bool enable_connection_quality_check_;
   bool encrypt_transport_;
   std::atomic <uint32_t> connection_target_bw_;
+  std::atomic <uint32_t> rtt_ms_;
+  std::atomic <uint32_t> sender_bitrate_target_;
   Pipeline::Ptr pipeline_;
   bool pipeline_initialized_;
   std::shared_ptr<HandlerManager> handler_manager_;
@@ -25,20 +25,31 @@ extern "C" {
 #include "lib/Base64.h"
 #include "./DtlsSocket.h"
 
+using dtls::DtlsIdentity;
 using dtls::DtlsSocketContext;
 using dtls::DtlsSocket;
 using std::memcpy;
 using erizo::Base64;
 
+#ifdef SRTP_AEAD_AES_128_GCM
+const char* DtlsSocketContext::DefaultSrtpProfile =
+    "SRTP_AEAD_AES_128_GCM:SRTP_AEAD_AES_256_GCM:SRTP_AES128_CM_SHA1_80";
+#else
+// OpenSSL < 1.1.0 doesn't know the AES-GCM profiles
 const char* DtlsSocketContext::DefaultSrtpProfile = "SRTP_AES128_CM_SHA1_80";
+#endif
 
-X509 *DtlsSocketContext::mCert = nullptr;
-EVP_PKEY *DtlsSocketContext::privkey = nullptr;
+std::mutex DtlsSocketContext::identity_mutex_;
+std::shared_ptr<DtlsIdentity> DtlsSocketContext::current_identity_;
+std::shared_ptr<DtlsIdentity> DtlsSocketContext::next_identity_;
+std::chrono::steady_clock::time_point DtlsSocketContext::current_since_;
+std::shared_ptr<erizo::ThreadPool> DtlsSocketContext::crypto_pool_;
 
 static const int KEY_LENGTH = 1024;
 
 static std::mutex* array_mutex;
 
+DEFINE_LOGGER(DtlsIdentity, "dtls.DtlsIdentity");
 DEFINE_LOGGER(DtlsSocketContext, "dtls.DtlsSocketContext");
 log4cxx::LoggerPtr sslLogger(log4cxx::Logger::getLogger("dtls.SSL"));
 #if OPENSSL_VERSION_NUMBER < 0x10100000
@@ -202,12 +213,14 @@ int createCert(const std::string& pAor, int expireDays, int keyLen, X509*& outCe
 
   int ret = EVP_PKEY_set1_RSA(privkey, rsa);
   assert(ret);
+  RSA_free(rsa);
+  BN_free(exponent);
 
   X509* cert = X509_new();
   assert(cert);
 
   X509_NAME* subject = X509_NAME_new();
-  X509_EXTENSION* ext = X509_EXTENSION_new();
+  X509_EXTENSION* ext;
 
   // set version to X509v3 (starts from 0)
   X509_set_version(cert, 2L);
@@ -230,6 +243,7 @@ int createCert(const std::string& pAor, int expireDays, int keyLen, X509*& outCe
   assert(ret);
   ret = X509_set_subject_name(cert, subject);
   assert(ret);
+  X509_NAME_free(subject);
 
   const long duration = 60 * 60 * 24 * expireDays;  // NOLINT
   X509_gmtime_adj(X509_get_notBefore(cert), 0);
@@ -261,39 +275,65 @@ int createCert(const std::string& pAor, int expireDays, int keyLen, X509*& outCe
     return ret;
   }
 
-  // memory is only valid for duration of callback; must be copied if queueing
-  // is required
-  DtlsSocketContext::DtlsSocketContext() {
-    started = false;
-
-    ELOG_DEBUG("Creating Dtls factory, Openssl v %s", OPENSSL_VERSION_TEXT);
-
-    mContext = SSL_CTX_new(DTLS_method());
-    assert(mContext);
+  DtlsIdentity::DtlsIdentity(X509 *cert, EVP_PKEY *key) : cert_{cert}, key_{key} {
+    context_ = SSL_CTX_new(DTLS_method());
+    assert(context_);
 
-    int r = SSL_CTX_use_certificate(mContext, mCert);
-    assert(r == 1);
+    int r = SSL_CTX_use_certificate(context_, cert_);
+    if (r != 1) {
+      ELOG_WARN("message: could not use the certificate, error: %d", r);
+    }
 
-    r = SSL_CTX_use_PrivateKey(mContext, privkey);
-    assert(r == 1);
+    r = SSL_CTX_use_PrivateKey(context_, key_);
+    if (r != 1) {
+      ELOG_WARN("message: could not use the private key, error: %d", r);
+    }
 
-    SSL_CTX_set_cipher_list(mContext, "ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+    SSL_CTX_set_cipher_list(context_, "ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
 
-    SSL_CTX_set_info_callback(mContext, SSLInfoCallback);
+    SSL_CTX_set_info_callback(context_, SSLInfoCallback);
 
-    SSL_CTX_set_verify(mContext, SSL_VERIFY_PEER |SSL_VERIFY_FAIL_IF_NO_PEER_CERT,
+    SSL_CTX_set_verify(context_, SSL_VERIFY_PEER |SSL_VERIFY_FAIL_IF_NO_PEER_CERT,
       SSLVerifyCallback);
 
-    SSL_CTX_set_options(mContext, SSL_OP_NO_QUERY_MTU);
-      // SSL_CTX_set_session_cache_mode(mContext, SSL_SESS_CACHE_OFF);
+    SSL_CTX_set_options(context_, SSL_OP_NO_QUERY_MTU);
+    // The context is shared by every session and DTLS-SRTP peers don't resume them, so don't cache them
+    SSL_CTX_set_session_cache_mode(context_, SSL_SESS_CACHE_OFF);
       // SSL_CTX_set_options(mContext, SSL_OP_NO_TICKET);
       // Set SRTP profiles
-    r = SSL_CTX_set_tlsext_use_srtp(mContext, DefaultSrtpProfile);
+    r = SSL_CTX_set_tlsext_use_srtp(context_, DtlsSocketContext::DefaultSrtpProfile);
     assert(r == 0);
 
-    SSL_CTX_set_verify_depth(mContext, 2);
-    SSL_CTX_set_read_ahead(mContext, 1);
+    SSL_CTX_set_verify_depth(context_, 2);
+    SSL_CTX_set_read_ahead(context_, 1);
+
+    char fingerprint[100] = {};
+    DtlsSocket::computeFingerprint(cert_, fingerprint);
+    fingerprint_ = fingerprint;
+    ELOG_DEBUG("message: DtlsIdentity created, fingerprint: %s", fingerprint_.c_str());
+  }
+
+  DtlsIdentity::~DtlsIdentity() {
+    SSL_CTX_free(context_);
+    X509_free(cert_);
+    EVP_PKEY_free(key_);
+  }
+
+  std::shared_ptr<DtlsIdentity> DtlsIdentity::generate() {
+    X509 *cert = nullptr;
+    EVP_PKEY *key = nullptr;
+    createCert("sip:licode@lynckia.com", 365, 1024, cert, key);
+    return std::make_shared<DtlsIdentity>(cert, key);
+  }
 
+  // memory is only valid for duration of callback; must be copied if queueing
+  // is required
+  DtlsSocketContext::DtlsSocketContext(std::shared_ptr<DtlsIdentity> identity)
+      : started{false}, mSocket{nullptr}, receiver{nullptr}, identity_{identity} {
+    ELOG_DEBUG("Creating Dtls factory, Openssl v %s", OPENSSL_VERSION_TEXT);
+    assert(identity_);
+    // Building an SSL_CTX is expensive, every context of the same identity shares it
+    mContext = identity_->getSSLContext();
     ELOG_DEBUG("DtlsSocketContext created");
   }
 
@@ -301,7 +341,6 @@ int createCert(const std::string& pAor, int expireDays, int keyLen, X509*& outCe
       mSocket->close();
       delete mSocket;
       mSocket = nullptr;
-      SSL_CTX_free(mContext);
     }
 
     void DtlsSocketContext::close() {
@@ -309,27 +348,104 @@ int createCert(const std::string& pAor, int expireDays, int keyLen, X509*& outCe
     }
 
     void DtlsSocketContext::Init() {
+      std::unique_lock<std::mutex> lock(identity_mutex_);
 #if OPENSSL_VERSION_NUMBER < 0x10100000
       ssl_thread_setup();
-      if (DtlsSocketContext::mCert == nullptr) {
+      if (current_identity_ == nullptr) {
         OpenSSL_add_all_algorithms();
         SSL_library_init();
         SSL_load_error_strings();
         ERR_load_crypto_strings();
-        createCert("sip:licode@lynckia.com", 365, 1024, DtlsSocketContext::mCert, DtlsSocketContext::privkey);
       }
 #else
-      if (DtlsSocketContext::mCert == nullptr) {
+      if (current_identity_ == nullptr) {
         OPENSSL_init_ssl(0, NULL);
-        createCert("sip:licode@lynckia.com", 365, 1024, DtlsSocketContext::mCert, DtlsSocketContext::privkey);
       }
 #endif
+      if (current_identity_ == nullptr) {
+        current_identity_ = DtlsIdentity::generate();
+        current_since_ = std::chrono::steady_clock::now();
+      }
+      if (crypto_pool_ == nullptr) {
+        crypto_pool_ = std::make_shared<erizo::ThreadPool>(kNumCryptoWorkers);
+        crypto_pool_->start();
+      }
+      lock.unlock();
+      pregenerateIdentity();
     }
 
     void DtlsSocketContext::Destroy() {
+      std::shared_ptr<erizo::ThreadPool> crypto_pool;
+      {
+        std::lock_guard<std::mutex> guard(identity_mutex_);
+        crypto_pool.swap(crypto_pool_);
+      }
+      if (crypto_pool) {
+        crypto_pool->close();
+      }
       ssl_thread_cleanup();
     }
 
+    std::shared_ptr<DtlsIdentity> DtlsSocketContext::getCurrentIdentity() {
+      std::shared_ptr<DtlsIdentity> identity;
+      bool rotated = false;
+      {
+        std::lock_guard<std::mutex> guard(identity_mutex_);
+        // We only rotate to a pre-generated identity, generating one here would block the caller
+        if (next_identity_ && std::chrono::steady_clock::now() - current_since_ >= kIdentityRotationPeriod) {
+          current_identity_ = std::move(next_identity_);
+          next_identity_.reset();
+          current_since_ = std::chrono::steady_clock::now();
+          rotated = true;
+        }
+        identity = current_identity_;
+      }
+      if (rotated) {
+        ELOG_INFO("message: Rotated DTLS certificate, fingerprint: %s", identity->getFingerprint().c_str());
+        pregenerateIdentity();
+      }
+      return identity;
+    }
+
+    void DtlsSocketContext::rotateIdentity() {
+      std::shared_ptr<DtlsIdentity> identity;
+      {
+        std::lock_guard<std::mutex> guard(identity_mutex_);
+        identity.swap(next_identity_);
+      }
+      if (!identity) {
+        identity = DtlsIdentity::generate();
+      }
+      {
+        std::lock_guard<std::mutex> guard(identity_mutex_);
+        current_identity_ = identity;
+        current_since_ = std::chrono::steady_clock::now();
+      }
+      ELOG_INFO("message: Rotated DTLS certificate, fingerprint: %s", identity->getFingerprint().c_str());
+      pregenerateIdentity();
+    }
+
+    // Keeps the next identity ready, so rotating doesn't have to wait for a new key pair
+    void DtlsSocketContext::pregenerateIdentity() {
+      std::shared_ptr<erizo::Worker> worker = getCryptoWorker();
+      if (!worker) {
+        return;
+      }
+      worker->task([] {
+        std::shared_ptr<DtlsIdentity> identity = DtlsIdentity::generate();
+        std::lock_guard<std::mutex> guard(identity_mutex_);
+        next_identity_ = identity;
+      });
+    }
+
+    std::shared_ptr<erizo::Worker> DtlsSocketContext::getCryptoWorker() {
+      std::lock_guard<std::mutex> guard(identity_mutex_);
+      if (!crypto_pool_) {
+        return std::shared_ptr<erizo::Worker>();
+      }
+      return crypto_pool_->getLessUsedWorker();
+    }
+
     DtlsSocket* DtlsSocketContext::createClient() {
       return new DtlsSocket(this, DtlsSocket::Client);
     }
@@ -340,17 +456,16 @@ int createCert(const std::string& pAor, int expireDays, int keyLen, X509*& outCe
     }
 
     void DtlsSocketContext::getMyCertFingerprint(char *fingerprint) {
-      DtlsSocket::computeFingerprint(DtlsSocketContext::mCert, fingerprint);
+      const std::string &identity_fingerprint = identity_->getFingerprint();
+      memcpy(fingerprint, identity_fingerprint.c_str(), identity_fingerprint.size() + 1);
     }
 
     void DtlsSocketContext::setSrtpProfiles(const char *str) {
-      int r = SSL_CTX_set_tlsext_use_srtp(mContext, str);
-      assert(r == 0);
+      mSocket->setSrtpProfiles(str);
     }
 
     void DtlsSocketContext::setCipherSuites(const char *str) {
-      int r = SSL_CTX_set_cipher_list(mContext, str);
-      assert(r == 1);
+      mSocket->setCipherSuites(str);
     }
 
     SSL_CTX* DtlsSocketContext::getSSLContext() {
@@ -372,9 +487,7 @@ int createCert(const std::string& pAor, int expireDays, int keyLen, X509*& outCe
 
 
     std::string DtlsSocketContext::getFingerprint() const {
-      char fprint[100] = {};
-      mSocket->getMyCertFingerprint(fprint);
-      return std::string(fprint);
+      return identity_->getFingerprint();
     }
 
     void DtlsSocketContext::start() {
@@ -450,7 +563,10 @@ int createCert(const std::string& pAor, int expireDays, int keyLen, X509*& outCe
           ELOG_DEBUG("SRTP Extension negotiated profile=%s", srtp_profile->name);
         }
 
-        if (receiver != NULL) {
+        if (srtp_profile == NULL) {
+          // There are no keys to protect media with, the transport can't become ready
+          handshakeFailed("No SRTP profile negotiated");
+        } else if (receiver != NULL) {
           receiver->onHandshakeCompleted(this, client_key_str, server_key_str, srtp_profile->name);
         }
       } else {
@@ -460,5 +576,7 @@ int createCert(const std::string& pAor, int expireDays, int keyLen, X509*& outCe
 
     void DtlsSocketContext::handshakeFailed(const char *err) {
       ELOG_WARN("DTLS Handshake Failure %s", err);
-      receiver->onHandshakeFailed(this, std::string(err));
+      if (receiver != NULL) {
+        receiver->onHandshakeFailed(this, std::string(err));
+      }
     }
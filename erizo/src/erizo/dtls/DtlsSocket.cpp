@@ -193,31 +193,55 @@ void DtlsSocket::getMyCertFingerprint(char *fingerprint) {
   mSocketContext->getMyCertFingerprint(fingerprint);
 }
 
+void DtlsSocket::setSrtpProfiles(const char *str) {
+  int r = SSL_set_tlsext_use_srtp(mSsl, str);
+  assert(r == 0);
+}
+
+void DtlsSocket::setCipherSuites(const char *str) {
+  int r = SSL_set_cipher_list(mSsl, str);
+  assert(r == 1);
+}
+
 SrtpSessionKeys* DtlsSocket::getSrtpSessionKeys() {
   // TODO(pedro): probably an exception candidate
   assert(mHandshakeCompleted);
 
   SrtpSessionKeys* keys = new SrtpSessionKeys();
 
-  unsigned char material[SRTP_MASTER_KEY_LEN << 1];
-  if (!SSL_export_keying_material(mSsl, material, sizeof(material), "EXTRACTOR-dtls_srtp", 19, NULL, 0, 0)) {
+  // libsrtp profiles use the DTLS-SRTP ids, so it tells us the key and salt lengths of the negotiated one
+  SRTP_PROTECTION_PROFILE *srtp_profile = SSL_get_selected_srtp_profile(mSsl);
+  if (srtp_profile == NULL) {
+    return keys;
+  }
+  srtp_profile_t profile = static_cast<srtp_profile_t>(srtp_profile->id);
+  int key_len = srtp_profile_get_master_key_length(profile);
+  int salt_len = srtp_profile_get_master_salt_length(profile);
+  if (key_len <= 0 || key_len > SRTP_MAX_MASTER_KEY_KEY_LEN || salt_len <= 0 ||
+      salt_len > SRTP_MAX_MASTER_KEY_SALT_LEN) {
+    ELOG_WARN("message: Unsupported SRTP profile, profile: %s", srtp_profile->name);
+    return keys;
+  }
+
+  unsigned char material[(SRTP_MAX_MASTER_KEY_KEY_LEN + SRTP_MAX_MASTER_KEY_SALT_LEN) << 1];
+  if (!SSL_export_keying_material(mSsl, material, (key_len + salt_len) << 1, "EXTRACTOR-dtls_srtp", 19, NULL, 0, 0)) {
     return keys;
   }
 
   size_t offset = 0;
 
-  memcpy(keys->clientMasterKey, &material[offset], SRTP_MASTER_KEY_KEY_LEN);
-  offset += SRTP_MASTER_KEY_KEY_LEN;
-  memcpy(keys->serverMasterKey, &material[offset], SRTP_MASTER_KEY_KEY_LEN);
-  offset += SRTP_MASTER_KEY_KEY_LEN;
-  memcpy(keys->clientMasterSalt, &material[offset], SRTP_MASTER_KEY_SALT_LEN);
-  offset += SRTP_MASTER_KEY_SALT_LEN;
-  memcpy(keys->serverMasterSalt, &material[offset], SRTP_MASTER_KEY_SALT_LEN);
-  offset += SRTP_MASTER_KEY_SALT_LEN;
-  keys->clientMasterKeyLen = SRTP_MASTER_KEY_KEY_LEN;
-  keys->serverMasterKeyLen = SRTP_MASTER_KEY_KEY_LEN;
-  keys->clientMasterSaltLen = SRTP_MASTER_KEY_SALT_LEN;
-  keys->serverMasterSaltLen = SRTP_MASTER_KEY_SALT_LEN;
+  memcpy(keys->clientMasterKey, &material[offset], key_len);
+  offset += key_len;
+  memcpy(keys->serverMasterKey, &material[offset], key_len);
+  offset += key_len;
+  memcpy(keys->clientMasterSalt, &material[offset], salt_len);
+  offset += salt_len;
+  memcpy(keys->serverMasterSalt, &material[offset], salt_len);
+  offset += salt_len;
+  keys->clientMasterKeyLen = key_len;
+  keys->serverMasterKeyLen = key_len;
+  keys->clientMasterSaltLen = salt_len;
+  keys->serverMasterSaltLen = salt_len;
 
   return keys;
 }
@@ -277,8 +301,7 @@ void DtlsSocket::handleTimeout() {
 void DtlsSocket::createSrtpSessionPolicies(srtp_policy_t& outboundPolicy, srtp_policy_t& inboundPolicy) {
   assert(mHandshakeCompleted);
 
-  /* we assume that the default profile is in effect, for now */
-  srtp_profile_t profile = srtp_profile_aes128_cm_sha1_80;
+  srtp_profile_t profile = static_cast<srtp_profile_t>(getSrtpProfile()->id);
   int key_len = srtp_profile_get_master_key_length(profile);
   int salt_len = srtp_profile_get_master_salt_length(profile);
 
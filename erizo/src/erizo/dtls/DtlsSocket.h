@@ -14,14 +14,19 @@ extern "C" {
 #include <boost/thread/mutex.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 
 #include "dtls/bf_dwrap.h"
 #include "../logger.h"
+#include "thread/ThreadPool.h"
 
-const int SRTP_MASTER_KEY_KEY_LEN = 16;
-const int SRTP_MASTER_KEY_SALT_LEN = 14;
+// Large enough for every profile we offer, the actual lengths depend on the negotiated profile
+const int SRTP_MAX_MASTER_KEY_KEY_LEN = 32;
+const int SRTP_MAX_MASTER_KEY_SALT_LEN = 14;
 static const int DTLS_MTU = 1472;
 
 namespace dtls {
@@ -30,13 +35,13 @@ class DtlsSocketContext;
 class SrtpSessionKeys {
  public:
   SrtpSessionKeys() {
-    clientMasterKey = new unsigned char[SRTP_MASTER_KEY_KEY_LEN];
+    clientMasterKey = new unsigned char[SRTP_MAX_MASTER_KEY_KEY_LEN];
     clientMasterKeyLen = 0;
-    clientMasterSalt = new unsigned char[SRTP_MASTER_KEY_SALT_LEN];
+    clientMasterSalt = new unsigned char[SRTP_MAX_MASTER_KEY_SALT_LEN];
     clientMasterSaltLen = 0;
-    serverMasterKey = new unsigned char[SRTP_MASTER_KEY_KEY_LEN];
+    serverMasterKey = new unsigned char[SRTP_MAX_MASTER_KEY_KEY_LEN];
     serverMasterKeyLen = 0;
-    serverMasterSalt = new unsigned char[SRTP_MASTER_KEY_SALT_LEN];
+    serverMasterSalt = new unsigned char[SRTP_MAX_MASTER_KEY_SALT_LEN];
     serverMasterSaltLen = 0;
   }
   ~SrtpSessionKeys() {
@@ -88,6 +93,10 @@ class DtlsSocket {
   // Retrieves the finger print of our local certificate, same as getMyCertFingerprint
   void getMyCertFingerprint(char *fingerprint);
 
+  // Change the SRTP profiles and cipher suites offered by this socket only, the SSL_CTX is shared
+  void setSrtpProfiles(const char *policyStr);
+  void setCipherSuites(const char *cipherSuites);
+
   // For client sockets only - causes a client handshake to start (doHandshakeIteration)
   void startClient();
 
@@ -136,14 +145,40 @@ class DtlsReceiver {
   virtual void onHandshakeFailed(DtlsSocketContext *ctx, const std::string& error) = 0;
 };
 
+// A self signed certificate, its private key and the SSL_CTX that uses them. Every DtlsSocketContext
+// keeps the identity it was created with, so rotating the current one doesn't change the fingerprint of
+// sessions that already signaled it.
+class DtlsIdentity {
+  DECLARE_LOGGER();
+
+ public:
+  DtlsIdentity(X509 *cert, EVP_PKEY *key);
+  ~DtlsIdentity();
+
+  static std::shared_ptr<DtlsIdentity> generate();
+
+  X509* getCertificate() const { return cert_; }
+  SSL_CTX* getSSLContext() const { return context_; }
+  const std::string& getFingerprint() const { return fingerprint_; }
+
+ private:
+  X509 *cert_;
+  EVP_PKEY *key_;
+  SSL_CTX *context_;
+  std::string fingerprint_;
+};
+
 class DtlsSocketContext {
   DECLARE_LOGGER();
 
  public:
-  bool started;
+  static constexpr unsigned int kNumCryptoWorkers = 2;
+  static constexpr std::chrono::hours kIdentityRotationPeriod{24 * 7};
+
+  std::atomic<bool> started;
   // memory is only valid for duration of callback; must be copied if queueing
   // is required
-  DtlsSocketContext();
+  explicit DtlsSocketContext(std::shared_ptr<DtlsIdentity> identity = getCurrentIdentity());
   virtual ~DtlsSocketContext();
 
   void close();
@@ -181,23 +216,39 @@ class DtlsSocketContext {
   void setCipherSuites(const char *cipherSuites);
 
   SSL_CTX* getSSLContext();
+  std::shared_ptr<DtlsIdentity> getIdentity() const { return identity_; }
 
   // Examines the first few bits of a packet to determine its type: rtp, dtls, stun or unknown
   static PacketType demuxPacket(const unsigned char *buf, unsigned int len);
 
-  static X509 *mCert;
-  static EVP_PKEY *privkey;
-
+  // Generates the first identity and starts the crypto workers
   static void Init();
   static void Destroy();
 
+  // The identity new contexts use. It is replaced by a pre-generated one every kIdentityRotationPeriod.
+  static std::shared_ptr<DtlsIdentity> getCurrentIdentity();
+  // Replaces the current identity right away, without affecting contexts that are already created
+  static void rotateIdentity();
+  // Handshakes (and every other use of a context) must run in one of these workers
+  static std::shared_ptr<erizo::Worker> getCryptoWorker();
+
  protected:
   DtlsSocket *mSocket;
   DtlsReceiver *receiver;
 
  private:
-  // Creates a DTLS SSL Context and enables srtp extension, also sets the private and public key cert
+  static void pregenerateIdentity();
+
+ private:
+  std::shared_ptr<DtlsIdentity> identity_;
+  // The SSL_CTX of our identity, with srtp extension and the private and public key cert
   SSL_CTX* mContext;
+
+  static std::mutex identity_mutex_;
+  static std::shared_ptr<DtlsIdentity> current_identity_;
+  static std::shared_ptr<DtlsIdentity> next_identity_;
+  static std::chrono::steady_clock::time_point current_since_;
+  static std::shared_ptr<erizo::ThreadPool> crypto_pool_;
 };
 }  // namespace dtls
 
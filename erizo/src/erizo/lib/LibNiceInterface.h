@@ -41,6 +41,9 @@ class LibNiceInterface {
   virtual GSList* NiceAgentGetLocalCandidates(NiceAgent* agent, unsigned int stream_id, unsigned int component_id) = 0;
   virtual int NiceAgentSend(NiceAgent* agent, unsigned int stream_id, unsigned int component_id,
       unsigned int len, const char* buf) = 0;
+  // Sends n_messages datagrams in a single call, returns how many were sent or -1
+  virtual int NiceAgentSendMessages(NiceAgent* agent, unsigned int stream_id, unsigned int component_id,
+      const char* const* bufs, const unsigned int* lens, unsigned int n_messages) = 0;
 };
 
 
@@ -69,6 +72,8 @@ class LibNiceInterfaceImpl: public LibNiceInterface {
   GSList* NiceAgentGetLocalCandidates(NiceAgent* agent, unsigned int stream_id, unsigned int component_id);
   int NiceAgentSend(NiceAgent* agent, unsigned int stream_id, unsigned int component_id,
       unsigned int len, const char* buf);
+  int NiceAgentSendMessages(NiceAgent* agent, unsigned int stream_id, unsigned int component_id,
+      const char* const* bufs, const unsigned int* lens, unsigned int n_messages);
 };
 
 }  // namespace erizo
@@ -6,6 +6,8 @@
 #include <nice/nice.h>
 #include <nice/interfaces.h>
 
+#include <vector>
+
 namespace erizo {
 
   NiceAgent* LibNiceInterfaceImpl::NiceAgentNew(GMainContext* context, bool ice_lite) {
@@ -69,5 +71,18 @@ namespace erizo {
       unsigned int len, const char* buf) {
     return nice_agent_send(agent, stream_id, component_id, len, buf);
   }
+  int LibNiceInterfaceImpl::NiceAgentSendMessages(NiceAgent* agent, unsigned int stream_id,
+      unsigned int component_id, const char* const* bufs, const unsigned int* lens, unsigned int n_messages) {
+    std::vector<GOutputVector> vectors(n_messages);
+    std::vector<NiceOutputMessage> messages(n_messages);
+    for (unsigned int i = 0; i < n_messages; i++) {
+      vectors[i].buffer = bufs[i];
+      vectors[i].size = lens[i];
+      messages[i].buffers = &vectors[i];
+      messages[i].n_buffers = 1;
+    }
+    return nice_agent_send_messages_nonblocking(agent, stream_id, component_id, messages.data(), n_messages,
+                                                NULL, NULL);
+  }
 
 }  // namespace erizo
@@ -0,0 +1,41 @@
+#ifndef ERIZO_SRC_ERIZO_LIB_PACKETBATCHQUEUE_H_
+#define ERIZO_SRC_ERIZO_LIB_PACKETBATCHQUEUE_H_
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "./MediaDefinitions.h"
+
+namespace erizo {
+
+/**
+ * Collects packets produced in one thread so another thread can take all of them in a single task,
+ * instead of posting one task per packet.
+ * push() returns true when the queue was empty, meaning the caller has to schedule a new flush.
+ */
+class PacketBatchQueue {
+ public:
+  PacketBatchQueue() = default;
+
+  bool push(std::shared_ptr<DataPacket> packet) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    pending_.push_back(std::move(packet));
+    return pending_.size() == 1;
+  }
+
+  // Moves every pending packet into batch, which is expected to be empty so both buffers keep their capacity
+  void takeAll(std::vector<std::shared_ptr<DataPacket>> *batch) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    pending_.swap(*batch);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<DataPacket>> pending_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_LIB_PACKETBATCHQUEUE_H_
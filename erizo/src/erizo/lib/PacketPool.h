@@ -0,0 +1,30 @@
+#ifndef ERIZO_SRC_ERIZO_LIB_PACKETPOOL_H_
+#define ERIZO_SRC_ERIZO_LIB_PACKETPOOL_H_
+
+#include <memory>
+#include <utility>
+
+#include "./MediaDefinitions.h"
+#include "lib/PoolAllocator.h"
+
+namespace erizo {
+
+/**
+ * Creates DataPackets whose storage (packet plus shared_ptr control block) is recycled through per thread
+ * free lists instead of going through the global allocator on every hop.
+ */
+class PacketPool {
+ public:
+  template <typename... Args>
+  static inline std::shared_ptr<DataPacket> create(Args&&... args) {
+    return std::allocate_shared<DataPacket>(PoolAllocator<DataPacket>(), std::forward<Args>(args)...);
+  }
+
+  static inline std::shared_ptr<DataPacket> clone(const DataPacket &packet) {
+    return create(packet);
+  }
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_LIB_PACKETPOOL_H_
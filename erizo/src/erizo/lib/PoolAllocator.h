@@ -0,0 +1,143 @@
+#ifndef ERIZO_SRC_ERIZO_LIB_POOLALLOCATOR_H_
+#define ERIZO_SRC_ERIZO_LIB_POOLALLOCATOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <new>
+#include <vector>
+
+namespace erizo {
+
+/**
+ * Fixed size block cache with a free list per thread.
+ * Blocks released by a thread are kept in that thread's free list. When a list grows over kMaxCachedBlocks
+ * a batch of blocks is moved to a shared depot, and threads with an empty list take a batch from it, so
+ * producer threads (ICE) and consumer threads (Workers) keep recycling the same memory.
+ */
+template <std::size_t kBlockSize, std::size_t kBlockAlign>
+class BlockCache {
+ public:
+  static constexpr std::size_t kMaxCachedBlocks = 1024;
+  static constexpr std::size_t kBatchSize = 128;
+
+  static void* allocate() {
+    std::vector<void*> &free_list = local().blocks;
+    if (free_list.empty()) {
+      depot().takeBatch(&free_list);
+    }
+    if (free_list.empty()) {
+      return ::operator new(kBlockSize, std::align_val_t{kBlockAlign});
+    }
+    void *block = free_list.back();
+    free_list.pop_back();
+    return block;
+  }
+
+  static void release(void *block) {
+    std::vector<void*> &free_list = local().blocks;
+    free_list.push_back(block);
+    if (free_list.size() > kMaxCachedBlocks) {
+      depot().giveBatch(&free_list);
+    }
+  }
+
+  static std::size_t cachedBlocksInThisThread() {
+    return local().blocks.size();
+  }
+
+ private:
+  static void destroy(void *block) {
+    ::operator delete(block, std::align_val_t{kBlockAlign});
+  }
+
+  struct LocalCache {
+    LocalCache() { blocks.reserve(kMaxCachedBlocks + 1); }
+    ~LocalCache() {
+      for (void *block : blocks) {
+        destroy(block);
+      }
+    }
+    std::vector<void*> blocks;
+  };
+
+  class Depot {
+   public:
+    ~Depot() {
+      for (void *block : blocks_) {
+        destroy(block);
+      }
+    }
+
+    void takeBatch(std::vector<void*> *free_list) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      std::size_t count = std::min(kBatchSize, blocks_.size());
+      free_list->insert(free_list->end(), blocks_.end() - count, blocks_.end());
+      blocks_.resize(blocks_.size() - count);
+    }
+
+    void giveBatch(std::vector<void*> *free_list) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      std::size_t count = std::min(kBatchSize, free_list->size());
+      if (blocks_.size() >= kMaxCachedBlocks * 8) {
+        std::for_each(free_list->end() - count, free_list->end(), destroy);
+      } else {
+        blocks_.insert(blocks_.end(), free_list->end() - count, free_list->end());
+      }
+      free_list->resize(free_list->size() - count);
+    }
+
+   private:
+    std::mutex mutex_;
+    std::vector<void*> blocks_;
+  };
+
+  static LocalCache& local() {
+    static thread_local LocalCache cache;
+    return cache;
+  }
+
+  static Depot& depot() {
+    static Depot the_depot;
+    return the_depot;
+  }
+};
+
+/**
+ * Stateless allocator backed by BlockCache. Single object allocations (the only ones std::allocate_shared
+ * performs) come from the cache, anything else falls back to the global allocator.
+ */
+template <class T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  PoolAllocator() = default;
+  template <class U>
+  PoolAllocator(const PoolAllocator<U>&) {}  // NOLINT
+
+  T* allocate(std::size_t n) {
+    if (n == 1) {
+      return static_cast<T*>(BlockCache<sizeof(T), alignof(T)>::allocate());
+    }
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) {
+    if (n == 1) {
+      BlockCache<sizeof(T), alignof(T)>::release(p);
+      return;
+    }
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <class U>
+  bool operator==(const PoolAllocator<U>&) const { return true; }
+  template <class U>
+  bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_LIB_POOLALLOCATOR_H_
@@ -0,0 +1,51 @@
+#include "lib/StringInterner.h"
+
+namespace erizo {
+
+StringInterner::StringInterner() : size_{0} {
+  // Well known ids are added first so they match their constants
+  add("");
+  add("VP8");
+  add("VP9");
+  add("H264");
+}
+
+StringInterner& StringInterner::instance() {
+  static StringInterner interner;
+  return interner;
+}
+
+StringId StringInterner::intern(const std::string &value) {
+  if (value.empty()) {
+    return kEmptyId;
+  }
+  StringInterner &interner = instance();
+  std::lock_guard<std::mutex> lock(interner.mutex_);
+  auto id_it = interner.ids_.find(value);
+  if (id_it != interner.ids_.end()) {
+    return id_it->second;
+  }
+  return interner.add(value);
+}
+
+const std::string& StringInterner::lookup(StringId id) {
+  StringInterner &interner = instance();
+  if (id >= interner.size_.load(std::memory_order_acquire)) {
+    return interner.strings_[kEmptyId];
+  }
+  return interner.strings_[id];
+}
+
+StringId StringInterner::add(const std::string &value) {
+  size_t size = size_.load(std::memory_order_relaxed);
+  if (size == kMaxStrings) {
+    return kEmptyId;
+  }
+  strings_[size] = value;
+  ids_.emplace(value, static_cast<StringId>(size));
+  // Readers only access strings below size_, so they never see one that is being written
+  size_.store(size + 1, std::memory_order_release);
+  return static_cast<StringId>(size);
+}
+
+}  // namespace erizo
@@ -0,0 +1,47 @@
+#ifndef ERIZO_SRC_ERIZO_LIB_STRINGINTERNER_H_
+#define ERIZO_SRC_ERIZO_LIB_STRINGINTERNER_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+
+namespace erizo {
+
+using StringId = uint16_t;
+
+/**
+ * Maps short strings that are attached to every packet, like codec names or mids, to small ids,
+ * so packets can carry and compare them without copying strings.
+ * Ids are shared by the whole process and never change, so they stay valid when a packet is
+ * forwarded from a publisher connection to its subscribers. Looking up an id does not lock.
+ */
+class StringInterner {
+ public:
+  static constexpr StringId kEmptyId = 0;
+  static constexpr StringId kVP8Id = 1;
+  static constexpr StringId kVP9Id = 2;
+  static constexpr StringId kH264Id = 3;
+  static constexpr size_t kMaxStrings = 1024;
+
+  // Returns kEmptyId for the empty string and when the table is full
+  static StringId intern(const std::string &value);
+  static const std::string& lookup(StringId id);
+
+ private:
+  StringInterner();
+  static StringInterner& instance();
+  StringId add(const std::string &value);
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, StringId> ids_;
+  std::array<std::string, kMaxStrings> strings_;
+  std::atomic<size_t> size_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_LIB_STRINGINTERNER_H_
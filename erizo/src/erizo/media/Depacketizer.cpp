@@ -110,6 +110,17 @@ bool Vp8Depacketizer::isKeyframe() const {
   return last_payload_->frameType == VP8FrameTypes::kVP8IFrame;
 }
 
+bool Vp8Depacketizer::isFrameStart(const char* pkt, int len) {
+  const RtpHeader* head = reinterpret_cast<const RtpHeader*>(pkt);
+  const int header_length = head->getHeaderLength();
+  if (len <= header_length) {
+    return false;
+  }
+  const unsigned char descriptor = static_cast<unsigned char>(pkt[header_length]);
+  // S bit set and partition index 0
+  return (descriptor & 0x10) && (descriptor & 0x07) == 0;
+}
+
 void Vp8Depacketizer::resetImpl() {
   last_payload_ = nullptr;
   search_state_ = SearchState::lookingForStart;
@@ -129,6 +140,19 @@ bool H264Depacketizer::isKeyframe() const {
   return last_payload_->frameType == H264FrameTypes::kH264IFrame;
 }
 
+bool H264Depacketizer::isFrameStart(const char* pkt, int len) {
+  const RtpHeader* head = reinterpret_cast<const RtpHeader*>(pkt);
+  const int header_length = head->getHeaderLength();
+  if (len <= header_length) {
+    return false;
+  }
+  const unsigned char nal_type = pkt[header_length] & 0x1F;
+  if (nal_type == 28) {  // FU-A
+    return len > header_length + 1 && (pkt[header_length + 1] & 0x80);
+  }
+  return nal_type > 0 && nal_type <= 24;  // single NAL or STAP-A
+}
+
 void H264Depacketizer::resetImpl() {
   last_payload_ = nullptr;
   search_state_ = SearchState::lookingForStart;
@@ -93,6 +93,13 @@ class Vp8Depacketizer: public Depacketizer {
   bool processPacket() override;
 
   bool isKeyframe() const override;
+
+  /**
+   * @returns True if the rtp packet carries the start of a VP8 frame (S bit set in partition 0). It only
+   * looks at the payload descriptor, so jitter buffers can use it to find frame boundaries.
+   */
+  static bool isFrameStart(const char* pkt, int len);
+
  private:
   void resetImpl() override;
 
@@ -108,6 +115,12 @@ class H264Depacketizer: public Depacketizer {
   bool processPacket() override;
 
   bool isKeyframe() const override;
+
+  /**
+   * @returns True if the rtp packet starts a NAL unit: single and aggregated NALs or the first FU-A fragment.
+   */
+  static bool isFrameStart(const char* pkt, int len);
+
  private:
   void resetImpl() override;
 
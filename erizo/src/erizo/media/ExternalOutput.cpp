@@ -2,6 +2,7 @@
 
 #include <sys/time.h>
 
+#include <cerrno>
 #include <string>
 #include <cstring>
 
@@ -23,13 +24,16 @@ namespace erizo {
 DEFINE_LOGGER(ExternalOutput, "media.ExternalOutput");
 ExternalOutput::ExternalOutput(std::shared_ptr<Worker> worker, const std::string& output_url,
                                const std::vector<RtpMap> rtp_mappings,
-                               const std::vector<erizo::ExtMap> ext_mappings, bool hasAudio, bool hasVideo)
+                               const std::vector<erizo::ExtMap> ext_mappings, bool hasAudio, bool hasVideo,
+                               bool direct_io, std::shared_ptr<RecordingEngine> engine)
   : worker_{worker}, pipeline_{Pipeline::create()}, audio_queue_{5.0, 10.0}, video_queue_{5.0, 10.0},
-    inited_{false}, video_stream_{nullptr},
-    audio_stream_{nullptr}, video_source_ssrc_{0},
+    recording_{false}, inited_{false}, closed_{false}, engine_{engine}, output_url_{output_url}, raw_dump_{false},
+    dump_failed_{false}, video_stream_{nullptr}, audio_stream_{nullptr}, video_source_ssrc_{0},
     first_video_timestamp_{-1}, first_audio_timestamp_{-1},
     first_data_received_{}, video_offset_ms_{-1}, audio_offset_ms_{-1},
-    need_to_send_fir_{true}, rtp_mappings_{rtp_mappings}, hasAudio_{hasAudio}, hasVideo_{hasVideo},
+    need_to_send_fir_{true}, keyframe_only_{false}, keyframe_requested_{false}, has_keyframe_timestamp_{false},
+    keyframe_timestamp_{0},
+    rtp_mappings_{rtp_mappings}, ext_mappings_{ext_mappings}, hasAudio_{hasAudio}, hasVideo_{hasVideo},
     video_codec_{AV_CODEC_ID_NONE}, audio_codec_{AV_CODEC_ID_NONE},
     pipeline_initialized_{false}, ext_processor_{ext_mappings}
      {
@@ -39,6 +43,16 @@ ExternalOutput::ExternalOutput(std::shared_ptr<Worker> worker, const std::string
   av_register_all();
   avcodec_register_all();
 
+  std::string dump_extension = kRtpDumpExtension;
+  raw_dump_ = output_url.size() > dump_extension.size() &&
+      output_url.compare(output_url.size() - dump_extension.size(), dump_extension.size(), dump_extension) == 0;
+  // Local files go through our own buffered writer, anything else (e.g. rtmp://) is left to libavformat
+  if (raw_dump_) {
+    dump_writer_.reset(new RtpDumpWriter(output_url, direct_io));
+  } else if (output_url.find("://") == std::string::npos) {
+    file_writer_.reset(new RecordingFileWriter(output_url, direct_io));
+  }
+
   stats_ = std::make_shared<Stats>();
   quality_manager_ = std::make_shared<QualityManager>();
 
@@ -55,8 +69,10 @@ ExternalOutput::ExternalOutput(std::shared_ptr<Worker> worker, const std::string
     }
   }
 
-  context_ = avformat_alloc_context();
-  if (context_ == nullptr) {
+  context_ = raw_dump_ ? nullptr : avformat_alloc_context();
+  if (raw_dump_) {
+    ELOG_DEBUG("Recording raw RTP dump to %s", output_url.c_str());
+  } else if (context_ == nullptr) {
     ELOG_ERROR("Error allocating memory for IO context");
   } else {
     output_url.copy(context_->filename, sizeof(context_->filename), 0);
@@ -81,12 +97,15 @@ bool ExternalOutput::init() {
   MediaInfo m;
   m.hasVideo = false;
   m.hasAudio = false;
+  if (raw_dump_ && !dump_writer_->open(rtp_mappings_, ext_mappings_)) {
+    ELOG_ERROR("Error opening raw RTP dump %s", output_url_.c_str());
+    return false;
+  }
   recording_ = true;
   closed_ = false;
   asyncTask([] (std::shared_ptr<ExternalOutput> output) {
     output->initializePipeline();
   });
-  thread_ = boost::thread(&ExternalOutput::sendLoop, this);
   ELOG_DEBUG("Initialized successfully");
   return true;
 }
@@ -107,10 +126,17 @@ void ExternalOutput::syncClose() {
     return;
   }
   recording_ = false;
-  // Stop our thread so we can safely nuke libav stuff and close our
+  // Wait for the recording engine to be done with us so we can safely nuke libav stuff and close
   // our file.
-  cond_.notify_one();
-  thread_.join();
+  boost::unique_lock<boost::mutex> lock(mtx_);
+  writeQueuedData(true);
+  if (raw_dump_) {
+    writeQueuedDumpPackets();
+    dump_writer_->close();
+  }
+  ELOG_DEBUG("message: Recording queue stats, video_late: %lu, video_dropped: %lu, audio_late: %lu, "
+             "audio_dropped: %lu", video_queue_.getLatePackets(), video_queue_.getDroppedPackets(),
+             audio_queue_.getLatePackets(), audio_queue_.getDroppedPackets());
 
   if (audio_stream_ != nullptr && video_stream_ != nullptr && context_ != nullptr) {
       av_write_trailer(context_);
@@ -125,7 +151,7 @@ void ExternalOutput::syncClose() {
   }
 
   if (context_ != nullptr) {
-      avio_close(context_->pb);
+      closeOutputFile();
       avformat_free_context(context_);
       context_ = nullptr;
   }
@@ -254,9 +280,11 @@ void ExternalOutput::updateVideoCodec(RtpMap map) {
   video_map_ = map;
   if (map.encoding_name == "VP8") {
     depacketizer_.reset(new Vp8Depacketizer());
+    video_queue_.setFrameStartDetector(&Vp8Depacketizer::isFrameStart);
     video_codec_ = AV_CODEC_ID_VP8;
   } else if (map.encoding_name == "H264") {
     depacketizer_.reset(new H264Depacketizer());
+    video_queue_.setFrameStartDetector(&H264Depacketizer::isFrameStart);
     video_codec_ = AV_CODEC_ID_H264;
   }
 }
@@ -324,9 +352,86 @@ void ExternalOutput::initializePipeline() {
 }
 
 void ExternalOutput::write(std::shared_ptr<DataPacket> packet) {
+  if (packet->type == VIDEO_PACKET && shouldDropForBackpressure(packet)) {
+    return;
+  }
+  if (raw_dump_) {
+    queueDumpPacket(std::move(packet));
+    return;
+  }
   queueData(packet->data, packet->length, packet->type);
 }
 
+void ExternalOutput::queueDumpPacket(std::shared_ptr<DataPacket> packet) {
+  if (!recording_ || dump_failed_) {
+    return;
+  }
+  if (need_to_send_fir_ && video_source_ssrc_) {
+    sendFirPacket();
+    need_to_send_fir_ = false;
+  }
+  {
+    boost::mutex::scoped_lock lock(dump_mutex_);
+    dump_queue_.push_back(std::move(packet));
+  }
+  engine_->schedule(shared_from_this());
+}
+
+void ExternalOutput::writeQueuedDumpPackets() {
+  std::vector<std::shared_ptr<DataPacket>> packets;
+  {
+    boost::mutex::scoped_lock lock(dump_mutex_);
+    packets.swap(dump_queue_);
+  }
+  if (dump_failed_) {
+    return;
+  }
+  for (const auto &packet : packets) {
+    if (!dump_writer_->append(*packet, static_cast<int64_t>(packet->received_time_ms) * 1000)) {
+      // The dump would be truncated anyway, stop queueing packets that can't be written
+      ELOG_ERROR("File %s, message: Error writing raw RTP dump, stopping the recording", output_url_.c_str());
+      dump_failed_ = true;
+      return;
+    }
+  }
+}
+
+bool ExternalOutput::shouldDropForBackpressure(std::shared_ptr<DataPacket> packet) {
+  RtcpHeader *chead = reinterpret_cast<RtcpHeader*>(packet->data);
+  if (chead->isRtcp()) {
+    return false;
+  }
+  uint32_t timestamp = reinterpret_cast<RtpHeader*>(packet->data)->getTimestamp();
+  if (engine_->isFallingBehind() && !keyframe_only_) {
+    ELOG_WARN("File %s, message: Storage is falling behind, recording only keyframes", output_url_.c_str());
+    keyframe_only_ = true;
+    keyframe_requested_ = false;
+    has_keyframe_timestamp_ = false;
+  }
+  if (!keyframe_only_) {
+    return false;
+  }
+  if (packet->is_keyframe) {
+    // The rest of the keyframe packets share its timestamp
+    keyframe_timestamp_ = timestamp;
+    has_keyframe_timestamp_ = true;
+    if (!engine_->isFallingBehind()) {
+      ELOG_INFO("File %s, message: Storage caught up, recording all frames", output_url_.c_str());
+      keyframe_only_ = false;
+    }
+    return false;
+  }
+  if (has_keyframe_timestamp_ && timestamp == keyframe_timestamp_) {
+    return false;
+  }
+  if (!engine_->isFallingBehind() && !keyframe_requested_) {
+    // Ask for a keyframe so we can go back to record every frame
+    need_to_send_fir_ = true;
+    keyframe_requested_ = true;
+  }
+  return true;
+}
+
 void ExternalOutput::queueDataAsync(std::shared_ptr<DataPacket> copied_packet) {
   asyncTask([copied_packet] (std::shared_ptr<ExternalOutput> this_ptr) {
     if (!this_ptr->pipeline_initialized_) {
@@ -434,7 +539,7 @@ bool ExternalOutput::initContext() {
   }
 
   if ( init_audio || init_video ) {
-    if (avio_open(&context_->pb, context_->filename, AVIO_FLAG_WRITE) < 0) {
+    if (!openOutputFile()) {
       ELOG_ERROR("Error opening output file");
       return false;
     }
@@ -521,9 +626,54 @@ void ExternalOutput::queueData(char* buffer, int length, packetType type) {
   }
 
   if (audio_queue_.hasData() || video_queue_.hasData()) {
-    // One or both of our queues has enough data to write stuff out.  Notify our writer.
-    cond_.notify_one();
+    // One or both of our queues has enough data to write stuff out.  Let the recording engine run us.
+    engine_->schedule(shared_from_this());
+  }
+}
+
+bool ExternalOutput::openOutputFile() {
+  if (!file_writer_) {
+    return avio_open(&context_->pb, context_->filename, AVIO_FLAG_WRITE) >= 0;
+  }
+  if (!file_writer_->open()) {
+    return false;
+  }
+  unsigned char *buffer = reinterpret_cast<unsigned char*>(av_malloc(kExternalOutputAvioBufferSize));
+  context_->pb = avio_alloc_context(buffer, kExternalOutputAvioBufferSize, 1, file_writer_.get(), nullptr,
+      &ExternalOutput::writeOutputFile, &ExternalOutput::seekOutputFile);
+  if (context_->pb == nullptr) {
+    av_free(buffer);
+    return false;
+  }
+  context_->flags |= AVFMT_FLAG_CUSTOM_IO;
+  return true;
+}
+
+void ExternalOutput::closeOutputFile() {
+  if (!file_writer_) {
+    avio_close(context_->pb);
+    return;
+  }
+  if (context_->pb != nullptr) {
+    avio_flush(context_->pb);
+    av_freep(&context_->pb->buffer);
+    av_freep(&context_->pb);
   }
+  file_writer_->close();
+}
+
+int ExternalOutput::writeOutputFile(void *opaque, uint8_t *buf, int buf_size) {
+  RecordingFileWriter *writer = reinterpret_cast<RecordingFileWriter*>(opaque);
+  return writer->write(buf, buf_size) ? buf_size : AVERROR(EIO);
+}
+
+int64_t ExternalOutput::seekOutputFile(void *opaque, int64_t offset, int whence) {
+  RecordingFileWriter *writer = reinterpret_cast<RecordingFileWriter*>(opaque);
+  if (whence & AVSEEK_SIZE) {
+    return writer->getSize();
+  }
+  int64_t position = writer->seek(offset, whence & ~AVSEEK_FORCE);
+  return position < 0 ? AVERROR(EIO) : position;
 }
 
 int ExternalOutput::sendFirPacket() {
@@ -543,30 +693,29 @@ int ExternalOutput::sendFirPacket() {
     return -1;
 }
 
-void ExternalOutput::sendLoop() {
-  while (recording_) {
-    boost::unique_lock<boost::mutex> lock(mtx_);
-    cond_.wait(lock);
-    while (audio_queue_.hasData()) {
-      boost::shared_ptr<DataPacket> audio_packet = audio_queue_.popPacket();
-      writeAudioData(audio_packet->data, audio_packet->length);
-    }
-    while (video_queue_.hasData()) {
-      boost::shared_ptr<DataPacket> video_packet = video_queue_.popPacket();
-      writeVideoData(video_packet->data, video_packet->length);
-    }
-    if (!inited_ && first_data_received_ != time_point()) {
-      inited_ = true;
-    }
+void ExternalOutput::processRecordingData() {
+  boost::unique_lock<boost::mutex> lock(mtx_);
+  if (!recording_) {
+    return;
   }
+  if (raw_dump_) {
+    writeQueuedDumpPackets();
+  } else {
+    writeQueuedData(false);
+  }
+  if (!inited_ && first_data_received_ != time_point()) {
+    inited_ = true;
+  }
+}
 
-  // Since we're bailing, let's completely drain our queues of all data.
-  while (audio_queue_.getSize() > 0) {
-    boost::shared_ptr<DataPacket> audio_packet = audio_queue_.popPacket(true);  // ignore our minimum depth check
+void ExternalOutput::writeQueuedData(bool ignore_depth) {
+  // When we're bailing we ignore our minimum depth check to completely drain our queues.
+  while (ignore_depth ? audio_queue_.getSize() > 0 : audio_queue_.hasData()) {
+    boost::shared_ptr<DataPacket> audio_packet = audio_queue_.popPacket(ignore_depth);
     writeAudioData(audio_packet->data, audio_packet->length);
   }
-  while (video_queue_.getSize() > 0) {
-    boost::shared_ptr<DataPacket> video_packet = video_queue_.popPacket(true);  // ignore our minimum depth check
+  while (ignore_depth ? video_queue_.getSize() > 0 : video_queue_.hasData()) {
+    boost::shared_ptr<DataPacket> video_packet = video_queue_.popPacket(ignore_depth);
     writeVideoData(video_packet->data, video_packet->length);
   }
 }
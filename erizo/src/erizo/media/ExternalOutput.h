@@ -17,6 +17,9 @@ extern "C" {
 #include "webrtc/modules/rtp_rtcp/include/ulpfec_receiver.h"
 #include "media/MediaProcessor.h"
 #include "media/Depacketizer.h"
+#include "media/RecordingEngine.h"
+#include "media/RecordingFileWriter.h"
+#include "media/RtpDump.h"
 #include "./Stats.h"
 #include "lib/Clock.h"
 #include "SdpInfo.h"
@@ -29,17 +32,19 @@ extern "C" {
 namespace erizo {
 
 static constexpr uint64_t kExternalOutputMaxBitrate = 1000000000;
+static constexpr int kExternalOutputAvioBufferSize = 32768;
 
 class ExternalOutput : public MediaSink, public RawDataReceiver, public FeedbackSource,
                        public webrtc::RecoveredPacketReceiver, public HandlerManagerListener,
-                       public std::enable_shared_from_this<ExternalOutput> {
+                       public RecordingTask, public std::enable_shared_from_this<ExternalOutput> {
   DECLARE_LOGGER();
 
  public:
   explicit ExternalOutput(std::shared_ptr<Worker> worker, const std::string& output_url,
                           const std::vector<RtpMap> rtp_mappings,
                           const std::vector<erizo::ExtMap> ext_mappings,
-                          bool hasAudio, bool hasVideo);
+                          bool hasAudio, bool hasVideo, bool direct_io = false,
+                          std::shared_ptr<RecordingEngine> engine = RecordingEngine::getDefault());
   virtual ~ExternalOutput();
   bool init();
   void receiveRawData(const RawDataPacket& packet) override;
@@ -53,7 +58,11 @@ class ExternalOutput : public MediaSink, public RawDataReceiver, public Feedback
 
   void notifyUpdateToHandlers() override;
 
+  // Runs in one of the recording engine threads
+  void processRecordingData() override;
+
   bool hasClosed() { return closed_; }
+  bool isKeyframeOnly() { return keyframe_only_; }
 
  private:
   std::shared_ptr<Worker> worker_;
@@ -61,9 +70,16 @@ class ExternalOutput : public MediaSink, public RawDataReceiver, public Feedback
   std::unique_ptr<webrtc::UlpfecReceiver> fec_receiver_;
   RtpPacketQueue audio_queue_, video_queue_;
   std::atomic<bool> recording_, inited_, closed_;
-  boost::mutex mtx_;  // a mutex we use to signal our writer thread that data is waiting.
-  boost::thread thread_;
-  boost::condition_variable cond_;
+  boost::mutex mtx_;  // protects the muxer, the engine and close() never write at the same time
+  std::shared_ptr<RecordingEngine> engine_;
+  std::string output_url_;
+  std::unique_ptr<RecordingFileWriter> file_writer_;
+  // Outputs ending in kRtpDumpExtension record the raw packets, RtpDumpMuxer makes a media file later
+  bool raw_dump_;
+  std::atomic<bool> dump_failed_;
+  std::unique_ptr<RtpDumpWriter> dump_writer_;
+  boost::mutex dump_mutex_;
+  std::vector<std::shared_ptr<DataPacket>> dump_queue_;
   AVStream *video_stream_, *audio_stream_;
   AVFormatContext *context_;
   uint32_t video_source_ssrc_;
@@ -103,7 +119,16 @@ class ExternalOutput : public MediaSink, public RawDataReceiver, public Feedback
   // composed of one or more partitions.  However, we don't seem to be sent anything but partition 0
   // so the second scheme seems not applicable.  Too bad.
   bool need_to_send_fir_;
+
+  // When the recording engine falls behind we only record video keyframes, so the file keeps a
+  // decodable picture while storage catches up. We leave that mode with the next keyframe.
+  bool keyframe_only_;
+  bool keyframe_requested_;
+  bool has_keyframe_timestamp_;
+  uint32_t keyframe_timestamp_;
+
   std::vector<RtpMap> rtp_mappings_;
+  std::vector<ExtMap> ext_mappings_;
   bool hasAudio_;
   bool hasVideo_;
   enum AVCodecID video_codec_;
@@ -123,7 +148,14 @@ class ExternalOutput : public MediaSink, public RawDataReceiver, public Feedback
   boost::future<void> asyncTask(std::function<void(std::shared_ptr<ExternalOutput>)> f);
   void queueData(char* buffer, int length, packetType type);
   void queueDataAsync(std::shared_ptr<DataPacket> copied_packet);
-  void sendLoop();
+  bool shouldDropForBackpressure(std::shared_ptr<DataPacket> packet);
+  void writeQueuedData(bool ignore_depth);
+  void queueDumpPacket(std::shared_ptr<DataPacket> packet);
+  void writeQueuedDumpPackets();
+  bool openOutputFile();
+  void closeOutputFile();
+  static int writeOutputFile(void *opaque, uint8_t *buf, int buf_size);
+  static int64_t seekOutputFile(void *opaque, int64_t offset, int whence);
   int deliverAudioData_(std::shared_ptr<DataPacket> audio_packet) override;
   int deliverVideoData_(std::shared_ptr<DataPacket> video_packet) override;
   int deliverEvent_(MediaEventPtr event) override;
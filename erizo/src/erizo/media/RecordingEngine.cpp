@@ -0,0 +1,118 @@
+#include "media/RecordingEngine.h"
+
+#include <memory>
+
+namespace erizo {
+
+DEFINE_LOGGER(RecordingEngine, "media.RecordingEngine");
+
+constexpr duration RecordingEngine::kMaxSchedulingDelay;
+constexpr duration RecordingEngine::kRecoveredSchedulingDelay;
+
+RecordingEngine::RecordingEngine(unsigned int num_threads, std::shared_ptr<Clock> the_clock)
+    : num_threads_{num_threads}, clock_{the_clock}, running_{false}, falling_behind_{false} {
+}
+
+RecordingEngine::~RecordingEngine() {
+  close();
+}
+
+std::shared_ptr<RecordingEngine> RecordingEngine::getDefault() {
+  static std::shared_ptr<RecordingEngine> engine = [] {
+    auto default_engine = std::make_shared<RecordingEngine>(kDefaultNumThreads);
+    default_engine->start();
+    return default_engine;
+  }();
+  return engine;
+}
+
+void RecordingEngine::start() {
+  boost::mutex::scoped_lock lock(mutex_);
+  if (running_) {
+    return;
+  }
+  running_ = true;
+  for (unsigned int index = 0; index < num_threads_; index++) {
+    threads_.emplace_back(&RecordingEngine::run, this);
+  }
+}
+
+void RecordingEngine::close() {
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+  }
+  cond_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  ready_tasks_.clear();
+}
+
+void RecordingEngine::schedule(std::shared_ptr<RecordingTask> task) {
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    switch (task->state_) {
+      case RecordingTask::State::kIdle:
+        task->state_ = RecordingTask::State::kScheduled;
+        ready_tasks_.push_back({task, clock_->now()});
+        break;
+      case RecordingTask::State::kRunning:
+        // It will be queued again when the running thread is done with it
+        task->state_ = RecordingTask::State::kRunningAndScheduled;
+        task->scheduled_at_ = clock_->now();
+        return;
+      default:
+        return;
+    }
+    updateFallingBehind();
+  }
+  cond_.notify_one();
+}
+
+void RecordingEngine::updateFallingBehind() {
+  duration delay = duration{0};
+  if (!ready_tasks_.empty()) {
+    delay = clock_->now() - ready_tasks_.front().scheduled_at;
+  }
+  if (!falling_behind_ && delay > kMaxSchedulingDelay) {
+    ELOG_WARN("message: Recordings are falling behind, scheduling delay: %lld ms",
+        std::chrono::duration_cast<std::chrono::milliseconds>(delay).count());
+    falling_behind_ = true;
+  } else if (falling_behind_ && delay < kRecoveredSchedulingDelay) {
+    ELOG_INFO("message: Recordings caught up");
+    falling_behind_ = false;
+  }
+}
+
+void RecordingEngine::run() {
+  boost::mutex::scoped_lock lock(mutex_);
+  while (running_) {
+    if (ready_tasks_.empty()) {
+      cond_.wait(lock);
+      continue;
+    }
+    std::shared_ptr<RecordingTask> task = ready_tasks_.front().task.lock();
+    ready_tasks_.pop_front();
+    updateFallingBehind();
+    if (!task) {
+      continue;
+    }
+    task->state_ = RecordingTask::State::kRunning;
+    lock.unlock();
+    task->processRecordingData();
+    lock.lock();
+    if (task->state_ == RecordingTask::State::kRunningAndScheduled) {
+      task->state_ = RecordingTask::State::kScheduled;
+      ready_tasks_.push_back({task, task->scheduled_at_});
+    } else {
+      task->state_ = RecordingTask::State::kIdle;
+    }
+  }
+}
+
+}  // namespace erizo
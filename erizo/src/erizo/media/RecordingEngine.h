@@ -0,0 +1,80 @@
+#ifndef ERIZO_SRC_ERIZO_MEDIA_RECORDINGENGINE_H_
+#define ERIZO_SRC_ERIZO_MEDIA_RECORDINGENGINE_H_
+
+#include <boost/thread.hpp>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "./logger.h"
+#include "lib/Clock.h"
+
+namespace erizo {
+
+class RecordingEngine;
+
+// Work that a recording has pending, like muxing queued packets and writing them to storage.
+// The engine never runs the same task in two threads at the same time.
+class RecordingTask {
+  friend class RecordingEngine;
+
+ public:
+  virtual ~RecordingTask() {}
+  virtual void processRecordingData() = 0;
+
+ private:
+  enum class State { kIdle, kScheduled, kRunning, kRunningAndScheduled };
+  State state_ = State::kIdle;
+  time_point scheduled_at_;
+};
+
+// A few muxer threads shared by every recording in the process. Recordings schedule themselves when
+// they have data to write, and the engine reports when storage falls behind so they can shed load.
+class RecordingEngine {
+  DECLARE_LOGGER();
+
+ public:
+  static constexpr unsigned int kDefaultNumThreads = 4;
+  static constexpr duration kMaxSchedulingDelay = std::chrono::seconds(1);
+  static constexpr duration kRecoveredSchedulingDelay = std::chrono::milliseconds(250);
+
+  explicit RecordingEngine(unsigned int num_threads,
+                           std::shared_ptr<Clock> the_clock = std::make_shared<SteadyClock>());
+  ~RecordingEngine();
+
+  static std::shared_ptr<RecordingEngine> getDefault();
+
+  void start();
+  void close();
+  void schedule(std::shared_ptr<RecordingTask> task);
+  // True while tasks wait longer than kMaxSchedulingDelay to run, until the wait goes back under
+  // kRecoveredSchedulingDelay.
+  bool isFallingBehind() { return falling_behind_; }
+
+ private:
+  struct ReadyTask {
+    std::weak_ptr<RecordingTask> task;
+    time_point scheduled_at;
+  };
+
+  void run();
+  // Must be called with mutex_ locked
+  void updateFallingBehind();
+
+ private:
+  unsigned int num_threads_;
+  std::shared_ptr<Clock> clock_;
+  boost::mutex mutex_;
+  boost::condition_variable cond_;
+  std::deque<ReadyTask> ready_tasks_;
+  std::vector<boost::thread> threads_;
+  bool running_;
+  std::atomic<bool> falling_behind_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_MEDIA_RECORDINGENGINE_H_
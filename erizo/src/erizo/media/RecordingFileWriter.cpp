@@ -0,0 +1,164 @@
+#include "media/RecordingFileWriter.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace erizo {
+
+DEFINE_LOGGER(RecordingFileWriter, "media.RecordingFileWriter");
+
+constexpr size_t RecordingFileWriter::kBlockSize;
+constexpr size_t RecordingFileWriter::kBufferSize;
+
+RecordingFileWriter::RecordingFileWriter(const std::string &path, bool direct_io)
+    : path_{path}, direct_io_{direct_io}, fd_{-1}, buffer_{nullptr}, buffer_offset_{0}, buffered_{0},
+      cursor_{0}, file_size_{0}, num_writes_{0} {
+}
+
+RecordingFileWriter::~RecordingFileWriter() {
+  close();
+}
+
+bool RecordingFileWriter::open() {
+  void *buffer;
+  if (posix_memalign(&buffer, kBlockSize, kBufferSize) != 0) {
+    ELOG_ERROR("message: Could not allocate recording buffer, path: %s", path_.c_str());
+    return false;
+  }
+  buffer_ = reinterpret_cast<uint8_t*>(buffer);
+
+  int flags = O_WRONLY | O_CREAT | O_TRUNC;
+  if (direct_io_) {
+    fd_ = ::open(path_.c_str(), flags | O_DIRECT, 0644);
+    if (fd_ < 0 && errno == EINVAL) {
+      ELOG_WARN("message: Filesystem does not support direct IO, path: %s", path_.c_str());
+      direct_io_ = false;
+    }
+  }
+  if (fd_ < 0) {
+    fd_ = ::open(path_.c_str(), flags, 0644);
+  }
+  if (fd_ < 0) {
+    ELOG_ERROR("message: Could not open recording file, path: %s, error: %s", path_.c_str(), strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool RecordingFileWriter::write(const uint8_t *data, size_t length) {
+  if (fd_ < 0) {
+    return false;
+  }
+  while (length > 0) {
+    if (cursor_ == kBufferSize && !flush()) {
+      return false;
+    }
+    size_t chunk = std::min(length, kBufferSize - cursor_);
+    memcpy(buffer_ + cursor_, data, chunk);
+    cursor_ += chunk;
+    buffered_ = std::max(buffered_, cursor_);
+    data += chunk;
+    length -= chunk;
+  }
+  file_size_ = std::max(file_size_, buffer_offset_ + static_cast<int64_t>(buffered_));
+  return true;
+}
+
+int64_t RecordingFileWriter::seek(int64_t offset, int whence) {
+  int64_t position;
+  switch (whence) {
+    case SEEK_SET:
+      position = offset;
+      break;
+    case SEEK_CUR:
+      position = buffer_offset_ + cursor_ + offset;
+      break;
+    case SEEK_END:
+      position = file_size_ + offset;
+      break;
+    default:
+      return -1;
+  }
+  if (position < 0) {
+    return -1;
+  }
+  if (position >= buffer_offset_ && position <= buffer_offset_ + static_cast<int64_t>(buffered_)) {
+    cursor_ = position - buffer_offset_;
+    return position;
+  }
+  if (!flush()) {
+    return -1;
+  }
+  buffer_offset_ = position;
+  return position;
+}
+
+int64_t RecordingFileWriter::getSize() const {
+  return file_size_;
+}
+
+bool RecordingFileWriter::flush() {
+  if (buffered_ == 0) {
+    return true;
+  }
+  bool written = writeAt(buffer_offset_, buffer_, buffered_);
+  buffer_offset_ += cursor_;
+  buffered_ = 0;
+  cursor_ = 0;
+  return written;
+}
+
+bool RecordingFileWriter::close() {
+  if (fd_ < 0) {
+    return true;
+  }
+  bool flushed = flush();
+  ::close(fd_);
+  fd_ = -1;
+  free(buffer_);
+  buffer_ = nullptr;
+  return flushed;
+}
+
+bool RecordingFileWriter::writeAt(int64_t offset, const uint8_t *data, size_t length) {
+  bool aligned = offset % kBlockSize == 0 && length % kBlockSize == 0;
+  if (direct_io_ && !aligned) {
+    setDirectIo(false);
+  }
+  bool written = true;
+  while (length > 0) {
+    ssize_t result = pwrite(fd_, data, length, offset);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ELOG_ERROR("message: Error writing recording, path: %s, error: %s", path_.c_str(), strerror(errno));
+      written = false;
+      break;
+    }
+    data += result;
+    offset += result;
+    length -= result;
+  }
+  num_writes_++;
+  if (direct_io_ && !aligned) {
+    setDirectIo(true);
+  }
+  return written;
+}
+
+bool RecordingFileWriter::setDirectIo(bool enabled) {
+  int flags = fcntl(fd_, F_GETFL);
+  if (flags < 0) {
+    return false;
+  }
+  flags = enabled ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+  return fcntl(fd_, F_SETFL, flags) == 0;
+}
+
+}  // namespace erizo
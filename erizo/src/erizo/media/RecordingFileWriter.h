@@ -0,0 +1,54 @@
+#ifndef ERIZO_SRC_ERIZO_MEDIA_RECORDINGFILEWRITER_H_
+#define ERIZO_SRC_ERIZO_MEDIA_RECORDINGFILEWRITER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "./logger.h"
+
+namespace erizo {
+
+// Buffers what a muxer writes to a recording file and sends it to storage in large, block aligned
+// writes. Seeks that land inside the buffer (e.g. to patch a size field) don't touch the file.
+// With direct_io the file is opened with O_DIRECT so recordings don't fill up the page cache,
+// unaligned writes at the end of the file or after a seek go through the page cache instead.
+class RecordingFileWriter {
+  DECLARE_LOGGER();
+
+ public:
+  static constexpr size_t kBlockSize = 4096;
+  static constexpr size_t kBufferSize = 256 * kBlockSize;
+
+  RecordingFileWriter(const std::string &path, bool direct_io);
+  ~RecordingFileWriter();
+
+  bool open();
+  bool write(const uint8_t *data, size_t length);
+  // Returns the new position or -1 on error, whence is one of SEEK_SET, SEEK_CUR or SEEK_END
+  int64_t seek(int64_t offset, int whence);
+  int64_t getSize() const;
+  bool flush();
+  bool close();
+
+  uint64_t getNumWrites() const { return num_writes_; }
+  bool isDirectIo() const { return direct_io_; }
+
+ private:
+  bool writeAt(int64_t offset, const uint8_t *data, size_t length);
+  bool setDirectIo(bool enabled);
+
+ private:
+  std::string path_;
+  bool direct_io_;
+  int fd_;
+  uint8_t *buffer_;
+  int64_t buffer_offset_;  // file offset of the first byte in buffer_
+  size_t buffered_;
+  size_t cursor_;  // write position inside buffer_
+  int64_t file_size_;
+  uint64_t num_writes_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_MEDIA_RECORDINGFILEWRITER_H_
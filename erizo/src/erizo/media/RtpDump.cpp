@@ -0,0 +1,242 @@
+#include "media/RtpDump.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rtp/RtpHeaders.h"
+
+namespace erizo {
+
+DEFINE_LOGGER(RtpDumpWriter, "media.RtpDumpWriter");
+DEFINE_LOGGER(RtpDumpReader, "media.RtpDumpReader");
+
+static constexpr size_t kRtpDumpAlignment = 8;
+// RTCP header plus the sender SSRC, the shortest packet we may have dumped
+static constexpr uint32_t kMinRtcpLength = 8;
+
+static size_t paddedLength(size_t length) {
+  return (length + kRtpDumpAlignment - 1) & ~(kRtpDumpAlignment - 1);
+}
+
+static const char* mediaTypeName(MediaType type) {
+  return type == AUDIO_TYPE ? "audio" : "video";
+}
+
+RtpDumpWriter::RtpDumpWriter(const std::string &path, bool direct_io) : file_writer_{path, direct_io} {
+}
+
+bool RtpDumpWriter::open(const std::vector<RtpMap> &rtp_mappings, const std::vector<ExtMap> &ext_mappings) {
+  if (!file_writer_.open()) {
+    return false;
+  }
+  std::string metadata = serializeMetadata(rtp_mappings, ext_mappings);
+  RtpDumpFileHeader header;
+  memcpy(header.magic, kRtpDumpMagic, sizeof(header.magic));
+  header.version = kRtpDumpVersion;
+  header.metadata_length = metadata.size();
+  return file_writer_.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) &&
+      writePadded(metadata.data(), metadata.size());
+}
+
+bool RtpDumpWriter::append(const DataPacket &packet, int64_t arrival_time_us) {
+  RtpDumpRecordHeader header;
+  memset(&header, 0, sizeof(header));
+  header.length = packet.length;
+  header.type = packet.type;
+  header.arrival_time_us = arrival_time_us;
+  return file_writer_.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) &&
+      writePadded(packet.data, packet.length);
+}
+
+bool RtpDumpWriter::close() {
+  return file_writer_.close();
+}
+
+bool RtpDumpWriter::writePadded(const void *data, size_t length) {
+  static const uint8_t kPadding[kRtpDumpAlignment] = {0};
+  size_t padding = paddedLength(length) - length;
+  return file_writer_.write(reinterpret_cast<const uint8_t*>(data), length) &&
+      file_writer_.write(kPadding, padding);
+}
+
+std::string RtpDumpWriter::serializeMetadata(const std::vector<RtpMap> &rtp_mappings,
+                                             const std::vector<ExtMap> &ext_mappings) {
+  std::ostringstream metadata;
+  for (MediaType media_type : {VIDEO_TYPE, AUDIO_TYPE}) {
+    metadata << "m=" << mediaTypeName(media_type) << "\n";
+    for (const RtpMap &rtp_map : rtp_mappings) {
+      if (rtp_map.media_type != media_type) {
+        continue;
+      }
+      metadata << "a=rtpmap:" << rtp_map.payload_type << " " << rtp_map.encoding_name << "/" << rtp_map.clock_rate;
+      if (media_type == AUDIO_TYPE && rtp_map.channels > 1) {
+        metadata << "/" << rtp_map.channels;
+      }
+      metadata << "\n";
+      if (!rtp_map.format_parameters.empty()) {
+        metadata << "a=fmtp:" << rtp_map.payload_type << " ";
+        const char *separator = "";
+        for (const auto &parameter : rtp_map.format_parameters) {
+          metadata << separator << parameter.first << "=" << parameter.second;
+          separator = ";";
+        }
+        metadata << "\n";
+      }
+    }
+    for (const ExtMap &ext_map : ext_mappings) {
+      if (ext_map.mediaType == media_type) {
+        metadata << "a=extmap:" << ext_map.value << " " << ext_map.uri << "\n";
+      }
+    }
+  }
+  return metadata.str();
+}
+
+RtpDumpReader::RtpDumpReader(const std::string &path)
+    : path_{path}, data_{nullptr}, size_{0}, first_record_{0}, position_{0}, corrupt_{false} {
+}
+
+RtpDumpReader::~RtpDumpReader() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+bool RtpDumpReader::open() {
+  int fd = ::open(path_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    ELOG_ERROR("message: Could not open dump, path: %s", path_.c_str());
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(RtpDumpFileHeader)) {
+    ELOG_ERROR("message: Dump is too short, path: %s", path_.c_str());
+    ::close(fd);
+    return false;
+  }
+  size_ = file_stat.st_size;
+  void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    ELOG_ERROR("message: Could not map dump, path: %s", path_.c_str());
+    size_ = 0;
+    return false;
+  }
+  data_ = reinterpret_cast<const char*>(data);
+  madvise(data, size_, MADV_SEQUENTIAL);
+
+  const RtpDumpFileHeader *header = reinterpret_cast<const RtpDumpFileHeader*>(data_);
+  if (memcmp(header->magic, kRtpDumpMagic, sizeof(header->magic)) != 0 || header->version != kRtpDumpVersion) {
+    ELOG_ERROR("message: Not a supported dump, path: %s", path_.c_str());
+    return false;
+  }
+  first_record_ = sizeof(RtpDumpFileHeader) + paddedLength(header->metadata_length);
+  if (first_record_ > size_) {
+    ELOG_ERROR("message: Dump metadata is truncated, path: %s", path_.c_str());
+    return false;
+  }
+  std::string metadata(data_ + sizeof(RtpDumpFileHeader), header->metadata_length);
+  parseMetadata(metadata, &rtp_mappings_, &ext_mappings_);
+  position_ = first_record_;
+  return true;
+}
+
+bool RtpDumpReader::next(RtpDumpRecord *record) {
+  if (data_ == nullptr || corrupt_ || position_ == size_) {
+    return false;
+  }
+  if (position_ + sizeof(RtpDumpRecordHeader) > size_) {
+    return reportCorrupt("record header runs past the end of the dump");
+  }
+  const RtpDumpRecordHeader *header = reinterpret_cast<const RtpDumpRecordHeader*>(data_ + position_);
+  const char *packet = data_ + position_ + sizeof(RtpDumpRecordHeader);
+  if (header->length > sizeof(DataPacket::data)) {
+    return reportCorrupt("record is longer than a packet");
+  }
+  size_t record_end = position_ + sizeof(RtpDumpRecordHeader) + paddedLength(header->length);
+  if (record_end > size_) {
+    return reportCorrupt("record runs past the end of the dump");
+  }
+  if (header->length < kMinRtcpLength ||
+      (!reinterpret_cast<const RtcpHeader*>(packet)->isRtcp() && header->length < RtpHeader::MIN_SIZE)) {
+    return reportCorrupt("record is shorter than a RTP header");
+  }
+  record->type = static_cast<packetType>(header->type);
+  record->arrival_time_us = header->arrival_time_us;
+  record->data = packet;
+  record->length = header->length;
+  position_ = record_end;
+  return true;
+}
+
+bool RtpDumpReader::reportCorrupt(const char *reason) {
+  ELOG_ERROR("message: Dump is corrupt, reason: %s, offset: %zu, path: %s", reason, position_, path_.c_str());
+  corrupt_ = true;
+  return false;
+}
+
+void RtpDumpReader::rewind() {
+  position_ = first_record_;
+  corrupt_ = false;
+}
+
+void RtpDumpReader::parseMetadata(const std::string &metadata, std::vector<RtpMap> *rtp_mappings,
+                                  std::vector<ExtMap> *ext_mappings) {
+  std::istringstream lines(metadata);
+  std::string line;
+  MediaType media_type = VIDEO_TYPE;
+  while (std::getline(lines, line)) {
+    if (line.compare(0, 2, "m=") == 0) {
+      media_type = line.substr(2) == "audio" ? AUDIO_TYPE : VIDEO_TYPE;
+    } else if (line.compare(0, 9, "a=rtpmap:") == 0) {
+      RtpMap rtp_map;
+      char encoding_name[64];
+      unsigned int channels = 1;
+      if (sscanf(line.c_str(), "a=rtpmap:%u %63[^/]/%u/%u", &rtp_map.payload_type, encoding_name,  // NOLINT
+                 &rtp_map.clock_rate, &channels) < 3) {
+        continue;
+      }
+      rtp_map.encoding_name = encoding_name;
+      rtp_map.media_type = media_type;
+      rtp_map.channels = channels;
+      rtp_mappings->push_back(rtp_map);
+    } else if (line.compare(0, 7, "a=fmtp:") == 0) {
+      unsigned int payload_type = std::strtoul(line.c_str() + 7, nullptr, 10);
+      size_t space = line.find(' ');
+      auto rtp_map = std::find_if(rtp_mappings->begin(), rtp_mappings->end(), [payload_type](const RtpMap &map) {
+        return map.payload_type == payload_type;
+      });
+      if (space == std::string::npos || rtp_map == rtp_mappings->end()) {
+        continue;
+      }
+      std::istringstream parameters(line.substr(space + 1));
+      std::string parameter;
+      while (std::getline(parameters, parameter, ';')) {
+        size_t equal = parameter.find('=');
+        if (equal != std::string::npos) {
+          rtp_map->format_parameters[parameter.substr(0, equal)] = parameter.substr(equal + 1);
+        }
+      }
+    } else if (line.compare(0, 9, "a=extmap:") == 0) {
+      size_t space = line.find(' ');
+      if (space == std::string::npos) {
+        continue;
+      }
+      ExtMap ext_map(std::strtoul(line.c_str() + 9, nullptr, 10), line.substr(space + 1));
+      ext_map.mediaType = media_type;
+      ext_mappings->push_back(ext_map);
+    }
+  }
+}
+
+}  // namespace erizo
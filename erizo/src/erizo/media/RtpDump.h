@@ -0,0 +1,102 @@
+#ifndef ERIZO_SRC_ERIZO_MEDIA_RTPDUMP_H_
+#define ERIZO_SRC_ERIZO_MEDIA_RTPDUMP_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./logger.h"
+#include "./MediaDefinitions.h"
+#include "./SdpInfo.h"
+#include "media/RecordingFileWriter.h"
+
+namespace erizo {
+
+// Raw RTP dumps store the decrypted RTP and RTCP packets of a recording as they arrived, so we don't
+// depacketize or mux while the session is live. RtpDumpMuxer turns them into regular media files.
+//
+// Layout: RtpDumpFileHeader, the SDP-like metadata and then one record per packet. Every record is a
+// RtpDumpRecordHeader followed by the packet, padded to 8 bytes so the file can be mapped and read in
+// place. Numbers are stored in host byte order.
+static constexpr char kRtpDumpMagic[8] = {'E', 'R', 'T', 'P', 'D', 'U', 'M', 'P'};
+static constexpr uint32_t kRtpDumpVersion = 1;
+static constexpr char kRtpDumpExtension[] = ".rtpdump";
+
+struct RtpDumpFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t metadata_length;
+};
+
+struct RtpDumpRecordHeader {
+  uint32_t length;
+  uint8_t type;  // packetType
+  uint8_t reserved[3];
+  int64_t arrival_time_us;
+};
+
+struct RtpDumpRecord {
+  packetType type;
+  int64_t arrival_time_us;
+  const char *data;
+  uint32_t length;
+};
+
+class RtpDumpWriter {
+  DECLARE_LOGGER();
+
+ public:
+  RtpDumpWriter(const std::string &path, bool direct_io);
+
+  bool open(const std::vector<RtpMap> &rtp_mappings, const std::vector<ExtMap> &ext_mappings);
+  bool append(const DataPacket &packet, int64_t arrival_time_us);
+  bool close();
+
+  static std::string serializeMetadata(const std::vector<RtpMap> &rtp_mappings,
+                                       const std::vector<ExtMap> &ext_mappings);
+
+ private:
+  bool writePadded(const void *data, size_t length);
+
+ private:
+  RecordingFileWriter file_writer_;
+};
+
+class RtpDumpReader {
+  DECLARE_LOGGER();
+
+ public:
+  explicit RtpDumpReader(const std::string &path);
+  ~RtpDumpReader();
+
+  bool open();
+  // Returns false at the end of the dump. A record that can't be a packet, or that was cut short (e.g. the
+  // process died while recording), also ends the dump and marks it as corrupt.
+  bool next(RtpDumpRecord *record);
+  void rewind();
+  bool isCorrupt() const { return corrupt_; }
+
+  const std::vector<RtpMap>& getRtpMappings() const { return rtp_mappings_; }
+  const std::vector<ExtMap>& getExtMappings() const { return ext_mappings_; }
+
+  static void parseMetadata(const std::string &metadata, std::vector<RtpMap> *rtp_mappings,
+                            std::vector<ExtMap> *ext_mappings);
+
+ private:
+  bool reportCorrupt(const char *reason);
+
+ private:
+  std::string path_;
+  const char *data_;
+  size_t size_;
+  size_t first_record_;
+  size_t position_;
+  bool corrupt_;
+  std::vector<RtpMap> rtp_mappings_;
+  std::vector<ExtMap> ext_mappings_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_MEDIA_RTPDUMP_H_
@@ -0,0 +1,311 @@
+#include "media/RtpDumpMuxer.h"
+
+#include <string>
+
+#include "rtp/RtpHeaders.h"
+
+namespace erizo {
+
+DEFINE_LOGGER(RtpDumpMuxer, "media.RtpDumpMuxer");
+
+RtpDumpMuxer::RtpDumpMuxer(const std::string &input_path, const std::string &output_path)
+  : reader_{input_path}, output_path_{output_path}, context_{nullptr}, video_stream_{nullptr},
+    audio_stream_{nullptr}, header_written_{false}, audio_queue_{5.0, 10.0}, video_queue_{5.0, 10.0},
+    video_codec_{AV_CODEC_ID_NONE}, audio_codec_{AV_CODEC_ID_NONE}, first_arrival_time_us_{-1},
+    first_video_timestamp_{-1}, first_audio_timestamp_{-1}, video_offset_ms_{-1}, audio_offset_ms_{-1},
+    last_video_sequence_number_{0} {
+  av_register_all();
+  avcodec_register_all();
+}
+
+RtpDumpMuxer::~RtpDumpMuxer() {
+  close();
+}
+
+bool RtpDumpMuxer::run() {
+  if (!reader_.open()) {
+    return false;
+  }
+  for (const RtpMap &rtp_map : reader_.getRtpMappings()) {
+    if (rtp_map.media_type == AUDIO_TYPE) {
+      audio_maps_[rtp_map.payload_type] = rtp_map;
+    } else if (rtp_map.media_type == VIDEO_TYPE) {
+      video_maps_[rtp_map.payload_type] = rtp_map;
+    }
+  }
+  if (!findCodecs() || !initContext()) {
+    return false;
+  }
+
+  RtpDumpRecord record;
+  reader_.rewind();
+  while (reader_.next(&record)) {
+    pushPacket(record);
+    writeQueuedData(false);
+  }
+  // We're done, let's completely drain our queues of all data.
+  writeQueuedData(true);
+  close();
+  if (reader_.isCorrupt()) {
+    ELOG_ERROR("message: Muxed the dump up to a corrupt record, output: %s", output_path_.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool RtpDumpMuxer::findCodecs() {
+  // Dumps have every packet from the beginning, so we can pick the codecs before muxing anything
+  RtpDumpRecord record;
+  while (reader_.next(&record) && (video_codec_ == AV_CODEC_ID_NONE || audio_codec_ == AV_CODEC_ID_NONE)) {
+    const RtcpHeader *chead = reinterpret_cast<const RtcpHeader*>(record.data);
+    if (chead->isRtcp()) {
+      continue;
+    }
+    const RtpHeader *head = reinterpret_cast<const RtpHeader*>(record.data);
+    unsigned int payload_type = head->getPayloadType();
+    if (payload_type == RED_90000_PT && record.length > static_cast<uint32_t>(head->getHeaderLength())) {
+      payload_type = record.data[head->getHeaderLength()] & 0x7F;
+    }
+    auto video_map = video_maps_.find(payload_type);
+    if (video_codec_ == AV_CODEC_ID_NONE && video_map != video_maps_.end()) {
+      if (video_map->second.encoding_name == "VP8") {
+        depacketizer_.reset(new Vp8Depacketizer());
+        video_queue_.setFrameStartDetector(&Vp8Depacketizer::isFrameStart);
+        video_codec_ = AV_CODEC_ID_VP8;
+      } else if (video_map->second.encoding_name == "H264") {
+        depacketizer_.reset(new H264Depacketizer());
+        video_queue_.setFrameStartDetector(&H264Depacketizer::isFrameStart);
+        video_codec_ = AV_CODEC_ID_H264;
+      }
+      video_map_ = video_map->second;
+    }
+    auto audio_map = audio_maps_.find(payload_type);
+    if (audio_codec_ == AV_CODEC_ID_NONE && audio_map != audio_maps_.end()) {
+      if (audio_map->second.encoding_name == "opus") {
+        audio_codec_ = AV_CODEC_ID_OPUS;
+      } else if (audio_map->second.encoding_name == "PCMU") {
+        audio_codec_ = AV_CODEC_ID_PCM_MULAW;
+      }
+      audio_map_ = audio_map->second;
+    }
+  }
+  if (video_codec_ == AV_CODEC_ID_NONE && audio_codec_ == AV_CODEC_ID_NONE) {
+    ELOG_ERROR("message: No supported codec found in the dump");
+    return false;
+  }
+  return true;
+}
+
+bool RtpDumpMuxer::initContext() {
+  context_ = avformat_alloc_context();
+  if (context_ == nullptr) {
+    ELOG_ERROR("message: Error allocating memory for IO context");
+    return false;
+  }
+  output_path_.copy(context_->filename, sizeof(context_->filename), 0);
+  context_->oformat = av_guess_format(nullptr, context_->filename, nullptr);
+  if (!context_->oformat) {
+    ELOG_ERROR("message: Error guessing format %s", context_->filename);
+    return false;
+  }
+
+  if (video_codec_ != AV_CODEC_ID_NONE) {
+    AVCodec *video_codec = avcodec_find_encoder(video_codec_);
+    if (video_codec == nullptr) {
+      ELOG_ERROR("message: Could not find video codec");
+      return false;
+    }
+    video_queue_.setTimebase(video_map_.clock_rate);
+    video_stream_ = avformat_new_stream(context_, video_codec);
+    video_stream_->id = 0;
+    video_stream_->codec->codec_id = video_codec_;
+    video_stream_->codec->width = 640;
+    video_stream_->codec->height = 480;
+    video_stream_->time_base = (AVRational) { 1, 30 };
+    video_stream_->codec->pix_fmt = PIX_FMT_YUV420P;
+    if (context_->oformat->flags & AVFMT_GLOBALHEADER) {
+      video_stream_->codec->flags |= CODEC_FLAG_GLOBAL_HEADER;
+    }
+    context_->oformat->flags |= AVFMT_VARIABLE_FPS;
+  }
+
+  if (audio_codec_ != AV_CODEC_ID_NONE) {
+    AVCodec *audio_codec = avcodec_find_encoder(audio_codec_);
+    if (audio_codec == nullptr) {
+      ELOG_ERROR("message: Could not find audio codec");
+      return false;
+    }
+    if (video_stream_ == nullptr) {
+      // Matroska needs a video stream with global headers, see ExternalOutput::initContext
+      video_stream_ = avformat_new_stream(context_, nullptr);
+      video_stream_->codec->flags |= CODEC_FLAG_GLOBAL_HEADER;
+    }
+    audio_queue_.setTimebase(audio_map_.clock_rate);
+    audio_stream_ = avformat_new_stream(context_, audio_codec);
+    audio_stream_->id = 1;
+    audio_stream_->codec->codec_id = audio_codec_;
+    audio_stream_->codec->sample_rate = audio_map_.clock_rate;
+    audio_stream_->time_base = (AVRational) { 1, audio_stream_->codec->sample_rate };
+    audio_stream_->codec->channels = audio_map_.channels;
+    if (context_->oformat->flags & AVFMT_GLOBALHEADER) {
+      audio_stream_->codec->flags |= CODEC_FLAG_GLOBAL_HEADER;
+    }
+  }
+
+  if (avio_open(&context_->pb, context_->filename, AVIO_FLAG_WRITE) < 0) {
+    ELOG_ERROR("message: Error opening output file %s", context_->filename);
+    return false;
+  }
+  if (avformat_write_header(context_, nullptr) < 0) {
+    ELOG_ERROR("message: Error writing header");
+    return false;
+  }
+  header_written_ = true;
+  return true;
+}
+
+void RtpDumpMuxer::pushPacket(const RtpDumpRecord &record) {
+  const RtcpHeader *chead = reinterpret_cast<const RtcpHeader*>(record.data);
+  if (chead->isRtcp()) {
+    return;
+  }
+  if (first_arrival_time_us_ == -1) {
+    first_arrival_time_us_ = record.arrival_time_us;
+  }
+  long long offset_ms = (record.arrival_time_us - first_arrival_time_us_) / 1000;  // NOLINT
+  const RtpHeader *head = reinterpret_cast<const RtpHeader*>(record.data);
+
+  if (record.type == VIDEO_PACKET) {
+    if (video_stream_ == nullptr || video_codec_ == AV_CODEC_ID_NONE) {
+      return;
+    }
+    if (video_offset_ms_ == -1) {
+      video_offset_ms_ = offset_ms;
+    }
+    if (head->getPayloadType() == RED_90000_PT) {
+      if (!fec_receiver_) {
+        rtc::ArrayView<const webrtc::RtpExtension> empty_extensions;
+        fec_receiver_ = webrtc::UlpfecReceiver::Create(head->getSSRC(), this, empty_extensions);
+      }
+      webrtc::RtpPacketReceived red_packet;
+      red_packet.Parse(reinterpret_cast<const uint8_t*>(record.data), record.length);
+      if (0 == fec_receiver_->AddReceivedRedPacket(red_packet, ULP_90000_PT)) {
+        fec_receiver_->ProcessReceivedFec();
+      }
+    } else {
+      video_queue_.pushPacket(record.data, record.length);
+    }
+  } else if (record.type == AUDIO_PACKET) {
+    if (audio_stream_ == nullptr) {
+      return;
+    }
+    if (audio_offset_ms_ == -1) {
+      audio_offset_ms_ = offset_ms;
+    }
+    audio_queue_.pushPacket(record.data, record.length);
+  }
+}
+
+void RtpDumpMuxer::OnRecoveredPacket(const uint8_t *packet, size_t packet_length) {
+  video_queue_.pushPacket(reinterpret_cast<const char*>(packet), packet_length);
+}
+
+void RtpDumpMuxer::writeQueuedData(bool ignore_depth) {
+  while (ignore_depth ? audio_queue_.getSize() > 0 : audio_queue_.hasData()) {
+    boost::shared_ptr<DataPacket> audio_packet = audio_queue_.popPacket(ignore_depth);
+    writeAudioData(audio_packet->data, audio_packet->length);
+  }
+  while (ignore_depth ? video_queue_.getSize() > 0 : video_queue_.hasData()) {
+    boost::shared_ptr<DataPacket> video_packet = video_queue_.popPacket(ignore_depth);
+    writeVideoData(video_packet->data, video_packet->length);
+  }
+}
+
+void RtpDumpMuxer::writeAudioData(char *buf, int len) {
+  RtpHeader *head = reinterpret_cast<RtpHeader*>(buf);
+  if (audio_maps_.find(head->getPayloadType()) == audio_maps_.end()) {
+    return;
+  }
+  if (first_audio_timestamp_ == -1) {
+    first_audio_timestamp_ = head->getTimestamp();
+  }
+
+  long long current_timestamp = head->getTimestamp();  // NOLINT
+  if (current_timestamp - first_audio_timestamp_ < 0) {
+    // We only handle a single wrap around, that's 13 hours of recording, minimum.
+    current_timestamp += 0xFFFFFFFF;
+  }
+  long long timestamp_to_write = (current_timestamp - first_audio_timestamp_) /  // NOLINT
+                                    (audio_stream_->codec->sample_rate / audio_stream_->time_base.den);
+  timestamp_to_write += audio_offset_ms_ / (1000 / audio_stream_->time_base.den);
+
+  AVPacket av_packet;
+  av_init_packet(&av_packet);
+  av_packet.data = reinterpret_cast<uint8_t*>(buf) + head->getHeaderLength();
+  av_packet.size = len - head->getHeaderLength();
+  av_packet.pts = timestamp_to_write;
+  av_packet.stream_index = 1;
+  av_interleaved_write_frame(context_, &av_packet);
+}
+
+void RtpDumpMuxer::writeVideoData(char *buf, int len) {
+  RtpHeader *head = reinterpret_cast<RtpHeader*>(buf);
+  if (video_maps_.find(head->getPayloadType()) == video_maps_.end()) {
+    return;
+  }
+  uint16_t current_video_sequence_number = head->getSeqNumber();
+  if (first_video_timestamp_ != -1 && current_video_sequence_number != last_video_sequence_number_ + 1) {
+    // Restart the depacketizer so it looks for the start of a frame
+    depacketizer_->reset();
+  }
+  last_video_sequence_number_ = current_video_sequence_number;
+  if (first_video_timestamp_ == -1) {
+    first_video_timestamp_ = head->getTimestamp();
+  }
+
+  depacketizer_->fetchPacket(reinterpret_cast<unsigned char*>(buf), len);
+  if (!depacketizer_->processPacket()) {
+    return;
+  }
+
+  long long current_timestamp = head->getTimestamp();  // NOLINT
+  if (current_timestamp - first_video_timestamp_ < 0) {
+    current_timestamp += 0xFFFFFFFF;
+  }
+  long long timestamp_to_write = (current_timestamp - first_video_timestamp_) /  // NOLINT
+                                    (video_map_.clock_rate / video_stream_->time_base.den);
+  timestamp_to_write += video_offset_ms_ / (1000 / video_stream_->time_base.den);
+
+  AVPacket av_packet;
+  av_init_packet(&av_packet);
+  av_packet.data = depacketizer_->frame();
+  av_packet.size = depacketizer_->frameSize();
+  av_packet.pts = timestamp_to_write;
+  av_packet.stream_index = 0;
+  av_interleaved_write_frame(context_, &av_packet);
+  depacketizer_->reset();
+}
+
+void RtpDumpMuxer::close() {
+  if (context_ == nullptr) {
+    return;
+  }
+  if (header_written_) {
+    av_write_trailer(context_);
+  }
+  if (video_stream_ && video_stream_->codec != nullptr) {
+    avcodec_close(video_stream_->codec);
+  }
+  if (audio_stream_ && audio_stream_->codec != nullptr) {
+    avcodec_close(audio_stream_->codec);
+  }
+  if (context_->pb != nullptr) {
+    avio_close(context_->pb);
+  }
+  avformat_free_context(context_);
+  context_ = nullptr;
+  video_stream_ = nullptr;
+  audio_stream_ = nullptr;
+}
+
+}  // namespace erizo
@@ -0,0 +1,71 @@
+#ifndef ERIZO_SRC_ERIZO_MEDIA_RTPDUMPMUXER_H_
+#define ERIZO_SRC_ERIZO_MEDIA_RTPDUMPMUXER_H_
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "./logger.h"
+#include "./SdpInfo.h"
+#include "media/Depacketizer.h"
+#include "media/RtpDump.h"
+#include "rtp/RtpPacketQueue.h"
+#include "webrtc/modules/rtp_rtcp/include/ulpfec_receiver.h"
+
+namespace erizo {
+
+// Turns a raw RTP dump recorded by ExternalOutput into a media file (webm, mp4...) offline. It
+// depacketizes and timestamps like ExternalOutput does live, but uses the recorded arrival times
+// to align audio and video.
+class RtpDumpMuxer : public webrtc::RecoveredPacketReceiver {
+  DECLARE_LOGGER();
+
+ public:
+  RtpDumpMuxer(const std::string &input_path, const std::string &output_path);
+  virtual ~RtpDumpMuxer();
+
+  bool run();
+
+  // webrtc::RecoveredPacketReceiver, for packets recovered from RED/ULPFEC
+  void OnRecoveredPacket(const uint8_t *packet, size_t packet_length) override;
+
+ private:
+  bool findCodecs();
+  bool initContext();
+  void pushPacket(const RtpDumpRecord &record);
+  void writeQueuedData(bool ignore_depth);
+  void writeAudioData(char *buf, int len);
+  void writeVideoData(char *buf, int len);
+  void close();
+
+ private:
+  RtpDumpReader reader_;
+  std::string output_path_;
+  AVFormatContext *context_;
+  AVStream *video_stream_, *audio_stream_;
+  bool header_written_;
+  RtpPacketQueue audio_queue_, video_queue_;
+  std::unique_ptr<webrtc::UlpfecReceiver> fec_receiver_;
+  std::unique_ptr<Depacketizer> depacketizer_;
+  std::map<uint, RtpMap> video_maps_;
+  std::map<uint, RtpMap> audio_maps_;
+  RtpMap video_map_;
+  RtpMap audio_map_;
+  enum AVCodecID video_codec_;
+  enum AVCodecID audio_codec_;
+  int64_t first_arrival_time_us_;
+  long long first_video_timestamp_;  // NOLINT
+  long long first_audio_timestamp_;  // NOLINT
+  long long video_offset_ms_;  // NOLINT
+  long long audio_offset_ms_;  // NOLINT
+  uint16_t last_video_sequence_number_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_MEDIA_RTPDUMPMUXER_H_
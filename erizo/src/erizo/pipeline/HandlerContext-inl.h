@@ -11,6 +11,7 @@
 #define ERIZO_SRC_ERIZO_PIPELINE_HANDLERCONTEXT_INL_H_
 
 #include "./MediaDefinitions.h"
+#include "stats/Metrics.h"
 
 namespace erizo {
 
@@ -73,6 +74,7 @@ class ContextImplBase : public PipelineContext {
     pipelineWeak_ = pipeline;
     pipelineRaw_ = pipeline.lock().get();
     handler_ = std::move(handler);
+    metric_index_ = MetricsRegistry::instance().handlerIndex(handler_->getName());
   }
 
   void notifyUpdate() override {
@@ -142,6 +144,7 @@ class ContextImplBase : public PipelineContext {
   std::shared_ptr<H> handler_;
   InboundLink* nextIn_{nullptr};
   OutboundLink* nextOut_{nullptr};
+  size_t metric_index_{kMaxHandlerMetrics - 1};
 
  private:
   bool attached_{false};
@@ -224,6 +227,7 @@ class ContextImpl
   // InboundLink overrides
   void read(std::shared_ptr<DataPacket> packet) override {
     auto guard = this->pipelineWeak_.lock();
+    WorkerMetrics::current().countHandlerPacket(this->metric_index_);
     this->handler_->read(this, std::move(packet));
   }
 
@@ -245,6 +249,7 @@ class ContextImpl
   // OutboundLink overrides
   void write(std::shared_ptr<DataPacket> packet) override {
     auto guard = this->pipelineWeak_.lock();
+    WorkerMetrics::current().countHandlerPacket(this->metric_index_);
     this->handler_->write(this, std::move(packet));
   }
 
@@ -316,6 +321,7 @@ class InboundContextImpl
   // InboundLink overrides
   void read(std::shared_ptr<DataPacket> packet) override {
     auto guard = this->pipelineWeak_.lock();
+    WorkerMetrics::current().countHandlerPacket(this->metric_index_);
     this->handler_->read(this, std::move(packet));
   }
 
@@ -383,6 +389,7 @@ class OutboundContextImpl
   // OutboundLink overrides
   void write(std::shared_ptr<DataPacket> packet) override {
     auto guard = this->pipelineWeak_.lock();
+    WorkerMetrics::current().countHandlerPacket(this->metric_index_);
     return this->handler_->write(this, std::move(packet));
   }
 
@@ -69,12 +69,12 @@ void FakeKeyframeGeneratorHandler::write(Context *ctx, std::shared_ptr<DataPacke
 
 std::shared_ptr<DataPacket> FakeKeyframeGeneratorHandler::transformIntoKeyframePacket
   (std::shared_ptr<DataPacket> packet) {
-    if (packet->codec == "VP8") {
+    if (packet->codec == StringInterner::kVP8Id) {
       auto keyframe_packet = RtpUtils::makeVP8BlackKeyframePacket(packet);
       packet->is_keyframe = true;
       return keyframe_packet;
     } else {
-      ELOG_DEBUG("Generate keyframe packet is not available for codec %s", packet->codec);
+      ELOG_DEBUG("Generate keyframe packet is not available for codec %s", packet->getCodecName().c_str());
       return packet;
     }
   }
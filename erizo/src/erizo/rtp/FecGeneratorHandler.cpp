@@ -0,0 +1,243 @@
+#include "rtp/FecGeneratorHandler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <utility>
+
+#include "./MediaDefinitions.h"
+#include "./MediaStream.h"
+#include "lib/PacketPool.h"
+#include "rtp/RtpUtils.h"
+#include "webrtc/modules/include/module_fec_types.h"
+
+namespace erizo {
+
+DEFINE_LOGGER(FecGeneratorHandler, "rtp.FecGeneratorHandler");
+
+constexpr double kLossToProtection = 2.;
+constexpr double kLossSmoothing = 0.5;
+constexpr size_t kMaxMediaPacketsPerFec = 48;
+constexpr size_t kRedHeaderLength = 1;
+constexpr duration kTimeToUpdateBudget = std::chrono::milliseconds(500);
+constexpr double kBudgetShare = 0.2;
+constexpr uint64_t kDefaultBitrate = 300000;
+constexpr uint64_t kMinBudgetBurstSize = 1500;
+constexpr uint64_t kBudgetBurstsPerSecond = 10;  // the FEC of a few frames can be sent at once
+
+FecGeneratorHandler::FecGeneratorHandler(std::shared_ptr<Clock> the_clock)
+  : clock_{the_clock}, stream_{nullptr}, enabled_{true}, negotiated_{false}, first_packet_received_{false},
+    highest_seq_num_{0}, red_payload_type_{0}, ulpfec_payload_type_{0},
+    max_protection_factor_{0}, protection_factor_{0}, fraction_lost_{0.}, video_sink_ssrc_{0},
+    budget_bitrate_{0}, bucket_{clock_},
+    last_budget_update_{clock_->now()} {
+  resetBudget(kDefaultBitrate);
+}
+
+void FecGeneratorHandler::enable() {
+  enabled_ = true;
+}
+
+void FecGeneratorHandler::disable() {
+  enabled_ = false;
+  media_packets_.clear();
+}
+
+void FecGeneratorHandler::notifyUpdate() {
+  auto pipeline = getContext()->getPipelineShared();
+  if (pipeline && !stream_) {
+    stream_ = pipeline->getService<MediaStream>().get();
+    stats_ = pipeline->getService<Stats>();
+    stats_->getNode()["total"].insertStat("fecBitrate",
+        MovingIntervalRateStat{std::chrono::milliseconds(100), 30, 8., clock_});
+  }
+  if (!stream_ || !stats_) {
+    return;
+  }
+  video_sink_ssrc_ = stream_->getVideoSinkSSRC();
+  max_protection_factor_ = std::min<uint32_t>(stream_->getMaxFecOverhead(), 100) * 255 / 100;
+  std::shared_ptr<SdpInfo> remote_sdp = stream_->getRemoteSdpInfo();
+  bool negotiated = remote_sdp && !stream_->isSlideShowModeEnabled() &&
+      remote_sdp->supportPayloadType(RED_90000_PT) && remote_sdp->supportPayloadType(ULP_90000_PT);
+  if (negotiated) {
+    red_payload_type_ = remote_sdp->getVideoExternalPT(RED_90000_PT);
+    ulpfec_payload_type_ = remote_sdp->getVideoExternalPT(ULP_90000_PT);
+  }
+  if (negotiated != negotiated_) {
+    media_packets_.clear();
+  }
+  negotiated_ = negotiated;
+  updateProtectionFactor();
+}
+
+void FecGeneratorHandler::read(Context *ctx, std::shared_ptr<DataPacket> packet) {
+  RtcpHeader *chead = reinterpret_cast<RtcpHeader*>(packet->data);
+  if (negotiated_ && chead->isRtcp()) {
+    RtpUtils::forEachRtcpBlock(packet, [this](RtcpHeader *block) {
+      if (block->isReceiverReport() && block->getSourceSSRC() == video_sink_ssrc_) {
+        onFractionLost(block->getFractionLost());
+      }
+    });
+  }
+  ctx->fireRead(std::move(packet));
+}
+
+void FecGeneratorHandler::onFractionLost(uint8_t fraction_lost) {
+  fraction_lost_ = kLossSmoothing * fraction_lost_ + (1 - kLossSmoothing) * fraction_lost;
+  updateProtectionFactor();
+}
+
+void FecGeneratorHandler::updateProtectionFactor() {
+  uint32_t rtt_ms = stream_ ? stream_->getRtt() : 0;
+  if (fraction_lost_ < kMinFractionLost || rtt_ms < kMinRttMs) {
+    // NACKs arrive in time or there is nothing to protect from
+    protection_factor_ = 0;
+    return;
+  }
+  double protection = fraction_lost_ * kLossToProtection;
+  if (rtt_ms < kFullProtectionRttMs) {
+    protection *= static_cast<double>(rtt_ms - kMinRttMs) / (kFullProtectionRttMs - kMinRttMs);
+  }
+  protection_factor_ = static_cast<uint8_t>(std::min<double>(protection, max_protection_factor_));
+}
+
+void FecGeneratorHandler::updateBudget() {
+  time_point now = clock_->now();
+  if (now - last_budget_update_ < kTimeToUpdateBudget) {
+    return;
+  }
+  last_budget_update_ = now;
+  StatNode &total = stats_->getNode()["total"];
+  uint64_t bitrate = kDefaultBitrate;
+  if (total.hasChild("senderBitrateEstimation")) {
+    bitrate = total["senderBitrateEstimation"].value();
+  } else if (total.hasChild("bitrateCalculated")) {
+    bitrate = total["bitrateCalculated"].value();
+  }
+  resetBudget(bitrate);
+}
+
+void FecGeneratorHandler::resetBudget(uint64_t bitrate) {
+  if (bitrate == budget_bitrate_) {
+    return;
+  }
+  budget_bitrate_ = bitrate;
+  uint64_t bytes_per_second = bitrate * kBudgetShare / 8;
+  bucket_.reset(bytes_per_second, std::max(kMinBudgetBurstSize, bytes_per_second / kBudgetBurstsPerSecond));
+}
+
+void FecGeneratorHandler::write(Context *ctx, std::shared_ptr<DataPacket> packet) {
+  RtcpHeader *chead = reinterpret_cast<RtcpHeader*>(packet->data);
+  if (packet->type != VIDEO_PACKET || chead->isRtcp()) {
+    ctx->fireWrite(std::move(packet));
+    return;
+  }
+  // Every packet goes through the translator so the sequence numbers taken by FEC packets stay consistent
+  RtpHeader *head = reinterpret_cast<RtpHeader*>(packet->data);
+  uint16_t seq_num = head->getSeqNumber();
+  head->setSeqNumber(translator_.get(seq_num, false).output);
+  bool is_new = !first_packet_received_ || RtpUtils::sequenceNumberLessThan(highest_seq_num_, seq_num);
+  if (is_new) {
+    highest_seq_num_ = seq_num;
+    first_packet_received_ = true;
+  }
+  if (!enabled_ || !negotiated_ || head->getPayloadType() == red_payload_type_) {
+    ctx->fireWrite(std::move(packet));
+    return;
+  }
+  // Every packet is sent as RED once it is negotiated, so the payload type does not change with the protection
+  bool protecting = is_new && (protection_factor_ > 0 || !media_packets_.empty());
+  if (!encapsulate(packet, protecting) || !protecting) {
+    ctx->fireWrite(std::move(packet));
+    return;
+  }
+  if (head->getMarker() || media_packets_.size() == kMaxMediaPacketsPerFec) {
+    std::shared_ptr<DataPacket> last_packet = packet;
+    ctx->fireWrite(std::move(packet));
+    sendFecPackets(*last_packet);
+    return;
+  }
+  ctx->fireWrite(std::move(packet));
+}
+
+std::shared_ptr<DataPacket> FecGeneratorHandler::createRedPacket(const DataPacket &packet, const uint8_t *payload,
+    size_t payload_length, uint8_t block_payload_type) {
+  const RtpHeader *head = reinterpret_cast<const RtpHeader*>(packet.data);
+  size_t header_length = head->getHeaderLength();
+  if (header_length + kRedHeaderLength + payload_length > sizeof(packet.data)) {
+    return std::shared_ptr<DataPacket>();
+  }
+  std::shared_ptr<DataPacket> red_packet = PacketPool::clone(packet);
+  RtpHeader *red_head = reinterpret_cast<RtpHeader*>(red_packet->data);
+  red_head->setPayloadType(red_payload_type_);
+  red_head->setPadding(0);
+  // RFC 2198 header of a single primary block: F bit unset and the block payload type
+  red_packet->data[header_length] = block_payload_type & 0x7f;
+  memcpy(red_packet->data + header_length + kRedHeaderLength, payload, payload_length);
+  red_packet->length = header_length + kRedHeaderLength + payload_length;
+  return red_packet;
+}
+
+bool FecGeneratorHandler::encapsulate(const std::shared_ptr<DataPacket> &packet, bool protect) {
+  RtpHeader *head = reinterpret_cast<RtpHeader*>(packet->data);
+  size_t header_length = head->getHeaderLength();
+  size_t length = packet->length;
+  if (head->hasPadding()) {
+    length -= static_cast<uint8_t>(packet->data[length - 1]);
+  }
+  if (length <= header_length) {
+    // Padding only packets have no block to encapsulate, they just take the RED payload type
+    head->setPayloadType(red_payload_type_);
+    return false;
+  }
+  if (length + kRedHeaderLength > sizeof(packet->data)) {
+    return false;
+  }
+  head->setPadding(0);
+  if (protect) {
+    // FEC protects the packet as the subscriber will see it after removing the RED header, with no padding
+    auto media_packet = std::make_unique<webrtc::ForwardErrorCorrection::Packet>();
+    media_packet->data.SetData(reinterpret_cast<const uint8_t*>(packet->data), length);
+    media_packets_.push_back(std::move(media_packet));
+  }
+
+  char *payload = packet->data + header_length;
+  memmove(payload + kRedHeaderLength, payload, length - header_length);
+  payload[0] = head->getPayloadType() & 0x7f;
+  head->setPayloadType(red_payload_type_);
+  packet->length = length + kRedHeaderLength;
+  return true;
+}
+
+void FecGeneratorHandler::sendFecPackets(const DataPacket &last_packet) {
+  webrtc::ForwardErrorCorrection::PacketList media_packets;
+  media_packets.swap(media_packets_);
+  if (protection_factor_ == 0) {
+    return;
+  }
+  if (!fec_) {
+    fec_ = webrtc::ForwardErrorCorrection::CreateUlpfec(video_sink_ssrc_);
+  }
+  std::list<webrtc::ForwardErrorCorrection::Packet*> fec_packets;
+  const RtpHeader *last_head = reinterpret_cast<const RtpHeader*>(last_packet.data);
+  webrtc::FecMaskType mask_type = last_head->getMarker() ? webrtc::kFecMaskBursty : webrtc::kFecMaskRandom;
+  if (fec_->EncodeFec(media_packets, protection_factor_, 0, false, mask_type, &fec_packets) != 0) {
+    ELOG_DEBUG("%s message: Could not generate FEC packets", stream_->toLog());
+    return;
+  }
+  updateBudget();
+  for (webrtc::ForwardErrorCorrection::Packet *fec_packet : fec_packets) {
+    std::shared_ptr<DataPacket> red_packet = createRedPacket(last_packet, fec_packet->data.cdata(),
+        fec_packet->data.size(), ulpfec_payload_type_);
+    if (!red_packet || !bucket_.consume(red_packet->length)) {
+      return;
+    }
+    RtpHeader *head = reinterpret_cast<RtpHeader*>(red_packet->data);
+    head->setMarker(0);
+    head->setSeqNumber(translator_.generate().output);
+    stats_->getNode()["total"]["fecBitrate"] += red_packet->length;
+    getContext()->fireWrite(std::move(red_packet));
+  }
+}
+
+}  // namespace erizo
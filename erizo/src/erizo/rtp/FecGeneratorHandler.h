@@ -0,0 +1,85 @@
+#ifndef ERIZO_SRC_ERIZO_RTP_FECGENERATORHANDLER_H_
+#define ERIZO_SRC_ERIZO_RTP_FECGENERATORHANDLER_H_
+
+#include <memory>
+#include <string>
+
+#include "./logger.h"
+#include "pipeline/Handler.h"
+#include "lib/Clock.h"
+#include "lib/TokenBucket.h"
+#include "rtp/SequenceNumberTranslator.h"
+#include "./Stats.h"
+#include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
+
+namespace erizo {
+
+class MediaStream;
+
+/**
+ * Protects the video sent to a subscriber with ULPFEC (RFC 5109) carried in RED (RFC 2198) when the
+ * subscriber negotiated both. Every video packet is sent as RED then, and the FEC packets of every frame
+ * follow its last packet, taking sequence numbers the way padding does. It sits on the wire side of the padding
+ * generator so FEC refers to the sequence numbers the subscriber receives.
+ * The protection follows the fraction lost reported by the subscriber and is only used when the RTT makes
+ * NACKs slow, within the maximum overhead of the stream and a share of its bandwidth estimation.
+ */
+class FecGeneratorHandler : public Handler {
+  DECLARE_LOGGER();
+
+ public:
+  static constexpr uint8_t kMinFractionLost = 3;  // ~1%
+  static constexpr uint32_t kMinRttMs = 20;
+  static constexpr uint32_t kFullProtectionRttMs = 100;
+
+  explicit FecGeneratorHandler(std::shared_ptr<Clock> the_clock = std::make_shared<SteadyClock>());
+
+  void enable() override;
+  void disable() override;
+
+  std::string getName() override {
+    return "fec-generator";
+  }
+
+  void read(Context *ctx, std::shared_ptr<DataPacket> packet) override;
+  void write(Context *ctx, std::shared_ptr<DataPacket> packet) override;
+  void notifyUpdate() override;
+
+  // FEC overhead in the [0, 255] domain, where 255 means as many FEC packets as media packets
+  uint8_t getProtectionFactor() const { return protection_factor_; }
+
+ private:
+  void onFractionLost(uint8_t fraction_lost);
+  void updateProtectionFactor();
+  void updateBudget();
+  void resetBudget(uint64_t bitrate);
+  std::shared_ptr<DataPacket> createRedPacket(const DataPacket &packet, const uint8_t *payload,
+      size_t payload_length, uint8_t block_payload_type);
+  bool encapsulate(const std::shared_ptr<DataPacket> &packet, bool protect);
+  void sendFecPackets(const DataPacket &last_packet);
+
+ private:
+  std::shared_ptr<Clock> clock_;
+  MediaStream *stream_;
+  std::shared_ptr<Stats> stats_;
+  bool enabled_;
+  bool negotiated_;
+  bool first_packet_received_;
+  uint16_t highest_seq_num_;
+  uint8_t red_payload_type_;
+  uint8_t ulpfec_payload_type_;
+  uint8_t max_protection_factor_;
+  uint8_t protection_factor_;
+  double fraction_lost_;
+  uint32_t video_sink_ssrc_;
+  SequenceNumberTranslator translator_;
+  std::unique_ptr<webrtc::ForwardErrorCorrection> fec_;
+  webrtc::ForwardErrorCorrection::PacketList media_packets_;
+  uint64_t budget_bitrate_;
+  TokenBucket bucket_;
+  time_point last_budget_update_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_RTP_FECGENERATORHANDLER_H_
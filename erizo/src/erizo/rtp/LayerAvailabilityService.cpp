@@ -0,0 +1,90 @@
+#include "rtp/LayerAvailabilityService.h"
+
+#include <algorithm>
+
+#include "rtp/LayerBitrateCalculationHandler.h"
+#include "rtp/QualityManager.h"
+
+namespace erizo {
+
+DEFINE_LOGGER(LayerAvailabilityService, "rtp.LayerAvailabilityService");
+
+uint64_t LayerAvailability::getLayerBitrate(const std::vector<std::vector<uint64_t>> &layer_bitrates,
+    int spatial_layer, int temporal_layer) {
+  if (spatial_layer < 0 || static_cast<size_t>(spatial_layer) >= layer_bitrates.size() ||
+      temporal_layer < 0 || static_cast<size_t>(temporal_layer) >= layer_bitrates[spatial_layer].size()) {
+    return 0;
+  }
+  return layer_bitrates[spatial_layer][temporal_layer];
+}
+
+LayerAvailabilityService::LayerAvailabilityService(std::shared_ptr<Clock> the_clock)
+  : clock_{the_clock}, max_seen_spatial_layer_{-1}, max_seen_temporal_layer_{-1},
+  last_update_{the_clock->now()} {}
+
+void LayerAvailabilityService::onVideoPacket(const DataPacket &packet) {
+  time_point now = clock_->now();
+  packet.compatible_spatial_layers.forEach([this, &packet, now](int spatial_layer) {
+    if (spatial_layer >= kMaxLayers) {
+      return;
+    }
+    packet.compatible_temporal_layers.forEach([this, &packet, now, spatial_layer](int temporal_layer) {
+      if (temporal_layer >= kMaxLayers) {
+        return;
+      }
+      std::unique_ptr<MovingIntervalRateStat> &layer_stat = layer_stats_[spatial_layer][temporal_layer];
+      if (!layer_stat) {
+        layer_stat.reset(new MovingIntervalRateStat{kLayerRateStatIntervalSize, kLayerRateStatIntervals, 8., clock_});
+        max_seen_spatial_layer_ = std::max(max_seen_spatial_layer_, spatial_layer);
+        max_seen_temporal_layer_ = std::max(max_seen_temporal_layer_, temporal_layer);
+      }
+      layer_stat->add(packet.length, now);
+    });
+  });
+}
+
+std::shared_ptr<const LayerAvailability> LayerAvailabilityService::maybeUpdate() {
+  time_point now = clock_->now();
+  if (max_seen_spatial_layer_ < 0 || now - last_update_ <= QualityManager::kActiveLayerInterval) {
+    return nullptr;
+  }
+  last_update_ = now;
+
+  auto availability = std::make_shared<LayerAvailability>();
+  size_t spatial_layers = max_seen_spatial_layer_ + 1;
+  size_t temporal_layers = max_seen_temporal_layer_ + 1;
+  availability->bitrates.assign(spatial_layers, std::vector<uint64_t>(temporal_layers, 0));
+  availability->instant_bitrates.assign(spatial_layers, std::vector<uint64_t>(temporal_layers, 0));
+  availability->max_bitrates.assign(spatial_layers, std::vector<uint64_t>(temporal_layers, 0));
+  for (size_t spatial_layer = 0; spatial_layer < spatial_layers; spatial_layer++) {
+    for (size_t temporal_layer = 0; temporal_layer < temporal_layers; temporal_layer++) {
+      MovingIntervalRateStat *layer_stat = layer_stats_[spatial_layer][temporal_layer].get();
+      if (!layer_stat) {
+        continue;
+      }
+      availability->bitrates[spatial_layer][temporal_layer] = layer_stat->value();
+      availability->instant_bitrates[spatial_layer][temporal_layer] =
+        layer_stat->value(QualityManager::kActiveLayerInterval);
+      availability->max_bitrates[spatial_layer][temporal_layer] =
+        layer_stat->maxValueForIntervalSize(std::chrono::milliseconds(1000));
+    }
+  }
+
+  int max_active_spatial_layer = max_seen_spatial_layer_;
+  int max_active_temporal_layer = max_seen_temporal_layer_;
+  for (; max_active_spatial_layer > 0; max_active_spatial_layer--) {
+    if (availability->instant_bitrates[max_active_spatial_layer][0] > 0) {
+      break;
+    }
+  }
+  for (; max_active_temporal_layer > 0; max_active_temporal_layer--) {
+    if (availability->instant_bitrates[max_active_spatial_layer][max_active_temporal_layer] > 0) {
+      break;
+    }
+  }
+  availability->max_active_spatial_layer = max_active_spatial_layer;
+  availability->max_active_temporal_layer = max_active_temporal_layer;
+  return availability;
+}
+
+}  // namespace erizo
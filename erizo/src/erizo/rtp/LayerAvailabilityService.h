@@ -0,0 +1,68 @@
+#ifndef ERIZO_SRC_ERIZO_RTP_LAYERAVAILABILITYSERVICE_H_
+#define ERIZO_SRC_ERIZO_RTP_LAYERAVAILABILITYSERVICE_H_
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./logger.h"
+#include "./MediaDefinitions.h"
+#include "lib/Clock.h"
+#include "stats/StatNode.h"
+
+namespace erizo {
+
+/**
+ * Active layers and bitrates of a publisher, computed once and shared by all its subscribers.
+ * Bitrates are indexed by spatial and then temporal layer.
+ */
+struct LayerAvailability {
+  int max_active_spatial_layer = 0;
+  int max_active_temporal_layer = 0;
+  std::vector<std::vector<uint64_t>> bitrates;
+  std::vector<std::vector<uint64_t>> instant_bitrates;
+  std::vector<std::vector<uint64_t>> max_bitrates;
+
+  static uint64_t getLayerBitrate(const std::vector<std::vector<uint64_t>> &layer_bitrates,
+      int spatial_layer, int temporal_layer);
+};
+
+class LayerAvailabilityChangedEvent : public MediaEvent {
+ public:
+  explicit LayerAvailabilityChangedEvent(std::shared_ptr<const LayerAvailability> availability_)
+    : availability{availability_} {}
+
+  std::string getType() const override {
+    return "LayerAvailabilityChangedEvent";
+  }
+  std::shared_ptr<const LayerAvailability> availability;
+};
+
+/**
+ * Measures the bitrate of every layer of a publisher and periodically builds its LayerAvailability,
+ * so subscribers only have to select their own layers. It is used from the publisher thread.
+ */
+class LayerAvailabilityService {
+  DECLARE_LOGGER();
+
+ public:
+  static constexpr int kMaxLayers = 6;
+
+  explicit LayerAvailabilityService(std::shared_ptr<Clock> the_clock = std::make_shared<SteadyClock>());
+
+  void onVideoPacket(const DataPacket &packet);
+  // Returns a new availability every update interval, nullptr otherwise or when there are no layers
+  std::shared_ptr<const LayerAvailability> maybeUpdate();
+
+ private:
+  std::shared_ptr<Clock> clock_;
+  std::array<std::array<std::unique_ptr<MovingIntervalRateStat>, kMaxLayers>, kMaxLayers> layer_stats_;
+  int max_seen_spatial_layer_;
+  int max_seen_temporal_layer_;
+  time_point last_update_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_RTP_LAYERAVAILABILITYSERVICE_H_
@@ -25,21 +25,22 @@ void LayerBitrateCalculationHandler::write(Context *ctx, std::shared_ptr<DataPac
     return;
   }
 
-  std::for_each(packet->compatible_spatial_layers.begin(),
-      packet->compatible_spatial_layers.end(), [this, packet](int &layer_num){
-        std::string spatial_layer_name = std::to_string(layer_num);
-        std::for_each(packet->compatible_temporal_layers.begin(),
-          packet->compatible_temporal_layers.end(), [this, packet, spatial_layer_name](int &layer_num){
-            std::string temporal_layer_name = std::to_string(layer_num);
-            if (!stats_->getNode()[kQualityLayersStatsKey][spatial_layer_name].hasChild(temporal_layer_name)) {
-              stats_->getNode()[kQualityLayersStatsKey][spatial_layer_name].insertStat(
-                  temporal_layer_name, MovingIntervalRateStat{kLayerRateStatIntervalSize,
-                  kLayerRateStatIntervals, 8.});
-            } else {
-              stats_->getNode()[kQualityLayersStatsKey][spatial_layer_name][temporal_layer_name]+=packet->length;
-            }
-          });
+  // Layer bitrates are measured once by the publisher when it shares them with its subscribers
+  if (!quality_manager_->hasSharedLayerAvailability()) {
+    packet->compatible_spatial_layers.forEach([this, packet](int layer_num){
+      std::string spatial_layer_name = std::to_string(layer_num);
+      packet->compatible_temporal_layers.forEach([this, packet, spatial_layer_name](int layer_num){
+        std::string temporal_layer_name = std::to_string(layer_num);
+        if (!stats_->getNode()[kQualityLayersStatsKey][spatial_layer_name].hasChild(temporal_layer_name)) {
+          stats_->getNode()[kQualityLayersStatsKey][spatial_layer_name].insertStat(
+              temporal_layer_name, MovingIntervalRateStat{kLayerRateStatIntervalSize,
+              kLayerRateStatIntervals, 8.});
+        } else {
+          stats_->getNode()[kQualityLayersStatsKey][spatial_layer_name][temporal_layer_name]+=packet->length;
+        }
       });
+    });
+  }
   quality_manager_->notifyQualityUpdate();
   ctx->fireWrite(std::move(packet));
 }
@@ -35,11 +35,11 @@ void LayerDetectorHandler::disable() {
 void LayerDetectorHandler::read(Context *ctx, std::shared_ptr<DataPacket> packet) {
   RtcpHeader *chead = reinterpret_cast<RtcpHeader*>(packet->data);
   if (!chead->isRtcp() && enabled_ && packet->type == VIDEO_PACKET) {
-    if (packet->codec == "VP8") {
+    if (packet->codec == StringInterner::kVP8Id) {
       parseLayerInfoFromVP8(packet);
-    } else if (packet->codec == "VP9") {
+    } else if (packet->codec == StringInterner::kVP9Id) {
       parseLayerInfoFromVP9(packet);
-    } else if (packet->codec == "H264") {
+    } else if (packet->codec == StringInterner::kH264Id) {
       parseLayerInfoFromH264(packet);
     }
   }
@@ -77,15 +77,16 @@ void LayerDetectorHandler::parseLayerInfoFromVP8(std::shared_ptr<DataPacket> pac
   RtpHeader *rtp_header = reinterpret_cast<RtpHeader*>(packet->data);
   unsigned char* start_buffer = reinterpret_cast<unsigned char*> (packet->data);
   start_buffer = start_buffer + rtp_header->getHeaderLength();
-  RTPPayloadVP8* payload = vp8_parser_.parseVP8(
-      start_buffer, packet->length - rtp_header->getHeaderLength());
+  RTPPayloadVP8 vp8_payload;
+  RTPPayloadVP8* payload = &vp8_payload;
+  vp8_parser_.parseVP8(start_buffer, packet->length - rtp_header->getHeaderLength(), payload);
   if (payload->hasPictureID) {
     packet->picture_id = payload->pictureID;
   }
   if (payload->hasTl0PicIdx) {
     packet->tl0_pic_idx = payload->tl0PicIdx;
   }
-  packet->compatible_temporal_layers = {};
+  packet->compatible_temporal_layers.clear();
   switch (payload->tID) {
     case 0: addTemporalLayerAndCalculateRate(packet, 0, payload->beginningOfPartition);
     case 1: addTemporalLayerAndCalculateRate(packet, 1, payload->beginningOfPartition);
@@ -97,7 +98,7 @@ void LayerDetectorHandler::parseLayerInfoFromVP8(std::shared_ptr<DataPacket> pac
       break;
   }
 
-  int position = std::max(stoi(packet->rid) - 1, 0);
+  int position = std::max(packet->rid - 1, 0);
   packet->compatible_spatial_layers = {position};
   if (!payload->frameType) {
     packet->is_keyframe = true;
@@ -111,7 +112,6 @@ void LayerDetectorHandler::parseLayerInfoFromVP8(std::shared_ptr<DataPacket> pac
     notifyLayerInfoChangedEvent();
   }
   notifyLayerInfoChangedEventMaybe();
-  delete payload;
 }
 
 void LayerDetectorHandler::addTemporalLayerAndCalculateRate(const std::shared_ptr<DataPacket> &packet,
@@ -119,15 +119,16 @@ void LayerDetectorHandler::addTemporalLayerAndCalculateRate(const std::shared_pt
   if (new_frame) {
     video_frame_rate_list_[temporal_layer]++;
   }
-  packet->compatible_temporal_layers.push_back(temporal_layer);
+  packet->compatible_temporal_layers.add(temporal_layer);
 }
 
 void LayerDetectorHandler::parseLayerInfoFromVP9(std::shared_ptr<DataPacket> packet) {
   RtpHeader *rtp_header = reinterpret_cast<RtpHeader*>(packet->data);
   unsigned char* start_buffer = reinterpret_cast<unsigned char*> (packet->data);
   start_buffer = start_buffer + rtp_header->getHeaderLength();
-  RTPPayloadVP9* payload = vp9_parser_.parseVP9(
-      start_buffer, packet->length - rtp_header->getHeaderLength());
+  RTPPayloadVP9 vp9_payload;
+  RTPPayloadVP9* payload = &vp9_payload;
+  vp9_parser_.parseVP9(start_buffer, packet->length - rtp_header->getHeaderLength(), payload);
 
   if (payload->hasPictureID) {
     packet->picture_id = payload->pictureID;
@@ -135,12 +136,12 @@ void LayerDetectorHandler::parseLayerInfoFromVP9(std::shared_ptr<DataPacket> pac
 
   int spatial_layer = payload->spatialID;
 
-  packet->compatible_spatial_layers = {};
+  packet->compatible_spatial_layers.clear();
   for (int i = 5; i >= spatial_layer; i--) {
-    packet->compatible_spatial_layers.push_back(i);
+    packet->compatible_spatial_layers.add(i);
   }
 
-  packet->compatible_temporal_layers = {};
+  packet->compatible_temporal_layers.clear();
   switch (payload->temporalID) {
     case 0: addTemporalLayerAndCalculateRate(packet, 0, payload->beginningOfLayerFrame);
     case 2: addTemporalLayerAndCalculateRate(packet, 1, payload->beginningOfLayerFrame);
@@ -171,17 +172,18 @@ void LayerDetectorHandler::parseLayerInfoFromVP9(std::shared_ptr<DataPacket> pac
   notifyLayerInfoChangedEventMaybe();
 
   packet->ending_of_layer_frame = payload->endingOfLayerFrame;
-  delete payload;
 }
 
 void LayerDetectorHandler::parseLayerInfoFromH264(std::shared_ptr<DataPacket> packet) {
   RtpHeader *rtp_header = reinterpret_cast<RtpHeader*>(packet->data);
   unsigned char* start_buffer = reinterpret_cast<unsigned char*> (packet->data);
   start_buffer = start_buffer + rtp_header->getHeaderLength();
-  RTPPayloadH264* payload = h264_parser_.parseH264(
-      start_buffer, packet->length - rtp_header->getHeaderLength());
+  RTPPayloadH264 h264_payload;
+  RTPPayloadH264* payload = &h264_payload;
+  // Only the descriptor is needed here, so aggregated NALs are not copied
+  h264_parser_.parseH264(start_buffer, packet->length - rtp_header->getHeaderLength(), payload, false);
 
-  int position = std::max(stoi(packet->rid) - 1, 0);
+  int position = std::max(packet->rid - 1, 0);
   packet->compatible_spatial_layers = {position};
 
   if (payload->frameType == kH264IFrame) {
@@ -194,7 +196,6 @@ void LayerDetectorHandler::parseLayerInfoFromH264(std::shared_ptr<DataPacket> pa
 
   notifyLayerInfoChangedEventMaybe();
 
-  delete payload;
 }
 
 void LayerDetectorHandler::notifyUpdate() {
@@ -0,0 +1,156 @@
+#include "rtp/PacerHandler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "./MediaDefinitions.h"
+#include "./WebRtcConnection.h"
+#include "lib/ClockUtils.h"
+#include "rtp/RtpHeaders.h"
+
+namespace erizo {
+
+DEFINE_LOGGER(PacerHandler, "rtp.PacerHandler");
+
+constexpr duration PacerHandler::kPacingInterval;
+constexpr duration PacerHandler::kMaxQueueDelay;
+constexpr duration PacerHandler::kMaxPaddingQueueDelay;
+
+PacerHandler::PacerHandler(std::shared_ptr<erizo::Clock> the_clock)
+  : enabled_{true}, initialized_{false}, flush_scheduled_{false}, clock_{the_clock}, connection_{nullptr},
+    budget_bytes_{0}, last_refill_{clock_->now()} {
+}
+
+void PacerHandler::enable() {
+  enabled_ = true;
+}
+
+void PacerHandler::disable() {
+  enabled_ = false;
+  for (auto &queue : queues_) {
+    while (!queue.empty()) {
+      std::shared_ptr<DataPacket> packet = std::move(queue.front().packet);
+      queue.pop_front();
+      send(std::move(packet));
+    }
+  }
+}
+
+void PacerHandler::notifyUpdate() {
+  if (initialized_) {
+    return;
+  }
+  auto pipeline = getContext()->getPipelineShared();
+  if (!pipeline) {
+    return;
+  }
+  connection_ = pipeline->getService<WebRtcConnection>().get();
+  initialized_ = connection_ != nullptr;
+}
+
+PacerHandler::Priority PacerHandler::getPriority(const std::shared_ptr<DataPacket> &packet) {
+  if (packet->is_padding) {
+    return kPadding;
+  }
+  if (packet->type == AUDIO_PACKET) {
+    return kAudio;
+  }
+  if (packet->is_retransmission) {
+    return kRetransmission;
+  }
+  return kVideo;
+}
+
+size_t PacerHandler::getQueuedPackets() const {
+  size_t queued_packets = 0;
+  for (const auto &queue : queues_) {
+    queued_packets += queue.size();
+  }
+  return queued_packets;
+}
+
+uint64_t PacerHandler::getPacingBitrate() {
+  uint64_t target_bitrate = std::max(connection_->getSenderBitrateTarget(), connection_->getConnectionTargetBw());
+  if (target_bitrate == 0) {
+    target_bitrate = kInitialBitrate;
+  }
+  return target_bitrate * kPacingFactor;
+}
+
+void PacerHandler::refillBudget() {
+  time_point now = clock_->now();
+  uint64_t bytes_per_second = getPacingBitrate() / 8;
+  int64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(now - last_refill_).count();
+  int64_t max_budget = bytes_per_second * ClockUtils::durationToMs(kPacingInterval) / 1000;
+  last_refill_ = now;
+  // Time spent idle does not accumulate into a burst longer than one interval
+  budget_bytes_ = std::min(budget_bytes_ + static_cast<int64_t>(bytes_per_second) * elapsed_us / 1000000,
+                           max_budget);
+}
+
+void PacerHandler::send(std::shared_ptr<DataPacket> packet) {
+  budget_bytes_ -= packet->length;
+  getContext()->fireWrite(std::move(packet));
+}
+
+void PacerHandler::write(Context *ctx, std::shared_ptr<DataPacket> packet) {
+  RtcpHeader *chead = reinterpret_cast<RtcpHeader*>(packet->data);
+  if (!enabled_ || !initialized_ || chead->isRtcp()) {
+    ctx->fireWrite(std::move(packet));
+    return;
+  }
+  refillBudget();
+  if (budget_bytes_ > 0 && getQueuedPackets() == 0) {
+    send(std::move(packet));
+    return;
+  }
+  queues_[getPriority(packet)].push_back(QueuedPacket{std::move(packet), clock_->now()});
+  scheduleFlush();
+}
+
+void PacerHandler::flushQueues() {
+  refillBudget();
+  for (auto &queue : queues_) {
+    while (!queue.empty() && budget_bytes_ > 0) {
+      std::shared_ptr<DataPacket> packet = std::move(queue.front().packet);
+      queue.pop_front();
+      send(std::move(packet));
+    }
+  }
+
+  time_point now = clock_->now();
+  // Padding that could not be sent soon only delays the media that comes after it
+  auto &padding = queues_[kPadding];
+  while (!padding.empty() && now - padding.front().queued_at > kMaxPaddingQueueDelay) {
+    padding.pop_front();
+  }
+  // An estimate too low to drain the queues should not add unbounded latency
+  for (int priority = kAudio; priority < kPadding; priority++) {
+    auto &queue = queues_[priority];
+    while (!queue.empty() && now - queue.front().queued_at > kMaxQueueDelay) {
+      std::shared_ptr<DataPacket> packet = std::move(queue.front().packet);
+      queue.pop_front();
+      send(std::move(packet));
+    }
+  }
+}
+
+void PacerHandler::scheduleFlush() {
+  if (flush_scheduled_) {
+    return;
+  }
+  flush_scheduled_ = true;
+  std::weak_ptr<PacerHandler> weak_this = shared_from_this();
+  connection_->getWorker()->scheduleEvery([weak_this] {
+    if (auto this_ptr = weak_this.lock()) {
+      this_ptr->flushQueues();
+      if (this_ptr->getQueuedPackets() > 0) {
+        return true;
+      }
+      this_ptr->flush_scheduled_ = false;
+    }
+    return false;
+  }, kPacingInterval);
+}
+
+}  // namespace erizo
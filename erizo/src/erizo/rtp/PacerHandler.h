@@ -0,0 +1,76 @@
+#ifndef ERIZO_SRC_ERIZO_RTP_PACERHANDLER_H_
+#define ERIZO_SRC_ERIZO_RTP_PACERHANDLER_H_
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "./logger.h"
+#include "pipeline/Handler.h"
+#include "thread/Worker.h"
+#include "lib/Clock.h"
+
+namespace erizo {
+
+class WebRtcConnection;
+
+/**
+ * Leaky bucket pacer for the packets a WebRtcConnection sends.
+ * Media is released at kPacingFactor times the sender BWE target in kPacingInterval steps, so keyframes, RTX
+ * bursts and padding are spread over time instead of hitting the wire at once. Queued packets are released
+ * by priority: audio, retransmissions, video and padding. RTCP is never delayed.
+ */
+class PacerHandler: public OutboundHandler, public std::enable_shared_from_this<PacerHandler> {
+  DECLARE_LOGGER();
+
+ public:
+  static constexpr duration kPacingInterval = std::chrono::milliseconds(5);
+  static constexpr duration kMaxQueueDelay = std::chrono::milliseconds(500);
+  static constexpr duration kMaxPaddingQueueDelay = std::chrono::milliseconds(50);
+  static constexpr double kPacingFactor = 2.5;
+  static constexpr uint64_t kInitialBitrate = 300000;
+
+  explicit PacerHandler(std::shared_ptr<erizo::Clock> the_clock = std::make_shared<erizo::SteadyClock>());
+
+  void enable() override;
+  void disable() override;
+
+  std::string getName() override {
+    return "pacer";
+  }
+
+  void write(Context *ctx, std::shared_ptr<DataPacket> packet) override;
+  void notifyUpdate() override;
+
+  size_t getQueuedPackets() const;
+
+ private:
+  enum Priority { kAudio = 0, kRetransmission, kVideo, kPadding, kPriorities };
+
+  struct QueuedPacket {
+    std::shared_ptr<DataPacket> packet;
+    time_point queued_at;
+  };
+
+  static Priority getPriority(const std::shared_ptr<DataPacket> &packet);
+  uint64_t getPacingBitrate();
+  void refillBudget();
+  void send(std::shared_ptr<DataPacket> packet);
+  void flushQueues();
+  void scheduleFlush();
+
+ private:
+  bool enabled_;
+  bool initialized_;
+  bool flush_scheduled_;
+  std::shared_ptr<erizo::Clock> clock_;
+  WebRtcConnection *connection_;
+  std::array<std::deque<QueuedPacket>, kPriorities> queues_;
+  int64_t budget_bytes_;
+  time_point last_refill_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_RTP_PACERHANDLER_H_
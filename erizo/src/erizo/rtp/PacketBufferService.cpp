@@ -1,35 +1,131 @@
 #include "rtp/PacketBufferService.h"
 
+#include <utility>
+
 namespace erizo {
 DEFINE_LOGGER(PacketBufferService, "rtp.PacketBufferService");
 
-PacketBufferService::PacketBufferService(): audio_{kServicePacketBufferSize},
-  video_{kServicePacketBufferSize} {
+// Extended sequence numbers start one cycle ahead so packets reordered around the first one stay positive
+constexpr uint64_t kFirstSeqNumCycle = 1 << 16;
+
+PacketHistory::PacketHistory(uint16_t initial_size, uint16_t max_size, duration history)
+  : max_size_{max_size}, history_{history}, has_packets_{false}, highest_seq_num_{0}, slots_(initial_size) {
+}
+
+uint64_t PacketHistory::extend(uint16_t seq_num) const {
+  if (!has_packets_) {
+    return kFirstSeqNumCycle + seq_num;
+  }
+  int16_t distance = static_cast<int16_t>(seq_num - static_cast<uint16_t>(highest_seq_num_));
+  return highest_seq_num_ + distance;
+}
+
+void PacketHistory::grow() {
+  std::vector<Slot> slots(slots_.size() * 2);
+  for (Slot &slot : slots_) {
+    if (slot.packet) {
+      slots[slot.extended_seq_num % slots.size()] = std::move(slot);
+    }
+  }
+  slots_.swap(slots);
+}
+
+void PacketHistory::insert(std::shared_ptr<DataPacket> packet, uint16_t seq_num, time_point now) {
+  uint64_t extended_seq_num = extend(seq_num);
+  if (!has_packets_ || extended_seq_num > highest_seq_num_) {
+    highest_seq_num_ = extended_seq_num;
+    has_packets_ = true;
+  }
+  Slot *slot = &slots_[extended_seq_num % slots_.size()];
+  while (slot->packet && slot->extended_seq_num < extended_seq_num && now - slot->inserted_at < history_ &&
+         slots_.size() * 2 <= max_size_) {
+    grow();
+    slot = &slots_[extended_seq_num % slots_.size()];
+  }
+  if (slot->packet && slot->extended_seq_num > extended_seq_num) {
+    // A late packet older than the one already in its slot
+    return;
+  }
+  slot->extended_seq_num = extended_seq_num;
+  slot->inserted_at = now;
+  slot->packet = std::move(packet);
+  slot->retransmissions = Retransmissions{};
+}
+
+std::shared_ptr<DataPacket> PacketHistory::get(uint16_t seq_num, Lookup *result) {
+  uint64_t extended_seq_num = extend(seq_num);
+  if (!has_packets_ || extended_seq_num > highest_seq_num_) {
+    *result = Lookup::kMiss;
+    return std::shared_ptr<DataPacket>();
+  }
+  const Slot &slot = slots_[extended_seq_num % slots_.size()];
+  if (slot.packet && slot.extended_seq_num == extended_seq_num) {
+    *result = Lookup::kHit;
+    return slot.packet;
+  }
+  bool overwritten = slot.packet && slot.extended_seq_num > extended_seq_num;
+  *result = overwritten || highest_seq_num_ - extended_seq_num >= slots_.size() ? Lookup::kTooOld : Lookup::kMiss;
+  return std::shared_ptr<DataPacket>();
+}
+
+PacketHistory::Retransmissions* PacketHistory::getRetransmissions(uint16_t seq_num) {
+  uint64_t extended_seq_num = extend(seq_num);
+  Slot &slot = slots_[extended_seq_num % slots_.size()];
+  if (!has_packets_ || !slot.packet || slot.extended_seq_num != extended_seq_num) {
+    return nullptr;
+  }
+  return &slot.retransmissions;
+}
+
+PacketBufferService::PacketBufferService(std::shared_ptr<Clock> the_clock, uint16_t initial_size,
+    uint16_t max_size, duration history)
+  : clock_{the_clock}, initial_size_{initial_size}, max_size_{max_size}, history_{history},
+    hits_{0}, misses_{0}, too_old_{0} {
 }
 
 void PacketBufferService::insertPacket(std::shared_ptr<DataPacket> packet) {
+  if (packet->type != VIDEO_PACKET && packet->type != AUDIO_PACKET) {
+    ELOG_INFO("message: Trying to store an unknown packet");
+    return;
+  }
   RtpHeader *head = reinterpret_cast<RtpHeader*> (packet->data);
-  switch (packet->type) {
-    case VIDEO_PACKET:
-      video_[getIndexInBuffer(head->getSeqNumber())] = packet;
+  uint32_t ssrc = head->getSSRC();
+  auto history = histories_.find(ssrc);
+  if (history == histories_.end()) {
+    history = histories_.emplace(ssrc, PacketHistory{initial_size_, max_size_, history_}).first;
+  }
+  uint16_t seq_num = head->getSeqNumber();
+  history->second.insert(std::move(packet), seq_num, clock_->now());
+}
+
+std::shared_ptr<DataPacket> PacketBufferService::getPacket(uint32_t ssrc, uint16_t seq_num) {
+  auto history = histories_.find(ssrc);
+  if (history == histories_.end()) {
+    misses_++;
+    return std::shared_ptr<DataPacket>();
+  }
+  PacketHistory::Lookup result;
+  std::shared_ptr<DataPacket> packet = history->second.get(seq_num, &result);
+  switch (result) {
+    case PacketHistory::Lookup::kHit:
+      hits_++;
       break;
-    case AUDIO_PACKET:
-      audio_[getIndexInBuffer(head->getSeqNumber())] = packet;
+    case PacketHistory::Lookup::kMiss:
+      misses_++;
       break;
-    default:
-      ELOG_INFO("message: Trying to store an unknown packet");
+    case PacketHistory::Lookup::kTooOld:
+      too_old_++;
       break;
   }
+  return packet;
 }
 
-std::shared_ptr<DataPacket> PacketBufferService::getVideoPacket(uint16_t seq_num) {
-  return video_[getIndexInBuffer(seq_num)];
-}
-std::shared_ptr<DataPacket> PacketBufferService::getAudioPacket(uint16_t seq_num) {
-  return audio_[getIndexInBuffer(seq_num)];
-}
-uint16_t PacketBufferService::getIndexInBuffer(uint16_t seq_num) {
-  return seq_num % kServicePacketBufferSize;
+PacketHistory::Retransmissions* PacketBufferService::getRetransmissions(uint32_t ssrc, uint16_t seq_num) {
+  auto history = histories_.find(ssrc);
+  if (history == histories_.end()) {
+    return nullptr;
+  }
+  return history->second.getRetransmissions(seq_num);
 }
 
 }  // namespace erizo
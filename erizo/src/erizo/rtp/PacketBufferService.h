@@ -1,34 +1,96 @@
 #ifndef ERIZO_SRC_ERIZO_RTP_PACKETBUFFERSERVICE_H_
 #define ERIZO_SRC_ERIZO_RTP_PACKETBUFFERSERVICE_H_
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include "./logger.h"
 #include "./MediaDefinitions.h"
+#include "lib/Clock.h"
 #include "rtp/RtpHeaders.h"
 #include "pipeline/Service.h"
 
 static constexpr uint16_t kServicePacketBufferSize = 256;
+static constexpr uint16_t kServicePacketBufferMaxSize = 8192;
+static constexpr erizo::duration kServicePacketBufferHistory = std::chrono::milliseconds(1000);
 
 namespace erizo {
+
+/**
+ * Ring of the last packets sent with one SSRC, indexed by extended sequence number.
+ * Every slot keeps the extended sequence number of its packet so a lookup never returns a packet from a
+ * previous sequence number cycle. The ring starts with initial_size slots and doubles, up to max_size, when
+ * it would overwrite a packet younger than history, so its depth follows bitrate x history.
+ */
+class PacketHistory {
+ public:
+  enum class Lookup { kHit, kMiss, kTooOld };
+
+  // Retransmissions of a buffered packet, reset when its slot gets a new packet
+  struct Retransmissions {
+    time_point last_sent_at;
+    uint32_t count;
+  };
+
+  PacketHistory(uint16_t initial_size, uint16_t max_size, duration history);
+
+  void insert(std::shared_ptr<DataPacket> packet, uint16_t seq_num, time_point now);
+  std::shared_ptr<DataPacket> get(uint16_t seq_num, Lookup *result);
+  // Returns nullptr if the packet is no longer in the history
+  Retransmissions* getRetransmissions(uint16_t seq_num);
+
+  size_t capacity() const { return slots_.size(); }
+
+ private:
+  struct Slot {
+    uint64_t extended_seq_num;
+    time_point inserted_at;
+    std::shared_ptr<DataPacket> packet;
+    Retransmissions retransmissions;
+  };
+
+  uint64_t extend(uint16_t seq_num) const;
+  void grow();
+
+ private:
+  uint16_t max_size_;
+  duration history_;
+  bool has_packets_;
+  uint64_t highest_seq_num_;
+  std::vector<Slot> slots_;
+};
+
 class PacketBufferService: public Service {
  public:
   DECLARE_LOGGER();
 
-  PacketBufferService();
+  explicit PacketBufferService(std::shared_ptr<Clock> the_clock = std::make_shared<SteadyClock>(),
+                               uint16_t initial_size = kServicePacketBufferSize,
+                               uint16_t max_size = kServicePacketBufferMaxSize,
+                               duration history = kServicePacketBufferHistory);
   ~PacketBufferService() {}
 
   PacketBufferService(const PacketBufferService&& service);
 
   void insertPacket(std::shared_ptr<DataPacket> packet);
 
-  std::shared_ptr<DataPacket> getVideoPacket(uint16_t seq_num);
-  std::shared_ptr<DataPacket> getAudioPacket(uint16_t seq_num);
+  std::shared_ptr<DataPacket> getPacket(uint32_t ssrc, uint16_t seq_num);
+  PacketHistory::Retransmissions* getRetransmissions(uint32_t ssrc, uint16_t seq_num);
 
- private:
-  uint16_t getIndexInBuffer(uint16_t seq_num);
+  uint64_t getHits() const { return hits_; }
+  uint64_t getMisses() const { return misses_; }
+  uint64_t getTooOld() const { return too_old_; }
 
  private:
-  std::vector<std::shared_ptr<DataPacket>> audio_;
-  std::vector<std::shared_ptr<DataPacket>> video_;
+  std::shared_ptr<Clock> clock_;
+  uint16_t initial_size_;
+  uint16_t max_size_;
+  duration history_;
+  std::unordered_map<uint32_t, PacketHistory> histories_;
+  uint64_t hits_;
+  uint64_t misses_;
+  uint64_t too_old_;
 };
 
 }  // namespace erizo
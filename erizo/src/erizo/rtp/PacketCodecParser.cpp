@@ -26,14 +26,23 @@ void PacketCodecParser::read(Context *ctx, std::shared_ptr<DataPacket> packet) {
         stream_->getRemoteSdpInfo()->getCodecByExternalPayloadType(
             rtp_header->getPayloadType());
     if (codec) {
-      packet->codec = codec->encoding_name;
+      packet->codec = getCodecId(rtp_header->getPayloadType(), codec->encoding_name);
       packet->clock_rate = codec->clock_rate;
-      ELOG_DEBUG("Reading codec: %s, clock: %u", packet->codec.c_str(), packet->clock_rate);
+      ELOG_DEBUG("Reading codec: %s, clock: %u", codec->encoding_name.c_str(), packet->clock_rate);
     }
   }
   ctx->fireRead(std::move(packet));
 }
 
+StringId PacketCodecParser::getCodecId(uint8_t payload_type, const std::string& encoding_name) {
+  std::pair<std::string, StringId> &entry = codec_ids_[payload_type & 0x7F];
+  if (entry.first != encoding_name) {
+    entry.first = encoding_name;
+    entry.second = StringInterner::intern(encoding_name);
+  }
+  return entry.second;
+}
+
 void PacketCodecParser::notifyUpdate() {
   if (initialized_) {
     return;
@@ -1,7 +1,12 @@
 #ifndef ERIZO_SRC_ERIZO_RTP_PACKETCODECPARSER_H_
 #define ERIZO_SRC_ERIZO_RTP_PACKETCODECPARSER_H_
 
+#include <array>
+#include <string>
+#include <utility>
+
 #include "./logger.h"
+#include "lib/StringInterner.h"
 #include "pipeline/Handler.h"
 
 namespace erizo {
@@ -25,8 +30,13 @@ class PacketCodecParser: public InboundHandler {
   void read(Context *ctx, std::shared_ptr<DataPacket> packet) override;
   void notifyUpdate() override;
 
+ private:
+  StringId getCodecId(uint8_t payload_type, const std::string& encoding_name);
+
  private:
   MediaStream *stream_;
+  // Interned codec per payload type, the name is kept to detect renegotiations
+  std::array<std::pair<std::string, StringId>, 128> codec_ids_;
   bool enabled_;
   bool initialized_;
 };
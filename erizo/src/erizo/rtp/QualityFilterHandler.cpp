@@ -108,7 +108,7 @@ void QualityFilterHandler::detectVideoScalability(const std::shared_ptr<DataPack
   if (is_scalable_ || packet->type != VIDEO_PACKET) {
     return;
   }
-  if (packet->rid != "0" ||
+  if (packet->rid != 0 ||
       packet->belongsToTemporalLayer(1) ||
       packet->belongsToSpatialLayer(1)) {
     is_scalable_ = true;
@@ -117,7 +117,7 @@ void QualityFilterHandler::detectVideoScalability(const std::shared_ptr<DataPack
 }
 
 void QualityFilterHandler::updatePictureID(const std::shared_ptr<DataPacket> &packet, int new_picture_id) {
-  if (packet->codec == "VP8") {
+  if (packet->codec == StringInterner::kVP8Id) {
     RtpHeader *rtp_header = reinterpret_cast<RtpHeader*>(packet->data);
     unsigned char* start_buffer = reinterpret_cast<unsigned char*> (packet->data);
     start_buffer = start_buffer + rtp_header->getHeaderLength();
@@ -126,7 +126,7 @@ void QualityFilterHandler::updatePictureID(const std::shared_ptr<DataPacket> &pa
 }
 
 void QualityFilterHandler::updateTL0PicIdx(const std::shared_ptr<DataPacket> &packet, uint8_t new_tl0_pic_idx) {
-  if (packet->codec == "VP8") {
+  if (packet->codec == StringInterner::kVP8Id) {
     RtpHeader *rtp_header = reinterpret_cast<RtpHeader*>(packet->data);
     unsigned char* start_buffer = reinterpret_cast<unsigned char*> (packet->data);
     start_buffer = start_buffer + rtp_header->getHeaderLength();
@@ -135,7 +135,7 @@ void QualityFilterHandler::updateTL0PicIdx(const std::shared_ptr<DataPacket> &pa
 }
 
 void QualityFilterHandler::removeVP8OptionalPayload(const std::shared_ptr<DataPacket> &packet) {
-  if (packet->codec == "VP8") {
+  if (packet->codec == StringInterner::kVP8Id) {
     RtpHeader *rtp_header = reinterpret_cast<RtpHeader*>(packet->data);
     unsigned char* start_buffer = reinterpret_cast<unsigned char*> (packet->data);
     start_buffer = start_buffer + rtp_header->getHeaderLength();
@@ -162,7 +162,7 @@ void QualityFilterHandler::write(Context *ctx, std::shared_ptr<DataPacket> packe
     int picture_id = packet->picture_id;
     uint8_t tl0_pic_idx = packet->tl0_pic_idx;
 
-    if (packet->rid != "0" && !receiving_multiple_ssrc_) {
+    if (packet->rid != 0 && !receiving_multiple_ssrc_) {
       receiving_multiple_ssrc_ = true;
     }
 
@@ -205,7 +205,7 @@ void QualityFilterHandler::write(Context *ctx, std::shared_ptr<DataPacket> packe
       return;
     }
 
-    if (packet->compatible_spatial_layers.back() == target_spatial_layer_ && packet->ending_of_layer_frame) {
+    if (packet->compatible_spatial_layers.lowest() == target_spatial_layer_ && packet->ending_of_layer_frame) {
       rtp_header->setMarker(1);
     }
 
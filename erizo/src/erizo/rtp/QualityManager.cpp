@@ -16,7 +16,7 @@ constexpr float QualityManager::kIncreaseLayerBitrateThreshold;
 QualityManager::QualityManager(std::shared_ptr<Clock> the_clock)
   : initialized_{false}, enabled_{false}, forced_layers_{false},
   freeze_fallback_active_{false}, enable_slideshow_below_spatial_layer_{false},
-  enable_fallback_below_min_layer_{false}, spatial_layer_{0},
+  enable_fallback_below_min_layer_{false}, layer_availability_changed_{false}, spatial_layer_{0},
   temporal_layer_{0}, max_active_spatial_layer_{0},
   max_active_temporal_layer_{0}, slideshow_below_spatial_layer_{-1}, max_video_width_{-1},
   max_video_height_{-1}, max_video_frame_rate_{-1}, current_estimated_bitrate_{0},
@@ -38,6 +38,9 @@ void QualityManager::notifyEvent(MediaEventPtr event) {
     video_frame_width_list_ = layer_event->video_frame_width_list;
     video_frame_height_list_ = layer_event->video_frame_height_list;
     video_frame_rate_list_ = layer_event->video_frame_rate_list;
+  } else if (event->getType() == "LayerAvailabilityChangedEvent") {
+    layer_availability_ = std::static_pointer_cast<LayerAvailabilityChangedEvent>(event)->availability;
+    layer_availability_changed_ = true;
   }
 }
 
@@ -121,11 +124,20 @@ bool QualityManager::doesLayerMeetConstraints(int spatial_layer, int temporal_la
 }
 
 void QualityManager::maybeUpdateAvailableLayersAndBitrates() {
-  time_point now = clock_->now();
-  if (now - last_activity_check_ > kActiveLayerInterval) {
-    last_activity_check_ = now;
+  if (layer_availability_) {
+    // The publisher already did the periodic work, we only have to apply its results once
+    if (!layer_availability_changed_) {
+      return;
+    }
+    layer_availability_changed_ = false;
+    storeSharedLayerBitratesInStats();
   } else {
-    return;
+    time_point now = clock_->now();
+    if (now - last_activity_check_ > kActiveLayerInterval) {
+      last_activity_check_ = now;
+    } else {
+      return;
+    }
   }
 
   calculateMaxActiveLayer();
@@ -133,7 +145,7 @@ void QualityManager::maybeUpdateAvailableLayersAndBitrates() {
 }
 
 void QualityManager::selectLayer(bool try_higher_layers) {
-  if (!initialized_  || !stats_->getNode().hasChild("qualityLayers")) {
+  if (!initialized_  || (!layer_availability_ && !stats_->getNode().hasChild("qualityLayers"))) {
     return;
   }
   stream_->setSimulcast(true);
@@ -152,29 +164,30 @@ void QualityManager::selectLayer(bool try_higher_layers) {
   bool layer_capped_by_constraints = false;
   ELOG_DEBUG("message: Calculate best layer, estimated_bitrate: %lu, current layer %d/%d, min_requested_spatial %d",
       current_estimated_bitrate_, spatial_layer_, temporal_layer_, min_requested_spatial_layer);
-  for (auto &spatial_layer_node : stats_->getNode()["qualityLayers"].getMap()) {
-    if (aux_spatial_layer >= min_valid_spatial_layer) {
-      for (auto &temporal_layer_node : spatial_layer_node.second->getMap()) {
-        ELOG_DEBUG("Bitrate for layer %d/%d %lu",
-            aux_spatial_layer, aux_temporal_layer, temporal_layer_node.second->value());
-        if (temporal_layer_node.second->value() != 0 &&
-            (1. + bitrate_margin) * temporal_layer_node.second->value() < current_estimated_bitrate_) {
-          if (doesLayerMeetConstraints(aux_spatial_layer, aux_temporal_layer)) {
-            next_temporal_layer = aux_temporal_layer;
-            next_spatial_layer = aux_spatial_layer;
-            below_min_layer = false;
-          } else {
-            layer_capped_by_constraints = true;
-          }
+  if (layer_availability_) {
+    const std::vector<std::vector<uint64_t>> &bitrates = layer_availability_->bitrates;
+    for (size_t spatial_layer = min_valid_spatial_layer; spatial_layer < bitrates.size(); spatial_layer++) {
+      for (size_t temporal_layer = 0; temporal_layer < bitrates[spatial_layer].size(); temporal_layer++) {
+        selectLayerIfBetter(spatial_layer, temporal_layer, bitrates[spatial_layer][temporal_layer], bitrate_margin,
+            &next_spatial_layer, &next_temporal_layer, &below_min_layer, &layer_capped_by_constraints);
+      }
+    }
+  } else {
+    for (auto &spatial_layer_node : stats_->getNode()["qualityLayers"].getMap()) {
+      if (aux_spatial_layer >= min_valid_spatial_layer) {
+        for (auto &temporal_layer_node : spatial_layer_node.second->getMap()) {
+          selectLayerIfBetter(aux_spatial_layer, aux_temporal_layer, temporal_layer_node.second->value(),
+              bitrate_margin, &next_spatial_layer, &next_temporal_layer, &below_min_layer,
+              &layer_capped_by_constraints);
+          aux_temporal_layer++;
         }
-        aux_temporal_layer++;
+      } else {
+        ELOG_DEBUG("message: Skipping below min spatial layer, aux_layer: %d, min_valid_spatial_layer: %d",
+            aux_spatial_layer, min_valid_spatial_layer);
       }
-    } else {
-      ELOG_DEBUG("message: Skipping below min spatial layer, aux_layer: %d, min_valid_spatial_layer: %d",
-          aux_spatial_layer, min_valid_spatial_layer);
+      aux_temporal_layer = 0;
+      aux_spatial_layer++;
     }
-    aux_temporal_layer = 0;
-    aux_spatial_layer++;
   }
 
   if (!(enable_slideshow_below_spatial_layer_ || enable_fallback_below_min_layer_)) {
@@ -220,6 +233,32 @@ void QualityManager::selectLayer(bool try_higher_layers) {
                                                 CumulativeStat{layer_capped_by_constraints});
 }
 
+void QualityManager::selectLayerIfBetter(int spatial_layer, int temporal_layer, uint64_t bitrate,
+    float bitrate_margin, int *next_spatial_layer, int *next_temporal_layer, bool *below_min_layer,
+    bool *layer_capped_by_constraints) {
+  ELOG_DEBUG("Bitrate for layer %d/%d %lu", spatial_layer, temporal_layer, bitrate);
+  if (bitrate == 0 || (1. + bitrate_margin) * bitrate >= current_estimated_bitrate_) {
+    return;
+  }
+  if (doesLayerMeetConstraints(spatial_layer, temporal_layer)) {
+    *next_temporal_layer = temporal_layer;
+    *next_spatial_layer = spatial_layer;
+    *below_min_layer = false;
+  } else {
+    *layer_capped_by_constraints = true;
+  }
+}
+
+void QualityManager::storeSharedLayerBitratesInStats() {
+  const std::vector<std::vector<uint64_t>> &bitrates = layer_availability_->bitrates;
+  for (size_t spatial_layer = 0; spatial_layer < bitrates.size(); spatial_layer++) {
+    for (size_t temporal_layer = 0; temporal_layer < bitrates[spatial_layer].size(); temporal_layer++) {
+      stats_->getNode()["qualityLayers"][spatial_layer].insertStat(std::to_string(temporal_layer),
+          CumulativeStat{bitrates[spatial_layer][temporal_layer]});
+    }
+  }
+}
+
 void QualityManager::storeLayersAndBitratesInMediaStream() {
   int max_available_spatial_layer_that_meets_constraints = 0;
   int max_available_temporal_layer_that_meets_constraints = 0;
@@ -261,14 +300,19 @@ void QualityManager::calculateMaxActiveLayer() {
   int max_active_spatial_layer = 5;
   int max_active_temporal_layer = 5;
 
-  for (; max_active_spatial_layer > 0; max_active_spatial_layer--) {
-    if (getInstantLayerBitrate(max_active_spatial_layer, 0) > 0) {
-      break;
+  if (layer_availability_) {
+    max_active_spatial_layer = layer_availability_->max_active_spatial_layer;
+    max_active_temporal_layer = layer_availability_->max_active_temporal_layer;
+  } else {
+    for (; max_active_spatial_layer > 0; max_active_spatial_layer--) {
+      if (getInstantLayerBitrate(max_active_spatial_layer, 0) > 0) {
+        break;
+      }
     }
-  }
-  for (; max_active_temporal_layer > 0; max_active_temporal_layer--) {
-    if (getInstantLayerBitrate(max_active_spatial_layer, max_active_temporal_layer) > 0) {
-      break;
+    for (; max_active_temporal_layer > 0; max_active_temporal_layer--) {
+      if (getInstantLayerBitrate(max_active_spatial_layer, max_active_temporal_layer) > 0) {
+        break;
+      }
     }
   }
   stats_->getNode()["qualityLayers"].insertStat("maxActiveSpatialLayer",
@@ -282,6 +326,9 @@ void QualityManager::calculateMaxActiveLayer() {
 }
 
 uint64_t QualityManager::getInstantLayerBitrate(int spatial_layer, int temporal_layer) {
+  if (layer_availability_) {
+    return LayerAvailability::getLayerBitrate(layer_availability_->instant_bitrates, spatial_layer, temporal_layer);
+  }
   if (!stats_->getNode()["qualityLayers"].hasChild(spatial_layer) ||
       !stats_->getNode()["qualityLayers"][spatial_layer].hasChild(temporal_layer)) {
     return 0;
@@ -293,6 +340,9 @@ uint64_t QualityManager::getInstantLayerBitrate(int spatial_layer, int temporal_
 }
 
 uint64_t QualityManager::getMaxLayerBitrateInInterval(int spatial_layer, int temporal_layer) {
+  if (layer_availability_) {
+    return LayerAvailability::getLayerBitrate(layer_availability_->max_bitrates, spatial_layer, temporal_layer);
+  }
   if (!stats_->getNode()["qualityLayers"].hasChild(spatial_layer) ||
       !stats_->getNode()["qualityLayers"][spatial_layer].hasChild(temporal_layer)) {
     return 0;
@@ -5,6 +5,7 @@
 #include "Stats.h"
 #include "lib/Clock.h"
 #include "pipeline/Service.h"
+#include "rtp/LayerAvailabilityService.h"
 
 namespace erizo {
 
@@ -38,11 +39,16 @@ class QualityManager: public Service, public std::enable_shared_from_this<Qualit
   void setVideoConstraints(int max_video_width, int max_video_height, int max_video_frame_rate);
   void notifyEvent(MediaEventPtr event) override;
   void notifyQualityUpdate();
+  // True when layer bitrates come from the publisher instead of being measured by this stream
+  bool hasSharedLayerAvailability() const { return layer_availability_ != nullptr; }
 
  private:
   void calculateMaxActiveLayer();
   void maybeUpdateAvailableLayersAndBitrates();
   void storeLayersAndBitratesInMediaStream();
+  void storeSharedLayerBitratesInStats();
+  void selectLayerIfBetter(int spatial_layer, int temporal_layer, uint64_t bitrate, float bitrate_margin,
+      int *next_spatial_layer, int *next_temporal_layer, bool *below_min_layer, bool *layer_capped_by_constraints);
   void selectLayer(bool try_higher_layers);
   uint64_t getInstantLayerBitrate(int spatial_layer, int temporal_layer);
   uint64_t getMaxLayerBitrateInInterval(int spatial_layer, int temporal_layer);
@@ -58,6 +64,7 @@ class QualityManager: public Service, public std::enable_shared_from_this<Qualit
   bool freeze_fallback_active_;
   bool enable_slideshow_below_spatial_layer_;
   bool enable_fallback_below_min_layer_;
+  bool layer_availability_changed_;
   int spatial_layer_;
   int temporal_layer_;
   int max_active_spatial_layer_;
@@ -72,6 +79,7 @@ class QualityManager: public Service, public std::enable_shared_from_this<Qualit
   time_point last_activity_check_;
   std::shared_ptr<Stats> stats_;
   std::shared_ptr<Clock> clock_;
+  std::shared_ptr<const LayerAvailability> layer_availability_;
   std::vector<uint32_t> video_frame_width_list_;
   std::vector<uint32_t> video_frame_height_list_;
   std::vector<uint64_t> video_frame_rate_list_;
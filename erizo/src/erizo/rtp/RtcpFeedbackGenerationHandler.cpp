@@ -72,6 +72,12 @@ void RtcpFeedbackGenerationHandler::read(Context *ctx, std::shared_ptr<DataPacke
       std::shared_ptr<DataPacket> rtcp_packet = generator->rr_generator->generateReceiverReport();
       notifyReceiverReportInfo(rtcp_packet, is_audio);
       if (nacks_enabled_ && generator->nack_generator != nullptr) {
+        // Publish only connections get no receiver reports to measure the RTT, so use the retransmissions
+        uint32_t rtt_ms = stream_->getRtt();
+        if (rtt_ms == 0) {
+          rtt_ms = generator->nack_generator->getMeasuredRtt();
+        }
+        generator->nack_generator->setRtt(rtt_ms);
         generator->nack_generator->addNackPacketToRr(rtcp_packet);
       }
       ctx->fireWrite(std::move(rtcp_packet));
@@ -9,10 +9,17 @@ DEFINE_LOGGER(RtcpNackGenerator, "rtp.RtcpNackGenerator");
 static const int kMaxRetransmits = 2;
 static const int kMaxNacks = 150;
 static const int kMinNackDelayMs = 20;
+// Weight of the previous RTT, as in the TCP smoothed RTT
+static const uint64_t kRttSmoothing = 8;
 static const int kNackCommonHeaderLengthRtcp = kNackCommonHeaderLengthBytes/4 - 1;
+static const uint16_t kNackBlpSize = 16;
+// Extended sequence numbers start in the second cycle so the window never goes below 0
+static const uint64_t kFirstCycle = 1 << 16;
 
 RtcpNackGenerator::RtcpNackGenerator(uint32_t ssrc, std::shared_ptr<Clock> the_clock) :
-  initialized_{false}, highest_seq_num_{0}, ssrc_{ssrc}, clock_{the_clock} {}
+  initialized_{false}, highest_ext_seq_num_{0}, ssrc_{ssrc}, rtt_ms_{0}, measured_rtt_ms_{0}, missing_count_{0},
+  missing_{},
+  retransmits_{}, sent_time_ms_{}, clock_{the_clock} {}
 
 bool RtcpNackGenerator::handleRtpPacket(std::shared_ptr<DataPacket> packet) {
   if (packet->type != VIDEO_PACKET) {
@@ -25,122 +32,181 @@ bool RtcpNackGenerator::handleRtpPacket(std::shared_ptr<DataPacket> packet) {
     return false;
   }
   if (!initialized_) {
-    highest_seq_num_ = seq_num;
+    highest_ext_seq_num_ = kFirstCycle + seq_num;
     initialized_ = true;
     return false;
   }
-  if (seq_num == highest_seq_num_) {
+  uint64_t ext_seq_num = extendSeqNum(seq_num);
+  if (ext_seq_num == highest_ext_seq_num_) {
     return false;
   }
   // TODO(pedro) Consider clearing the nack list if this is a keyframe
-  if (RtpUtils::sequenceNumberLessThan(seq_num, highest_seq_num_)) {
+  if (ext_seq_num < highest_ext_seq_num_) {
     ELOG_DEBUG("message: packet out of order, ssrc: %u, seq_num: %u, highest_seq_num: %u",
-        seq_num, highest_seq_num_, ssrc_);
-    //  Look for it in nack list, remove it if its there
-    auto nack_info = std::find_if(nack_info_list_.begin(), nack_info_list_.end(),
-        [seq_num](NackInfo& current_nack) {
-        return (current_nack.seq_num == seq_num);
-        });
-    if (nack_info != nack_info_list_.end()) {
+        ssrc_, seq_num, static_cast<uint16_t>(highest_ext_seq_num_));
+    if (ext_seq_num >= lowestTracked() && isMissing(ext_seq_num)) {
       ELOG_DEBUG("message: Recovered Packet %u", seq_num);
-      nack_info_list_.erase(nack_info);
+      updateMeasuredRtt(ext_seq_num);
+      clearMissing(ext_seq_num);
     }
     return false;
   }
-  bool available_nacks = addNacks(seq_num);
-  highest_seq_num_ = seq_num;
-  return available_nacks;
+  return addNacks(ext_seq_num);
 }
 
-bool RtcpNackGenerator::addNacks(uint16_t seq_num) {
-  for (uint16_t current_seq_num = highest_seq_num_ + 1; current_seq_num != seq_num; current_seq_num++) {
-    ELOG_DEBUG("message: Inserting a new Nack in list, ssrc: %u, seq_num: %u", ssrc_, current_seq_num);
-    nack_info_list_.push_back(NackInfo{current_seq_num});
+uint64_t RtcpNackGenerator::extendSeqNum(uint16_t seq_num) {
+  int16_t delta = seq_num - static_cast<uint16_t>(highest_ext_seq_num_);
+  return highest_ext_seq_num_ + delta;
+}
+
+bool RtcpNackGenerator::addNacks(uint64_t ext_seq_num) {
+  if (ext_seq_num - highest_ext_seq_num_ > kWindowSize) {
+    // Nothing we are tracking stays in the window
+    missing_.fill(0);
+    missing_count_ = 0;
+    highest_ext_seq_num_ = ext_seq_num - kWindowSize;
+  }
+  for (uint64_t current = highest_ext_seq_num_ + 1; current != ext_seq_num; current++) {
+    ELOG_DEBUG("message: Inserting a new Nack in list, ssrc: %u, seq_num: %u", ssrc_,
+        static_cast<uint16_t>(current));
+    // A bit still set here belongs to the sequence number that is leaving the window
+    if (isMissing(current)) {
+      clearMissing(current);
+    }
+    setMissing(current);
   }
-  while (nack_info_list_.size() > kMaxNacks) {
-     nack_info_list_.erase(nack_info_list_.end() - 1);
+  if (isMissing(ext_seq_num)) {
+    clearMissing(ext_seq_num);
   }
-  return !nack_info_list_.empty();
+  highest_ext_seq_num_ = ext_seq_num;
+  while (missing_count_ > kMaxNacks) {
+    clearMissing(nextMissing(lowestTracked()));
+  }
+  return missing_count_ > 0;
+}
+
+bool RtcpNackGenerator::isMissing(uint64_t ext_seq_num) {
+  uint32_t index = ext_seq_num % kWindowSize;
+  return (missing_[index / 64] >> (index % 64)) & 1;
+}
+
+void RtcpNackGenerator::setMissing(uint64_t ext_seq_num) {
+  uint32_t index = ext_seq_num % kWindowSize;
+  missing_[index / 64] |= uint64_t{1} << (index % 64);
+  retransmits_[index] = 0;
+  sent_time_ms_[index] = 0;
+  missing_count_++;
+}
+
+void RtcpNackGenerator::clearMissing(uint64_t ext_seq_num) {
+  uint32_t index = ext_seq_num % kWindowSize;
+  missing_[index / 64] &= ~(uint64_t{1} << (index % 64));
+  missing_count_--;
+}
+
+uint64_t RtcpNackGenerator::nextMissing(uint64_t from) {
+  // The highest sequence number is never missing
+  while (from < highest_ext_seq_num_) {
+    uint32_t index = from % kWindowSize;
+    uint64_t word = missing_[index / 64] >> (index % 64);
+    if (word != 0) {
+      uint64_t found = from + __builtin_ctzll(word);
+      return found < highest_ext_seq_num_ ? found : 0;
+    }
+    from += 64 - index % 64;
+  }
+  return 0;
 }
 
 bool RtcpNackGenerator::addNackPacketToRr(std::shared_ptr<DataPacket> rr_packet) {
-  // Goes through the list adds blocks of 16 in compound packets (adds more PID/BLP blocks) max is 10 blocks
-  // Only does it if it's time (> 100 ms since last NACK)
-  std::vector <NackBlock> nack_vector;
-  ELOG_DEBUG("message: Adding nacks to RR, nack_info_list_.size(): %lu", nack_info_list_.size());
+  // Adds a PID/BLP block for every missing packet that is due, together with the ones in the next 16
+  ELOG_DEBUG("message: Adding nacks to RR, missing_count_: %lu", missing_count_);
+  if (missing_count_ == 0) {
+    return false;
+  }
+  char* buffer = rr_packet->data + rr_packet->length;
+  size_t max_blocks = (sizeof(rr_packet->data) - rr_packet->length - kNackCommonHeaderLengthBytes) /
+      sizeof(NackBlock);
+  char* blocks = buffer + kNackCommonHeaderLengthBytes;
+  size_t block_count = 0;
   uint64_t now_ms = ClockUtils::timePointToMs(clock_->now());
-  for (uint16_t index = 0; index < nack_info_list_.size(); index++) {
-    NackInfo& base_nack_info = nack_info_list_[index];
-    if (!isTimeToRetransmit(base_nack_info, now_ms)) {
-      ELOG_DEBUG("It's not time to retransmit %lu, now %lu, diff %lu", base_nack_info.sent_time, now_ms,
-          now_ms - base_nack_info.sent_time);
+  uint64_t ext_seq_num = nextMissing(lowestTracked());
+  while (ext_seq_num != 0 && block_count < max_blocks) {
+    uint32_t index = ext_seq_num % kWindowSize;
+    if (!isTimeToRetransmit(ext_seq_num, now_ms)) {
+      ext_seq_num = nextMissing(ext_seq_num + 1);
       continue;
     }
-    if (base_nack_info.retransmits >= kMaxRetransmits) {
+    if (retransmits_[index] >= kMaxRetransmits) {
       ELOG_DEBUG("message: Removing Nack in list too many retransmits, ssrc: %u, seq_num: %u",
-          ssrc_, base_nack_info.seq_num);
-        nack_info_list_.erase(nack_info_list_.begin() + index);
-        index--;  // Items are moved in the list so the next element has the current index
-        continue;
+          ssrc_, static_cast<uint16_t>(ext_seq_num));
+      clearMissing(ext_seq_num);
+      ext_seq_num = nextMissing(ext_seq_num + 1);
+      continue;
     }
-    ELOG_DEBUG("message: PID, seq_num %u", base_nack_info.seq_num);
-    uint16_t pid = base_nack_info.seq_num;
+    ELOG_DEBUG("message: PID, seq_num %u", static_cast<uint16_t>(ext_seq_num));
+    uint64_t pid = ext_seq_num;
     uint16_t blp = 0;
-    base_nack_info.sent_time = now_ms;
-    base_nack_info.retransmits++;
-    while (index + 1u < nack_info_list_.size()) {
-      NackInfo& blp_nack_info = nack_info_list_[index + 1];
-      uint16_t distance = blp_nack_info.seq_num - pid -1;
-      if (distance <= 15) {
-        if (!isTimeToRetransmit(blp_nack_info, now_ms)) {
-          index++;
-          continue;
-        }
-        if (blp_nack_info.retransmits >= kMaxRetransmits) {
+    sent_time_ms_[index] = now_ms;
+    retransmits_[index]++;
+    ext_seq_num = nextMissing(pid + 1);
+    while (ext_seq_num != 0 && ext_seq_num - pid <= kNackBlpSize) {
+      uint32_t blp_index = ext_seq_num % kWindowSize;
+      if (isTimeToRetransmit(ext_seq_num, now_ms)) {
+        if (retransmits_[blp_index] >= kMaxRetransmits) {
           ELOG_DEBUG("message: Removing Nack in list too many retransmits, ssrc: %u, seq_num: %u",
-              ssrc_, blp_nack_info.seq_num);
-          nack_info_list_.erase(nack_info_list_.begin() + index + 1);
-          continue;
+              ssrc_, static_cast<uint16_t>(ext_seq_num));
+          clearMissing(ext_seq_num);
+        } else {
+          ELOG_DEBUG("message: Adding Nack to BLP, seq_num: %u", static_cast<uint16_t>(ext_seq_num));
+          blp |= 1 << (ext_seq_num - pid - 1);
+          sent_time_ms_[blp_index] = now_ms;
+          retransmits_[blp_index]++;
         }
-        ELOG_DEBUG("message: Adding Nack to BLP, seq_num: %u", blp_nack_info.seq_num);
-        blp |= (1 << distance);
-        blp_nack_info.sent_time = now_ms;
-        blp_nack_info.retransmits++;
-        index++;
-      } else {
-        break;
       }
+      ext_seq_num = nextMissing(ext_seq_num + 1);
     }
     NackBlock block;
-    block.setNackPid(pid);
+    block.setNackPid(static_cast<uint16_t>(pid));
     block.setNackBlp(blp);
-    nack_vector.push_back(block);
+    memcpy(blocks + block_count * sizeof(NackBlock), &block, sizeof(NackBlock));
+    block_count++;
   }
-  if (nack_vector.size() == 0) {
+  if (block_count == 0) {
     return false;
   }
 
-  char* buffer = rr_packet->data;
-  buffer += rr_packet->length;
-
   RtcpHeader nack_packet;
   nack_packet.setPacketType(RTCP_RTP_Feedback_PT);
   nack_packet.setBlockCount(1);
   nack_packet.setSSRC(ssrc_);
   nack_packet.setSourceSSRC(ssrc_);
-  nack_packet.setLength(kNackCommonHeaderLengthRtcp + nack_vector.size());
+  nack_packet.setLength(kNackCommonHeaderLengthRtcp + block_count);
   memcpy(buffer, reinterpret_cast<char *>(&nack_packet), kNackCommonHeaderLengthBytes);
-  buffer += kNackCommonHeaderLengthBytes;
-
-  memcpy(buffer, &nack_vector[0], nack_vector.size()*4);
   int nack_length = (nack_packet.getLength()+1)*4;
 
   rr_packet->length += nack_length;
   return true;
 }
 
-bool RtcpNackGenerator::isTimeToRetransmit(const NackInfo& nack_info, uint64_t current_time_ms) {
-  return (nack_info.sent_time == 0 || (current_time_ms - nack_info.sent_time) > kMinNackDelayMs);
+void RtcpNackGenerator::updateMeasuredRtt(uint64_t ext_seq_num) {
+  uint32_t index = ext_seq_num % kWindowSize;
+  // After a second NACK we can't tell which one was answered
+  if (retransmits_[index] != 1) {
+    return;
+  }
+  uint64_t rtt_ms = ClockUtils::timePointToMs(clock_->now()) - sent_time_ms_[index];
+  if (measured_rtt_ms_ == 0) {
+    measured_rtt_ms_ = rtt_ms;
+  } else {
+    measured_rtt_ms_ = (measured_rtt_ms_ * (kRttSmoothing - 1) + rtt_ms) / kRttSmoothing;
+  }
+}
+
+bool RtcpNackGenerator::isTimeToRetransmit(uint64_t ext_seq_num, uint64_t current_time_ms) {
+  uint64_t sent_time_ms = sent_time_ms_[ext_seq_num % kWindowSize];
+  uint64_t retry_delay_ms = std::max<uint64_t>(kMinNackDelayMs, rtt_ms_);
+  return sent_time_ms == 0 || (current_time_ms - sent_time_ms) > retry_delay_ms;
 }
 
 }  // namespace erizo
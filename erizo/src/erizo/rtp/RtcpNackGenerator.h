@@ -1,6 +1,7 @@
 #ifndef ERIZO_SRC_ERIZO_RTP_RTCPNACKGENERATOR_H_
 #define ERIZO_SRC_ERIZO_RTP_RTCPNACKGENERATOR_H_
 
+#include <array>
 #include <memory>
 #include <string>
 #include <map>
@@ -13,15 +14,10 @@
 
 namespace erizo {
 
-class NackInfo {
- public:
-  NackInfo(): seq_num{0}, retransmits{0}, sent_time{0} {}
-  explicit NackInfo(uint16_t seq_num): seq_num{seq_num}, retransmits{0}, sent_time{0} {}
-  uint16_t seq_num;
-  uint16_t retransmits;
-  uint64_t sent_time;
-};
-
+/**
+ * Tracks missing sequence numbers in a ring of bits indexed by extended sequence number, so receiving a
+ * packet and building the NACKs cost the same whatever the loss rate is.
+ */
 class RtcpNackGenerator{
   DECLARE_LOGGER();
 
@@ -31,16 +27,37 @@ class RtcpNackGenerator{
   bool handleRtpPacket(std::shared_ptr<DataPacket> packet);
   bool addNackPacketToRr(std::shared_ptr<DataPacket> rr_packet);
 
+  // NACKs are not sent again for a packet until the round trip time has passed
+  void setRtt(uint32_t rtt_ms) { rtt_ms_ = rtt_ms; }
+  // Smoothed time from a NACK to the retransmission it asked for, 0 until a packet is recovered
+  uint32_t getMeasuredRtt() const { return measured_rtt_ms_; }
+  size_t getPendingNacks() const { return missing_count_; }
+
  private:
-  bool addNacks(uint16_t seq_num);
-  bool isTimeToRetransmit(const NackInfo& nack_info, uint64_t current_time_ms);
+  static constexpr uint32_t kWindowSize = 1024;
+  static constexpr uint32_t kWindowWords = kWindowSize / 64;
+
+  uint64_t extendSeqNum(uint16_t seq_num);
+  bool addNacks(uint64_t ext_seq_num);
+  bool isMissing(uint64_t ext_seq_num);
+  void setMissing(uint64_t ext_seq_num);
+  void clearMissing(uint64_t ext_seq_num);
+  // Returns the first missing extended sequence number from the given one, or 0 if there are none
+  uint64_t nextMissing(uint64_t from);
+  uint64_t lowestTracked() { return highest_ext_seq_num_ - kWindowSize + 1; }
+  bool isTimeToRetransmit(uint64_t ext_seq_num, uint64_t current_time_ms);
+  void updateMeasuredRtt(uint64_t ext_seq_num);
 
  private:
   bool initialized_;
-  uint16_t highest_seq_num_;
+  uint64_t highest_ext_seq_num_;
   uint32_t ssrc_;
-  NackInfo nack_info_;
-  std::vector<NackInfo> nack_info_list_;
+  uint32_t rtt_ms_;
+  uint32_t measured_rtt_ms_;
+  size_t missing_count_;
+  std::array<uint64_t, kWindowWords> missing_;
+  std::array<uint8_t, kWindowSize> retransmits_;
+  std::array<uint64_t, kWindowSize> sent_time_ms_;
   std::shared_ptr<Clock> clock_;
 };
 }  // namespace erizo
@@ -2,6 +2,7 @@
  * RtpExtensionProcessor.cpp
  */
 #include "rtp/RtpExtensionProcessor.h"
+#include <cstdlib>
 #include <map>
 #include <string>
 #include <vector>
@@ -12,7 +13,8 @@ namespace erizo {
 DEFINE_LOGGER(RtpExtensionProcessor, "rtp.RtpExtensionProcessor");
 
 RtpExtensionProcessor::RtpExtensionProcessor(const std::vector<erizo::ExtMap> ext_mappings) :
-    ext_mappings_{ext_mappings}, video_orientation_{kVideoRotation_0}, external_transportcc_id_video_{0} {
+    ext_mappings_{ext_mappings}, video_orientation_{kVideoRotation_0}, mid_id_{StringInterner::kEmptyId},
+    rid_index_{0}, external_transportcc_id_video_{0} {
   translationMap_["urn:ietf:params:rtp-hdrext:ssrc-audio-level"] = SSRC_AUDIO_LEVEL;
   translationMap_["http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time"] = ABS_SEND_TIME;
   translationMap_["urn:ietf:params:rtp-hdrext:toffset"] = TOFFSET;
@@ -43,6 +45,52 @@ void RtpExtensionProcessor::setSdpInfo(std::shared_ptr<SdpInfo> theInfo) {
       ELOG_WARN("Unsupported extension %s", map.uri.c_str());
     }
   }
+  // RIDs are opaque tokens, numeric ones keep their value as layer and the rest follow the SDP order
+  rid_indexes_.clear();
+  const std::vector<Rid>& rids = theInfo->rids();
+  for (unsigned int i = 0; i < rids.size(); i++) {
+    char *end;
+    long numeric_rid = std::strtol(rids[i].id.c_str(), &end, 10);  // NOLINT
+    bool is_numeric = !rids[i].id.empty() && *end == '\0' && numeric_rid > 0;
+    rid_indexes_[rids[i].id] = is_numeric ? static_cast<int>(numeric_rid) : static_cast<int>(i + 1);
+  }
+}
+
+int RtpExtensionProcessor::resolveRidIndex(const std::string& rid) const {
+  auto it = rid_indexes_.find(rid);
+  if (it != rid_indexes_.end()) {
+    return it->second;
+  }
+  char *end;
+  long numeric_rid = std::strtol(rid.c_str(), &end, 10);  // NOLINT
+  if (rid.empty() || *end != '\0' || numeric_rid < 0) {
+    ELOG_WARN("Unknown RID %s, ignoring it", rid.c_str());
+    return 0;
+  }
+  return static_cast<int>(numeric_rid);
+}
+
+void RtpExtensionProcessor::setNegotiatedMids(const std::vector<SdpMediaInfo>& medias) {
+  // Only MIDs from the SDP are interned, the ones received in packets are never added to the interner
+  mid_ids_.clear();
+  for (const SdpMediaInfo& media : medias) {
+    if (!media.mid.empty()) {
+      mid_ids_[media.mid] = StringInterner::intern(media.mid);
+    }
+  }
+  mid_id_ = resolveMidId(mid_);
+}
+
+StringId RtpExtensionProcessor::resolveMidId(const std::string& mid) const {
+  if (mid.empty()) {
+    return StringInterner::kEmptyId;
+  }
+  auto it = mid_ids_.find(mid);
+  if (it == mid_ids_.end()) {
+    ELOG_WARN("Unknown MID %s, ignoring it", mid.c_str());
+    return StringInterner::kEmptyId;
+  }
+  return it->second;
 }
 
 void RtpExtensionProcessor::setExtension(MediaType type, uint16_t internal_value, uint16_t value) {
@@ -101,17 +149,17 @@ uint32_t RtpExtensionProcessor::processRtpExtensions(std::shared_ptr<DataPacket>
           switch (extMap[current_ext_id]) {
             case MID:
               processMid(ext_buffer);
-              if (!p->mid.empty()) {
+              if (p->mid != StringInterner::kEmptyId) {
                 ext_byte = ext_buffer + 1;
-                ext_byte[0] = p->mid.c_str()[0];
+                ext_byte[0] = StringInterner::lookup(p->mid).c_str()[0];
               }
-              p->mid = mid_;
+              p->mid = mid_id_;
               break;
             case RTP_ID:
               processRid(ext_buffer);
               ext_byte = ext_buffer + 1;
               ext_byte[0] = a[0];
-              p->rid = rid_;
+              p->rid = rid_index_;
               break;
             case ABS_SEND_TIME:
               processAbsSendTime(ext_buffer);
@@ -231,8 +279,12 @@ uint32_t RtpExtensionProcessor::processTransportCc(char* buf, uint16_t new_seq_n
 
 uint32_t RtpExtensionProcessor::processMid(char* buf) {
   GenericOneByteExtension* header = new GenericOneByteExtension(buf);
-  mid_ = std::string(header->getData());
+  std::string mid = std::string(header->getData());
   delete header;
+  if (mid != mid_) {
+    mid_ = mid;
+    mid_id_ = resolveMidId(mid_);
+  }
   return 0;
 }
 
@@ -242,8 +294,12 @@ std::string RtpExtensionProcessor::getRid() {
 
 uint32_t RtpExtensionProcessor::processRid(char* buf) {
   GenericOneByteExtension* header = new GenericOneByteExtension(buf);
-  rid_ = std::string(header->getData());
+  std::string rid = std::string(header->getData());
   delete header;
+  if (rid != rid_) {
+    rid_ = rid;
+    rid_index_ = resolveRidIndex(rid_);
+  }
   return 0;
 }
 
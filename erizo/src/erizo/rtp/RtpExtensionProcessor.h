@@ -32,6 +32,7 @@ class RtpExtensionProcessor{
   virtual ~RtpExtensionProcessor();
 
   void setSdpInfo(std::shared_ptr<SdpInfo> theInfo);
+  void setNegotiatedMids(const std::vector<SdpMediaInfo>& medias);
   uint32_t processRtpExtensions(std::shared_ptr<DataPacket> p);
   uint32_t removeMidAndRidExtensions(std::shared_ptr<DataPacket> p);
   VideoRotation getVideoRotation();
@@ -58,12 +59,20 @@ class RtpExtensionProcessor{
   VideoRotation video_orientation_;
   std::string mid_;
   std::string rid_;
+  StringId mid_id_;
+  int rid_index_;
+  // Simulcast layer (starting at 1) for each RID negotiated in the SDP
+  std::map<std::string, int> rid_indexes_;
+  // Id of each MID negotiated in the SDP, MIDs received in packets are only resolved against them
+  std::map<std::string, StringId> mid_ids_;
   uint16_t external_transportcc_id_video_;
 
   uint32_t processAbsSendTime(char* buf);
   uint32_t processVideoOrientation(char* buf);
   uint32_t processRid(char* buf);
   uint32_t processMid(char* buf);
+  int resolveRidIndex(const std::string& rid) const;
+  StringId resolveMidId(const std::string& mid) const;
   uint32_t stripExtension(char* buf, int len);
   uint32_t addTransportCc(std::shared_ptr<DataPacket> p);
   uint32_t processTransportCc(char* buf, uint16_t new_seq_num);
@@ -33,12 +33,17 @@ RtpH264Parser::~RtpH264Parser() {
 
 RTPPayloadH264* RtpH264Parser::parseH264(unsigned char* buf, int len) {
   RTPPayloadH264* h264 = new RTPPayloadH264;
+  parseH264(buf, len, h264, true);
+  return h264;
+}
+
+void RtpH264Parser::parseH264(unsigned char* buf, int len, RTPPayloadH264* h264, bool unpack_aggregated) {
   uint8_t nal;
   uint8_t type;
 
   if (!len) {
     ELOG_ERROR("Empty H.264 RTP packet");
-    return h264;
+    return;
   }
 
   nal  = buf[0];
@@ -63,7 +68,7 @@ RTPPayloadH264* RtpH264Parser::parseH264(unsigned char* buf, int len) {
       // Consume the STAP-A NAL
       buf++;
       len--;
-      parse_aggregated_packet(h264, buf, len);
+      parse_aggregated_packet(h264, buf, len, unpack_aggregated);
       break;
     case 25:           // STAP-B
     case 26:           // MTAP-16
@@ -80,8 +85,6 @@ RTPPayloadH264* RtpH264Parser::parseH264(unsigned char* buf, int len) {
       ELOG_ERROR("Undefined H264 NAL unit type (%d)", type);
       break;
   }
-
-  return h264;
 }
 
 int RtpH264Parser::parse_packet_fu_a(RTPPayloadH264* h264, unsigned char* buf, int len) const {
@@ -117,7 +120,7 @@ int RtpH264Parser::parse_packet_fu_a(RTPPayloadH264* h264, unsigned char* buf, i
   return 0;
 }
 
-int RtpH264Parser::parse_aggregated_packet(RTPPayloadH264* h264, unsigned char* buf, int len) const {
+int RtpH264Parser::parse_aggregated_packet(RTPPayloadH264* h264, unsigned char* buf, int len, bool unpack) const {
   h264->nal_type = aggregated;
   unsigned char* dst = nullptr;
   int pass     = 0;
@@ -139,6 +142,9 @@ int RtpH264Parser::parse_aggregated_packet(RTPPayloadH264* h264, unsigned char*
         if (pass == 0) {
           // counting
           total_length += sizeof(RTPPayloadH264::start_sequence) + nal_size;
+          if (!unpack && (src[0] & 0x1f) == 5) {
+            h264->frameType = kH264IFrame;
+          }
         } else {
           // copying
           std::memcpy(dst, RTPPayloadH264::start_sequence, sizeof(RTPPayloadH264::start_sequence));
@@ -160,6 +166,9 @@ int RtpH264Parser::parse_aggregated_packet(RTPPayloadH264* h264, unsigned char*
       src_len -= nal_size;
     }
 
+    if (pass == 0 && !unpack) {
+      return 0;
+    }
     if (pass == 0) {
       /* now we know the total size of the packet (with the start sequences added) */
       h264->unpacked_data_len = total_length;
@@ -37,9 +37,11 @@ class RtpH264Parser {
   RtpH264Parser();
   virtual ~RtpH264Parser();
   erizo::RTPPayloadH264* parseH264(unsigned char* data, int datalength);
+  // Fills a payload owned by the caller. Aggregated NALs are only copied to unpacked_data when requested
+  void parseH264(unsigned char* data, int datalength, erizo::RTPPayloadH264* payload, bool unpack_aggregated);
  private:
   int parse_packet_fu_a(RTPPayloadH264* h264, unsigned char* buf, int len) const;
-  int parse_aggregated_packet(RTPPayloadH264* h264, unsigned char* buf, int len) const;
+  int parse_aggregated_packet(RTPPayloadH264* h264, unsigned char* buf, int len, bool unpack) const;
 };
 }  // namespace erizo
 #endif  // ERIZO_SRC_ERIZO_RTP_RTPH264PARSER_H_
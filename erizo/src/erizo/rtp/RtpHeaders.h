@@ -495,7 +495,7 @@ class RtcpHeader {
   inline bool isREMB() {
     return packettype == RTCP_PS_Feedback_PT && blockcount == RTCP_AFB;
   }
-  inline bool isRtcp(void) {
+  inline bool isRtcp(void) const {
     return (packettype >= RTCP_MIN_PT && packettype <= RTCP_MAX_PT);
   }
   inline uint8_t getPacketType() {
@@ -1,8 +1,11 @@
 #include "rtp/RtpPacketQueue.h"
 
+#include <boost/make_shared.hpp>
+
 #include <cstring>
 
 #include "./MediaDefinitions.h"
+#include "lib/PoolAllocator.h"
 #include "rtp/RtpHeaders.h"
 
 using std::memcpy;
@@ -12,7 +15,9 @@ namespace erizo {
 DEFINE_LOGGER(RtpPacketQueue, "rtp.RtpPacketQueue");
 
 RtpPacketQueue::RtpPacketQueue(double depthInSeconds, double maxDepthInSeconds) :
-  lastSequenceNumberGiven_(-1), timebase_(0), depthInSeconds_(depthInSeconds), maxDepthInSeconds_(maxDepthInSeconds) {
+  slots_(kCapacity), size_(0), oldest_(0), newest_(0), lastSequenceNumberGiven_(-1), releasable_packets_(0),
+  late_packets_(0), duplicate_packets_(0), dropped_packets_(0),
+  timebase_(0), depthInSeconds_(depthInSeconds), maxDepthInSeconds_(maxDepthInSeconds) {
   if (depthInSeconds_ >= maxDepthInSeconds_) {
       ELOG_WARN("invalid configuration, depth_: %f, max_: %f; reset to defaults",
                  depthInSeconds_, maxDepthInSeconds_);
@@ -22,19 +27,21 @@ RtpPacketQueue::RtpPacketQueue(double depthInSeconds, double maxDepthInSeconds)
 }
 
 RtpPacketQueue::~RtpPacketQueue(void) {
-  queue_.clear();
+  slots_.clear();
 }
 
 void RtpPacketQueue::pushPacket(const char *data, int length) {
   const RtpHeader *currentHeader = reinterpret_cast<const RtpHeader*>(data);
   uint16_t currentSequenceNumber = currentHeader->getSeqNumber();
 
+  boost::mutex::scoped_lock lock(queueMutex_);
   if (lastSequenceNumberGiven_ >= 0 &&
         (rtpSequenceLessThan(currentSequenceNumber, (uint16_t)lastSequenceNumberGiven_) ||
         currentSequenceNumber == lastSequenceNumberGiven_)) {
     // this sequence number is less than the stuff we've already handed out,
     // which means it's too late to be of any value.
-    ELOG_WARN("SSRC:%u, Payload: %u, discarding very late sample %d that is <= %d",
+    late_packets_++;
+    ELOG_DEBUG("SSRC:%u, Payload: %u, discarding very late sample %d that is <= %d",
               currentHeader->getSSRC(),
               currentHeader->getPayloadType(),
               currentSequenceNumber,
@@ -42,41 +49,61 @@ void RtpPacketQueue::pushPacket(const char *data, int length) {
     return;
   }
 
-  // TODO(pedro) this should be a secret of the DataPacket class.  It should maintain its own memory
-  // and copy stuff as necessary.
-  boost::shared_ptr<DataPacket> packet(new DataPacket());
-  memcpy(packet->data, data, length);
-  packet->length = length;
-
-  // let's insert this packet where it belongs in the queue.
-  boost::mutex::scoped_lock lock(queueMutex_);
-  std::list<boost::shared_ptr<DataPacket> >::iterator it;
-  for (it=queue_.begin(); it != queue_.end(); ++it) {
-    const RtpHeader *header = reinterpret_cast<const RtpHeader*>((*it)->data);
-    uint16_t sequenceNumber = header->getSeqNumber();
-
-    if (sequenceNumber == currentSequenceNumber) {
+  if (size_ > 0) {
+    if (rtpSequenceLessThan(currentSequenceNumber, oldest_)) {
+      if (static_cast<uint16_t>(newest_ - currentSequenceNumber) >= kCapacity) {
+        late_packets_++;
+        ELOG_DEBUG("discarding sample %d, it is too old to fit in the queue", currentSequenceNumber);
+        return;
+      }
+    } else {
+      // Make room for packets that are too far ahead of the oldest one
+      while (size_ > 0 && static_cast<uint16_t>(currentSequenceNumber - oldest_) >= kCapacity) {
+        dropped_packets_++;
+        takeOldest();
+        releasable_packets_ = 0;
+      }
+    }
+    if (isStored(currentSequenceNumber)) {
       // We already have this sequence number in the queue.
-      ELOG_INFO("discarding duplicate sample %d", currentSequenceNumber);
-      break;
+      duplicate_packets_++;
+      ELOG_DEBUG("discarding duplicate sample %d", currentSequenceNumber);
+      return;
     }
+  }
 
-    if (this->rtpSequenceLessThan(sequenceNumber, currentSequenceNumber)) {
-      queue_.insert(it, packet);
-      break;
-    }
+  // Blocks come from the packet pool, so in steady state storing a packet doesn't allocate.
+  Slot &slot = slotFor(currentSequenceNumber);
+  slot.packet = boost::allocate_shared<DataPacket>(PoolAllocator<DataPacket>());
+  memcpy(slot.packet->data, data, length);
+  slot.packet->length = length;
+  slot.timestamp = currentHeader->getTimestamp();
+  slot.sequence_number = currentSequenceNumber;
+  slot.frame_packets = 0;
+  slot.marker = currentHeader->getMarker();
+  slot.frame_start = frame_start_detector_ && frame_start_detector_(data, length);
+
+  if (size_ == 0) {
+    oldest_ = newest_ = currentSequenceNumber;
+  } else if (rtpSequenceLessThan(currentSequenceNumber, oldest_)) {
+    oldest_ = currentSequenceNumber;
+  } else if (rtpSequenceLessThan(newest_, currentSequenceNumber)) {
+    newest_ = currentSequenceNumber;
   }
+  size_++;
 
-  if (it == queue_.end()) {
-    // something old, or queue is empty.
-    queue_.push_back(packet);
+  if (frame_start_detector_) {
+    checkFrameComplete(currentSequenceNumber);
   }
 
   // Enforce our max queue size.
   while (getDepthInSeconds() > maxDepthInSeconds_) {
     ELOG_WARN("RtpPacketQueue - Discarding a sample due to excessive queue depth");
-    queue_.pop_back();  // remove oldest samples.
+    dropped_packets_++;
+    takeOldest();  // remove oldest samples.
+    releasable_packets_ = 0;
   }
+  updateReleasablePackets();
 }
 
 // pops a packet off the queue, respecting the specified queue depth.
@@ -84,36 +111,115 @@ boost::shared_ptr<DataPacket> RtpPacketQueue::popPacket(bool ignore_depth) {
   boost::shared_ptr<DataPacket> packet;
 
   boost::mutex::scoped_lock lock(queueMutex_);
-  if (queue_.size() > 0) {
-    if (ignore_depth || getDepthInSeconds() > depthInSeconds_) {
-      packet = queue_.back();
-      queue_.pop_back();
-      const RtpHeader *header = reinterpret_cast<const RtpHeader*>(packet->data);
-      lastSequenceNumberGiven_ = static_cast<int>(header->getSeqNumber());
+  if (size_ > 0) {
+    if (ignore_depth || releasable_packets_ > 0 || getDepthInSeconds() > depthInSeconds_) {
+      lastSequenceNumberGiven_ = static_cast<int>(oldest_);
+      packet = takeOldest();
+      updateReleasablePackets();
     }
   }
 
   return packet;
 }
 
+bool RtpPacketQueue::isStored(uint16_t sequence_number) {
+  const Slot &slot = slotFor(sequence_number);
+  return slot.packet && slot.sequence_number == sequence_number;
+}
+
+boost::shared_ptr<DataPacket> RtpPacketQueue::takeOldest() {
+  Slot &slot = slotFor(oldest_);
+  boost::shared_ptr<DataPacket> packet;
+  packet.swap(slot.packet);
+  slot.frame_packets = 0;
+  size_--;
+  if (releasable_packets_ > 0) {
+    releasable_packets_--;
+  }
+  // Skip the gaps, so oldest_ always points to a packet we have
+  while (size_ > 0 && !isStored(++oldest_)) {
+  }
+  return packet;
+}
+
+// A frame is complete when we have every packet from its start (same timestamp and flagged by the
+// detector) to the one with the marker bit. It only walks the packets of the frame the new one belongs to.
+void RtpPacketQueue::checkFrameComplete(uint16_t sequence_number) {
+  const uint32_t timestamp = slotFor(sequence_number).timestamp;
+  uint16_t first = sequence_number;
+  while (isStored(first - 1)) {
+    const Slot &previous = slotFor(first - 1);
+    if (previous.marker || previous.timestamp != timestamp) {
+      break;
+    }
+    first--;
+  }
+  if (!slotFor(first).frame_start) {
+    return;
+  }
+  uint16_t last = sequence_number;
+  while (!slotFor(last).marker) {
+    if (!isStored(last + 1) || slotFor(last + 1).timestamp != timestamp) {
+      return;
+    }
+    last++;
+  }
+  slotFor(first).frame_packets = static_cast<uint16_t>(last - first) + 1;
+}
+
+// Complete frames can skip the depth wait only if they directly follow the last packet we handed out,
+// otherwise we'd be giving up on the missing packets before them.
+void RtpPacketQueue::updateReleasablePackets() {
+  if (releasable_packets_ > 0 || size_ == 0 || lastSequenceNumberGiven_ < 0 ||
+      oldest_ != static_cast<uint16_t>(lastSequenceNumberGiven_ + 1)) {
+    return;
+  }
+  releasable_packets_ = slotFor(oldest_).frame_packets;
+}
+
 void RtpPacketQueue::setTimebase(unsigned int timebase) {
   boost::mutex::scoped_lock lock(queueMutex_);
   timebase_ = timebase;
 }
 
+void RtpPacketQueue::setFrameStartDetector(FrameStartDetector detector) {
+  boost::mutex::scoped_lock lock(queueMutex_);
+  frame_start_detector_ = detector;
+}
+
 int RtpPacketQueue::getSize() {
   boost::mutex::scoped_lock lock(queueMutex_);
-  return queue_.size();
+  return size_;
+}
+
+double RtpPacketQueue::getDepth() {
+  boost::mutex::scoped_lock lock(queueMutex_);
+  return getDepthInSeconds();
+}
+
+uint64_t RtpPacketQueue::getLatePackets() {
+  boost::mutex::scoped_lock lock(queueMutex_);
+  return late_packets_;
+}
+
+uint64_t RtpPacketQueue::getDuplicatePackets() {
+  boost::mutex::scoped_lock lock(queueMutex_);
+  return duplicate_packets_;
+}
+
+uint64_t RtpPacketQueue::getDroppedPackets() {
+  boost::mutex::scoped_lock lock(queueMutex_);
+  return dropped_packets_;
 }
 
 double RtpPacketQueue::getDepthInSeconds() {
   // must be called while queueMutex_ is taken.  Private method.  Also, if no timebase has been set, this always
   // returns zero because we have no way of interpreting how much data is in the queue.
   double depth = 0.0;
-  if (timebase_ > 0 && queue_.size() > 1) {
-    const RtpHeader *oldest = reinterpret_cast<const RtpHeader*>(queue_.back()->data);
-    const RtpHeader *newest = reinterpret_cast<const RtpHeader*>(queue_.front()->data);
-    depth = (static_cast<double>(newest->getTimestamp() - oldest->getTimestamp())) / static_cast<double>(timebase_);
+  if (timebase_ > 0 && size_ > 1) {
+    uint32_t oldest = slotFor(oldest_).timestamp;
+    uint32_t newest = slotFor(newest_).timestamp;
+    depth = (static_cast<double>(newest - oldest)) / static_cast<double>(timebase_);
   }
 
   return depth;
@@ -121,6 +227,9 @@ double RtpPacketQueue::getDepthInSeconds() {
 
 bool RtpPacketQueue::hasData() {
   boost::mutex::scoped_lock lock(queueMutex_);
+  if (releasable_packets_ > 0) {
+    return true;
+  }
   double currentDepth = getDepthInSeconds();
   return currentDepth > depthInSeconds_;
 }
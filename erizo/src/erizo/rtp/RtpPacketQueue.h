@@ -4,7 +4,8 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 
-#include <list>
+#include <functional>
+#include <vector>
 
 #include "./logger.h"
 
@@ -15,21 +16,26 @@ struct DataPacket;
 static const double DEFAULT_DEPTH = 3.0;
 static const double DEFAULT_MAX = 5.0;
 
-// This class implements a packet reordering queue. Here's what it does:
+// This class implements a packet reordering queue (a jitter buffer). Here's what it does:
 //
-// 1. Receives incoming packets and pushes them into a queue based on sequence number
+// 1. Receives incoming packets and stores them in a ring indexed by sequence number, so inserting
+//    an out of order packet costs the same as inserting an in order one
 // 2. Rejects duplicate packets--duplicate sequence numbers are dropped on the floor
 // 3. Handles sequence number wrap (e.g. packet "1" is technically greater than "65535" because that
 //    is a sequence number wrap
 // 4. Handles out of order packets
-// 5. Handles late packets.  Packets with sequence number greater than the last sequence number
-//    handed out through popPacket are discarded.  There's a log message to help identify
-//    a sane value for their queue depth.
+// 5. Handles late packets.  Packets with sequence number lower than the last sequence number
+//    handed out through popPacket are discarded and counted (see getLatePackets()) to help
+//    identify a sane value for the queue depth.
 // 6. Is threadsafe.  All public methods lock to ensure the container isn't fouled by multithreaded
 //    access.  This also prevents a minimal amount of locking in calling classes, which prevents
 //    blocking of worker threads.
 // 7. Manages queue depth.  It won't return data until depth (which is % of seconds) is attained, and
-//    will prevent the queue from growing over max seconds.
+//    will prevent the queue from growing over max seconds or kCapacity packets.
+// 8. Is frame aware when given a frame start detector (e.g. Vp8Depacketizer::isFrameStart).  Frames
+//    are complete once we have every packet from their start to the one with the marker bit.  A
+//    complete frame that directly follows the last packet handed out doesn't need to wait for more
+//    packets, so it is released regardless of the depth.
 //
 // Usage is straight-forward:
 //
@@ -41,22 +47,57 @@ class RtpPacketQueue {
   DECLARE_LOGGER();
 
  public:
+  typedef std::function<bool(const char *data, int length)> FrameStartDetector;
+
+  // Must be a power of two, and lower than half the sequence number space so we can tell whether a
+  // packet is older or newer than the ones we have.
+  static constexpr uint16_t kCapacity = 8192;
+
   explicit RtpPacketQueue(double depthInSeconds = DEFAULT_DEPTH, double maxDepthInSeconds = DEFAULT_MAX);
   ~RtpPacketQueue(void);
   void setTimebase(unsigned int timebase);
+  void setFrameStartDetector(FrameStartDetector detector);
   void pushPacket(const char *data, int length);
   boost::shared_ptr<DataPacket> popPacket(bool ignore_depth = false);
   int getSize();  // total size of all items in the queue
-  bool hasData();  // whether or not current queue depth is >= depth_
+  bool hasData();  // whether or not current queue depth is >= depth_, or a complete frame can be released
+  double getDepth();  // in seconds
+  uint64_t getLatePackets();
+  uint64_t getDuplicatePackets();
+  uint64_t getDroppedPackets();  // because of max depth or capacity
 
  private:
+  struct Slot {
+    boost::shared_ptr<DataPacket> packet;
+    uint32_t timestamp;
+    uint16_t sequence_number;
+    uint16_t frame_packets;  // only set in the first packet of a complete frame
+    bool marker;
+    bool frame_start;
+  };
+
   // Only used internally; does the math to calculate our current depth based on the supplied timebase.
   // Must be called with queueMutex_ locked.
   double getDepthInSeconds();
 
+  // The following must be called with queueMutex_ locked too.
+  Slot& slotFor(uint16_t sequence_number) { return slots_[sequence_number & (kCapacity - 1)]; }
+  bool isStored(uint16_t sequence_number);
+  boost::shared_ptr<DataPacket> takeOldest();
+  void checkFrameComplete(uint16_t sequence_number);
+  void updateReleasablePackets();
+
   boost::mutex queueMutex_;
-  std::list<boost::shared_ptr<DataPacket> > queue_;
+  std::vector<Slot> slots_;
+  int size_;
+  uint16_t oldest_;
+  uint16_t newest_;
   int lastSequenceNumberGiven_;
+  int releasable_packets_;
+  FrameStartDetector frame_start_detector_;
+  uint64_t late_packets_;
+  uint64_t duplicate_packets_;
+  uint64_t dropped_packets_;
   bool rtpSequenceLessThan(uint16_t x, uint16_t y);
 
   // We use a timebase so we can understand how many seconds of data we have in our queue.
@@ -2,8 +2,11 @@
 #include "rtp/RtpRetransmissionHandler.h"
 
 #include <algorithm>
+#include <cstring>
 
+#include "lib/PacketPool.h"
 #include "rtp/RtpUtils.h"
+#include "stats/Metrics.h"
 
 namespace erizo {
 
@@ -16,7 +19,9 @@ RtpRetransmissionHandler::RtpRetransmissionHandler(std::shared_ptr<erizo::Clock>
     stream_{nullptr},
     initialized_{false}, enabled_{true},
     bucket_{static_cast<uint64_t>(kDefaultBitrate * kMarginRtxBitrate), kBurstSize, clock_},
-    last_bitrate_time_{clock_->now()} {}
+    last_bitrate_time_{clock_->now()},
+    rtx_seq_num_{0},
+    suppressed_retransmissions_{0} {}
 
 
 void RtpRetransmissionHandler::enable() {
@@ -36,6 +41,10 @@ void RtpRetransmissionHandler::notifyUpdate() {
     if (stats_ && packet_buffer_) {
       initialized_ = true;
     }
+    if (stream_) {
+      // The RTX SSRC is random, so is the first RTX sequence number
+      rtx_seq_num_ = static_cast<uint16_t>(stream_->getVideoSinkRtxSSRC());
+    }
   }
 }
 
@@ -62,6 +71,52 @@ void RtpRetransmissionHandler::calculateRtxBitrate() {
   }
 }
 
+void RtpRetransmissionHandler::updateBufferStats() {
+  StatNode &total = stats_->getNode()["total"];
+  total.insertStat("rtxBufferHits", CumulativeStat{packet_buffer_->getHits()});
+  total.insertStat("rtxBufferMisses", CumulativeStat{packet_buffer_->getMisses()});
+  total.insertStat("rtxBufferTooOld", CumulativeStat{packet_buffer_->getTooOld()});
+  total.insertStat("rtxSuppressed", CumulativeStat{suppressed_retransmissions_});
+}
+
+duration RtpRetransmissionHandler::getRetransmissionInterval() {
+  duration rtt = stream_ ? std::chrono::milliseconds(stream_->getRtt()) : duration{0};
+  return std::max<duration>(rtt, kMinRetransmissionInterval);
+}
+
+std::shared_ptr<DataPacket> RtpRetransmissionHandler::createRetransmission(const DataPacket &packet) {
+  // The buffered packet is shared with the history, the copy lets the pacer tell it is a retransmission
+  std::shared_ptr<DataPacket> retransmission = PacketPool::clone(packet);
+  retransmission->is_retransmission = true;
+  RtpHeader *head = reinterpret_cast<RtpHeader*>(retransmission->data);
+  uint32_t rtx_ssrc = stream_ ? stream_->getVideoSinkRtxSSRC() : 0;
+  std::shared_ptr<SdpInfo> remote_sdp = stream_ ? stream_->getRemoteSdpInfo() : std::shared_ptr<SdpInfo>();
+  if (packet.type != VIDEO_PACKET || rtx_ssrc == 0 || !remote_sdp) {
+    return retransmission;
+  }
+  unsigned int rtx_pt = remote_sdp->getVideoRtxPT(head->getPayloadType());
+  int length = retransmission->length;
+  if (head->hasPadding()) {
+    length -= static_cast<uint8_t>(retransmission->data[length - 1]);
+  }
+  int header_length = head->getHeaderLength();
+  if (rtx_pt == 0 || length < header_length ||
+      static_cast<size_t>(length) + sizeof(uint16_t) > sizeof(retransmission->data)) {
+    return retransmission;
+  }
+  // RFC 4588: the original sequence number goes before the payload, padding is not kept
+  char *payload = retransmission->data + header_length;
+  memmove(payload + sizeof(uint16_t), payload, length - header_length);
+  uint16_t original_seq_num = htons(head->getSeqNumber());
+  memcpy(payload, &original_seq_num, sizeof(uint16_t));
+  head->setPadding(0);
+  head->setSSRC(rtx_ssrc);
+  head->setPayloadType(rtx_pt);
+  head->setSeqNumber(rtx_seq_num_++);
+  retransmission->length = length + sizeof(uint16_t);
+  return retransmission;
+}
+
 void RtpRetransmissionHandler::read(Context *ctx, std::shared_ptr<DataPacket> packet) {
   if (!enabled_ || !initialized_) {
     return;
@@ -70,46 +125,56 @@ void RtpRetransmissionHandler::read(Context *ctx, std::shared_ptr<DataPacket> pa
 
   bool contains_nack = false;
   bool is_fully_recovered = true;
+  time_point now = clock_->now();
+  duration retransmission_interval = getRetransmissionInterval();
 
-  RtpUtils::forEachRtcpBlock(packet, [this, &contains_nack, &is_fully_recovered](RtcpHeader *chead) {
+  RtpUtils::forEachRtcpBlock(packet, [this, &contains_nack, &is_fully_recovered, now,
+      retransmission_interval](RtcpHeader *chead) {
     if (chead->isNACK()) {
       contains_nack = true;
-      RtpUtils::forEachNack(chead, [this, chead, &is_fully_recovered](uint16_t new_seq_num,
-         uint16_t new_plb, RtcpHeader* nack_head) {
+      RtpUtils::forEachNack(chead, [this, chead, &is_fully_recovered, now, retransmission_interval](
+          uint16_t new_seq_num, uint16_t new_plb, RtcpHeader* nack_head) {
         uint16_t initial_seq_num = new_seq_num;
         uint16_t plb = new_plb;
+        uint32_t source_ssrc = chead->getSourceSSRC();
 
         for (int i = -1; i <= kNackBlpSize; i++) {
           uint16_t seq_num = initial_seq_num + i + 1;
           bool packet_nacked = i == -1 || (plb >> i) & 0x0001;
-
-          if (packet_nacked) {
-          std::shared_ptr<DataPacket> recovered;
-
-          if (stream_->getVideoSinkSSRC() == chead->getSourceSSRC()) {
-            recovered = packet_buffer_->getVideoPacket(seq_num);
-          } else if (stream_->getAudioSinkSSRC() == chead->getSourceSSRC()) {
-            recovered = packet_buffer_->getAudioPacket(seq_num);
+          if (!packet_nacked) {
+            continue;
           }
-
-          if (recovered.get()) {
-            if (!bucket_.consume(recovered->length)) {
-              continue;
-            }
-            RtpHeader *recovered_head = reinterpret_cast<RtpHeader*> (recovered->data);
-            if (recovered_head->getSeqNumber() == seq_num) {
-              getRtxBitrateStat() += recovered->length;
-              getContext()->fireWrite(recovered);
-              continue;
-            }
+          std::shared_ptr<DataPacket> recovered = packet_buffer_->getPacket(source_ssrc, seq_num);
+          if (!recovered.get()) {
+            ELOG_DEBUG("Packet missed in buffer %d", seq_num);
+            is_fully_recovered = false;
+            continue;
+          }
+          PacketHistory::Retransmissions *retransmissions = packet_buffer_->getRetransmissions(source_ssrc, seq_num);
+          // Without the bookkeeping of the packet it is retransmitted without suppressing duplicates
+          if (retransmissions && retransmissions->count > 0 &&
+              now - retransmissions->last_sent_at < retransmission_interval) {
+            // The previous retransmission can still be on its way
+            suppressed_retransmissions_++;
+            continue;
           }
-          ELOG_DEBUG("Packet missed in buffer %d", seq_num);
-          is_fully_recovered = false;
+          if (!bucket_.consume(recovered->length)) {
+            continue;
           }
+          if (retransmissions) {
+            retransmissions->last_sent_at = now;
+            retransmissions->count++;
+          }
+          getRtxBitrateStat() += recovered->length;
+          WorkerMetrics::current().retransmissions.add();
+          getContext()->fireWrite(createRetransmission(*recovered));
         }
       });
     }
   });
+  if (contains_nack) {
+    updateBufferStats();
+  }
   if (!contains_nack || !is_fully_recovered) {
     ctx->fireRead(std::move(packet));
   }
@@ -14,6 +14,8 @@ static constexpr uint kRetransmissionsBufferSize = 256;
 static constexpr int kNackBlpSize = 16;
 
 static constexpr erizo::duration kTimeToUpdateBitrate = std::chrono::milliseconds(500);
+// A packet is not retransmitted again until max(RTT, this) has passed since its previous retransmission
+static constexpr erizo::duration kMinRetransmissionInterval = std::chrono::milliseconds(10);
 static constexpr float kMarginRtxBitrate = 0.1;
 static constexpr int kBurstSize = 1300 * 20;  // 20 packets with almost max size
 
@@ -21,6 +23,11 @@ namespace erizo {
 
 class MediaStream;
 
+/**
+ * Answers NACKs with the packets kept in PacketBufferService. Every buffered packet remembers when it was
+ * last retransmitted so NACKs repeated within one RTT do not send it twice, and retransmissions are sent as
+ * RTX (RFC 4588) on the subscriber RTX SSRC when the subscriber negotiated RTX for their payload type.
+ */
 class RtpRetransmissionHandler : public Handler {
  public:
   DECLARE_LOGGER();
@@ -42,6 +49,9 @@ class RtpRetransmissionHandler : public Handler {
   MovingIntervalRateStat& getRtxBitrateStat();
   uint64_t getBitrateCalculated();
   void calculateRtxBitrate();
+  void updateBufferStats();
+  duration getRetransmissionInterval();
+  std::shared_ptr<DataPacket> createRetransmission(const DataPacket &packet);
 
  private:
   std::shared_ptr<erizo::Clock> clock_;
@@ -51,6 +61,8 @@ class RtpRetransmissionHandler : public Handler {
   std::shared_ptr<PacketBufferService> packet_buffer_;
   TokenBucket bucket_;
   erizo::time_point last_bitrate_time_;
+  uint16_t rtx_seq_num_;
+  uint64_t suppressed_retransmissions_;
 };
 }  // namespace erizo
 
@@ -346,8 +346,13 @@ int RtpVP8Parser::removeTIDAndKeyIdx(unsigned char* data, int data_length) {
 }
 
 RTPPayloadVP8* RtpVP8Parser::parseVP8(unsigned char* data, int dataLength) {
+  RTPPayloadVP8* vp8 = new RTPPayloadVP8;
+  parseVP8(data, dataLength, vp8);
+  return vp8;
+}
+
+void RtpVP8Parser::parseVP8(unsigned char* data, int dataLength, RTPPayloadVP8* vp8) {
   // ELOG_DEBUG("Parsing VP8 %d bytes", dataLength);
-  RTPPayloadVP8* vp8 = new RTPPayloadVP8;  // = &parsedPacket.info.VP8;
   const unsigned char* dataPtr = data;
 
   // Parse mandatory first byte of payload descriptor
@@ -361,7 +366,7 @@ RTPPayloadVP8* RtpVP8Parser::parseVP8(unsigned char* data, int dataLength) {
 
   if (vp8->partitionID > 8) {
     // Weak check for corrupt data: PartID MUST NOT be larger than 8.
-    return vp8;
+    return;
   }
 
   // Advance dataPtr and decrease remaining payload size
@@ -371,7 +376,7 @@ RTPPayloadVP8* RtpVP8Parser::parseVP8(unsigned char* data, int dataLength) {
   if (extension) {
     const int parsedBytes = ParseVP8Extension(vp8, dataPtr, dataLength);
     if (parsedBytes < 0) {
-      return vp8;
+      return;
     }
     dataPtr += parsedBytes;
     dataLength -= parsedBytes;
@@ -380,7 +385,7 @@ RTPPayloadVP8* RtpVP8Parser::parseVP8(unsigned char* data, int dataLength) {
 
   if (dataLength <= 0) {
     ELOG_WARN("Error parsing VP8 payload descriptor; payload too short");
-    return vp8;
+    return;
   }
 
   // Read P bit from payload header (only at beginning of first partition)
@@ -397,7 +402,5 @@ RTPPayloadVP8* RtpVP8Parser::parseVP8(unsigned char* data, int dataLength) {
   }
   vp8->data = dataPtr;
   vp8->dataLength = (unsigned int) dataLength;
-
-  return vp8;
 }
 }  // namespace erizo
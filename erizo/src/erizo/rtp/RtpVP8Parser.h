@@ -42,6 +42,8 @@ class RtpVP8Parser {
   static int removeTl0PicIdx(unsigned char* data, int data_length);
   static int removeTIDAndKeyIdx(unsigned char* data, int data_length);
   erizo::RTPPayloadVP8* parseVP8(unsigned char* data, int datalength);
+  // Same as above but fills a payload owned by the caller, so it does not allocate
+  void parseVP8(unsigned char* data, int datalength, erizo::RTPPayloadVP8* payload);
 };
 }  // namespace erizo
 #endif  // ERIZO_SRC_ERIZO_RTP_RTPVP8PARSER_H_
@@ -69,8 +69,13 @@ RtpVP9Parser::~RtpVP9Parser() {
 //      +-+-+-+-+-+-+-+-+
 
 RTPPayloadVP9* RtpVP9Parser::parseVP9(unsigned char* data, int dataLength) {
+  RTPPayloadVP9* vp9 = new RTPPayloadVP9;
+  parseVP9(data, dataLength, vp9);
+  return vp9;
+}
+
+void RtpVP9Parser::parseVP9(unsigned char* data, int dataLength, RTPPayloadVP9* vp9) {
   // ELOG_DEBUG("Parsing VP9 %d bytes", dataLength);
-  RTPPayloadVP9* vp9 = new RTPPayloadVP9;  // = &parsedPacket.info.VP9;
   const unsigned char* dataPtr = data;
   int len = dataLength;
 
@@ -163,8 +168,6 @@ RTPPayloadVP9* RtpVP9Parser::parseVP9(unsigned char* data, int dataLength) {
 
   vp9->data = dataPtr;
   vp9->dataLength = (unsigned int) len;
-
-  return vp9;
 }
 
 }  // namespace erizo
@@ -55,6 +55,8 @@ class RtpVP9Parser {
   RtpVP9Parser();
   virtual ~RtpVP9Parser();
   erizo::RTPPayloadVP9* parseVP9(unsigned char* data, int datalength);
+  // Same as above but fills a payload owned by the caller, so it does not allocate
+  void parseVP9(unsigned char* data, int datalength, erizo::RTPPayloadVP9* payload);
 };
 }  // namespace erizo
 #endif  // ERIZO_SRC_ERIZO_RTP_RTPVP9PARSER_H_
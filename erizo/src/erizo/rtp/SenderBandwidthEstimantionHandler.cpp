@@ -235,6 +235,7 @@ void SenderBandwidthEstimationHandler::updateReceiverBlockFromList() {
                 "delay: %u, period_packets_sent_: %u",
                 connection_->toLog(), total_packets_lost, avg_delay, total_packets_sent);
       sender_bwe_->UpdateRtt(webrtc::TimeDelta::Millis(avg_delay), getNowTimestamp());
+      connection_->setRtt(avg_delay);
       sender_bwe_->UpdatePacketsLost(total_packets_lost, total_packets_sent, getNowTimestamp());
       updateEstimate();
     }
@@ -317,6 +318,7 @@ void SenderBandwidthEstimationHandler::updateEstimate() {
     stats_->getNode()["total"].insertStat("senderBitrateEstimationTarget",
       CumulativeStat{static_cast<uint64_t>(estimated_target_)});
   }
+  connection_->setSenderBitrateTarget(estimated_target_);
   ELOG_DEBUG("%s message: estimated bitrate %lu, estimated_target %lu loss %u, rtt %ld,"
       "received_transport_fb %u, received_remb %u",
       connection_->toLog(), estimated_bitrate_, estimated_target_, estimated_loss_, estimated_rtt_,
@@ -17,12 +17,7 @@ void StatsCalculator::update(MediaStream *stream, std::shared_ptr<Stats> stats)
   if (!stream_) {
     stream_ = stream;
     stats_ = stats;
-    if (!getStatsInfo().hasChild("total")) {
-      getStatsInfo()["total"].insertStat("bitrateCalculated", MovingIntervalRateStat{kRateStatIntervalSize,
-        kRateStatIntervals, 8.});
-      getStatsInfo()["total"].insertStat("packetsCalculated", MovingIntervalRateStat{kRateStatIntervalSize,
-        kRateStatIntervals, 1.});
-    }
+    stats_->getSsrcStats().total();
   }
 }
 
@@ -40,35 +35,35 @@ void StatsCalculator::processRtpPacket(std::shared_ptr<DataPacket> packet) {
   int len = packet->length;
   RtpHeader* head = reinterpret_cast<RtpHeader*>(buf);
   uint32_t ssrc = head->getSSRC();
-  if (!stream_->isSinkSSRC(ssrc) && !stream_->isSourceSSRC(ssrc)) {
+  // Retransmissions to subscribers that negotiated RTX go in their own SSRC
+  bool is_rtx = ssrc != 0 && ssrc == stream_->getVideoSinkRtxSSRC();
+  if (!is_rtx && !stream_->isSinkSSRC(ssrc) && !stream_->isSourceSSRC(ssrc)) {
     ELOG_DEBUG("message: Unknown SSRC in processRtpPacket, ssrc: %u, PT: %u", ssrc, head->getPayloadType());
     return;
   }
-  if (!getStatsInfo()[ssrc].hasChild("bitrateCalculated")) {
-    if (stream_->isVideoSourceSSRC(ssrc) || stream_->isVideoSinkSSRC(ssrc)) {
-      getStatsInfo()[ssrc].insertStat("type", StringStat{"video"});
+  SsrcStatsRegistry &registry = stats_->getSsrcStats();
+  PacketStats *ssrc_stats = registry.find(ssrc);
+  if (!ssrc_stats) {
+    std::string type;
+    if (is_rtx || stream_->isVideoSourceSSRC(ssrc) || stream_->isVideoSinkSSRC(ssrc)) {
+      type = "video";
     } else if (stream_->isAudioSourceSSRC(ssrc) || stream_->isAudioSinkSSRC(ssrc)) {
-      getStatsInfo()[ssrc].insertStat("type", StringStat{"audio"});
+      type = "audio";
     }
-    getStatsInfo()[ssrc].insertStat("bitrateCalculated", MovingIntervalRateStat{kRateStatIntervalSize,
-        kRateStatIntervals, 8.});
-    getStatsInfo()[ssrc].insertStat("mediaBitrateCalculated", MovingIntervalRateStat{kRateStatIntervalSize,
-        kRateStatIntervals, 8.});
-    getStatsInfo()[ssrc].insertStat("packetsCalculated", MovingIntervalRateStat{kRateStatIntervalSize,
-        kRateStatIntervals, 1.});
-    getStatsInfo()[ssrc].insertStat("mediaPacketsCalculated", MovingIntervalRateStat{kRateStatIntervalSize,
-        kRateStatIntervals, 1.});
+    ssrc_stats = &registry.create(ssrc, type);
   }
-  getStatsInfo()[ssrc]["bitrateCalculated"] += len;
-  getStatsInfo()[ssrc]["packetsCalculated"] += 1;
-  getStatsInfo()["total"]["bitrateCalculated"] += len;
-  getStatsInfo()["total"]["packetsCalculated"] += 1;
+  PacketStats &total_stats = registry.total();
+  time_point now = registry.now();
+  (*ssrc_stats)[PacketStat::kBitrate].add(len, now);
+  (*ssrc_stats)[PacketStat::kPackets].add(1, now);
+  total_stats[PacketStat::kBitrate].add(len, now);
+  total_stats[PacketStat::kPackets].add(1, now);
   if (!packet->is_padding) {
-    getStatsInfo()[ssrc]["mediaBitrateCalculated"] += len;
-    getStatsInfo()[ssrc]["mediaPacketsCalculated"] += 1;
+    (*ssrc_stats)[PacketStat::kMediaBitrate].add(len, now);
+    (*ssrc_stats)[PacketStat::kMediaPackets].add(1, now);
   }
-  if (packet->type == VIDEO_PACKET) {
-    stream_->setVideoBitrate(getStatsInfo()[ssrc]["mediaBitrateCalculated"].value());
+  if (packet->type == VIDEO_PACKET && !is_rtx) {
+    stream_->setVideoBitrate((*ssrc_stats)[PacketStat::kMediaBitrate].value());
     if (packet->is_keyframe) {
       incrStat(ssrc, "keyFrames");
     }
@@ -145,6 +140,7 @@ void StatsCalculator::processRtcpPacket(std::shared_ptr<DataPacket> packet) {
           ELOG_DEBUG("NACKs: %u", chead->getBlockCount());
           ELOG_DEBUG("PID %u BLP %u", chead->getNackPid(), chead->getNackBlp());
           incrStat(ssrc, "NACK");
+          WorkerMetrics::current().countFeedback(FeedbackMetric::kNack, direction_);
         }
         break;
       case RTCP_PS_Feedback_PT:
@@ -153,6 +149,7 @@ void StatsCalculator::processRtcpPacket(std::shared_ptr<DataPacket> packet) {
           case RTCP_PLI_FMT:
             ELOG_DEBUG("PLI Packet, SSRC %u, sourceSSRC %u", chead->getSSRC(), chead->getSourceSSRC());
             incrStat(ssrc, "PLI");
+            WorkerMetrics::current().countFeedback(FeedbackMetric::kPli, direction_);
             break;
           case RTCP_SLI_FMT:
             ELOG_DEBUG("SLI Message");
@@ -161,6 +158,7 @@ void StatsCalculator::processRtcpPacket(std::shared_ptr<DataPacket> packet) {
           case RTCP_FIR_FMT:
             ELOG_DEBUG("FIR Packet, SSRC %u, sourceSSRC %u", chead->getSSRC(), chead->getSourceSSRC());
             incrStat(ssrc, "FIR");
+            WorkerMetrics::current().countFeedback(FeedbackMetric::kFir, direction_);
             break;
           case RTCP_AFB:
             {
@@ -194,7 +192,7 @@ void StatsCalculator::processRtcpPacket(std::shared_ptr<DataPacket> packet) {
   notifyStats();
 }
 
-IncomingStatsHandler::IncomingStatsHandler() : stream_{nullptr} {}
+IncomingStatsHandler::IncomingStatsHandler() : StatsCalculator{MetricDirection::kIn}, stream_{nullptr} {}
 
 void IncomingStatsHandler::enable() {}
 
@@ -214,7 +212,7 @@ void IncomingStatsHandler::read(Context *ctx, std::shared_ptr<DataPacket> packet
   ctx->fireRead(std::move(packet));
 }
 
-OutgoingStatsHandler::OutgoingStatsHandler() : stream_{nullptr} {}
+OutgoingStatsHandler::OutgoingStatsHandler() : StatsCalculator{MetricDirection::kOut}, stream_{nullptr} {}
 
 void OutgoingStatsHandler::enable() {}
 
@@ -6,19 +6,17 @@
 #include "./logger.h"
 #include "pipeline/Handler.h"
 #include "./Stats.h"
+#include "stats/Metrics.h"
 
 namespace erizo {
 
-constexpr duration kRateStatIntervalSize = std::chrono::milliseconds(100);
-constexpr uint32_t kRateStatIntervals = 30;
-
 class MediaStream;
 
 class StatsCalculator {
   DECLARE_LOGGER();
 
  public:
-  StatsCalculator() : stream_{nullptr} {}
+  explicit StatsCalculator(MetricDirection direction) : stream_{nullptr}, direction_{direction} {}
   virtual ~StatsCalculator() {}
 
   void update(MediaStream *connection, std::shared_ptr<Stats> stats);
@@ -40,6 +38,7 @@ class StatsCalculator {
  private:
   MediaStream* stream_;
   std::shared_ptr<Stats> stats_;
+  MetricDirection direction_;
 };
 
 class IncomingStatsHandler: public InboundHandler, public StatsCalculator {
@@ -0,0 +1,199 @@
+#include "stats/Metrics.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace erizo {
+
+static thread_local WorkerMetrics *current_metrics = nullptr;
+
+static const char *kFeedbackNames[] = {"nack", "pli", "fir"};
+static const char *kDirectionNames[] = {"in", "out"};
+static const char kOtherHandlers[] = "other";
+
+void MetricHistogram::observe(duration value) {
+  uint64_t value_us = std::chrono::duration_cast<std::chrono::microseconds>(value).count();
+  size_t bucket = std::lower_bound(kBucketBoundsUs.begin(), kBucketBoundsUs.end(), value_us) - kBucketBoundsUs.begin();
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  sum_us_.fetch_add(value_us, std::memory_order_relaxed);
+}
+
+void MetricHistogram::accumulate(const MetricHistogram &other) {
+  for (size_t bucket = 0; bucket < kBuckets; bucket++) {
+    buckets_[bucket].fetch_add(other.bucketCount(bucket), std::memory_order_relaxed);
+  }
+  sum_us_.fetch_add(other.sumUs(), std::memory_order_relaxed);
+}
+
+WorkerMetrics::WorkerMetrics(std::string label) : label_{label} {
+}
+
+void WorkerMetrics::accumulate(const WorkerMetrics &other) {
+  task_duration.accumulate(other.task_duration);
+  task_delay.accumulate(other.task_delay);
+  queued_tasks.add(other.queued_tasks.value());
+  retransmissions.add(other.retransmissions.value());
+  srtp_protect_errors.add(other.srtp_protect_errors.value());
+  srtp_unprotect_errors.add(other.srtp_unprotect_errors.value());
+  for (size_t type = 0; type < feedback_.size(); type++) {
+    for (size_t direction = 0; direction < feedback_[type].size(); direction++) {
+      feedback_[type][direction].add(other.feedback_[type][direction].value());
+    }
+  }
+  for (size_t index = 0; index < kMaxHandlerMetrics; index++) {
+    handler_packets_[index].add(other.handlerPackets(index));
+  }
+}
+
+WorkerMetrics& WorkerMetrics::current() {
+  if (current_metrics) {
+    return *current_metrics;
+  }
+  return MetricsRegistry::instance().sharedShard();
+}
+
+void WorkerMetrics::setCurrent(WorkerMetrics *metrics) {
+  current_metrics = metrics;
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+  static MetricsRegistry registry;
+  return registry;
+}
+
+MetricsRegistry::MetricsRegistry() : next_shard_{0}, next_worker_{0} {
+}
+
+WorkerMetrics& MetricsRegistry::sharedShard() {
+  // Shards are handed out round robin the first time each thread counts something
+  static thread_local size_t shard = next_shard_.fetch_add(1, std::memory_order_relaxed) % kSharedShards;
+  return shared_shards_[shard].metrics;
+}
+
+std::shared_ptr<WorkerMetrics> MetricsRegistry::createWorkerMetrics() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  workers_.erase(std::remove_if(workers_.begin(), workers_.end(),
+      [](const std::weak_ptr<WorkerMetrics> &worker) { return worker.expired(); }), workers_.end());
+  auto metrics = std::make_shared<WorkerMetrics>(std::to_string(next_worker_++));
+  workers_.push_back(metrics);
+  return metrics;
+}
+
+size_t MetricsRegistry::handlerIndex(const std::string &name) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto handler = std::find(handler_names_.begin(), handler_names_.end(), name);
+  if (handler != handler_names_.end()) {
+    return handler - handler_names_.begin();
+  }
+  if (handler_names_.size() == kMaxHandlerMetrics - 1) {
+    return kMaxHandlerMetrics - 1;
+  }
+  handler_names_.push_back(name);
+  return handler_names_.size() - 1;
+}
+
+static void writeSeconds(std::ostringstream *text, uint64_t value_us) {
+  *text << value_us / 1000000 << "." << std::setw(6) << std::setfill('0') << value_us % 1000000 << std::setfill(' ');
+}
+
+static void writeHistogram(std::ostringstream *text, const std::string &name, const std::string &worker,
+    const MetricHistogram &histogram) {
+  uint64_t count = 0;
+  for (size_t bucket = 0; bucket < MetricHistogram::kBuckets; bucket++) {
+    count += histogram.bucketCount(bucket);
+    *text << name << "_bucket{worker=\"" << worker << "\",le=\"";
+    if (bucket < MetricHistogram::kBucketBoundsUs.size()) {
+      writeSeconds(text, MetricHistogram::kBucketBoundsUs[bucket]);
+    } else {
+      *text << "+Inf";
+    }
+    *text << "\"} " << count << "\n";
+  }
+  *text << name << "_count{worker=\"" << worker << "\"} " << count << "\n";
+  *text << name << "_sum{worker=\"" << worker << "\"} ";
+  writeSeconds(text, histogram.sumUs());
+  *text << "\n";
+}
+
+std::string MetricsRegistry::toOpenMetrics() {
+  std::vector<std::shared_ptr<WorkerMetrics>> workers;
+  std::vector<std::string> handler_names;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (const std::weak_ptr<WorkerMetrics> &weak_worker : workers_) {
+      if (auto worker = weak_worker.lock()) {
+        workers.push_back(worker);
+      }
+    }
+    handler_names = handler_names_;
+  }
+  WorkerMetrics shared{"shared"};
+  for (const SharedShard &shard : shared_shards_) {
+    shared.accumulate(shard.metrics);
+  }
+  std::vector<WorkerMetrics*> all_metrics{&shared};
+  for (const std::shared_ptr<WorkerMetrics> &worker : workers) {
+    all_metrics.push_back(worker.get());
+  }
+  std::ostringstream text;
+
+  text << "# TYPE erizo_task_duration_seconds histogram\n"
+       << "# HELP erizo_task_duration_seconds Time spent running worker tasks.\n";
+  for (WorkerMetrics *metrics : all_metrics) {
+    writeHistogram(&text, "erizo_task_duration_seconds", metrics->label(), metrics->task_duration);
+  }
+  text << "# TYPE erizo_task_delay_seconds histogram\n"
+       << "# HELP erizo_task_delay_seconds Time worker tasks waited before running.\n";
+  for (WorkerMetrics *metrics : all_metrics) {
+    writeHistogram(&text, "erizo_task_delay_seconds", metrics->label(), metrics->task_delay);
+  }
+  text << "# TYPE erizo_queued_tasks gauge\n"
+       << "# HELP erizo_queued_tasks Tasks posted to the worker that have not run yet.\n";
+  for (WorkerMetrics *metrics : all_metrics) {
+    text << "erizo_queued_tasks{worker=\"" << metrics->label() << "\"} " << metrics->queued_tasks.value() << "\n";
+  }
+  text << "# TYPE erizo_handler_packets counter\n"
+       << "# HELP erizo_handler_packets Packets processed by each pipeline handler.\n";
+  for (WorkerMetrics *metrics : all_metrics) {
+    for (size_t index = 0; index < kMaxHandlerMetrics; index++) {
+      uint64_t packets = metrics->handlerPackets(index);
+      if (packets == 0) {
+        continue;
+      }
+      const char *handler = index < handler_names.size() ? handler_names[index].c_str() : kOtherHandlers;
+      text << "erizo_handler_packets_total{worker=\"" << metrics->label() << "\",handler=\"" << handler << "\"} "
+           << packets << "\n";
+    }
+  }
+  text << "# TYPE erizo_rtcp_feedback counter\n"
+       << "# HELP erizo_rtcp_feedback RTCP feedback messages received (in) and sent (out).\n";
+  for (WorkerMetrics *metrics : all_metrics) {
+    for (size_t type = 0; type < static_cast<size_t>(FeedbackMetric::kCount); type++) {
+      for (size_t direction = 0; direction < static_cast<size_t>(MetricDirection::kCount); direction++) {
+        text << "erizo_rtcp_feedback_total{worker=\"" << metrics->label() << "\",type=\"" << kFeedbackNames[type]
+             << "\",direction=\"" << kDirectionNames[direction] << "\"} "
+             << metrics->feedback(static_cast<FeedbackMetric>(type), static_cast<MetricDirection>(direction)) << "\n";
+      }
+    }
+  }
+  text << "# TYPE erizo_retransmissions counter\n"
+       << "# HELP erizo_retransmissions Packets retransmitted in response to NACKs.\n";
+  for (WorkerMetrics *metrics : all_metrics) {
+    text << "erizo_retransmissions_total{worker=\"" << metrics->label() << "\"} "
+         << metrics->retransmissions.value() << "\n";
+  }
+  text << "# TYPE erizo_srtp_errors counter\n"
+       << "# HELP erizo_srtp_errors SRTP and SRTCP failures, replayed packets are not counted.\n";
+  for (WorkerMetrics *metrics : all_metrics) {
+    text << "erizo_srtp_errors_total{worker=\"" << metrics->label() << "\",operation=\"protect\"} "
+         << metrics->srtp_protect_errors.value() << "\n";
+    text << "erizo_srtp_errors_total{worker=\"" << metrics->label() << "\",operation=\"unprotect\"} "
+         << metrics->srtp_unprotect_errors.value() << "\n";
+  }
+  text << "# EOF\n";
+  return text.str();
+}
+
+}  // namespace erizo
@@ -0,0 +1,150 @@
+#ifndef ERIZO_SRC_ERIZO_STATS_METRICS_H_
+#define ERIZO_SRC_ERIZO_STATS_METRICS_H_
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "lib/Clock.h"
+
+namespace erizo {
+
+// Metrics are updated with relaxed atomics by the thread that owns them and read by the exporter
+
+class MetricCounter {
+ public:
+  void add(uint64_t value = 1) { value_.fetch_add(value, std::memory_order_relaxed); }
+  uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> value_{0};
+};
+
+class MetricGauge {
+ public:
+  void add(int64_t value) { value_.fetch_add(value, std::memory_order_relaxed); }
+  int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<int64_t> value_{0};
+};
+
+class MetricHistogram {
+ public:
+  // Upper bounds of the buckets in microseconds, the last bucket has no bound
+  static constexpr std::array<uint64_t, 9> kBucketBoundsUs = {{
+    100, 500, 1000, 5000, 10000, 50000, 100000, 1000000, 5000000
+  }};
+  static constexpr size_t kBuckets = kBucketBoundsUs.size() + 1;
+
+  void observe(duration value);
+
+  // Samples in the bucket, not cumulative
+  uint64_t bucketCount(size_t bucket) const { return buckets_[bucket].load(std::memory_order_relaxed); }
+  uint64_t sumUs() const { return sum_us_.load(std::memory_order_relaxed); }
+
+  void accumulate(const MetricHistogram &other);
+
+ private:
+  std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+  std::atomic<uint64_t> sum_us_{0};
+};
+
+enum class FeedbackMetric : uint8_t {
+  kNack,
+  kPli,
+  kFir,
+  kCount
+};
+
+enum class MetricDirection : uint8_t {
+  kIn,
+  kOut,
+  kCount
+};
+
+constexpr size_t kMaxHandlerMetrics = 64;
+
+/**
+ * Metrics of a single Worker, or the ones shared by every thread that is not a Worker.
+ * Code running in a pipeline gets them through current() so it does not need to know its Worker.
+ */
+class WorkerMetrics {
+ public:
+  explicit WorkerMetrics(std::string label);
+
+  const std::string& label() const { return label_; }
+
+  void countFeedback(FeedbackMetric type, MetricDirection direction) {
+    feedback_[static_cast<size_t>(type)][static_cast<size_t>(direction)].add();
+  }
+  uint64_t feedback(FeedbackMetric type, MetricDirection direction) const {
+    return feedback_[static_cast<size_t>(type)][static_cast<size_t>(direction)].value();
+  }
+
+  void countHandlerPacket(size_t handler_index) { handler_packets_[handler_index].add(); }
+  uint64_t handlerPackets(size_t handler_index) const { return handler_packets_[handler_index].value(); }
+
+  // Adds the values of other to these metrics, used to render the shared shards as a single worker
+  void accumulate(const WorkerMetrics &other);
+
+  static WorkerMetrics& current();
+  static void setCurrent(WorkerMetrics *metrics);
+
+ public:
+  MetricHistogram task_duration;
+  MetricHistogram task_delay;
+  MetricGauge queued_tasks;
+  MetricCounter retransmissions;
+  MetricCounter srtp_protect_errors;
+  MetricCounter srtp_unprotect_errors;
+
+ private:
+  std::string label_;
+  std::array<std::array<MetricCounter, static_cast<size_t>(MetricDirection::kCount)>,
+      static_cast<size_t>(FeedbackMetric::kCount)> feedback_;
+  std::array<MetricCounter, kMaxHandlerMetrics> handler_packets_;
+};
+
+/**
+ * Keeps track of every WorkerMetrics and renders them in the OpenMetrics text format.
+ */
+class MetricsRegistry {
+ public:
+  static MetricsRegistry& instance();
+
+  // Threads that are not Workers are spread over these many shards, so they don't contend on the same counters
+  static constexpr size_t kSharedShards = 16;
+
+  std::shared_ptr<WorkerMetrics> createWorkerMetrics();
+  // Shard of the calling thread, all shards are rendered together with the "shared" label
+  WorkerMetrics& sharedShard();
+
+  // Slot of the handler in WorkerMetrics, handlers beyond kMaxHandlerMetrics share the last one
+  size_t handlerIndex(const std::string &name);
+
+  std::string toOpenMetrics();
+
+ private:
+  MetricsRegistry();
+
+  struct alignas(64) SharedShard {
+    SharedShard() : metrics{"shared"} {}
+    WorkerMetrics metrics;
+  };
+
+ private:
+  std::mutex mutex_;
+  std::array<SharedShard, kSharedShards> shared_shards_;
+  std::atomic<size_t> next_shard_;
+  std::vector<std::weak_ptr<WorkerMetrics>> workers_;
+  uint64_t next_worker_;
+  std::vector<std::string> handler_names_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_STATS_METRICS_H_
@@ -0,0 +1,130 @@
+#include "stats/MetricsServer.h"
+
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+
+#include "stats/Metrics.h"
+
+namespace erizo {
+
+DEFINE_LOGGER(MetricsServer, "stats.MetricsServer");
+
+constexpr size_t kMaxRequestSize = 8192;
+// Clients that don't send a request and read the response in this time are dropped, so they can't hold sockets
+constexpr std::chrono::seconds kRequestTimeout{5};
+
+namespace {
+
+struct MetricsConnection : std::enable_shared_from_this<MetricsConnection> {
+  explicit MetricsConnection(boost::asio::io_service *service)
+      : socket{*service}, timer{*service}, request{kMaxRequestSize} {}
+
+  void start() {
+    auto self = shared_from_this();
+    timer.expires_from_now(kRequestTimeout);
+    timer.async_wait([self](const boost::system::error_code &error) {
+      if (error) {
+        return;
+      }
+      boost::system::error_code ignored;
+      self->socket.close(ignored);
+    });
+    boost::asio::async_read_until(socket, request, "\r\n\r\n",
+      [self](const boost::system::error_code &error, size_t length) {
+        if (error) {
+          self->timer.cancel();
+          return;
+        }
+        self->respond();
+      });
+  }
+
+  void respond() {
+    std::string body = MetricsRegistry::instance().toOpenMetrics();
+    response = "HTTP/1.1 200 OK\r\n"
+               "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+               "Content-Length: " + std::to_string(body.size()) + "\r\n"
+               "Connection: close\r\n\r\n" + body;
+    auto self = shared_from_this();
+    boost::asio::async_write(socket, boost::asio::buffer(response),
+      [self](const boost::system::error_code &error, size_t length) {
+        self->timer.cancel();
+        boost::system::error_code ignored;
+        self->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+      });
+  }
+
+  boost::asio::ip::tcp::socket socket;
+  boost::asio::steady_timer timer;
+  boost::asio::streambuf request;
+  std::string response;
+};
+
+}  // namespace
+
+MetricsServer::MetricsServer() : acceptor_{service_} {
+}
+
+MetricsServer::~MetricsServer() {
+  close();
+}
+
+int MetricsServer::start(const std::string &address, uint16_t first_port, uint16_t attempts) {
+  boost::system::error_code error;
+  boost::asio::ip::address listen_address = boost::asio::ip::address::from_string(address, error);
+  if (error) {
+    ELOG_ERROR("message: Invalid metrics address, address: %s", address.c_str());
+    return -1;
+  }
+  for (uint32_t port = first_port; port < uint32_t{first_port} + attempts && port <= 0xffff; port++) {
+    boost::asio::ip::tcp::endpoint endpoint{listen_address, static_cast<uint16_t>(port)};
+    acceptor_.open(endpoint.protocol(), error);
+    if (!error) {
+      acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true), error);
+      acceptor_.bind(endpoint, error);
+    }
+    if (!error) {
+      acceptor_.listen(boost::asio::socket_base::max_connections, error);
+    }
+    if (error) {
+      boost::system::error_code ignored;
+      acceptor_.close(ignored);
+      continue;
+    }
+    int bound_port = acceptor_.local_endpoint().port();
+    accept();
+    thread_.reset(new boost::thread([this] { service_.run(); }));
+    ELOG_INFO("message: Serving metrics, address: %s, port: %d", address.c_str(), bound_port);
+    return bound_port;
+  }
+  ELOG_ERROR("message: Could not listen for metrics, address: %s, firstPort: %u, attempts: %u",
+      address.c_str(), first_port, attempts);
+  return -1;
+}
+
+void MetricsServer::accept() {
+  auto connection = std::make_shared<MetricsConnection>(&service_);
+  acceptor_.async_accept(connection->socket, [this, connection](const boost::system::error_code &error) {
+    if (error == boost::asio::error::operation_aborted) {
+      return;
+    }
+    if (!error) {
+      connection->start();
+    }
+    accept();
+  });
+}
+
+void MetricsServer::close() {
+  if (!thread_) {
+    return;
+  }
+  service_.stop();
+  thread_->join();
+  thread_.reset();
+  boost::system::error_code ignored;
+  acceptor_.close(ignored);
+}
+
+}  // namespace erizo
@@ -0,0 +1,41 @@
+#ifndef ERIZO_SRC_ERIZO_STATS_METRICSSERVER_H_
+#define ERIZO_SRC_ERIZO_STATS_METRICSSERVER_H_
+
+#include <boost/asio.hpp>
+#include <boost/thread.hpp>
+
+#include <memory>
+#include <string>
+
+#include "./logger.h"
+
+namespace erizo {
+
+/**
+ * Serves MetricsRegistry in the OpenMetrics text format to local scrapers, on its own thread so scrapes
+ * never delay workers or the Node event loop. Every request gets the metrics, whatever its path.
+ */
+class MetricsServer {
+  DECLARE_LOGGER();
+
+ public:
+  MetricsServer();
+  ~MetricsServer();
+
+  // Listens on the first free port of [first_port, first_port + attempts), so every erizoJS in a host can
+  // use the same configuration. Returns the port or -1 if none was free.
+  int start(const std::string &address, uint16_t first_port, uint16_t attempts = 1);
+  void close();
+
+ private:
+  void accept();
+
+ private:
+  boost::asio::io_service service_;
+  boost::asio::ip::tcp::acceptor acceptor_;
+  std::unique_ptr<boost::thread> thread_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_STATS_METRICSSERVER_H_
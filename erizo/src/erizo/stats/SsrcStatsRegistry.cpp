@@ -0,0 +1,60 @@
+#include "stats/SsrcStatsRegistry.h"
+
+#include <string>
+
+namespace erizo {
+
+SsrcStatsRegistry::SsrcStatsRegistry(StatNode *root, std::shared_ptr<Clock> the_clock)
+  : root_{root}, clock_{the_clock}, last_slot_{0}, has_total_{false} {
+}
+
+std::shared_ptr<MovingIntervalRateStat> SsrcStatsRegistry::createStat(StatNode *parent,
+    const PacketStatSchema &schema) {
+  return parent->insertStat(schema.name, MovingIntervalRateStat{kRateStatIntervalSize, kRateStatIntervals,
+      schema.scale, clock_});
+}
+
+PacketStats* SsrcStatsRegistry::find(uint32_t ssrc) {
+  if (last_slot_ < slots_.size() && slots_[last_slot_].ssrc == ssrc) {
+    return &slots_[last_slot_].stats;
+  }
+  for (size_t index = 0; index < slots_.size(); index++) {
+    if (slots_[index].ssrc == ssrc) {
+      last_slot_ = index;
+      return &slots_[index].stats;
+    }
+  }
+  return nullptr;
+}
+
+PacketStats& SsrcStatsRegistry::create(uint32_t ssrc, const std::string &type) {
+  if (PacketStats *existing = find(ssrc)) {
+    return *existing;
+  }
+  StatNode &node = (*root_)[ssrc];
+  if (!type.empty()) {
+    node.insertStat("type", StringStat{type});
+  }
+  Slot slot{ssrc, PacketStats{}};
+  for (const PacketStatSchema &schema : kPacketStatSchema) {
+    slot.stats.stats_[static_cast<size_t>(schema.id)] = createStat(&node, schema);
+  }
+  slots_.push_back(std::move(slot));
+  last_slot_ = slots_.size() - 1;
+  return slots_.back().stats;
+}
+
+PacketStats& SsrcStatsRegistry::total() {
+  if (!has_total_) {
+    StatNode &node = (*root_)["total"];
+    for (const PacketStatSchema &schema : kPacketStatSchema) {
+      if (schema.in_total) {
+        total_.stats_[static_cast<size_t>(schema.id)] = createStat(&node, schema);
+      }
+    }
+    has_total_ = true;
+  }
+  return total_;
+}
+
+}  // namespace erizo
@@ -0,0 +1,99 @@
+#ifndef ERIZO_SRC_ERIZO_STATS_SSRCSTATSREGISTRY_H_
+#define ERIZO_SRC_ERIZO_STATS_SSRCSTATSREGISTRY_H_
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "lib/Clock.h"
+#include "stats/StatNode.h"
+
+namespace erizo {
+
+constexpr duration kRateStatIntervalSize = std::chrono::milliseconds(100);
+constexpr uint32_t kRateStatIntervals = 30;
+
+// Stats updated for every RTP packet, per SSRC and (some of them) in "total"
+enum class PacketStat : uint8_t {
+  kBitrate,
+  kMediaBitrate,
+  kPackets,
+  kMediaPackets,
+  kCount
+};
+
+constexpr size_t kPacketStatCount = static_cast<size_t>(PacketStat::kCount);
+
+struct PacketStatSchema {
+  PacketStat id;
+  const char *name;
+  double scale;
+  bool in_total;
+};
+
+constexpr std::array<PacketStatSchema, kPacketStatCount> kPacketStatSchema = {{
+  {PacketStat::kBitrate, "bitrateCalculated", 8., true},
+  {PacketStat::kMediaBitrate, "mediaBitrateCalculated", 8., false},
+  {PacketStat::kPackets, "packetsCalculated", 1., true},
+  {PacketStat::kMediaPackets, "mediaPacketsCalculated", 1., false},
+}};
+
+constexpr bool isPacketStatSchemaSorted(size_t index = 0) {
+  return index == kPacketStatCount ||
+    (static_cast<size_t>(kPacketStatSchema[index].id) == index && isPacketStatSchemaSorted(index + 1));
+}
+static_assert(isPacketStatSchemaSorted(), "kPacketStatSchema must be indexed by PacketStat");
+
+class PacketStats {
+ public:
+  MovingIntervalRateStat& operator[](PacketStat id) {
+    return *stats_[static_cast<size_t>(id)];
+  }
+
+ private:
+  friend class SsrcStatsRegistry;
+  std::array<std::shared_ptr<MovingIntervalRateStat>, kPacketStatCount> stats_;
+};
+
+/**
+ * Dense storage for the stats in kPacketStatSchema.
+ * Every SSRC gets a slot holding its stats by PacketStat id, so the packet path updates them without building
+ * string keys or walking the StatNode maps. The same stats are linked into the StatNode tree under
+ * "<ssrc>" and "total", so Stats::getStats() keeps reporting them as before.
+ */
+class SsrcStatsRegistry {
+ public:
+  explicit SsrcStatsRegistry(StatNode *root, std::shared_ptr<Clock> the_clock = std::make_shared<SteadyClock>());
+
+  // Returns nullptr if there are no stats for the SSRC yet
+  PacketStats* find(uint32_t ssrc);
+  // type is reported as the "type" of the SSRC when not empty
+  PacketStats& create(uint32_t ssrc, const std::string &type);
+  // Only the stats with in_total set are available
+  PacketStats& total();
+
+  time_point now() { return clock_->now(); }
+
+ private:
+  std::shared_ptr<MovingIntervalRateStat> createStat(StatNode *parent, const PacketStatSchema &schema);
+
+ private:
+  struct Slot {
+    uint32_t ssrc;
+    PacketStats stats;
+  };
+
+  StatNode *root_;
+  std::shared_ptr<Clock> clock_;
+  // Streams have a handful of SSRCs, a linear scan starting with the last one found beats hashing.
+  // deque keeps the PacketStats returned by create() valid when new SSRCs are added
+  std::deque<Slot> slots_;
+  size_t last_slot_;
+  PacketStats total_;
+  bool has_total_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_STATS_SSRCSTATSREGISTRY_H_
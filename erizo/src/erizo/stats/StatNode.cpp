@@ -127,7 +127,11 @@ StatNode& MovingIntervalRateStat::operator+=(uint64_t value) {
 }
 
 void MovingIntervalRateStat::add(uint64_t value) {
-  uint64_t now_ms = ClockUtils::timePointToMs(clock_->now());
+  add(value, clock_->now());
+}
+
+void MovingIntervalRateStat::add(uint64_t value, time_point now) {
+  uint64_t now_ms = ClockUtils::timePointToMs(now);
   if (!initialized_) {
     calculation_start_ms_ = now_ms;
     initialized_ = true;
@@ -10,6 +10,13 @@
 
 namespace erizo {
 
+// kNode for the inner nodes of the tree, leaves are numbers or texts
+enum class StatKind {
+  kNode,
+  kNumber,
+  kText
+};
+
 class StatNode {
  public:
   StatNode() {}
@@ -20,12 +27,14 @@ class StatNode {
   virtual StatNode& operator[](uint64_t key) { return (*this)[std::to_string(key)]; }
 
   template <typename Node>
-  void insertStat(std::string key, Node&& stat) {  // NOLINT
+  std::shared_ptr<Node> insertStat(std::string key, Node&& stat) {  // NOLINT
     // forward ensures that Node type is passed to make_shared(). It would otherwise pass StatNode.
     if (node_map_.find(key) != node_map_.end()) {
       node_map_.erase(key);
     }
-    node_map_.insert(std::make_pair(key, std::make_shared<Node>(std::forward<Node>(stat))));
+    auto node = std::make_shared<Node>(std::forward<Node>(stat));
+    node_map_.insert(std::make_pair(key, node));
+    return node;
   }
 
   virtual bool hasChild(std::string name) { return node_map_.find(name) != node_map_.end(); }
@@ -38,6 +47,8 @@ class StatNode {
 
   virtual uint64_t value() { return 0; }
 
+  virtual StatKind kind() { return StatKind::kNode; }
+
   virtual const std::map<std::string, std::shared_ptr<StatNode>>& getMap() {return node_map_;}
 
   virtual std::string toString();
@@ -63,6 +74,10 @@ class StringStat : public StatNode {
 
   uint64_t value() override { return 0; }
 
+  StatKind kind() override { return StatKind::kText; }
+
+  const std::string& text() const { return text_; }
+
  private:
   std::string text_;
 };
@@ -83,6 +98,8 @@ class CumulativeStat : public StatNode {
 
   uint64_t value() override { return total_; }
 
+  StatKind kind() override { return StatKind::kNumber; }
+
  private:
   uint64_t total_;
 };
@@ -99,6 +116,8 @@ class RateStat : public StatNode {
 
   uint64_t value() override;
 
+  StatKind kind() override { return StatKind::kNumber; }
+
   std::string toString() override;
 
  private:
@@ -127,9 +146,14 @@ class MovingIntervalRateStat : public StatNode {
   StatNode& operator+=(uint64_t value) override;
 
   uint64_t value() override;
+
+  StatKind kind() override { return StatKind::kNumber; }
   uint64_t value(duration stat_interval);
   uint64_t maxValueForIntervalSize(duration requested_interval_size);
 
+  // Same as += but with the current time already read by the caller
+  void add(uint64_t value, time_point now);
+
   std::string toString() override;
 
 
@@ -165,6 +189,8 @@ class MovingAverageStat : public StatNode {
 
   uint64_t value() override;
 
+  StatKind kind() override { return StatKind::kNumber; }
+
   uint64_t value(uint32_t sample_number);
 
   std::string toString() override;
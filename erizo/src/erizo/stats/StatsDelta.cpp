@@ -0,0 +1,160 @@
+#include "stats/StatsDelta.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace erizo {
+
+static void writeVarint(uint64_t value, std::string *out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+static void writeString(const std::string &value, std::string *out) {
+  writeVarint(value.size(), out);
+  out->append(value);
+}
+
+StatsDeltaEncoder::StatsDeltaEncoder() : generation_{0} {
+}
+
+void StatsDeltaEncoder::reset() {
+  last_values_.clear();
+}
+
+void StatsDeltaEncoder::encode(StatNode *root, std::string *delta) {
+  generation_++;
+  std::string path;
+  encodeNode(root, &path, delta);
+  for (auto last_value = last_values_.begin(); last_value != last_values_.end();) {
+    if (last_value->second.generation != generation_) {
+      encodeEntry(StatsDeltaOp::kRemoved, last_value->first, delta);
+      last_value = last_values_.erase(last_value);
+    } else {
+      ++last_value;
+    }
+  }
+}
+
+void StatsDeltaEncoder::encodeNode(StatNode *node, std::string *path, std::string *delta) {
+  size_t parent_length = path->size();
+  for (const auto &child : node->getMap()) {
+    if (parent_length > 0) {
+      path->push_back(kStatsDeltaPathSeparator);
+    }
+    path->append(child.first);
+    StatNode *stat = child.second.get();
+    StatKind kind = stat->kind();
+    if (kind == StatKind::kNode) {
+      encodeNode(stat, path, delta);
+    } else {
+      LastValue &last_value = last_values_[*path];
+      bool is_new = last_value.generation == 0 || last_value.kind != kind;
+      last_value.generation = generation_;
+      last_value.kind = kind;
+      if (kind == StatKind::kText) {
+        const std::string &text = static_cast<StringStat*>(stat)->text();
+        if (is_new || last_value.text != text) {
+          last_value.text = text;
+          encodeEntry(StatsDeltaOp::kText, *path, delta);
+          writeString(text, delta);
+        }
+      } else {
+        uint64_t number = stat->value();
+        if (is_new || last_value.number != number) {
+          last_value.number = number;
+          encodeEntry(StatsDeltaOp::kNumber, *path, delta);
+          writeVarint(number, delta);
+        }
+      }
+    }
+    path->resize(parent_length);
+  }
+}
+
+void StatsDeltaEncoder::encodeEntry(StatsDeltaOp op, const std::string &path, std::string *delta) {
+  delta->push_back(static_cast<char>(op));
+  writeString(path, delta);
+}
+
+StatsDeltaReader::StatsDeltaReader(const std::string &delta) : delta_{delta}, position_{0} {
+}
+
+bool StatsDeltaReader::next(StatsDeltaEntry *entry) {
+  if (position_ >= delta_.size()) {
+    return false;
+  }
+  uint8_t op = static_cast<uint8_t>(delta_[position_++]);
+  if (op > static_cast<uint8_t>(StatsDeltaOp::kRemoved) || !readString(&entry->path)) {
+    position_ = delta_.size();
+    return false;
+  }
+  entry->op = static_cast<StatsDeltaOp>(op);
+  bool valid = true;
+  switch (entry->op) {
+    case StatsDeltaOp::kNumber:
+      valid = readVarint(&entry->number);
+      break;
+    case StatsDeltaOp::kText:
+      valid = readString(&entry->text);
+      break;
+    case StatsDeltaOp::kRemoved:
+      break;
+  }
+  if (!valid) {
+    position_ = delta_.size();
+  }
+  return valid;
+}
+
+bool StatsDeltaReader::readVarint(uint64_t *value) {
+  *value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (position_ >= delta_.size()) {
+      return false;
+    }
+    uint8_t byte = static_cast<uint8_t>(delta_[position_++]);
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool StatsDeltaReader::readString(std::string *value) {
+  uint64_t length;
+  if (!readVarint(&length) || length > delta_.size() - position_) {
+    return false;
+  }
+  value->assign(delta_, position_, length);
+  position_ += length;
+  return true;
+}
+
+void StatsDeltaTracker::read(const std::string &delta, bool is_snapshot, std::vector<StatsDeltaEntry> *entries) {
+  std::unordered_set<std::string> missing_paths;
+  if (is_snapshot) {
+    missing_paths.swap(paths_);
+  }
+  StatsDeltaReader reader{delta};
+  StatsDeltaEntry entry;
+  while (reader.next(&entry)) {
+    if (entry.op == StatsDeltaOp::kRemoved) {
+      paths_.erase(entry.path);
+    } else {
+      paths_.insert(entry.path);
+    }
+    missing_paths.erase(entry.path);
+    entries->push_back(entry);
+  }
+  for (const std::string &path : missing_paths) {
+    entries->push_back(StatsDeltaEntry{StatsDeltaOp::kRemoved, path, 0, ""});
+  }
+}
+
+}  // namespace erizo
@@ -0,0 +1,92 @@
+#ifndef ERIZO_SRC_ERIZO_STATS_STATSDELTA_H_
+#define ERIZO_SRC_ERIZO_STATS_STATSDELTA_H_
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "stats/StatNode.h"
+
+namespace erizo {
+
+/*
+ * Binary format of a stats delta, a sequence of entries:
+ *   op (1 byte) | path length (varint) | path | value
+ * Numbers are written as a varint and texts as length (varint) | bytes. Removed stats have no value.
+ * Paths join the keys of the StatNode tree with kStatsDeltaPathSeparator, e.g. "1234.bitrateCalculated".
+ * Deltas can be concatenated, applying the entries in order gives the latest value of every stat.
+ */
+enum class StatsDeltaOp : uint8_t {
+  kNumber = 0,
+  kText = 1,
+  kRemoved = 2
+};
+
+constexpr char kStatsDeltaPathSeparator = '.';
+
+struct StatsDeltaEntry {
+  StatsDeltaOp op;
+  std::string path;
+  uint64_t number;
+  std::string text;
+};
+
+class StatsDeltaEncoder {
+ public:
+  StatsDeltaEncoder();
+
+  // Appends to delta the stats of root that changed since the previous call and the ones that are gone
+  void encode(StatNode *root, std::string *delta);
+  // The next call to encode() will report every stat
+  void reset();
+
+ private:
+  struct LastValue {
+    StatKind kind;
+    uint64_t number;
+    std::string text;
+    uint64_t generation;
+  };
+
+  void encodeNode(StatNode *node, std::string *path, std::string *delta);
+  void encodeEntry(StatsDeltaOp op, const std::string &path, std::string *delta);
+
+ private:
+  std::unordered_map<std::string, LastValue> last_values_;
+  uint64_t generation_;
+};
+
+class StatsDeltaReader {
+ public:
+  explicit StatsDeltaReader(const std::string &delta);
+
+  // Returns false at the end of the delta or when the rest of it is malformed
+  bool next(StatsDeltaEntry *entry);
+
+ private:
+  bool readVarint(uint64_t *value);
+  bool readString(std::string *value);
+
+ private:
+  const std::string &delta_;
+  size_t position_;
+};
+
+/*
+ * Keeps the stats a consumer of deltas has seen. When a delta is discarded the encoder is reset and the next
+ * one is a full snapshot, which does not tell which stats were removed meanwhile; reading it as a snapshot
+ * reports every stat that is not in it as removed.
+ */
+class StatsDeltaTracker {
+ public:
+  // Appends the entries of delta to entries, delta starts with a full snapshot when is_snapshot is true
+  void read(const std::string &delta, bool is_snapshot, std::vector<StatsDeltaEntry> *entries);
+
+ private:
+  std::unordered_set<std::string> paths_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_STATS_STATSDELTA_H_
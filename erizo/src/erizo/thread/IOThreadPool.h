@@ -5,7 +5,6 @@
 #include <vector>
 
 #include "thread/IOWorker.h"
-#include "thread/Scheduler.h"
 
 namespace erizo {
 
@@ -1,17 +1,30 @@
 #include "thread/ThreadPool.h"
 
+#include <sched.h>
+
+#include <algorithm>
 #include <memory>
+#include <vector>
 
-constexpr int kNumThreadsPerScheduler = 2;
+// Worker load is in microseconds, so each reference is expected to bring at least 1 ms of load
+constexpr double kMinLoadPerReference = 1000;
 
 using erizo::ThreadPool;
 using erizo::Worker;
 using erizo::DurationDistribution;
 
-ThreadPool::ThreadPool(unsigned int num_workers)
-    : workers_{}, scheduler_{std::make_shared<Scheduler>(kNumThreadsPerScheduler)} {
+ThreadPool::ThreadPool(unsigned int num_workers, bool pin_workers)
+    : workers_{} {
+  std::vector<int> cpus;
+  if (pin_workers) {
+    cpus = getAllowedCpus();
+  }
   for (unsigned int index = 0; index < num_workers; index++) {
-    workers_.push_back(std::make_shared<Worker>(scheduler_));
+    auto worker = std::make_shared<Worker>();
+    if (!cpus.empty()) {
+      worker->setCpuAffinity(cpus[index % cpus.size()]);
+    }
+    workers_.push_back(worker);
   }
 }
 
@@ -19,11 +32,46 @@ ThreadPool::~ThreadPool() {
   close();
 }
 
+std::vector<int> ThreadPool::getAllowedCpus() {
+  std::vector<int> cpus;
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    return cpus;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &cpu_set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
 std::shared_ptr<Worker> ThreadPool::getLessUsedWorker() {
-  std::shared_ptr<Worker> chosen_worker = workers_.front();
-  for (auto worker : workers_) {
-    if (chosen_worker.use_count() > worker.use_count()) {
-      chosen_worker = worker;
+  // Measured load only shows up once a connection starts sending media, so every reference to a worker
+  // (connections, streams, ...) is also expected to bring the average load per reference in the pool.
+  // With no measured load yet this falls back to picking the worker with fewer references.
+  uint64_t total_load = 0;
+  int64_t total_references = 0;
+  std::vector<uint64_t> loads;
+  loads.reserve(workers_.size());
+  for (const auto &worker : workers_) {
+    loads.push_back(worker->getLoad());
+    total_load += loads.back();
+    total_references += worker.use_count() - 1;
+  }
+  double load_per_reference = kMinLoadPerReference;
+  if (total_references > 0) {
+    load_per_reference = std::max(load_per_reference, static_cast<double>(total_load) / total_references);
+  }
+
+  std::shared_ptr<Worker> chosen_worker;
+  double chosen_expected_load = 0;
+  for (size_t index = 0; index < workers_.size(); index++) {
+    double expected_load = loads[index] + (workers_[index].use_count() - 1) * load_per_reference;
+    if (!chosen_worker || expected_load < chosen_expected_load) {
+      chosen_worker = workers_[index];
+      chosen_expected_load = expected_load;
     }
   }
   return chosen_worker;
@@ -45,7 +93,6 @@ void ThreadPool::close() {
   for (auto worker : workers_) {
     worker->close();
   }
-  scheduler_->stop(true);
 }
 
 DurationDistribution ThreadPool::getDurationDistribution() {
@@ -5,13 +5,12 @@
 #include <vector>
 
 #include "thread/Worker.h"
-#include "thread/Scheduler.h"
 
 namespace erizo {
 
 class ThreadPool {
  public:
-  explicit ThreadPool(unsigned int num_workers);
+  explicit ThreadPool(unsigned int num_workers, bool pin_workers = false);
   ~ThreadPool();
 
   std::shared_ptr<Worker> getLessUsedWorker();
@@ -22,9 +21,11 @@ class ThreadPool {
   DurationDistribution getDurationDistribution();
   DurationDistribution getDelayDistribution();
 
+ private:
+  static std::vector<int> getAllowedCpus();
+
  private:
   std::vector<std::shared_ptr<Worker>> workers_;
-  std::shared_ptr<Scheduler> scheduler_;
 };
 }  // namespace erizo
 
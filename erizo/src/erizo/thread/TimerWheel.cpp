@@ -0,0 +1,127 @@
+#include "thread/TimerWheel.h"
+
+#include <algorithm>
+#include <utility>
+
+using erizo::TimerWheel;
+using erizo::time_point;
+using erizo::duration;
+
+constexpr uint64_t kSlotMask = TimerWheel::kSlotsPerLevel - 1;
+constexpr uint64_t kMaxDelta = (uint64_t{1} << (TimerWheel::kSlotBits * TimerWheel::kLevels)) - 1;
+
+static uint64_t levelSpan(int level) {
+  return uint64_t{1} << (TimerWheel::kSlotBits * level);
+}
+
+TimerWheel::TimerWheel(time_point now, duration tick)
+    : origin_{now}, tick_{tick}, current_tick_{0}, next_id_{0} {
+}
+
+uint64_t TimerWheel::toTick(time_point when) const {
+  if (when <= origin_) {
+    return 0;
+  }
+  return (when - origin_ + tick_ - duration{1}) / tick_;
+}
+
+time_point TimerWheel::toTime(uint64_t tick) const {
+  return origin_ + tick_ * static_cast<int64_t>(tick);
+}
+
+TimerWheel::TimerId TimerWheel::add(Task f, time_point when) {
+  TimerId id = ++next_id_;
+  // The slot of the current tick has already been run, so the earliest we can run a timer is the next one
+  uint64_t expiration_tick = std::max(toTick(when), current_tick_ + 1);
+  Slot pending;
+  pending.push_back(Timer{id, expiration_tick, std::move(f)});
+  insert(&pending, pending.begin());
+  return id;
+}
+
+void TimerWheel::insert(Slot *from, Slot::iterator timer) {
+  uint64_t expiration_tick = timer->expiration_tick;
+  uint64_t delta = expiration_tick > current_tick_ ? expiration_tick - current_tick_ : 0;
+  if (delta > kMaxDelta) {
+    // Too far away, it will be inserted again when its slot is cascaded
+    expiration_tick = current_tick_ + kMaxDelta;
+    delta = kMaxDelta;
+  }
+  int level = 0;
+  while (level < kLevels - 1 && delta >= levelSpan(level + 1)) {
+    level++;
+  }
+  Slot *slot = &levels_[level][(expiration_tick >> (kSlotBits * level)) & kSlotMask];
+  slot->splice(slot->end(), *from, timer);
+  timers_[timer->id] = std::make_pair(slot, timer);
+}
+
+bool TimerWheel::cancel(TimerId id) {
+  auto timer = timers_.find(id);
+  if (timer == timers_.end()) {
+    return false;
+  }
+  timer->second.first->erase(timer->second.second);
+  timers_.erase(timer);
+  return true;
+}
+
+void TimerWheel::clear() {
+  for (auto &level : levels_) {
+    for (Slot &slot : level) {
+      slot.clear();
+    }
+  }
+  timers_.clear();
+}
+
+void TimerWheel::cascade(int level) {
+  Slot cascading;
+  cascading.swap(levels_[level][(current_tick_ >> (kSlotBits * level)) & kSlotMask]);
+  while (!cascading.empty()) {
+    insert(&cascading, cascading.begin());
+  }
+}
+
+size_t TimerWheel::advance(time_point now) {
+  return advance(now, [](const Task &f, time_point expiration) { f(); });
+}
+
+size_t TimerWheel::advance(time_point now, std::function<void(const Task&, time_point)> runner) {
+  uint64_t target_tick = now > origin_ ? (now - origin_) / tick_ : 0;
+  size_t run_timers = 0;
+  while (current_tick_ < target_tick) {
+    if (timers_.empty()) {
+      current_tick_ = target_tick;
+      break;
+    }
+    current_tick_++;
+    for (int level = kLevels - 1; level > 0; level--) {
+      if ((current_tick_ & (levelSpan(level) - 1)) == 0) {
+        cascade(level);
+      }
+    }
+
+    Slot expired;
+    expired.swap(levels_[0][current_tick_ & kSlotMask]);
+    for (auto timer = expired.begin(); timer != expired.end(); ++timer) {
+      timers_[timer->id].first = &expired;
+    }
+    while (!expired.empty()) {
+      Timer timer = std::move(expired.front());
+      timers_.erase(timer.id);
+      expired.pop_front();
+      runner(timer.task, toTime(timer.expiration_tick));
+      run_timers++;
+    }
+  }
+  return run_timers;
+}
+
+time_point TimerWheel::nextExpiration() const {
+  for (uint64_t tick = current_tick_ + 1; ; tick++) {
+    if ((tick & kSlotMask) == 0 || !levels_[0][tick & kSlotMask].empty()) {
+      return toTime(tick);
+    }
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef ERIZO_SRC_ERIZO_THREAD_TIMERWHEEL_H_
+#define ERIZO_SRC_ERIZO_THREAD_TIMERWHEEL_H_
+
+#include <array>
+#include <chrono>  // NOLINT
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+#include "lib/Clock.h"
+
+namespace erizo {
+
+/**
+ * Hierarchical timing wheel with a resolution of one tick.
+ * Level 0 holds the timers expiring in the next kSlotsPerLevel ticks, every upper level covers kSlotsPerLevel
+ * times the range of the previous one and its slots are cascaded down when the lower level wraps around.
+ * Insertion and cancellation are O(1), expired timers are run in batches by advance().
+ * It is not thread safe, Worker only uses it from its own thread.
+ */
+class TimerWheel {
+ public:
+  typedef std::function<void()> Task;
+  typedef uint64_t TimerId;
+
+  static constexpr int kLevels = 4;
+  static constexpr int kSlotBits = 6;
+  static constexpr uint64_t kSlotsPerLevel = 1 << kSlotBits;
+
+  explicit TimerWheel(time_point now, duration tick = std::chrono::milliseconds(1));
+
+  TimerId add(Task f, time_point when);
+  bool cancel(TimerId id);
+  void clear();
+
+  // Runs every timer that expired at or before now and returns how many were run.
+  // Timers added or cancelled by the tasks themselves are handled as expected.
+  size_t advance(time_point now, std::function<void(const Task&, time_point)> runner);
+  size_t advance(time_point now);
+
+  bool empty() const { return timers_.empty(); }
+  size_t size() const { return timers_.size(); }
+  // Earliest point at which advance() may have work to do, only valid when the wheel is not empty
+  time_point nextExpiration() const;
+
+ private:
+  struct Timer {
+    TimerId id;
+    uint64_t expiration_tick;
+    Task task;
+  };
+  typedef std::list<Timer> Slot;
+
+  uint64_t toTick(time_point when) const;
+  time_point toTime(uint64_t tick) const;
+  void insert(Slot *from, Slot::iterator timer);
+  void cascade(int level);
+
+ private:
+  time_point origin_;
+  duration tick_;
+  uint64_t current_tick_;
+  TimerId next_id_;
+  std::array<std::array<Slot, kSlotsPerLevel>, kLevels> levels_;
+  std::unordered_map<TimerId, std::pair<Slot*, Slot::iterator>> timers_;
+};
+
+}  // namespace erizo
+
+#endif  // ERIZO_SRC_ERIZO_THREAD_TIMERWHEEL_H_
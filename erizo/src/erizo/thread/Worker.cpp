@@ -2,8 +2,11 @@
 
 #include <boost/asio.hpp>
 #include <boost/thread.hpp>
+#include <pthread.h>
+#include <sched.h>
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 
 #include "lib/ClockUtils.h"
@@ -13,7 +16,16 @@ using erizo::DurationDistribution;
 using erizo::SimulatedWorker;
 using erizo::ScheduledTaskReference;
 
-ScheduledTaskReference::ScheduledTaskReference() : cancelled{false} {
+DEFINE_LOGGER(Worker, "thread.Worker");
+
+// Queueing delay is what connections actually suffer, so it weighs more than busy time in the load estimate
+constexpr uint64_t kDelayLoadWeight = 4;
+// Tasks that wait less than this are not late, any worker with some traffic delays tasks a bit
+constexpr auto kLateTaskThreshold = std::chrono::milliseconds(10);
+// Load decays by half in this time, so it reflects what the worker has been doing in the last few seconds
+constexpr auto kLoadHalfLife = std::chrono::seconds(5);
+
+ScheduledTaskReference::ScheduledTaskReference() : cancelled{false}, timer_id_{0} {
 }
 
 bool ScheduledTaskReference::isCancelled() {
@@ -47,12 +59,18 @@ DurationDistribution& DurationDistribution::operator+=(const DurationDistributio
   return *this;
 }
 
-Worker::Worker(std::weak_ptr<Scheduler> scheduler, std::shared_ptr<Clock> the_clock)
-    : scheduler_{scheduler},
-      clock_{the_clock},
+Worker::Worker(std::shared_ptr<Clock> the_clock)
+    : clock_{the_clock},
       service_{},
       service_worker_{new asio_worker::element_type(service_)},
-      closed_{false} {
+      timer_{service_},
+      timer_wheel_{clock_->now()},
+      timer_armed_{false},
+      closed_{false},
+      cpu_affinity_{-1},
+      load_us_{0},
+      load_updated_at_{},
+      metrics_{MetricsRegistry::instance().createWorkerMetrics()} {
 }
 
 Worker::~Worker() {
@@ -61,16 +79,19 @@ Worker::~Worker() {
 void Worker::task(Task f) {
   std::weak_ptr<Worker> weak_this = shared_from_this();
   time_point scheduled_at = clock_->now();
+  metrics_->queued_tasks.add(1);
   service_.dispatch([f, scheduled_at, weak_this] {
     time_point start;
     if (auto this_ptr = weak_this.lock()) {
       start = this_ptr->clock_->now();
+      this_ptr->metrics_->queued_tasks.add(-1);
     }
     f();
     if (auto this_ptr = weak_this.lock()) {
       time_point end = this_ptr->clock_->now();
       this_ptr->addToDurationStats(end - start);
       this_ptr->addToDelayStats(start - scheduled_at);
+      this_ptr->addToLoad(end, end - start, start - scheduled_at);
     }
   });
 }
@@ -83,6 +104,8 @@ void Worker::start() {
 void Worker::start(std::shared_ptr<std::promise<void>> start_promise) {
   auto this_ptr = shared_from_this();
   auto worker = [this_ptr, start_promise] {
+    this_ptr->pinToCpu();
+    WorkerMetrics::setCurrent(this_ptr->metrics_.get());
     start_promise->set_value();
     if (!this_ptr->closed_) {
       return this_ptr->service_.run();
@@ -94,31 +117,92 @@ void Worker::start(std::shared_ptr<std::promise<void>> start_promise) {
   group_.add_thread(thread);
 }
 
+void Worker::pinToCpu() {
+  if (cpu_affinity_ < 0) {
+    return;
+  }
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu_affinity_, &cpu_set);
+  int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (error != 0) {
+    ELOG_WARN("message: Could not pin worker to cpu, cpu: %d, error: %d", cpu_affinity_, error);
+  }
+}
+
 void Worker::close() {
   closed_ = true;
+  // A pending timer would keep the io_service running
+  service_.post([this] {
+    timer_.cancel();
+    timer_wheel_.clear();
+  });
   service_worker_.reset();
   group_.join_all();
   service_.stop();
 }
 
 std::shared_ptr<ScheduledTaskReference> Worker::scheduleFromNow(Task f, duration delta) {
-  auto delta_ms = std::chrono::duration_cast<std::chrono::milliseconds>(delta);
   auto id = std::make_shared<ScheduledTaskReference>();
-  if (auto scheduler = scheduler_.lock()) {
-    scheduler->scheduleFromNow(safeTask([f, id](std::shared_ptr<Worker> this_ptr) {
-      this_ptr->task(this_ptr->safeTask([f, id](std::shared_ptr<Worker> this_ptr) {
-        {
-          if (id->isCancelled()) {
-            return;
-          }
-        }
-        f();
-      }));
-    }), delta_ms);
-  }
+  time_point expiration = clock_->now() + delta;
+  std::weak_ptr<Worker> weak_this = shared_from_this();
+  service_.dispatch([f, id, expiration, weak_this] {
+    if (auto this_ptr = weak_this.lock()) {
+      this_ptr->addTimer(f, id, expiration);
+    }
+  });
   return id;
 }
 
+void Worker::addTimer(Task f, std::shared_ptr<ScheduledTaskReference> id, time_point expiration) {
+  if (closed_ || id->isCancelled()) {
+    return;
+  }
+  id->timer_id_ = timer_wheel_.add([f, id] {
+    if (id->isCancelled()) {
+      return;
+    }
+    f();
+  }, expiration);
+  armTimer();
+}
+
+void Worker::armTimer() {
+  if (closed_ || timer_wheel_.empty()) {
+    return;
+  }
+  time_point deadline = timer_wheel_.nextExpiration();
+  if (timer_armed_ && timer_deadline_ <= deadline) {
+    return;
+  }
+  timer_armed_ = true;
+  timer_deadline_ = deadline;
+  // Rearming cancels the previous wait, its handler is then called with operation_aborted
+  timer_.expires_from_now(deadline - clock_->now());
+  std::weak_ptr<Worker> weak_this = shared_from_this();
+  timer_.async_wait([weak_this](const boost::system::error_code &error) {
+    if (error == boost::asio::error::operation_aborted) {
+      return;
+    }
+    if (auto this_ptr = weak_this.lock()) {
+      this_ptr->onTimer();
+    }
+  });
+}
+
+void Worker::onTimer() {
+  timer_armed_ = false;
+  timer_wheel_.advance(clock_->now(), [this](const TimerWheel::Task &f, time_point expiration) {
+    time_point start = clock_->now();
+    f();
+    time_point end = clock_->now();
+    addToDurationStats(end - start);
+    addToDelayStats(start - expiration);
+    addToLoad(end, end - start, start - expiration);
+  });
+  armTimer();
+}
+
 void Worker::scheduleEvery(ScheduledTask f, duration period) {
   scheduleEvery(f, period, period);
 }
@@ -138,6 +222,13 @@ void Worker::scheduleEvery(ScheduledTask f, duration period, duration next_delay
 
 void Worker::unschedule(std::shared_ptr<ScheduledTaskReference> id) {
   id->cancel();
+  // Free the slot now instead of waiting for the cancelled timer to expire
+  std::weak_ptr<Worker> weak_this = shared_from_this();
+  service_.dispatch([id, weak_this] {
+    if (auto this_ptr = weak_this.lock()) {
+      this_ptr->timer_wheel_.cancel(id->timer_id_);
+    }
+  });
 }
 
 std::function<void()> Worker::safeTask(std::function<void(std::shared_ptr<Worker>)> f) {
@@ -153,6 +244,7 @@ std::function<void()> Worker::safeTask(std::function<void(std::shared_ptr<Worker
 }
 
 void Worker::addToDurationStats(duration task_duration) {
+  metrics_->task_duration.observe(task_duration);
   if (task_duration <= std::chrono::milliseconds(10)) {
     durations_.duration_0_10_ms++;
   } else if (task_duration <= std::chrono::milliseconds(50)) {
@@ -167,6 +259,7 @@ void Worker::addToDurationStats(duration task_duration) {
 }
 
 void Worker::addToDelayStats(duration task_delay) {
+  metrics_->task_delay.observe(task_delay);
   if (task_delay <= std::chrono::milliseconds(10)) {
     delays_.duration_0_10_ms++;
   } else if (task_delay <= std::chrono::milliseconds(50)) {
@@ -180,6 +273,31 @@ void Worker::addToDelayStats(duration task_delay) {
   }
 }
 
+// Only called from the worker thread, the lock keeps the load and the time it was updated consistent for readers
+void Worker::addToLoad(time_point now, duration task_duration, duration task_delay) {
+  duration sample = task_duration;
+  if (task_delay > kLateTaskThreshold) {
+    sample += kDelayLoadWeight * (task_delay - kLateTaskThreshold);
+  }
+  boost::mutex::scoped_lock lock(load_mutex_);
+  load_us_ = decayedLoad(now) + std::chrono::duration<double, std::micro>(sample).count();
+  load_updated_at_ = now;
+}
+
+double Worker::decayedLoad(time_point now) {
+  if (now <= load_updated_at_) {
+    return load_us_;
+  }
+  std::chrono::duration<double> elapsed = now - load_updated_at_;
+  return load_us_ * std::exp2(-elapsed / std::chrono::duration<double>(kLoadHalfLife));
+}
+
+uint64_t Worker::getLoad() {
+  time_point now = clock_->now();
+  boost::mutex::scoped_lock lock(load_mutex_);
+  return static_cast<uint64_t>(decayedLoad(now));
+}
+
 void Worker::resetStats() {
   task(safeTask([](std::shared_ptr<Worker> worker) {
     worker->durations_.reset();
@@ -188,7 +306,7 @@ void Worker::resetStats() {
 }
 
 SimulatedWorker::SimulatedWorker(std::shared_ptr<SimulatedClock> the_clock)
-    : Worker(std::make_shared<Scheduler>(1), the_clock), clock_{the_clock} {
+    : Worker(the_clock), clock_{the_clock} {
 }
 
 void SimulatedWorker::task(Task f) {
@@ -218,10 +336,14 @@ std::shared_ptr<ScheduledTaskReference> SimulatedWorker::scheduleFromNow(Task f,
 }
 
 void SimulatedWorker::executeTasks() {
-  for (Task f : tasks_) {
-    f();
+  // Tasks may queue more tasks (e.g. a connection handing a packet to a stream), run them as well
+  while (!tasks_.empty()) {
+    std::vector<Task> tasks;
+    tasks.swap(tasks_);
+    for (const Task &f : tasks) {
+      f();
+    }
   }
-  tasks_.clear();
 }
 
 void SimulatedWorker::executePastScheduledTasks() {
@@ -5,25 +5,31 @@
 #include <boost/thread.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono> // NOLINT
 #include <map>
 #include <memory>
 #include <future>  // NOLINT
 #include <vector>
 
+#include "./logger.h"
 #include "lib/Clock.h"
+#include "stats/Metrics.h"
 
-#include "thread/Scheduler.h"
+#include "thread/TimerWheel.h"
 
 namespace erizo {
 
 class ScheduledTaskReference {
+  friend class Worker;
+
  public:
   ScheduledTaskReference();
   bool isCancelled();
   void cancel();
  private:
   std::atomic<bool> cancelled;
+  TimerWheel::TimerId timer_id_;
 };
 
 class DurationDistribution {
@@ -42,13 +48,14 @@ class DurationDistribution {
 };
 
 class Worker : public std::enable_shared_from_this<Worker> {
+  DECLARE_LOGGER();
+
  public:
   typedef std::unique_ptr<boost::asio::io_service::work> asio_worker;
   typedef std::function<void()> Task;
   typedef std::function<bool()> ScheduledTask;
 
-  explicit Worker(std::weak_ptr<Scheduler> scheduler,
-                  std::shared_ptr<Clock> the_clock = std::make_shared<SteadyClock>());
+  explicit Worker(std::shared_ptr<Clock> the_clock = std::make_shared<SteadyClock>());
   virtual ~Worker();
 
   virtual void task(Task f);
@@ -57,6 +64,7 @@ class Worker : public std::enable_shared_from_this<Worker> {
   virtual void start(std::shared_ptr<std::promise<void>> start_promise);
   virtual void close();
   virtual boost::thread::id getId() { return thread_id_; }
+  void setCpuAffinity(int cpu) { cpu_affinity_ = cpu; }
 
   virtual std::shared_ptr<ScheduledTaskReference> scheduleFromNow(Task f, duration delta);
   virtual void unschedule(std::shared_ptr<ScheduledTaskReference> id);
@@ -66,26 +74,44 @@ class Worker : public std::enable_shared_from_this<Worker> {
   void resetStats();
   DurationDistribution getDurationDistribution() { return durations_; }
   DurationDistribution getDelayDistribution() { return delays_; }
+  // Busy time plus the extra delay of late tasks, in microseconds, decaying exponentially over time
+  uint64_t getLoad();
+  WorkerMetrics& getMetrics() { return *metrics_; }
+  std::shared_ptr<Clock> getClock() { return clock_; }
 
  private:
   void scheduleEvery(ScheduledTask f, duration period, duration next_delay);
   std::function<void()> safeTask(std::function<void(std::shared_ptr<Worker>)> f);
   void addToDurationStats(duration task_duration);
   void addToDelayStats(duration task_delay);
+  void addToLoad(time_point now, duration task_duration, duration task_delay);
+  double decayedLoad(time_point now);  // Needs load_mutex_
+  void pinToCpu();
+  void addTimer(Task f, std::shared_ptr<ScheduledTaskReference> id, time_point expiration);
+  void armTimer();
+  void onTimer();
 
  protected:
   int next_scheduled_ = 0;
 
  private:
-  std::weak_ptr<Scheduler> scheduler_;
   std::shared_ptr<Clock> clock_;
   boost::asio::io_service service_;
   asio_worker service_worker_;
+  boost::asio::steady_timer timer_;
+  TimerWheel timer_wheel_;
+  bool timer_armed_;
+  time_point timer_deadline_;
   boost::thread_group group_;
   std::atomic<bool> closed_;
   boost::thread::id thread_id_;
+  int cpu_affinity_;
   DurationDistribution durations_;
   DurationDistribution delays_;
+  boost::mutex load_mutex_;
+  double load_us_;
+  time_point load_updated_at_;
+  std::shared_ptr<WorkerMetrics> metrics_;
 };
 
 class SimulatedWorker : public Worker {
@@ -40,3 +40,20 @@ TEST_F(DtlsSocketTest, create_1000_DtlsClient) {
   runTest(1000);
   EXPECT_THAT(true, Eq(true));
 }
+
+TEST_F(DtlsSocketTest, rotateIdentity_Changes_NewContextsFingerprintOnly) {
+  dtls::DtlsSocketContext old_context;
+  dtls::DtlsSocketContext same_identity_context;
+  old_context.createServer();
+  same_identity_context.createServer();
+  std::string old_fingerprint = old_context.getFingerprint();
+  EXPECT_THAT(same_identity_context.getFingerprint(), Eq(old_fingerprint));
+
+  dtls::DtlsSocketContext::rotateIdentity();
+  dtls::DtlsSocketContext new_context;
+  new_context.createServer();
+
+  EXPECT_THAT(old_context.getFingerprint(), Eq(old_fingerprint));
+  EXPECT_THAT(new_context.getFingerprint() == old_fingerprint, Eq(false));
+  EXPECT_THAT(new_context.getIdentity(), Eq(dtls::DtlsSocketContext::getCurrentIdentity()));
+}
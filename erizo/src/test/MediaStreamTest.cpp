@@ -0,0 +1,190 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <rtp/RtpHeaders.h>
+#include <MediaDefinitions.h>
+#include <MediaStream.h>
+#include <WebRtcConnection.h>
+
+#include <string>
+#include <vector>
+
+#include "utils/Mocks.h"
+#include "utils/Tools.h"
+
+using testing::Contains;
+using testing::Eq;
+using testing::Gt;
+using erizo::DataPacket;
+using erizo::ExtMap;
+using erizo::IceConfig;
+using erizo::RtpHeader;
+using erizo::RtpMap;
+using erizo::BwDistributionConfig;
+using erizo::WebRtcConnection;
+
+constexpr uint8_t kVp8PayloadType = 96;
+constexpr uint64_t kPaddingBitrate = 100000;
+constexpr size_t kRedHeaderLength = 1;
+constexpr size_t kFecSeqNumBaseOffset = 2;
+
+// Keeps the packets written to the wire
+class WireTransport : public erizo::MockTransport {
+ public:
+  using MockTransport::MockTransport;
+
+  void write(char* data, int len) override {
+    packets.push_back(std::make_shared<DataPacket>(0, data, len, erizo::VIDEO_PACKET));
+  }
+
+  std::vector<std::shared_ptr<DataPacket>> packets;
+};
+
+// A subscriber stream that runs the default pipeline, with padding enabled
+class PaddedMediaStream : public erizo::MediaStream {
+ public:
+  PaddedMediaStream(std::shared_ptr<erizo::Worker> worker, std::shared_ptr<WebRtcConnection> connection) :
+    MediaStream(worker, connection, "stream", "stream", false, true, true, "") {}
+
+  uint64_t getTargetPaddingBitrate() override {
+    return kPaddingBitrate;
+  }
+  void setTargetPaddingBitrate(uint64_t bitrate) override {
+  }
+};
+
+class MediaStreamTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    simulated_clock = std::make_shared<erizo::SimulatedClock>();
+    simulated_worker = std::make_shared<erizo::SimulatedWorker>(simulated_clock);
+    simulated_worker->start();
+    io_worker = std::make_shared<erizo::IOWorker>();
+    io_worker->start();
+    rtp_maps.push_back(RtpMap{kVp8PayloadType, "VP8", 90000, erizo::VIDEO_TYPE});
+    connection = std::make_shared<WebRtcConnection>(simulated_worker, io_worker,
+      "test_connection", ice_config, rtp_maps, ext_maps, true, distribution_config,
+      true, nullptr);
+    transport = std::make_shared<WireTransport>("test_connection", true, ice_config,
+                                                simulated_worker, io_worker);
+    connection->setTransport(transport);
+    connection->updateState(TRANSPORT_READY, transport.get());
+    connection->init();
+
+    sink = std::make_shared<erizo::MockMediaSink>();
+    stream = std::make_shared<PaddedMediaStream>(simulated_worker, connection);
+    stream->init();
+    stream->setVideoSinkSSRC(erizo::kVideoSsrc);
+    stream->setAudioSinkSSRC(erizo::kAudioSsrc);
+    stream->setVideoSink(sink);
+    connection->addMediaStream(stream);
+    simulated_worker->executeTasks();
+  }
+
+  virtual void TearDown() {
+    connection->close();
+    simulated_worker->executeTasks();
+  }
+
+  void negotiateRedAndUlpfec() {
+    auto remote_sdp = std::make_shared<erizo::SdpInfo>(rtp_maps);
+    for (unsigned int payload_type : {RED_90000_PT, ULP_90000_PT}) {
+      remote_sdp->inOutPTMap[payload_type] = payload_type;
+      remote_sdp->outInPTMap[payload_type] = payload_type;
+      remote_sdp->payloadVector.push_back(RtpMap{payload_type, payload_type == RED_90000_PT ? "red" : "ulpfec",
+          90000, erizo::VIDEO_TYPE});
+    }
+    stream->configure(true);
+    stream->setRemoteSdp(remote_sdp);
+    simulated_worker->executeTasks();
+  }
+
+  void receiveFractionLost(uint8_t fraction_lost) {
+    stream->onTransportData(erizo::PacketTools::createReceiverReport(erizo::kVideoSsrc, erizo::kVideoSsrc,
+        erizo::kArbitrarySeqNumber, erizo::VIDEO_PACKET, 0, fraction_lost), transport.get());
+    simulated_worker->executeTasks();
+  }
+
+  void executeTasksInNextMs(int time) {
+    for (int step = 0; step < time + 1; step++) {
+      simulated_worker->executeTasks();
+      simulated_worker->executePastScheduledTasks();
+      simulated_clock->advanceTime(std::chrono::milliseconds(1));
+    }
+  }
+
+  IceConfig ice_config;
+  std::vector<RtpMap> rtp_maps;
+  std::vector<ExtMap> ext_maps;
+  BwDistributionConfig distribution_config;
+  std::shared_ptr<erizo::MockMediaSink> sink;
+  std::shared_ptr<PaddedMediaStream> stream;
+  std::shared_ptr<WireTransport> transport;
+  std::shared_ptr<WebRtcConnection> connection;
+  std::shared_ptr<erizo::SimulatedClock> simulated_clock;
+  std::shared_ptr<erizo::SimulatedWorker> simulated_worker;
+  std::shared_ptr<erizo::IOWorker> io_worker;
+};
+
+TEST_F(MediaStreamTest, shouldProtectTheSequenceNumbersOnTheWire_whenPaddingIsSent) {
+  const uint16_t kFrames = 3;
+  const uint16_t kFramePackets = 4;
+  const int kFrameIntervalMs = 33;
+  negotiateRedAndUlpfec();
+  connection->setRtt(200);
+  receiveFractionLost(100);
+  receiveFractionLost(100);
+
+  uint16_t seq_num = erizo::kArbitrarySeqNumber;
+  for (uint16_t frame = 0; frame < kFrames; frame++) {
+    for (uint16_t i = 0; i < kFramePackets; i++) {
+      stream->deliverVideoData(erizo::PacketTools::createVP8Packet(seq_num++, frame == 0 && i == 0,
+          i == kFramePackets - 1));
+    }
+    executeTasksInNextMs(kFrameIntervalMs);
+  }
+  executeTasksInNextMs(kFrameIntervalMs);
+
+  std::vector<uint16_t> media_seq_nums;
+  std::vector<uint16_t> padding_seq_nums;
+  std::vector<uint16_t> fec_seq_num_bases;
+  uint16_t frame_first_seq_num = 0;
+  bool starts_frame = true;
+  for (const std::shared_ptr<DataPacket> &packet : transport->packets) {
+    const erizo::RtcpHeader *chead = reinterpret_cast<const erizo::RtcpHeader*>(packet->data);
+    if (chead->isRtcp()) {
+      continue;
+    }
+    const RtpHeader *head = reinterpret_cast<const RtpHeader*>(packet->data);
+    ASSERT_THAT(head->getPayloadType(), Eq(RED_90000_PT));
+    size_t header_length = head->getHeaderLength();
+    size_t payload_length = packet->length - header_length;
+    if (head->hasPadding()) {
+      payload_length -= static_cast<uint8_t>(packet->data[packet->length - 1]);
+    }
+    if (payload_length == 0) {
+      padding_seq_nums.push_back(head->getSeqNumber());
+      continue;
+    }
+    const uint8_t *red_payload = reinterpret_cast<const uint8_t*>(packet->data + header_length);
+    if ((red_payload[0] & 0x7f) == ULP_90000_PT) {
+      const uint8_t *fec_header = red_payload + kRedHeaderLength;
+      uint16_t seq_num_base = (fec_header[kFecSeqNumBaseOffset] << 8) | fec_header[kFecSeqNumBaseOffset + 1];
+      fec_seq_num_bases.push_back(seq_num_base);
+      EXPECT_THAT(seq_num_base, Eq(frame_first_seq_num));
+      continue;
+    }
+    media_seq_nums.push_back(head->getSeqNumber());
+    if (starts_frame) {
+      frame_first_seq_num = head->getSeqNumber();
+    }
+    starts_frame = head->getMarker();
+  }
+
+  EXPECT_THAT(media_seq_nums.size(), Eq(kFrames * kFramePackets));
+  EXPECT_THAT(padding_seq_nums.size(), Gt(0u));
+  ASSERT_THAT(fec_seq_num_bases.size(), Gt(1u));
+  for (uint16_t seq_num_base : fec_seq_num_bases) {
+    EXPECT_THAT(media_seq_nums, Contains(seq_num_base));
+  }
+}
@@ -2,9 +2,11 @@
 #include <gtest/gtest.h>
 
 #include <rtp/RtpHeaders.h>
+#include <rtp/RtpUtils.h>
 #include <MediaDefinitions.h>
 #include <OneToManyProcessor.h>
 #include <string>
+#include <vector>
 
 using testing::_;
 using testing::Return;
@@ -110,6 +112,15 @@ TEST_F(OneToManyProcessorTest, addSubscriber_Substitutes_WhenRepeated) {
   EXPECT_THAT(getSubscriber(kArbitraryPeerId).get(), Eq(new_subscriber.get()));
 }
 
+TEST_F(OneToManyProcessorTest, addSubscriber_Success_WhenThereIsNoPublisher) {
+  erizo::OneToManyProcessor otm_without_publisher;
+  auto new_subscriber = std::make_shared<MockSubscriber>();
+
+  otm_without_publisher.addSubscriber(new_subscriber, kArbitraryPeerId);
+
+  EXPECT_THAT(otm_without_publisher.getSubscriber(kArbitraryPeerId).get(), Eq(new_subscriber.get()));
+}
+
 TEST_F(OneToManyProcessorTest, deliverFeedback_CallsPublisher_WhenCalled) {
   erizo::RtpHeader header;
   header.setSeqNumber(12);
@@ -136,3 +147,191 @@ TEST_F(OneToManyProcessorTest, deliverAudioData_CallsSubscriber_whenCalled) {
   otm.deliverAudioData(std::make_shared<DataPacket>(0, reinterpret_cast<char*>(&header),
                        sizeof(erizo::RtpHeader), erizo::AUDIO_PACKET));
 }
+
+TEST_F(OneToManyProcessorTest, deliverVideoData_DoesNotModifySharedPacket_whenCalled) {
+  auto second_subscriber = std::make_shared<MockSubscriber>();
+  otm.addSubscriber(second_subscriber, "222");
+  subscriber->setVideoSinkSSRC(10);
+  second_subscriber->setVideoSinkSSRC(20);
+  erizo::RtpHeader header;
+  header.setSSRC(1);
+  header.setSeqNumber(12);
+  auto packet = std::make_shared<DataPacket>(0, reinterpret_cast<char*>(&header),
+                                             sizeof(erizo::RtpHeader), erizo::VIDEO_PACKET);
+
+  std::shared_ptr<DataPacket> first_packet, second_packet;
+  EXPECT_CALL(*subscriber, internalDeliverVideoData_(_)).WillOnce(testing::DoAll(
+    testing::SaveArg<0>(&first_packet), Return(0)));
+  EXPECT_CALL(*second_subscriber, internalDeliverVideoData_(_)).WillOnce(testing::DoAll(
+    testing::SaveArg<0>(&second_packet), Return(0)));
+  otm.deliverVideoData(packet);
+
+  EXPECT_EQ(reinterpret_cast<erizo::RtpHeader*>(packet->data)->getSSRC(), 1u);
+  EXPECT_EQ(reinterpret_cast<erizo::RtpHeader*>(first_packet->data)->getSSRC(), 10u);
+  EXPECT_EQ(reinterpret_cast<erizo::RtpHeader*>(second_packet->data)->getSSRC(), 20u);
+  EXPECT_EQ(reinterpret_cast<erizo::RtpHeader*>(first_packet->data)->getSeqNumber(), 12);
+}
+
+TEST_F(OneToManyProcessorTest, deliverAudioData_DoesNotModifySharedPacket_whenCalled) {
+  subscriber->setAudioSinkSSRC(30);
+  erizo::RtpHeader header;
+  header.setSSRC(2);
+  auto packet = std::make_shared<DataPacket>(0, reinterpret_cast<char*>(&header),
+                                             sizeof(erizo::RtpHeader), erizo::AUDIO_PACKET);
+
+  std::shared_ptr<DataPacket> delivered_packet;
+  EXPECT_CALL(*subscriber, internalDeliverAudioData_(_)).WillOnce(testing::DoAll(
+    testing::SaveArg<0>(&delivered_packet), Return(0)));
+  otm.deliverAudioData(packet);
+
+  EXPECT_EQ(reinterpret_cast<erizo::RtpHeader*>(packet->data)->getSSRC(), 2u);
+  EXPECT_EQ(reinterpret_cast<erizo::RtpHeader*>(delivered_packet->data)->getSSRC(), 30u);
+}
+
+TEST_F(OneToManyProcessorTest, deliverVideoData_DoesNotCallSubscriber_whenRemoved) {
+  erizo::RtpHeader header;
+  header.setSeqNumber(12);
+
+  otm.removeSubscriber(kArbitraryPeerId);
+
+  EXPECT_CALL(*subscriber, internalDeliverVideoData_(_)).Times(0);
+  otm.deliverVideoData(std::make_shared<DataPacket>(0, reinterpret_cast<char*>(&header),
+                       sizeof(erizo::RtpHeader), erizo::VIDEO_PACKET));
+}
+
+TEST_F(OneToManyProcessorTest, deliverFeedback_TranslatesSubscriberSSRCs_whenCalled) {
+  auto audio_subscriber = std::make_shared<MockSubscriber>();
+  audio_subscriber->setAudioSinkSSRC(30);
+  otm.addSubscriber(audio_subscriber, "222");
+  erizo::RtcpHeader audio_report;
+  audio_report.setPacketType(RTCP_Receiver_PT);
+  audio_report.setBlockCount(1);
+  audio_report.setSourceSSRC(30);
+  audio_report.setLength(7);
+  erizo::RtcpHeader video_report = audio_report;
+  video_report.setSourceSSRC(40);
+
+  std::shared_ptr<DataPacket> audio_feedback, video_feedback;
+  EXPECT_CALL(*publisher, internalDeliverFeedback_(_))
+    .WillOnce(testing::DoAll(testing::SaveArg<0>(&audio_feedback), Return(0)))
+    .WillOnce(testing::DoAll(testing::SaveArg<0>(&video_feedback), Return(0)));
+  otm.deliverFeedback(std::make_shared<DataPacket>(0, reinterpret_cast<char*>(&audio_report),
+                      (audio_report.getLength() + 1) * 4, erizo::AUDIO_PACKET));
+  otm.deliverFeedback(std::make_shared<DataPacket>(0, reinterpret_cast<char*>(&video_report),
+                      (video_report.getLength() + 1) * 4, erizo::VIDEO_PACKET));
+
+  EXPECT_EQ(reinterpret_cast<erizo::RtcpHeader*>(audio_feedback->data)->getSourceSSRC(),
+            publisher->getAudioSourceSSRC());
+  EXPECT_EQ(reinterpret_cast<erizo::RtcpHeader*>(video_feedback->data)->getSourceSSRC(),
+            publisher->getVideoSourceSSRC());
+}
+
+static std::shared_ptr<DataPacket> createVideoPacket(uint16_t seq_number, uint32_t timestamp, bool is_keyframe) {
+  erizo::RtpHeader header;
+  header.setSSRC(1);
+  header.setSeqNumber(seq_number);
+  header.setTimestamp(timestamp);
+  auto packet = std::make_shared<DataPacket>(0, reinterpret_cast<char*>(&header),
+                                             sizeof(erizo::RtpHeader), erizo::VIDEO_PACKET);
+  packet->is_keyframe = is_keyframe;
+  return packet;
+}
+
+TEST_F(OneToManyProcessorTest, deliverVideoData_PrimesNewSubscribersFromTheKeyframeCache_whenTheyAskForKeyframes) {
+  auto new_subscriber = std::make_shared<MockSubscriber>();
+  new_subscriber->setVideoSinkSSRC(20);
+  std::vector<uint16_t> received_seq_numbers;
+  EXPECT_CALL(*subscriber, internalDeliverVideoData_(_)).WillRepeatedly(Return(0));
+  EXPECT_CALL(*new_subscriber, internalDeliverVideoData_(_)).WillRepeatedly(testing::Invoke(
+    [&received_seq_numbers](std::shared_ptr<DataPacket> packet) {
+      received_seq_numbers.push_back(reinterpret_cast<erizo::RtpHeader*>(packet->data)->getSeqNumber());
+      return 0;
+  }));
+  EXPECT_CALL(*publisher, internalDeliverFeedback_(_)).Times(0);
+
+  otm.deliverVideoData(createVideoPacket(11, 1000, false));
+  otm.deliverVideoData(createVideoPacket(12, 2000, true));
+  otm.deliverVideoData(createVideoPacket(13, 2000, false));
+  otm.addSubscriber(new_subscriber, "222");
+  otm.deliverVideoData(createVideoPacket(14, 3000, false));
+  EXPECT_THAT(received_seq_numbers.size(), Eq(0u));
+
+  otm.deliverFeedback(erizo::RtpUtils::createPLI(20, publisher->getVideoSourceSSRC()));
+  otm.deliverVideoData(createVideoPacket(15, 3000, false));
+
+  EXPECT_THAT(received_seq_numbers, testing::ElementsAre(12, 13, 14, 15));
+}
+
+TEST_F(OneToManyProcessorTest, deliverFeedback_DropsOnlyTheRepeatedRequest_whenSubscribersArePrimed) {
+  auto new_subscriber = std::make_shared<MockSubscriber>();
+  new_subscriber->setVideoSinkSSRC(20);
+  EXPECT_CALL(*subscriber, internalDeliverVideoData_(_)).WillRepeatedly(Return(0));
+  EXPECT_CALL(*new_subscriber, internalDeliverVideoData_(_)).WillRepeatedly(Return(0));
+  otm.deliverVideoData(createVideoPacket(11, 1000, true));
+  otm.addSubscriber(new_subscriber, "222");
+  otm.deliverFeedback(erizo::RtpUtils::createPLI(20, publisher->getVideoSourceSSRC()));
+  otm.deliverVideoData(createVideoPacket(12, 1000, false));
+
+  EXPECT_CALL(*publisher, internalDeliverFeedback_(_)).Times(1).WillOnce(Return(0));
+  otm.deliverFeedback(erizo::RtpUtils::createPLI(20, publisher->getVideoSourceSSRC()));
+  otm.deliverFeedback(erizo::RtpUtils::createPLI(20, publisher->getVideoSourceSSRC()));
+}
+
+TEST_F(OneToManyProcessorTest, deliverFeedback_CallsPublisher_whenPrimedSubscribersAskForANewerKeyframe) {
+  auto new_subscriber = std::make_shared<MockSubscriber>();
+  new_subscriber->setVideoSinkSSRC(20);
+  EXPECT_CALL(*subscriber, internalDeliverVideoData_(_)).WillRepeatedly(Return(0));
+  EXPECT_CALL(*new_subscriber, internalDeliverVideoData_(_)).WillRepeatedly(Return(0));
+  otm.deliverVideoData(createVideoPacket(11, 1000, true));
+  otm.addSubscriber(new_subscriber, "222");
+  otm.deliverFeedback(erizo::RtpUtils::createPLI(20, publisher->getVideoSourceSSRC()));
+  otm.deliverVideoData(createVideoPacket(12, 1000, false));
+  otm.deliverVideoData(createVideoPacket(13, 2000, true));
+
+  EXPECT_CALL(*publisher, internalDeliverFeedback_(_)).Times(1).WillOnce(Return(0));
+  otm.deliverFeedback(erizo::RtpUtils::createPLI(20, publisher->getVideoSourceSSRC()));
+}
+
+TEST_F(OneToManyProcessorTest, deliverVideoData_PacesThePriming_whenTheCacheIsLarge) {
+  auto new_subscriber = std::make_shared<MockSubscriber>();
+  new_subscriber->setVideoSinkSSRC(20);
+  std::vector<uint16_t> received_seq_numbers;
+  EXPECT_CALL(*subscriber, internalDeliverVideoData_(_)).WillRepeatedly(Return(0));
+  EXPECT_CALL(*new_subscriber, internalDeliverVideoData_(_)).WillRepeatedly(testing::Invoke(
+    [&received_seq_numbers](std::shared_ptr<DataPacket> packet) {
+      received_seq_numbers.push_back(reinterpret_cast<erizo::RtpHeader*>(packet->data)->getSeqNumber());
+      return 0;
+  }));
+
+  uint16_t seq_number = 100;
+  otm.deliverVideoData(createVideoPacket(seq_number++, 1000, true));
+  for (int packets = 1; packets < 40; packets++) {
+    otm.deliverVideoData(createVideoPacket(seq_number++, 1000, false));
+  }
+  otm.addSubscriber(new_subscriber, "222");
+  otm.deliverFeedback(erizo::RtpUtils::createPLI(20, publisher->getVideoSourceSSRC()));
+
+  otm.deliverVideoData(createVideoPacket(seq_number++, 2000, false));
+  EXPECT_THAT(received_seq_numbers.size(), Eq(erizo::OneToManyProcessor::kMaxPrimingPacketsPerPacket));
+  for (int packets = 0; packets < 5; packets++) {
+    otm.deliverVideoData(createVideoPacket(seq_number++, 2000, false));
+  }
+
+  ASSERT_THAT(received_seq_numbers.size(), Eq(46u));
+  for (uint16_t index = 0; index < received_seq_numbers.size(); index++) {
+    EXPECT_THAT(received_seq_numbers[index], Eq(100 + index));
+  }
+}
+
+TEST_F(OneToManyProcessorTest, deliverFeedback_CallsPublisher_whenThereIsNoCachedKeyframe) {
+  auto new_subscriber = std::make_shared<MockSubscriber>();
+  new_subscriber->setVideoSinkSSRC(20);
+  EXPECT_CALL(*subscriber, internalDeliverVideoData_(_)).WillRepeatedly(Return(0));
+  otm.deliverVideoData(createVideoPacket(11, 1000, false));
+  otm.addSubscriber(new_subscriber, "222");
+
+  EXPECT_CALL(*publisher, internalDeliverFeedback_(_)).Times(1).WillOnce(Return(0));
+  EXPECT_CALL(*new_subscriber, internalDeliverVideoData_(_)).Times(1).WillOnce(Return(0));
+  otm.deliverFeedback(erizo::RtpUtils::createPLI(20, publisher->getVideoSourceSSRC()));
+  otm.deliverVideoData(createVideoPacket(12, 2000, false));
+}
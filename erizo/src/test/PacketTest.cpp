@@ -1,5 +1,6 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <cstring>
 
 // Headers for RtpPacketQueue.h tests
 #include <rtp/RtpPacketQueue.h>
@@ -237,3 +238,119 @@ TEST(erizoPacket, depthCalculationHandlesTimestampWrap) {
     ASSERT_EQ(queue.getSize(), (max + 1));
     ASSERT_EQ(queue.hasData(), true);
 }
+
+namespace {
+// Pushes a packet whose one byte payload tells isTestFrameStart if it starts a frame.
+void pushFramePacket(erizo::RtpPacketQueue *queue, uint16_t seq, uint32_t timestamp, bool start, bool marker) {
+    erizo::RtpHeader header;
+    header.setSeqNumber(seq);
+    header.setTimestamp(timestamp);
+    header.setMarker(marker);
+    char buffer[sizeof(erizo::RtpHeader) + 1];
+    memcpy(buffer, &header, header.getHeaderLength());
+    buffer[header.getHeaderLength()] = start ? 1 : 0;
+    queue->pushPacket(buffer, header.getHeaderLength() + 1);
+}
+
+bool isTestFrameStart(const char *data, int length) {
+    const erizo::RtpHeader *header = reinterpret_cast<const erizo::RtpHeader*>(data);
+    return data[header->getHeaderLength()] == 1;
+}
+
+uint16_t popSequenceNumber(erizo::RtpPacketQueue *queue, bool ignore_depth = false) {
+    boost::shared_ptr<erizo::DataPacket> packet = queue->popPacket(ignore_depth);
+    return reinterpret_cast<const erizo::RtpHeader*>(packet->data)->getSeqNumber();
+}
+}  // namespace
+
+TEST(erizoPacket, rtpPacketQueueReleasesCompleteFramesWithoutWaitingForDepth) {
+    erizo::RtpPacketQueue queue;
+    queue.setTimebase(90000);
+    queue.setFrameStartDetector(isTestFrameStart);
+
+    pushFramePacket(&queue, 10, 3000, true, false);
+    pushFramePacket(&queue, 12, 3000, false, true);
+    pushFramePacket(&queue, 11, 3000, false, false);
+    pushFramePacket(&queue, 14, 6000, false, true);
+    pushFramePacket(&queue, 13, 6000, true, false);
+
+    // Nothing has been handed out yet, so we don't know if there is anything missing before the first frame.
+    ASSERT_EQ(queue.hasData(), false);
+    for (uint16_t x = 10; x <= 12; x++) {
+        ASSERT_EQ(popSequenceNumber(&queue, true), x);
+    }
+
+    // The next frame follows the last packet we handed out and it is complete.
+    ASSERT_EQ(queue.hasData(), true);
+    ASSERT_EQ(popSequenceNumber(&queue), 13);
+    ASSERT_EQ(popSequenceNumber(&queue), 14);
+    ASSERT_EQ(queue.hasData(), false);
+
+    // An incomplete frame waits for the missing packet.
+    pushFramePacket(&queue, 15, 9000, true, false);
+    pushFramePacket(&queue, 17, 9000, false, true);
+    ASSERT_EQ(queue.hasData(), false);
+    ASSERT_THAT(queue.popPacket().get(), IsNull());
+
+    pushFramePacket(&queue, 16, 9000, false, false);
+    ASSERT_EQ(queue.hasData(), true);
+    for (uint16_t x = 15; x <= 17; x++) {
+        ASSERT_EQ(popSequenceNumber(&queue), x);
+    }
+    ASSERT_EQ(queue.getSize(), 0);
+}
+
+TEST(erizoPacket, rtpPacketQueueHoldsCompleteFramesAfterMissingPackets) {
+    erizo::RtpPacketQueue queue;
+    queue.setTimebase(90000);
+    queue.setFrameStartDetector(isTestFrameStart);
+
+    pushFramePacket(&queue, 100, 3000, true, true);
+    ASSERT_EQ(popSequenceNumber(&queue, true), 100);
+
+    // 101 is missing, releasing 102 would make it late.
+    pushFramePacket(&queue, 102, 9000, true, true);
+    ASSERT_EQ(queue.hasData(), false);
+
+    pushFramePacket(&queue, 101, 6000, true, true);
+    ASSERT_EQ(queue.hasData(), true);
+    ASSERT_EQ(popSequenceNumber(&queue), 101);
+    ASSERT_EQ(popSequenceNumber(&queue), 102);
+    ASSERT_EQ(queue.getLatePackets(), 0u);
+}
+
+TEST(erizoPacket, rtpPacketQueueCountsLateAndDuplicatePackets) {
+    int max = 10, depth = 5;
+    erizo::RtpPacketQueue queue(depth, max);
+    queue.setTimebase(1);
+
+    pushFramePacket(&queue, 5, 5, false, false);
+    ASSERT_EQ(popSequenceNumber(&queue, true), 5);
+
+    pushFramePacket(&queue, 4, 4, false, false);
+    pushFramePacket(&queue, 5, 5, false, false);
+    ASSERT_EQ(queue.getLatePackets(), 2u);
+
+    pushFramePacket(&queue, 6, 6, false, false);
+    pushFramePacket(&queue, 6, 6, false, false);
+    pushFramePacket(&queue, 9, 9, false, false);
+    ASSERT_EQ(queue.getDuplicatePackets(), 1u);
+    ASSERT_EQ(queue.getSize(), 2);
+    ASSERT_EQ(queue.getDepth(), 3.0);
+    ASSERT_EQ(queue.getDroppedPackets(), 0u);
+}
+
+TEST(erizoPacket, rtpPacketQueueDropsOldestPacketsWhenOverCapacity) {
+    erizo::RtpPacketQueue queue;
+    const uint16_t far_ahead = static_cast<uint16_t>(65530 + erizo::RtpPacketQueue::kCapacity);
+
+    pushFramePacket(&queue, 65530, 0, false, false);
+    pushFramePacket(&queue, 65534, 0, false, false);
+    pushFramePacket(&queue, far_ahead, 0, false, false);
+
+    // 65530 doesn't fit in the ring with the new packet, 65534 still does.
+    ASSERT_EQ(queue.getSize(), 2);
+    ASSERT_EQ(queue.getDroppedPackets(), 1u);
+    ASSERT_EQ(popSequenceNumber(&queue, true), 65534);
+    ASSERT_EQ(popSequenceNumber(&queue, true), far_ahead);
+}
@@ -0,0 +1,462 @@
+/*
+ * MediaStreamPipelineBenchmark.cpp
+ * Drives synthetic RTP through fully initialized publisher and subscriber MediaStreams (and the pipeline of
+ * their WebRtcConnection) on simulated time. Reports the cost, allocations and throughput per packet for audio,
+ * VP8 simulcast and VP9 SVC streams, and the marginal cost of every MediaStream handler, measured by running
+ * the same traffic again with that handler disabled. Handlers that stop forwarding packets when disabled
+ * (retransmissions) also account for the cost of the handlers after them.
+ *
+ * Usage: pipeline_benchmark [packets per run]
+ */
+
+#include <MediaStream.h>
+#include <WebRtcConnection.h>
+#include <lib/Clock.h>
+#include <rtp/RtpHeaders.h>
+#include <thread/IOWorker.h>
+#include <thread/Worker.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using erizo::DataPacket;
+using erizo::IceConfig;
+using erizo::IOWorker;
+using erizo::MediaStream;
+using erizo::RtpHeader;
+using erizo::RtpMap;
+using erizo::SdpInfo;
+using erizo::SimulatedClock;
+using erizo::SimulatedWorker;
+using erizo::WebRtcConnection;
+
+static std::atomic<uint64_t> allocations{0};
+
+void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *block = std::malloc(size ? size : 1)) {
+    return block;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  std::size_t alignment = static_cast<std::size_t>(align);
+  if (void *block = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) {
+    return block;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+  return operator new(size, align);
+}
+
+void operator delete(void *block) noexcept { std::free(block); }
+void operator delete[](void *block) noexcept { std::free(block); }
+void operator delete(void *block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void *block, std::size_t) noexcept { std::free(block); }
+void operator delete(void *block, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void *block, std::align_val_t) noexcept { std::free(block); }
+void operator delete(void *block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void *block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+
+constexpr int kDefaultPackets = 20000;
+constexpr int kWarmupPackets = 2000;
+constexpr int kRepetitions = 3;
+constexpr unsigned int kVp8PayloadType = 96;
+constexpr unsigned int kVp9PayloadType = 98;
+constexpr unsigned int kOpusPayloadType = 111;
+constexpr uint32_t kAudioSsrc = 1111;
+constexpr uint32_t kVideoSsrcs[] = {2222, 3333, 4444};
+constexpr uint32_t kSubscriberAudioSsrc = 5555;
+constexpr uint32_t kSubscriberVideoSsrc = 6666;
+constexpr int kLayers = 3;
+constexpr int kTemporalLayers = 3;
+constexpr int kPacketsPerLayer[kLayers] = {1, 3, 8};
+constexpr int kVideoPayloadSize = 1100;
+constexpr int kAudioPayloadSize = 160;
+constexpr int kFramesPerKeyframe = 90;
+constexpr std::chrono::milliseconds kFrameInterval{33};
+constexpr std::chrono::milliseconds kAudioInterval{20};
+constexpr std::chrono::microseconds kPacketInterval{500};
+constexpr uint32_t kVideoTimestampStep = 3000;
+constexpr uint32_t kAudioTimestampStep = 960;
+
+// MediaStream handlers in pipeline order, reader and writer are left out as the stream does nothing without them
+static const char *kHandlers[] = {
+  "rtcp-processor", "fec-receiver", "layer_bitrate_calculator", "quality_filter", "incoming-stats",
+  "fake-keyframe-generator", "track-mute", "slideshow", "padding-generator", "periodic-pli", "pli-priority",
+  "pli-pacer", "padding_removal", "rtcp_feedback_generation", "retransmissions", "sr_handler", "layer_detector",
+  "outgoing-stats", "packet_codec_parser",
+};
+
+enum class StreamKind { kAudio, kVp8Simulcast, kVp9Svc };
+
+struct Scenario {
+  const char *name;
+  StreamKind kind;
+  bool is_publisher;
+};
+
+struct TimedPacket {
+  std::chrono::microseconds at;
+  std::shared_ptr<DataPacket> packet;
+};
+
+struct Result {
+  int64_t packets = 0;
+  int64_t delivered = 0;
+  std::chrono::nanoseconds time{0};
+  uint64_t allocations = 0;
+
+  double nsPerPacket() const { return packets > 0 ? static_cast<double>(time.count()) / packets : 0.; }
+  double allocationsPerPacket() const { return packets > 0 ? static_cast<double>(allocations) / packets : 0.; }
+  double packetsPerSecond() const { return time.count() > 0 ? packets * 1e9 / time.count() : 0.; }
+};
+
+class BenchmarkTransport : public erizo::Transport {
+ public:
+  BenchmarkTransport(std::string connection_id, const IceConfig &ice_config,
+                     std::shared_ptr<erizo::Worker> worker, std::shared_ptr<IOWorker> io_worker) :
+    Transport(erizo::VIDEO_TYPE, "video", connection_id, true, true,
+              std::shared_ptr<erizo::TransportListener>(nullptr), ice_config, worker, io_worker) {}
+
+  void updateIceState(erizo::IceState state, erizo::IceConnection *conn) override {}
+  void maybeRestartIce(std::string username, std::string password) override {}
+  void onIceData(erizo::packetPtr packet) override {}
+  void onCandidate(const erizo::CandidateInfo &candidate, erizo::IceConnection *conn) override {}
+  void write(char* data, int len) override {
+    written++;
+  }
+  void processLocalSdp(SdpInfo *local_sdp) override {}
+  void start() override {}
+  boost::future<void> close() override {
+    boost::promise<void> promise;
+    promise.set_value();
+    return promise.get_future();
+  }
+
+  int64_t written = 0;
+};
+
+class CountingSink : public erizo::MediaSink {
+ public:
+  boost::future<void> close() override {
+    boost::promise<void> promise;
+    promise.set_value();
+    return promise.get_future();
+  }
+
+  int64_t delivered = 0;
+  bool record = false;
+  std::vector<std::shared_ptr<DataPacket>> recorded;
+
+ private:
+  int deliverAudioData_(std::shared_ptr<DataPacket> packet) override {
+    return deliver(packet);
+  }
+  int deliverVideoData_(std::shared_ptr<DataPacket> packet) override {
+    return deliver(packet);
+  }
+  int deliver(std::shared_ptr<DataPacket> packet) {
+    delivered++;
+    if (record) {
+      recorded.push_back(packet);
+    }
+    return packet->length;
+  }
+  int deliverEvent_(erizo::MediaEventPtr event) override {
+    return 0;
+  }
+};
+
+static std::vector<RtpMap> createRtpMaps() {
+  return std::vector<RtpMap>{
+    RtpMap{kVp8PayloadType, "VP8", 90000, erizo::VIDEO_TYPE, 1, {"nack", "ccm fir", "goog-remb"}, {}},
+    RtpMap{kVp9PayloadType, "VP9", 90000, erizo::VIDEO_TYPE, 1, {"nack", "ccm fir", "goog-remb"}, {}},
+    RtpMap{kOpusPayloadType, "opus", 48000, erizo::AUDIO_TYPE, 2, {}, {}},
+  };
+}
+
+static std::shared_ptr<DataPacket> createRtpPacket(erizo::packetType type, unsigned int payload_type, uint32_t ssrc,
+    uint16_t seq_number, uint32_t timestamp, bool marker, const std::vector<unsigned char> &descriptor,
+    int payload_size) {
+  char buffer[sizeof(DataPacket::data)] = {0};
+  RtpHeader *header = reinterpret_cast<RtpHeader*>(buffer);
+  header->setVersion(2);
+  header->setPayloadType(payload_type);
+  header->setSSRC(ssrc);
+  header->setSeqNumber(seq_number);
+  header->setTimestamp(timestamp);
+  header->setMarker(marker);
+  char *payload = buffer + RtpHeader::MIN_SIZE;
+  memcpy(payload, descriptor.data(), descriptor.size());
+  memset(payload + descriptor.size(), 0xab, payload_size - descriptor.size());
+  // Same constructor the transports use for the packets they receive
+  return std::make_shared<DataPacket>(0, buffer, RtpHeader::MIN_SIZE + payload_size, type);
+}
+
+// VP8 payload descriptor with picture id, TL0PICIDX and TID, followed by the start of the VP8 payload header
+static std::vector<unsigned char> vp8Descriptor(bool start, bool keyframe, uint8_t picture_id, uint8_t tl0_pic_idx,
+                                                uint8_t temporal_id) {
+  std::vector<unsigned char> descriptor{
+    static_cast<unsigned char>(0x80 | (start ? 0x10 : 0)), 0xe0, static_cast<unsigned char>(picture_id & 0x7f),
+    tl0_pic_idx, static_cast<unsigned char>(temporal_id << 6)};
+  if (start) {
+    // Frame tag (P bit clear for keyframes), start code and a 640x360 frame size
+    descriptor.insert(descriptor.end(), {static_cast<unsigned char>(keyframe ? 0x10 : 0x11), 0, 0,
+                                         0x9d, 0x01, 0x2a, 0x80, 0x02, 0x68, 0x01});
+  }
+  return descriptor;
+}
+
+// Non flexible mode VP9 payload descriptor with picture id and layer indices
+static std::vector<unsigned char> vp9Descriptor(bool begin, bool end, bool keyframe, uint8_t picture_id,
+                                                uint8_t tl0_pic_idx, uint8_t temporal_id, uint8_t spatial_id) {
+  unsigned char flags = 0xa0 | (keyframe ? 0 : 0x40) | (begin ? 0x08 : 0) | (end ? 0x04 : 0);
+  return std::vector<unsigned char>{
+    flags, static_cast<unsigned char>(picture_id & 0x7f),
+    static_cast<unsigned char>((temporal_id << 5) | (spatial_id << 1) | (spatial_id > 0 ? 1 : 0)), tl0_pic_idx};
+}
+
+static std::vector<TimedPacket> createTraffic(StreamKind kind, int count) {
+  static const uint8_t kTemporalPattern[] = {0, 2, 1, 2};
+  std::vector<TimedPacket> traffic;
+  traffic.reserve(count);
+  uint16_t seq_numbers[kLayers] = {0, 0, 0};
+  if (kind == StreamKind::kAudio) {
+    for (int i = 0; static_cast<int>(traffic.size()) < count; i++) {
+      traffic.push_back(TimedPacket{kAudioInterval * i, createRtpPacket(erizo::AUDIO_PACKET, kOpusPayloadType,
+          kAudioSsrc, seq_numbers[0]++, i * kAudioTimestampStep, false, {}, kAudioPayloadSize)});
+    }
+    return traffic;
+  }
+  for (int frame = 0; static_cast<int>(traffic.size()) < count; frame++) {
+    bool keyframe = frame % kFramesPerKeyframe == 0;
+    uint8_t picture_id = frame & 0x7f;
+    uint8_t tl0_pic_idx = frame / 4;
+    uint8_t temporal_id = keyframe ? 0 : kTemporalPattern[frame % 4];
+    uint32_t timestamp = frame * kVideoTimestampStep;
+    std::chrono::microseconds packet_time = kFrameInterval * frame;
+    for (int layer = 0; layer < kLayers; layer++) {
+      for (int i = 0; i < kPacketsPerLayer[layer]; i++) {
+        bool first = i == 0;
+        bool last = i == kPacketsPerLayer[layer] - 1;
+        std::shared_ptr<DataPacket> packet;
+        if (kind == StreamKind::kVp8Simulcast) {
+          // Every simulcast layer is an independent stream with its own SSRC
+          packet = createRtpPacket(erizo::VIDEO_PACKET, kVp8PayloadType, kVideoSsrcs[layer],
+              seq_numbers[layer]++, timestamp, last,
+              vp8Descriptor(first, keyframe, picture_id, tl0_pic_idx, temporal_id), kVideoPayloadSize);
+        } else {
+          // Spatial layers share the SSRC and the marker is only set at the end of the whole picture
+          packet = createRtpPacket(erizo::VIDEO_PACKET, kVp9PayloadType, kVideoSsrcs[0],
+              seq_numbers[0]++, timestamp, last && layer == kLayers - 1,
+              vp9Descriptor(first, last, keyframe && layer == 0, picture_id, tl0_pic_idx, temporal_id, layer),
+              kVideoPayloadSize);
+        }
+        traffic.push_back(TimedPacket{packet_time, packet});
+        packet_time += kPacketInterval;
+      }
+    }
+  }
+  traffic.resize(count);
+  return traffic;
+}
+
+/**
+ * A WebRtcConnection with a single MediaStream, both running on a SimulatedWorker.
+ */
+class PipelineFixture {
+ public:
+  PipelineFixture(const Scenario &scenario, std::shared_ptr<IOWorker> io_worker)
+      : scenario_{scenario}, rtp_maps_{createRtpMaps()},
+        clock_{std::make_shared<SimulatedClock>()},
+        worker_{std::make_shared<SimulatedWorker>(clock_)},
+        sink_{std::make_shared<CountingSink>()} {
+    worker_->start();
+    connection_ = std::make_shared<WebRtcConnection>(worker_, io_worker, "benchmark", ice_config_, rtp_maps_,
+        std::vector<erizo::ExtMap>(), true, erizo::BwDistributionConfig(), true, nullptr);
+    transport_ = std::make_shared<BenchmarkTransport>("benchmark", ice_config_, worker_, io_worker);
+    connection_->setTransport(transport_);
+    connection_->updateState(TRANSPORT_READY, transport_.get());
+    connection_->init();
+
+    stream_ = std::make_shared<MediaStream>(worker_, connection_, "stream", "label", scenario.is_publisher,
+        true, true);
+    stream_->init();
+    stream_->setVideoSink(sink_);
+    stream_->setAudioSink(sink_);
+    stream_->setVideoSinkSSRC(kSubscriberVideoSsrc);
+    stream_->setAudioSinkSSRC(kSubscriberAudioSsrc);
+    stream_->setSimulcast(scenario.kind == StreamKind::kVp8Simulcast);
+    connection_->addMediaStream(stream_);
+    worker_->executeTasks();
+
+    // What a parsed remote description would hold: negotiated codecs, bundle and the SSRCs of the stream
+    auto sdp = std::make_shared<SdpInfo>(rtp_maps_);
+    sdp->payloadVector = rtp_maps_;
+    sdp->isBundle = true;
+    sdp->audio_ssrc_map["label"] = kAudioSsrc;
+    sdp->video_ssrc_map["label"] = std::vector<uint32_t>(std::begin(kVideoSsrcs), std::end(kVideoSsrcs));
+    stream_->configure(true);
+    stream_->setRemoteSdp(sdp);
+    if (!scenario.is_publisher && scenario.kind != StreamKind::kAudio) {
+      // There is no bandwidth estimation to pick layers from, subscribe to the top one
+      stream_->setQualityLayer(kLayers - 1, kTemporalLayers - 1);
+    }
+    worker_->executeTasks();
+  }
+
+  ~PipelineFixture() {
+    stream_->close();
+    connection_->close();
+    worker_->executeTasks();
+    worker_->close();
+  }
+
+  void disableHandler(const std::string &name) {
+    stream_->disableHandler(name);
+    worker_->executeTasks();
+  }
+
+  void feed(const TimedPacket &timed_packet) {
+    std::chrono::microseconds elapsed = timed_packet.at - current_time_;
+    if (elapsed.count() > 0) {
+      clock_->advanceTime(elapsed);
+      current_time_ += elapsed;
+      worker_->executePastScheduledTasks();
+    }
+    if (scenario_.is_publisher) {
+      connection_->onTransportData(timed_packet.packet, transport_.get());
+    } else if (timed_packet.packet->type == erizo::AUDIO_PACKET) {
+      stream_->deliverAudioData(timed_packet.packet);
+    } else {
+      stream_->deliverVideoData(timed_packet.packet);
+    }
+    worker_->executeTasks();
+  }
+
+  // Publisher only, returns the packets as they leave the pipeline (with their layer information, like the ones
+  // that OneToManyProcessor hands to subscribers)
+  std::vector<TimedPacket> forward(const std::vector<TimedPacket> &traffic) {
+    std::vector<TimedPacket> forwarded;
+    sink_->record = true;
+    for (const TimedPacket &timed_packet : traffic) {
+      feed(timed_packet);
+      for (std::shared_ptr<DataPacket> &packet : sink_->recorded) {
+        forwarded.push_back(TimedPacket{timed_packet.at, std::move(packet)});
+      }
+      sink_->recorded.clear();
+    }
+    sink_->record = false;
+    return forwarded;
+  }
+
+  int64_t delivered() const {
+    return scenario_.is_publisher ? sink_->delivered : transport_->written;
+  }
+
+ private:
+  Scenario scenario_;
+  IceConfig ice_config_;
+  std::vector<RtpMap> rtp_maps_;
+  std::shared_ptr<SimulatedClock> clock_;
+  std::shared_ptr<SimulatedWorker> worker_;
+  std::shared_ptr<CountingSink> sink_;
+  std::shared_ptr<WebRtcConnection> connection_;
+  std::shared_ptr<BenchmarkTransport> transport_;
+  std::shared_ptr<MediaStream> stream_;
+  std::chrono::microseconds current_time_{0};
+};
+
+static Result run(const Scenario &scenario, std::shared_ptr<IOWorker> io_worker, int packets,
+                  const std::string &disabled_handler = "") {
+  size_t needed_packets = kWarmupPackets + kRepetitions * packets;
+  std::vector<TimedPacket> traffic = createTraffic(scenario.kind, needed_packets);
+  if (!scenario.is_publisher) {
+    Scenario publisher = scenario;
+    publisher.is_publisher = true;
+    traffic = PipelineFixture(publisher, io_worker).forward(createTraffic(scenario.kind, needed_packets * 2));
+    if (traffic.size() < needed_packets) {
+      fprintf(stderr, "%s: the publisher only forwarded %zu packets\n", scenario.name, traffic.size());
+      exit(1);
+    }
+  }
+  auto timed_packet = traffic.begin();
+
+  PipelineFixture fixture(scenario, io_worker);
+  if (!disabled_handler.empty()) {
+    fixture.disableHandler(disabled_handler);
+  }
+  for (int i = 0; i < kWarmupPackets; i++) {
+    fixture.feed(*timed_packet++);
+  }
+
+  // The traffic keeps flowing between repetitions, the best one is reported to filter out noise
+  Result best;
+  for (int repetition = 0; repetition < kRepetitions; repetition++) {
+    Result result;
+    int64_t delivered_before = fixture.delivered();
+    uint64_t allocations_before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < packets; i++) {
+      fixture.feed(*timed_packet++);
+    }
+    result.time = std::chrono::steady_clock::now() - start;
+    result.allocations = allocations.load() - allocations_before;
+    result.delivered = fixture.delivered() - delivered_before;
+    result.packets = packets;
+    if (repetition == 0 || result.time < best.time) {
+      best = result;
+    }
+  }
+  return best;
+}
+
+int main(int argc, char *argv[]) {
+  int packets = argc > 1 ? std::max(1, atoi(argv[1])) : kDefaultPackets;
+  const Scenario scenarios[] = {
+    {"audio publisher", StreamKind::kAudio, true},
+    {"audio subscriber", StreamKind::kAudio, false},
+    {"vp8 simulcast publisher", StreamKind::kVp8Simulcast, true},
+    {"vp8 simulcast subscriber", StreamKind::kVp8Simulcast, false},
+    {"vp9 svc publisher", StreamKind::kVp9Svc, true},
+    {"vp9 svc subscriber", StreamKind::kVp9Svc, false},
+  };
+  auto io_worker = std::make_shared<IOWorker>();
+  io_worker->start();
+
+  printf("MediaStream pipeline, best of %d runs of %d packets after %d warmup packets\n", kRepetitions, packets,
+         kWarmupPackets);
+  for (const Scenario &scenario : scenarios) {
+    Result total = run(scenario, io_worker, packets);
+    printf("\n%-26s %10.0f ns/packet %8.2f allocs/packet %10.0f packets/s  (%" PRId64 " delivered)\n",
+           scenario.name, total.nsPerPacket(), total.allocationsPerPacket(), total.packetsPerSecond(),
+           total.delivered);
+    for (const char *handler : kHandlers) {
+      Result without = run(scenario, io_worker, packets, handler);
+      printf("  %-28s %10.0f ns/packet %8.2f allocs/packet  (%" PRId64 " delivered when disabled)\n", handler,
+             total.nsPerPacket() - without.nsPerPacket(),
+             total.allocationsPerPacket() - without.allocationsPerPacket(), without.delivered);
+    }
+  }
+
+  io_worker->close();
+  return 0;
+}
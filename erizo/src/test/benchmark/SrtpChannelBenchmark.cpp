@@ -0,0 +1,109 @@
+/*
+ * SrtpChannelBenchmark.cpp
+ * Measures SRTP protect/unprotect throughput of a single core for the supported profiles.
+ */
+
+#include <SrtpChannel.h>
+#include <lib/Base64.h>
+#include <rtp/RtpHeaders.h>
+
+#include <chrono>  // NOLINT
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using erizo::DataPacket;
+using erizo::SrtpChannel;
+
+constexpr int kBatchSize = 64;
+constexpr int kIterations = 20000;
+constexpr int kPayloadSize = 1100;
+constexpr uint32_t kSsrc = 1234;
+
+struct Profile {
+  const char *name;
+  srtp_profile_t profile;
+};
+
+static std::string createKey(srtp_profile_t profile, std::mt19937 *random) {
+  std::string key(srtp_profile_get_master_key_length(profile) + srtp_profile_get_master_salt_length(profile), 0);
+  for (char &byte : key) {
+    byte = static_cast<char>((*random)());
+  }
+  std::string encoded_key;
+  erizo::Base64::Encode(key, &encoded_key);
+  return encoded_key;
+}
+
+static void fillBatch(const std::vector<std::shared_ptr<DataPacket>> &batch, uint16_t *seq_number) {
+  for (const std::shared_ptr<DataPacket> &packet : batch) {
+    erizo::RtpHeader header;
+    header.setPayloadType(96);
+    header.setSSRC(kSsrc);
+    header.setSeqNumber((*seq_number)++);
+    header.setTimestamp(*seq_number * 3000);
+    memcpy(packet->data, &header, erizo::RtpHeader::MIN_SIZE);
+    memset(packet->data + erizo::RtpHeader::MIN_SIZE, 0xab, kPayloadSize);
+    packet->length = erizo::RtpHeader::MIN_SIZE + kPayloadSize;
+  }
+}
+
+static void runProfile(const Profile &profile) {
+  std::mt19937 random(42);
+  std::string local_key = createKey(profile.profile, &random);
+  std::string remote_key = createKey(profile.profile, &random);
+  SrtpChannel sender;
+  SrtpChannel receiver;
+  if (!sender.setRtpParams(local_key, remote_key, profile.profile) ||
+      !receiver.setRtpParams(remote_key, local_key, profile.profile)) {
+    printf("%-24s unsupported by this libsrtp build\n", profile.name);
+    return;
+  }
+
+  std::vector<std::shared_ptr<DataPacket>> batch;
+  for (int i = 0; i < kBatchSize; i++) {
+    batch.push_back(std::make_shared<DataPacket>());
+  }
+
+  uint16_t seq_number = 0;
+  std::chrono::nanoseconds protect_time{0};
+  std::chrono::nanoseconds unprotect_time{0};
+  int64_t protected_packets = 0;
+  int64_t unprotected_packets = 0;
+  for (int i = 0; i < kIterations; i++) {
+    fillBatch(batch, &seq_number);
+    auto start = std::chrono::steady_clock::now();
+    protected_packets += sender.protectPackets(batch);
+    auto middle = std::chrono::steady_clock::now();
+    unprotected_packets += receiver.unprotectPackets(batch);
+    auto end = std::chrono::steady_clock::now();
+    protect_time += middle - start;
+    unprotect_time += end - middle;
+  }
+
+  auto packets_per_second = [](int64_t packets, std::chrono::nanoseconds time) {
+    return time.count() > 0 ? packets * 1e9 / time.count() : 0.;
+  };
+  printf("%-24s protect: %10.0f packets/s  unprotect: %10.0f packets/s  (%" PRId64 "/%" PRId64 " packets ok)\n",
+         profile.name,
+         packets_per_second(protected_packets, protect_time),
+         packets_per_second(unprotected_packets, unprotect_time),
+         unprotected_packets, static_cast<int64_t>(kBatchSize) * kIterations);
+}
+
+int main() {
+  const Profile profiles[] = {
+    {"AES_CM_128_HMAC_SHA1_80", srtp_profile_aes128_cm_sha1_80},
+    {"AEAD_AES_128_GCM", srtp_profile_aead_aes_128_gcm},
+    {"AEAD_AES_256_GCM", srtp_profile_aead_aes_256_gcm},
+  };
+  printf("SRTP throughput, %d byte packets in batches of %d\n", erizo::RtpHeader::MIN_SIZE + kPayloadSize, kBatchSize);
+  for (const Profile &profile : profiles) {
+    runProfile(profile);
+  }
+  return 0;
+}
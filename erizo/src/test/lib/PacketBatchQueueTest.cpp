@@ -0,0 +1,46 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <lib/PacketBatchQueue.h>
+
+#include <memory>
+#include <vector>
+
+using erizo::DataPacket;
+using erizo::PacketBatchQueue;
+
+class PacketBatchQueueTest : public ::testing::Test {
+ protected:
+  std::shared_ptr<DataPacket> createPacket(int comp) {
+    char buffer[10] = {0};
+    return std::make_shared<DataPacket>(comp, buffer, sizeof(buffer), erizo::VIDEO_PACKET);
+  }
+
+  PacketBatchQueue queue;
+  std::vector<std::shared_ptr<DataPacket>> batch;
+};
+
+TEST_F(PacketBatchQueueTest, shouldAskForAFlushOnlyForTheFirstPacket) {
+  EXPECT_TRUE(queue.push(createPacket(1)));
+  EXPECT_FALSE(queue.push(createPacket(2)));
+  EXPECT_FALSE(queue.push(createPacket(3)));
+}
+
+TEST_F(PacketBatchQueueTest, shouldTakeAllPacketsInOrder) {
+  queue.push(createPacket(1));
+  queue.push(createPacket(2));
+
+  queue.takeAll(&batch);
+
+  ASSERT_EQ(batch.size(), 2u);
+  EXPECT_EQ(batch[0]->comp, 1);
+  EXPECT_EQ(batch[1]->comp, 2);
+}
+
+TEST_F(PacketBatchQueueTest, shouldAskForAFlushAgainAfterTakingThePackets) {
+  queue.push(createPacket(1));
+  queue.takeAll(&batch);
+  batch.clear();
+
+  EXPECT_TRUE(queue.push(createPacket(2)));
+}
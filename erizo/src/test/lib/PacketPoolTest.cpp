@@ -0,0 +1,96 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <lib/PacketPool.h>
+
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+
+using erizo::DataPacket;
+using erizo::PacketPool;
+using packetPtr = std::shared_ptr<DataPacket>;
+
+class PacketPoolTest : public ::testing::Test {
+ protected:
+  packetPtr createPacket(int length) {
+    char buffer[1500];
+    memset(buffer, 0xab, sizeof(buffer));
+    return PacketPool::create(1, buffer, length, erizo::AUDIO_PACKET, 1234);
+  }
+};
+
+TEST_F(PacketPoolTest, shouldCreatePacketsWithTheGivenContent) {
+  packetPtr packet = createPacket(100);
+
+  EXPECT_EQ(packet->comp, 1);
+  EXPECT_EQ(packet->length, 100);
+  EXPECT_EQ(packet->type, erizo::AUDIO_PACKET);
+  EXPECT_EQ(packet->received_time_ms, 1234u);
+  EXPECT_EQ(static_cast<unsigned char>(packet->data[99]), 0xab);
+  EXPECT_EQ(packet->rid, 0);
+  EXPECT_EQ(packet->codec, erizo::StringInterner::kEmptyId);
+}
+
+TEST_F(PacketPoolTest, shouldCloneAllFieldsAndPayload) {
+  packetPtr packet = createPacket(200);
+  packet->codec = erizo::StringInterner::kVP8Id;
+  packet->mid = erizo::StringInterner::intern("1");
+  packet->rid = 2;
+  packet->is_keyframe = true;
+  packet->picture_id = 42;
+  packet->compatible_spatial_layers = {0, 1};
+  packet->transport_sequence_number = 7;
+
+  packetPtr clone = PacketPool::clone(*packet);
+
+  EXPECT_NE(clone.get(), packet.get());
+  EXPECT_EQ(clone->length, 200);
+  EXPECT_EQ(memcmp(clone->data, packet->data, 200), 0);
+  EXPECT_EQ(clone->getCodecName(), "VP8");
+  EXPECT_EQ(clone->getMidName(), "1");
+  EXPECT_EQ(clone->rid, 2);
+  EXPECT_TRUE(clone->is_keyframe);
+  EXPECT_EQ(clone->picture_id, 42);
+  EXPECT_TRUE(clone->belongsToSpatialLayer(1));
+  EXPECT_EQ(*clone->transport_sequence_number, 7);
+}
+
+TEST_F(PacketPoolTest, shouldCopyOnlyTheBytesInUse) {
+  packetPtr packet = createPacket(10);
+  DataPacket copy;
+  memset(copy.data, 0, sizeof(copy.data));
+  copy = *packet;
+
+  EXPECT_EQ(static_cast<unsigned char>(copy.data[9]), 0xab);
+  EXPECT_EQ(copy.data[10], 0);
+}
+
+TEST_F(PacketPoolTest, shouldReuseReleasedMemory) {
+  packetPtr packet = createPacket(10);
+  DataPacket *address = packet.get();
+  packet.reset();
+
+  packetPtr another_packet = createPacket(10);
+
+  EXPECT_EQ(another_packet.get(), address);
+}
+
+TEST_F(PacketPoolTest, shouldAllowReleasingPacketsFromOtherThreads) {
+  std::vector<packetPtr> packets;
+  std::thread producer([&packets, this] {
+    for (int i = 0; i < 2000; i++) {
+      packets.push_back(createPacket(i % 1500));
+    }
+  });
+  producer.join();
+
+  for (int i = 0; i < 2000; i++) {
+    EXPECT_EQ(packets[i]->length, i % 1500);
+  }
+  packets.clear();
+
+  packetPtr packet = createPacket(10);
+  EXPECT_EQ(packet->length, 10);
+}
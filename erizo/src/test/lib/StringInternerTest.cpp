@@ -0,0 +1,32 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <lib/StringInterner.h>
+
+#include <string>
+
+using ::testing::Eq;
+using ::testing::Ne;
+using erizo::StringId;
+using erizo::StringInterner;
+
+TEST(StringInternerTest, shouldReserveIdsForWellKnownCodecs) {
+  EXPECT_THAT(StringInterner::intern(""), Eq(StringInterner::kEmptyId));
+  EXPECT_THAT(StringInterner::intern("VP8"), Eq(StringInterner::kVP8Id));
+  EXPECT_THAT(StringInterner::intern("VP9"), Eq(StringInterner::kVP9Id));
+  EXPECT_THAT(StringInterner::intern("H264"), Eq(StringInterner::kH264Id));
+  EXPECT_THAT(StringInterner::lookup(StringInterner::kVP8Id), Eq("VP8"));
+}
+
+TEST(StringInternerTest, shouldReturnTheSameIdForTheSameString) {
+  StringId audio_mid = StringInterner::intern("string_interner_test_0");
+  StringId video_mid = StringInterner::intern("string_interner_test_1");
+
+  EXPECT_THAT(audio_mid, Ne(video_mid));
+  EXPECT_THAT(StringInterner::intern(std::string("string_interner_test_0")), Eq(audio_mid));
+  EXPECT_THAT(StringInterner::lookup(video_mid), Eq("string_interner_test_1"));
+}
+
+TEST(StringInternerTest, shouldReturnEmptyStringForUnknownIds) {
+  EXPECT_THAT(StringInterner::lookup(StringInterner::kMaxStrings - 1), Eq(""));
+}
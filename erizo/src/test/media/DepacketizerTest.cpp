@@ -113,6 +113,23 @@ TEST_F(DepacketizerVp8Test, shouldReset) {
   EXPECT_EQ(0, depacketizer->frameSize());
 }
 
+TEST_F(DepacketizerVp8Test, shouldDetectFrameStart) {
+  auto pkt = erizo::PacketTools::createVP8Packet(seq, false, false);
+  EXPECT_TRUE(erizo::Vp8Depacketizer::isFrameStart(pkt->data, pkt->length));
+
+  // unset the bit indicating the start of partition
+  unsigned char* pkt_ptr = reinterpret_cast<unsigned char*>(pkt->data);
+  erizo::RtpHeader* head = reinterpret_cast<erizo::RtpHeader*>(pkt_ptr);
+  pkt_ptr += head->getHeaderLength();
+  *pkt_ptr = erizo::change_bit(*pkt_ptr, 4, false);
+  EXPECT_FALSE(erizo::Vp8Depacketizer::isFrameStart(pkt->data, pkt->length));
+
+  // start of a partition that is not the first one
+  *pkt_ptr = 0x11;
+  EXPECT_FALSE(erizo::Vp8Depacketizer::isFrameStart(pkt->data, pkt->length));
+  EXPECT_FALSE(erizo::Vp8Depacketizer::isFrameStart(pkt->data, head->getHeaderLength()));
+}
+
 TEST_F(DepacketizerH264Test, isReallyEmpty) {
   EXPECT_EQ(0, depacketizer->isKeyframe());
   EXPECT_EQ(0, depacketizer->frameSize());
@@ -162,6 +179,20 @@ TEST_F(DepacketizerH264Test, shouldDepacketFragmentedFrame) {
       static_cast<unsigned>(depacketizer->frameSize()));
 }
 
+TEST_F(DepacketizerH264Test, shouldDetectFrameStart) {
+  auto pkt = erizo::PacketTools::createH264SingleNalPacket(seq, timestamp, false);
+  EXPECT_TRUE(erizo::H264Depacketizer::isFrameStart(pkt->data, pkt->length));
+
+  pkt = erizo::PacketTools::createH264AggregatedPacket(seq, timestamp, 10, 10);
+  EXPECT_TRUE(erizo::H264Depacketizer::isFrameStart(pkt->data, pkt->length));
+
+  pkt = erizo::PacketTools::createH264FragmentedPacket(seq, timestamp, true, false, false);
+  EXPECT_TRUE(erizo::H264Depacketizer::isFrameStart(pkt->data, pkt->length));
+
+  pkt = erizo::PacketTools::createH264FragmentedPacket(seq, timestamp, false, true, false);
+  EXPECT_FALSE(erizo::H264Depacketizer::isFrameStart(pkt->data, pkt->length));
+}
+
 TEST_F(DepacketizerH264Test, shouldReset) {
   const auto pkt = erizo::PacketTools::createH264SingleNalPacket(seq, timestamp, true);
   depacketizer->fetchPacket(reinterpret_cast<unsigned char*>(pkt->data), pkt->length);
@@ -0,0 +1,126 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <media/RecordingEngine.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <functional>
+#include <future>  // NOLINT
+#include <memory>
+#include <thread>  // NOLINT
+
+using testing::Eq;
+using testing::Ge;
+using erizo::RecordingEngine;
+using erizo::RecordingTask;
+using erizo::SimulatedClock;
+
+class TestRecordingTask : public RecordingTask {
+ public:
+  explicit TestRecordingTask(std::function<void()> on_run = [] {}) : on_run_{on_run} {}
+
+  void processRecordingData() override {
+    int running = ++running_;
+    max_running_ = std::max(max_running_.load(), running);
+    on_run_();
+    runs_++;
+    running_--;
+  }
+
+  std::atomic<int> runs_{0};
+  std::atomic<int> running_{0};
+  std::atomic<int> max_running_{0};
+
+ private:
+  std::function<void()> on_run_;
+};
+
+class RecordingEngineTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    clock = std::make_shared<SimulatedClock>();
+  }
+  virtual void TearDown() {
+    if (engine) {
+      engine->close();
+    }
+  }
+
+  void createEngine(unsigned int num_threads) {
+    engine = std::make_shared<RecordingEngine>(num_threads, clock);
+    engine->start();
+  }
+
+  void waitForRuns(std::shared_ptr<TestRecordingTask> task, int runs) {
+    for (int i = 0; i < 1000 && task->runs_ < runs; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  std::shared_ptr<SimulatedClock> clock;
+  std::shared_ptr<RecordingEngine> engine;
+};
+
+TEST_F(RecordingEngineTest, schedule_shouldRunTheTask) {
+  createEngine(2);
+  auto task = std::make_shared<TestRecordingTask>();
+
+  engine->schedule(task);
+
+  waitForRuns(task, 1);
+  EXPECT_THAT(task->runs_.load(), Eq(1));
+}
+
+TEST_F(RecordingEngineTest, schedule_shouldNotRunTheSameTaskInTwoThreads) {
+  createEngine(4);
+  auto task = std::make_shared<TestRecordingTask>([] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  });
+
+  for (int i = 0; i < 20; i++) {
+    engine->schedule(task);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  waitForRuns(task, 2);
+  EXPECT_THAT(task->runs_.load(), Ge(2));
+  EXPECT_THAT(task->max_running_.load(), Eq(1));
+}
+
+TEST_F(RecordingEngineTest, isFallingBehind_shouldBeTrue_whenTasksWaitTooLong) {
+  createEngine(1);
+  std::promise<void> release_promise;
+  std::shared_future<void> release = release_promise.get_future().share();
+  auto blocking_task = std::make_shared<TestRecordingTask>([release] { release.wait(); });
+  auto waiting_task = std::make_shared<TestRecordingTask>();
+  auto late_task = std::make_shared<TestRecordingTask>();
+
+  engine->schedule(blocking_task);
+  for (int i = 0; i < 1000 && blocking_task->running_ == 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  engine->schedule(waiting_task);
+  clock->advanceTime(RecordingEngine::kMaxSchedulingDelay + std::chrono::milliseconds(1));
+  engine->schedule(late_task);
+
+  EXPECT_THAT(engine->isFallingBehind(), Eq(true));
+
+  release_promise.set_value();
+  waitForRuns(late_task, 1);
+  EXPECT_THAT(engine->isFallingBehind(), Eq(false));
+}
+
+TEST_F(RecordingEngineTest, schedule_shouldIgnoreTasksThatAreGone) {
+  createEngine(1);
+  auto task = std::make_shared<TestRecordingTask>();
+  auto gone_task = std::make_shared<TestRecordingTask>();
+
+  engine->schedule(gone_task);
+  gone_task.reset();
+  engine->schedule(task);
+
+  waitForRuns(task, 1);
+  EXPECT_THAT(task->runs_.load(), Eq(1));
+}
@@ -0,0 +1,102 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <media/RecordingFileWriter.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using testing::Eq;
+using erizo::RecordingFileWriter;
+
+class RecordingFileWriterTest : public ::testing::TestWithParam<bool> {
+ public:
+  virtual void SetUp() {
+    char path_template[] = "/tmp/recording_file_writer_XXXXXX";
+    int fd = mkstemp(path_template);
+    close(fd);
+    path = path_template;
+    writer.reset(new RecordingFileWriter(path, GetParam()));
+    ASSERT_TRUE(writer->open());
+  }
+  virtual void TearDown() {
+    writer.reset();
+    unlink(path.c_str());
+  }
+
+  std::vector<uint8_t> writeSequence(size_t length) {
+    std::vector<uint8_t> data(length);
+    for (size_t i = 0; i < length; i++) {
+      data[i] = static_cast<uint8_t>(i * 7);
+    }
+    EXPECT_TRUE(writer->write(data.data(), data.size()));
+    return data;
+  }
+
+  std::vector<uint8_t> readFile() {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  std::string path;
+  std::unique_ptr<RecordingFileWriter> writer;
+};
+
+TEST_P(RecordingFileWriterTest, write_shouldBatchSmallWrites) {
+  std::vector<uint8_t> expected;
+  for (int i = 0; i < 100; i++) {
+    std::vector<uint8_t> data = writeSequence(100);
+    expected.insert(expected.end(), data.begin(), data.end());
+  }
+
+  EXPECT_THAT(writer->getNumWrites(), Eq(0u));
+  EXPECT_TRUE(writer->close());
+
+  EXPECT_THAT(writer->getNumWrites(), Eq(1u));
+  EXPECT_THAT(readFile(), Eq(expected));
+}
+
+TEST_P(RecordingFileWriterTest, write_shouldFlushWhenTheBufferIsFull) {
+  std::vector<uint8_t> expected = writeSequence(RecordingFileWriter::kBufferSize * 2 + 10);
+
+  EXPECT_THAT(writer->getNumWrites(), Eq(2u));
+  EXPECT_TRUE(writer->close());
+
+  EXPECT_THAT(readFile(), Eq(expected));
+}
+
+TEST_P(RecordingFileWriterTest, seek_shouldOverwriteBufferedDataWithoutWriting) {
+  std::vector<uint8_t> expected = writeSequence(1000);
+  uint8_t patch[] = {1, 2, 3, 4};
+
+  EXPECT_THAT(writer->seek(10, SEEK_SET), Eq(10));
+  EXPECT_TRUE(writer->write(patch, sizeof(patch)));
+  EXPECT_THAT(writer->seek(0, SEEK_END), Eq(1000));
+  EXPECT_THAT(writer->getNumWrites(), Eq(0u));
+  EXPECT_TRUE(writer->close());
+
+  std::copy(patch, patch + sizeof(patch), expected.begin() + 10);
+  EXPECT_THAT(readFile(), Eq(expected));
+}
+
+TEST_P(RecordingFileWriterTest, seek_shouldOverwriteDataThatIsAlreadyInTheFile) {
+  std::vector<uint8_t> expected = writeSequence(RecordingFileWriter::kBufferSize + 100);
+  uint8_t patch[] = {1, 2, 3, 4};
+
+  EXPECT_THAT(writer->seek(10, SEEK_SET), Eq(10));
+  EXPECT_TRUE(writer->write(patch, sizeof(patch)));
+  EXPECT_THAT(writer->seek(0, SEEK_END), Eq(static_cast<int64_t>(expected.size())));
+  std::vector<uint8_t> tail = writeSequence(50);
+  EXPECT_TRUE(writer->close());
+
+  std::copy(patch, patch + sizeof(patch), expected.begin() + 10);
+  expected.insert(expected.end(), tail.begin(), tail.end());
+  EXPECT_THAT(readFile(), Eq(expected));
+}
+
+INSTANTIATE_TEST_CASE_P(DirectIo, RecordingFileWriterTest, testing::Values(false, true));
@@ -0,0 +1,145 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <media/RtpDump.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "../utils/Mocks.h"
+#include "../utils/Tools.h"
+
+using testing::Eq;
+using erizo::DataPacket;
+using erizo::ExtMap;
+using erizo::RtpDumpReader;
+using erizo::RtpDumpRecord;
+using erizo::RtpDumpWriter;
+using erizo::RtpMap;
+
+class RtpDumpTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    char path_template[] = "/tmp/rtp_dump_XXXXXX";
+    int fd = mkstemp(path_template);
+    close(fd);
+    path = path_template;
+
+    rtp_mappings.push_back(RtpMap{96, "VP8", 90000, erizo::VIDEO_TYPE, 1});
+    rtp_mappings.push_back(RtpMap{111, "opus", 48000, erizo::AUDIO_TYPE, 2});
+    rtp_mappings.back().format_parameters["minptime"] = "10";
+    rtp_mappings.back().format_parameters["useinbandfec"] = "1";
+    ExtMap orientation(4, "urn:3gpp:video-orientation");
+    orientation.mediaType = erizo::VIDEO_TYPE;
+    ext_mappings.push_back(orientation);
+  }
+  virtual void TearDown() {
+    unlink(path.c_str());
+  }
+
+  void writeDump(const std::vector<std::shared_ptr<DataPacket>> &packets) {
+    RtpDumpWriter writer(path, false);
+    ASSERT_TRUE(writer.open(rtp_mappings, ext_mappings));
+    int64_t arrival_time_us = 1000;
+    for (const auto &packet : packets) {
+      ASSERT_TRUE(writer.append(*packet, arrival_time_us));
+      arrival_time_us += 1000;
+    }
+    ASSERT_TRUE(writer.close());
+  }
+
+  std::string path;
+  std::vector<RtpMap> rtp_mappings;
+  std::vector<ExtMap> ext_mappings;
+};
+
+TEST_F(RtpDumpTest, shouldReadThePacketsThatWereWritten) {
+  auto video_packet = erizo::PacketTools::createVP8Packet(erizo::kArbitrarySeqNumber, true, true);
+  auto audio_packet = erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber, erizo::AUDIO_PACKET);
+  auto rtcp_packet = erizo::PacketTools::createReceiverReport(erizo::kVideoSsrc, erizo::kVideoSsrc,
+      erizo::kArbitrarySeqNumber, erizo::VIDEO_PACKET);
+  writeDump({video_packet, audio_packet, rtcp_packet});
+
+  RtpDumpReader reader(path);
+  ASSERT_TRUE(reader.open());
+  RtpDumpRecord record;
+  int index = 0;
+  for (const auto &packet : {video_packet, audio_packet, rtcp_packet}) {
+    ASSERT_TRUE(reader.next(&record));
+    EXPECT_THAT(record.type, Eq(packet->type));
+    EXPECT_THAT(record.arrival_time_us, Eq(1000 * (index++ + 1)));
+    ASSERT_THAT(record.length, Eq(static_cast<uint32_t>(packet->length)));
+    EXPECT_THAT(memcmp(record.data, packet->data, packet->length), Eq(0));
+  }
+  EXPECT_FALSE(reader.next(&record));
+  EXPECT_FALSE(reader.isCorrupt());
+
+  reader.rewind();
+  ASSERT_TRUE(reader.next(&record));
+  EXPECT_THAT(record.type, Eq(erizo::VIDEO_PACKET));
+}
+
+TEST_F(RtpDumpTest, shouldKeepTheSdpMetadata) {
+  writeDump({});
+
+  RtpDumpReader reader(path);
+  ASSERT_TRUE(reader.open());
+
+  ASSERT_THAT(reader.getRtpMappings().size(), Eq(2u));
+  const RtpMap &video_map = reader.getRtpMappings()[0];
+  EXPECT_THAT(video_map.payload_type, Eq(96u));
+  EXPECT_THAT(video_map.encoding_name, Eq("VP8"));
+  EXPECT_THAT(video_map.clock_rate, Eq(90000u));
+  EXPECT_THAT(video_map.media_type, Eq(erizo::VIDEO_TYPE));
+  const RtpMap &audio_map = reader.getRtpMappings()[1];
+  EXPECT_THAT(audio_map.encoding_name, Eq("opus"));
+  EXPECT_THAT(audio_map.channels, Eq(2u));
+  EXPECT_THAT(audio_map.media_type, Eq(erizo::AUDIO_TYPE));
+  EXPECT_THAT(audio_map.format_parameters, Eq(rtp_mappings[1].format_parameters));
+  ASSERT_THAT(reader.getExtMappings().size(), Eq(1u));
+  EXPECT_THAT(reader.getExtMappings()[0].value, Eq(4u));
+  EXPECT_THAT(reader.getExtMappings()[0].uri, Eq("urn:3gpp:video-orientation"));
+}
+
+TEST_F(RtpDumpTest, shouldStopAtATruncatedRecord) {
+  auto first_packet = erizo::PacketTools::createVP8Packet(erizo::kArbitrarySeqNumber, true, true);
+  auto second_packet = erizo::PacketTools::createVP8Packet(erizo::kArbitrarySeqNumber + 1, true, true);
+  writeDump({first_packet, second_packet});
+  FILE *file = fopen(path.c_str(), "r+");
+  fseek(file, 0, SEEK_END);
+  ASSERT_THAT(ftruncate(fileno(file), ftell(file) - 10), Eq(0));
+  fclose(file);
+
+  RtpDumpReader reader(path);
+  ASSERT_TRUE(reader.open());
+  RtpDumpRecord record;
+
+  EXPECT_TRUE(reader.next(&record));
+  EXPECT_FALSE(reader.next(&record));
+  EXPECT_TRUE(reader.isCorrupt());
+}
+
+TEST_F(RtpDumpTest, shouldStopAtRecordsThatCantBePackets) {
+  auto first_packet = erizo::PacketTools::createVP8Packet(erizo::kArbitrarySeqNumber, true, true);
+  auto second_packet = erizo::PacketTools::createVP8Packet(erizo::kArbitrarySeqNumber + 1, true, true);
+  for (uint32_t length : {static_cast<uint32_t>(sizeof(DataPacket::data) + 1), 4u}) {
+    writeDump({first_packet, second_packet});
+    // Overwrite the length of the last record
+    off_t last_record = -static_cast<off_t>(sizeof(erizo::RtpDumpRecordHeader) + ((second_packet->length + 7) & ~7));
+    FILE *file = fopen(path.c_str(), "r+");
+    fseek(file, last_record, SEEK_END);
+    fwrite(&length, sizeof(length), 1, file);
+    fclose(file);
+
+    RtpDumpReader reader(path);
+    ASSERT_TRUE(reader.open());
+    RtpDumpRecord record;
+
+    EXPECT_TRUE(reader.next(&record));
+    EXPECT_FALSE(reader.next(&record));
+    EXPECT_TRUE(reader.isCorrupt());
+  }
+}
@@ -0,0 +1,127 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <pipeline/StaticPipeline.h>
+#include <MediaDefinitions.h>
+
+#include <string>
+
+#include "../utils/Mocks.h"
+#include "../utils/Tools.h"
+
+using ::testing::_;
+using ::testing::Eq;
+using ::testing::Return;
+using erizo::DataPacket;
+using erizo::Handler;
+using erizo::Reader;
+using erizo::StaticPipeline;
+using erizo::VIDEO_PACKET;
+using erizo::Writer;
+
+class ForwardingHandler : public Handler {
+ public:
+  void enable() override {
+    enabled = true;
+  }
+
+  void disable() override {
+    enabled = false;
+  }
+
+  std::string getName() override {
+    return "forwarding";
+  }
+
+  void read(Context *ctx, std::shared_ptr<DataPacket> packet) override {
+    reads++;
+    if (enabled) {
+      ctx->fireRead(std::move(packet));
+    }
+  }
+
+  void write(Context *ctx, std::shared_ptr<DataPacket> packet) override {
+    writes++;
+    if (enabled) {
+      ctx->fireWrite(std::move(packet));
+    }
+  }
+
+  void notifyUpdate() override {
+    updates++;
+  }
+
+  bool enabled = true;
+  int reads = 0;
+  int writes = 0;
+  int updates = 0;
+};
+
+class StaticPipelineTest : public ::testing::Test {
+ protected:
+  typedef StaticPipeline<Writer, ForwardingHandler, Reader> TestPipeline;
+
+  void SetUp() override {
+    reader = std::make_shared<Reader>();
+    writer = std::make_shared<Writer>();
+    handler = std::make_shared<ForwardingHandler>();
+    EXPECT_CALL(*reader, notifyUpdate()).Times(testing::AtLeast(1));
+    EXPECT_CALL(*writer, notifyUpdate()).Times(testing::AtLeast(1));
+    EXPECT_CALL(*reader, getName()).WillRepeatedly(Return("reader"));
+    EXPECT_CALL(*writer, getName()).WillRepeatedly(Return("writer"));
+
+    pipeline = TestPipeline::create(writer, handler, reader);
+    pipeline->finalize();
+    packet = erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber, VIDEO_PACKET);
+  }
+
+  std::shared_ptr<Reader> reader;
+  std::shared_ptr<Writer> writer;
+  std::shared_ptr<ForwardingHandler> handler;
+  TestPipeline::Ptr pipeline;
+  std::shared_ptr<DataPacket> packet;
+};
+
+TEST_F(StaticPipelineTest, read_ShouldGoThroughHandlers_FromFrontToBack) {
+  EXPECT_CALL(*reader, read(_, Eq(packet))).Times(1);
+  EXPECT_CALL(*writer, write(_, _)).Times(0);
+
+  pipeline->read(packet);
+
+  EXPECT_THAT(handler->reads, Eq(1));
+}
+
+TEST_F(StaticPipelineTest, write_ShouldGoThroughHandlers_FromBackToFront) {
+  EXPECT_CALL(*writer, write(_, Eq(packet))).Times(1);
+  EXPECT_CALL(*reader, read(_, _)).Times(0);
+
+  pipeline->write(packet);
+
+  EXPECT_THAT(handler->writes, Eq(1));
+}
+
+TEST_F(StaticPipelineTest, handlers_ShouldBeManaged_LikeInADynamicPipeline) {
+  EXPECT_CALL(*reader, read(_, _)).Times(0);
+
+  EXPECT_THAT(pipeline->getHandler<ForwardingHandler>(), Eq(handler.get()));
+  EXPECT_THAT(handler->updates, Eq(1));
+
+  pipeline->notifyUpdate();
+  pipeline->disable("forwarding");
+  pipeline->read(packet);
+
+  EXPECT_THAT(handler->updates, Eq(2));
+  EXPECT_THAT(handler->reads, Eq(1));
+}
+
+TEST_F(StaticPipelineTest, packetsFiredByAHandler_ShouldReachTheNextHandler) {
+  EXPECT_CALL(*reader, read(_, Eq(packet))).Times(1);
+  EXPECT_CALL(*writer, write(_, Eq(packet))).Times(1);
+
+  // Like handlers do from scheduled tasks
+  handler->getContext()->fireRead(packet);
+  handler->getContext()->fireWrite(packet);
+
+  EXPECT_THAT(handler->reads, Eq(0));
+  EXPECT_THAT(handler->writes, Eq(0));
+}
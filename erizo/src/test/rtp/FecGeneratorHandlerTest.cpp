@@ -0,0 +1,169 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <rtp/FecGeneratorHandler.h>
+#include <rtp/RtpHeaders.h>
+#include <MediaDefinitions.h>
+#include <WebRtcConnection.h>
+#include <stats/StatNode.h>
+
+#include <webrtc/modules/rtp_rtcp/include/ulpfec_receiver.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../utils/Mocks.h"
+#include "../utils/Tools.h"
+#include "../utils/Matchers.h"
+
+using ::testing::_;
+using ::testing::Args;
+using ::testing::Contains;
+using ::testing::Eq;
+using ::testing::Gt;
+using ::testing::Invoke;
+using ::testing::Return;
+using erizo::DataPacket;
+using erizo::VIDEO_PACKET;
+using erizo::RtpMap;
+using erizo::RtpHeader;
+using erizo::FecGeneratorHandler;
+
+class FecGeneratorHandlerTest : public erizo::HandlerTest, public webrtc::RecoveredPacketReceiver {
+ public:
+  FecGeneratorHandlerTest() {}
+
+  void OnRecoveredPacket(const uint8_t* packet, size_t length) override {
+    const RtpHeader *head = reinterpret_cast<const RtpHeader*>(packet);
+    received_seq_nums.insert(head->getSeqNumber());
+  }
+
+ protected:
+  void setHandler() {
+    clock = std::make_shared<erizo::SimulatedClock>();
+    fec_handler = std::make_shared<FecGeneratorHandler>(clock);
+    pipeline->addBack(fec_handler);
+    EXPECT_CALL(*media_stream.get(), isSlideShowModeEnabled()).WillRepeatedly(Return(false));
+  }
+
+  void negotiateRedAndUlpfec() {
+    std::shared_ptr<erizo::SdpInfo> remote_sdp = media_stream->getRemoteSdpInfo();
+    for (unsigned int payload_type : {RED_90000_PT, ULP_90000_PT}) {
+      remote_sdp->inOutPTMap[payload_type] = payload_type;
+      remote_sdp->outInPTMap[payload_type] = payload_type;
+      remote_sdp->payloadVector.push_back(RtpMap{payload_type, payload_type == RED_90000_PT ? "red" : "ulpfec",
+          90000, erizo::VIDEO_TYPE});
+    }
+    pipeline->notifyUpdate();
+  }
+
+  void receiveFractionLost(uint8_t fraction_lost) {
+    pipeline->read(erizo::PacketTools::createReceiverReport(erizo::kVideoSsrc, erizo::kVideoSsrc,
+        erizo::kArbitrarySeqNumber, VIDEO_PACKET, 0, fraction_lost));
+  }
+
+  void captureSentPackets() {
+    EXPECT_CALL(*writer.get(), write(_, _)).WillRepeatedly(Invoke(
+      [this](erizo::OutboundHandler::Context *ctx, std::shared_ptr<DataPacket> packet) {
+        sent_packets.push_back(packet);
+    }));
+  }
+
+  uint8_t getPayloadType(std::shared_ptr<DataPacket> packet) {
+    return reinterpret_cast<RtpHeader*>(packet->data)->getPayloadType();
+  }
+
+  // Sends every packet that reaches the transport to the subscriber but the dropped one
+  void sendThroughLossyTransport(uint16_t dropped_seq_num) {
+    EXPECT_CALL(*writer.get(), write(_, _)).WillRepeatedly(Invoke(
+      [this, dropped_seq_num](erizo::OutboundHandler::Context *ctx, std::shared_ptr<DataPacket> packet) {
+        sent_packets.push_back(packet);
+        RtpHeader *head = reinterpret_cast<RtpHeader*>(packet->data);
+        if (head->getSeqNumber() == dropped_seq_num) {
+          return;
+        }
+        webrtc::RtpPacketReceived received_packet;
+        received_packet.Parse(reinterpret_cast<const uint8_t*>(packet->data), packet->length);
+        if (fec_receiver->AddReceivedRedPacket(received_packet, ULP_90000_PT)) {
+          fec_receiver->ProcessReceivedFec();
+        }
+    }));
+  }
+
+  void afterPipelineSetup() {
+    fec_receiver = webrtc::UlpfecReceiver::Create(erizo::kVideoSsrc, this,
+        rtc::ArrayView<const webrtc::RtpExtension>());
+  }
+
+  std::shared_ptr<FecGeneratorHandler> fec_handler;
+  std::shared_ptr<erizo::SimulatedClock> clock;
+  std::unique_ptr<webrtc::UlpfecReceiver> fec_receiver;
+  std::vector<std::shared_ptr<DataPacket>> sent_packets;
+  std::set<uint16_t> received_seq_nums;
+};
+
+TEST_F(FecGeneratorHandlerTest, basicBehaviourShouldWritePackets) {
+  auto packet = erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber, VIDEO_PACKET);
+
+  EXPECT_CALL(*writer.get(), write(_, _)).
+    With(Args<1>(erizo::RtpHasSequenceNumber(erizo::kArbitrarySeqNumber))).Times(1);
+  pipeline->write(packet);
+}
+
+TEST_F(FecGeneratorHandlerTest, shouldNotProtect_whenUlpfecIsNotNegotiated) {
+  connection->setRtt(200);
+  receiveFractionLost(100);
+
+  captureSentPackets();
+  pipeline->write(erizo::PacketTools::createVP8Packet(erizo::kArbitrarySeqNumber, true, true));
+
+  ASSERT_THAT(sent_packets.size(), Eq(1u));
+  EXPECT_THAT(getPayloadType(sent_packets[0]), Eq(96));
+  EXPECT_THAT(fec_handler->getProtectionFactor(), Eq(0));
+}
+
+TEST_F(FecGeneratorHandlerTest, shouldNotProtect_whenNacksAreFastEnough) {
+  negotiateRedAndUlpfec();
+  connection->setRtt(FecGeneratorHandler::kMinRttMs - 1);
+  receiveFractionLost(100);
+
+  captureSentPackets();
+  pipeline->write(erizo::PacketTools::createVP8Packet(erizo::kArbitrarySeqNumber, true, true));
+
+  ASSERT_THAT(sent_packets.size(), Eq(1u));
+  EXPECT_THAT(getPayloadType(sent_packets[0]), Eq(RED_90000_PT));
+  EXPECT_THAT(fec_handler->getProtectionFactor(), Eq(0));
+}
+
+TEST_F(FecGeneratorHandlerTest, shouldStopProtecting_whenLossGoesAway) {
+  negotiateRedAndUlpfec();
+  connection->setRtt(200);
+  receiveFractionLost(100);
+  EXPECT_THAT(fec_handler->getProtectionFactor(), Gt(0));
+
+  for (int i = 0; i < 10; i++) {
+    receiveFractionLost(0);
+  }
+  EXPECT_THAT(fec_handler->getProtectionFactor(), Eq(0));
+}
+
+TEST_F(FecGeneratorHandlerTest, shouldRecoverLostPackets_whenLossIsHigh) {
+  const uint16_t kFirstSeqNum = erizo::kArbitrarySeqNumber;
+  const uint16_t kFramePackets = 4;
+  negotiateRedAndUlpfec();
+  connection->setRtt(200);
+  receiveFractionLost(100);
+  receiveFractionLost(100);
+  sendThroughLossyTransport(kFirstSeqNum + 1);
+
+  for (uint16_t i = 0; i < kFramePackets; i++) {
+    pipeline->write(erizo::PacketTools::createVP8Packet(kFirstSeqNum + i, i == 0, i == kFramePackets - 1));
+  }
+
+  ASSERT_THAT(sent_packets.size(), Gt(kFramePackets));
+  EXPECT_THAT(getPayloadType(sent_packets[0]), Eq(RED_90000_PT));
+  for (uint16_t i = 0; i < kFramePackets; i++) {
+    EXPECT_THAT(received_seq_nums, Contains(kFirstSeqNum + i));
+  }
+}
@@ -0,0 +1,93 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <rtp/LayerAvailabilityService.h>
+#include <rtp/QualityManager.h>
+#include <MediaDefinitions.h>
+
+#include <memory>
+#include <vector>
+
+#include "../utils/Mocks.h"
+#include "../utils/Tools.h"
+
+using ::testing::Eq;
+using ::testing::Gt;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using erizo::DataPacket;
+using erizo::LayerAvailability;
+using erizo::LayerAvailabilityService;
+using erizo::QualityManager;
+using erizo::SimulatedClock;
+
+class LayerAvailabilityServiceTest : public ::testing::Test {
+ public:
+  LayerAvailabilityServiceTest() : clock{std::make_shared<SimulatedClock>()}, service{clock} {}
+
+ protected:
+  void sendLayerPacket(int spatial_layer, int temporal_layer) {
+    auto packet = erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber, erizo::VIDEO_PACKET);
+    packet->compatible_spatial_layers = {spatial_layer};
+    packet->compatible_temporal_layers = {temporal_layer};
+    service.onVideoPacket(*packet);
+  }
+
+  void sendAllLayers(int spatial_layers, int temporal_layers) {
+    for (int spatial_layer = 0; spatial_layer < spatial_layers; spatial_layer++) {
+      for (int temporal_layer = 0; temporal_layer < temporal_layers; temporal_layer++) {
+        sendLayerPacket(spatial_layer, temporal_layer);
+      }
+    }
+  }
+
+  void advanceUpdateInterval() {
+    clock->advanceTime(QualityManager::kActiveLayerInterval + std::chrono::milliseconds(1));
+  }
+
+  std::shared_ptr<SimulatedClock> clock;
+  LayerAvailabilityService service;
+};
+
+TEST_F(LayerAvailabilityServiceTest, shouldNotUpdate_whenNoLayersHaveBeenReceived) {
+  advanceUpdateInterval();
+
+  EXPECT_THAT(service.maybeUpdate(), IsNull());
+}
+
+TEST_F(LayerAvailabilityServiceTest, shouldNotUpdate_beforeTheUpdateInterval) {
+  sendAllLayers(2, 3);
+  clock->advanceTime(QualityManager::kActiveLayerInterval - std::chrono::milliseconds(1));
+
+  EXPECT_THAT(service.maybeUpdate(), IsNull());
+}
+
+TEST_F(LayerAvailabilityServiceTest, shouldReportBitratesAndActiveLayers_whenLayersAreReceived) {
+  sendAllLayers(2, 3);
+  advanceUpdateInterval();
+  sendAllLayers(2, 3);
+
+  std::shared_ptr<const LayerAvailability> availability = service.maybeUpdate();
+
+  ASSERT_THAT(availability, NotNull());
+  EXPECT_THAT(availability->max_active_spatial_layer, Eq(1));
+  EXPECT_THAT(availability->max_active_temporal_layer, Eq(2));
+  EXPECT_THAT(LayerAvailability::getLayerBitrate(availability->bitrates, 1, 2), Gt(0u));
+  EXPECT_THAT(LayerAvailability::getLayerBitrate(availability->max_bitrates, 1, 2), Gt(0u));
+  EXPECT_THAT(LayerAvailability::getLayerBitrate(availability->bitrates, 2, 0), Eq(0u));
+  EXPECT_THAT(service.maybeUpdate(), IsNull());
+}
+
+TEST_F(LayerAvailabilityServiceTest, shouldLowerActiveLayers_whenLayersStop) {
+  sendAllLayers(2, 3);
+  advanceUpdateInterval();
+  service.maybeUpdate();
+
+  clock->advanceTime(std::chrono::seconds(4));
+  sendAllLayers(1, 2);
+  std::shared_ptr<const LayerAvailability> availability = service.maybeUpdate();
+
+  ASSERT_THAT(availability, NotNull());
+  EXPECT_THAT(availability->max_active_spatial_layer, Eq(0));
+  EXPECT_THAT(availability->max_active_temporal_layer, Eq(1));
+}
@@ -1,7 +1,6 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
-#include <thread/Scheduler.h>
 #include <rtp/LayerDetectorHandler.h>
 #include <rtp/PacketCodecParser.h>
 #include <rtp/RtpHeaders.h>
@@ -59,7 +58,7 @@ class LayerDetectorHandlerVp8Test : public erizo::BaseHandlerTest,
     RtpHeader *rtp_header = reinterpret_cast<RtpHeader*>(packet->data);
     rtp_header->setSSRC(kArbitrarySsrc1);
 
-    packet->rid = std::to_string(rid);
+    packet->rid = rid;
 
     unsigned char* data = reinterpret_cast<unsigned char*>(packet->data + rtp_header->getHeaderLength());
     *data |= 0x80;  // set extension bit
@@ -165,3 +164,26 @@ INSTANTIATE_TEST_CASE_P(
     std::make_tuple(2,   1,                1,      true,                0,    false),
     std::make_tuple(2,   1,                1,      true,                1,     true),
     std::make_tuple(2,   1,                1,      true,                2,     true)));
+
+class LayerDetectorHandlerH264Test : public erizo::HandlerTest {
+ protected:
+  void setHandler() override {
+    std::vector<RtpMap>& payloads = media_stream->getRemoteSdpInfo()->getPayloadInfos();
+    payloads.push_back({97, "H264"});
+    pipeline->addBack(std::make_shared<PacketCodecParser>());
+    pipeline->addBack(std::make_shared<LayerDetectorHandler>());
+  }
+};
+
+TEST_F(LayerDetectorHandlerH264Test, shouldDetectKeyframesInAggregatedPackets) {
+  const uint8_t kNalLength = 10;
+  const uint8_t kIdrNalType = 5;
+  auto packet = erizo::PacketTools::createH264AggregatedPacket(erizo::kArbitrarySeqNumber, 0, kNalLength, kNalLength);
+  RtpHeader *rtp_header = reinterpret_cast<RtpHeader*>(packet->data);
+  // The first NAL header goes after the STAP-A header and the NAL size
+  packet->data[rtp_header->getHeaderLength() + 3] = kIdrNalType;
+
+  EXPECT_CALL(*reader.get(), read(_, _)).
+    With(AllOf(Args<1>(erizo::PacketIsKeyframe()), Args<1>(erizo::PacketBelongsToTemporalLayer(0)))).Times(1);
+  pipeline->read(packet);
+}
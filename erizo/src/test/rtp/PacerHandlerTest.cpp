@@ -0,0 +1,105 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <rtp/PacerHandler.h>
+#include <rtp/RtpHeaders.h>
+#include <MediaDefinitions.h>
+#include <WebRtcConnection.h>
+
+#include <string>
+#include <vector>
+
+#include "../utils/Mocks.h"
+#include "../utils/Tools.h"
+#include "../utils/Matchers.h"
+
+using ::testing::_;
+using ::testing::Args;
+using ::testing::Eq;
+using ::testing::InSequence;
+using erizo::DataPacket;
+using erizo::AUDIO_PACKET;
+using erizo::VIDEO_PACKET;
+using erizo::PacerHandler;
+
+static constexpr int kPacketLength = 1000;
+// Paced at 2.5 x 400kbps, 625 bytes every 5ms
+static constexpr uint32_t kTargetBitrate = 400000;
+
+class PacerHandlerTest : public erizo::HandlerTest {
+ public:
+  PacerHandlerTest() {}
+
+ protected:
+  void setHandler() {
+    pacer = std::make_shared<PacerHandler>(simulated_clock);
+    pipeline->addBack(pacer);
+  }
+
+  void afterPipelineSetup() {
+    connection->setSenderBitrateTarget(kTargetBitrate);
+    simulated_clock->advanceTime(PacerHandler::kPacingInterval);
+  }
+
+  std::shared_ptr<DataPacket> createPacket(uint16_t seq_number, erizo::packetType type) {
+    auto packet = erizo::PacketTools::createDataPacket(seq_number, type);
+    packet->length = kPacketLength;
+    return packet;
+  }
+
+  std::shared_ptr<PacerHandler> pacer;
+};
+
+TEST_F(PacerHandlerTest, basicBehaviourShouldWritePackets) {
+  EXPECT_CALL(*writer.get(), write(_, _)).Times(1);
+
+  pipeline->write(createPacket(erizo::kArbitrarySeqNumber, VIDEO_PACKET));
+}
+
+TEST_F(PacerHandlerTest, shouldQueueBursts_andReleaseThemOverTime) {
+  EXPECT_CALL(*writer.get(), write(_, _)).Times(1);
+  for (uint16_t seq_number = 0; seq_number < 10; seq_number++) {
+    pipeline->write(createPacket(seq_number, VIDEO_PACKET));
+  }
+  EXPECT_THAT(pacer->getQueuedPackets(), Eq(9u));
+
+  EXPECT_CALL(*writer.get(), write(_, _)).Times(9);
+  executeTasksInNextMs(100);
+  EXPECT_THAT(pacer->getQueuedPackets(), Eq(0u));
+}
+
+TEST_F(PacerHandlerTest, shouldNotDelayRtcp_whenMediaIsQueued) {
+  pipeline->write(createPacket(0, VIDEO_PACKET));
+  pipeline->write(createPacket(1, VIDEO_PACKET));
+
+  EXPECT_CALL(*writer.get(), write(_, _)).Times(1);
+  pipeline->write(erizo::PacketTools::createNack(erizo::kVideoSsrc, erizo::kVideoSsrc, 0, VIDEO_PACKET));
+  EXPECT_THAT(pacer->getQueuedPackets(), Eq(1u));
+}
+
+TEST_F(PacerHandlerTest, shouldReleaseAudioAndRetransmissionsBeforeVideo) {
+  pipeline->write(createPacket(0, VIDEO_PACKET));
+  pipeline->write(createPacket(1, VIDEO_PACKET));
+  auto retransmission = createPacket(2, VIDEO_PACKET);
+  retransmission->is_retransmission = true;
+  pipeline->write(retransmission);
+  pipeline->write(createPacket(3, AUDIO_PACKET));
+
+  {
+    InSequence s;
+    EXPECT_CALL(*writer.get(), write(_, _)).With(Args<1>(erizo::RtpHasSequenceNumber(3))).Times(1);
+    EXPECT_CALL(*writer.get(), write(_, _)).With(Args<1>(erizo::RtpHasSequenceNumber(2))).Times(1);
+    EXPECT_CALL(*writer.get(), write(_, _)).With(Args<1>(erizo::RtpHasSequenceNumber(1))).Times(1);
+  }
+  executeTasksInNextMs(100);
+}
+
+TEST_F(PacerHandlerTest, shouldSendEverythingQueued_whenDisabled) {
+  for (uint16_t seq_number = 0; seq_number < 5; seq_number++) {
+    pipeline->write(createPacket(seq_number, VIDEO_PACKET));
+  }
+
+  EXPECT_CALL(*writer.get(), write(_, _)).Times(4);
+  pacer->disable();
+  EXPECT_THAT(pacer->getQueuedPackets(), Eq(0u));
+}
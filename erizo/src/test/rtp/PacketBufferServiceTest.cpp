@@ -0,0 +1,92 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <rtp/PacketBufferService.h>
+#include <rtp/RtpHeaders.h>
+#include <lib/Clock.h>
+#include <MediaDefinitions.h>
+
+#include <memory>
+
+using ::testing::Eq;
+using ::testing::IsNull;
+using erizo::DataPacket;
+using erizo::PacketBufferService;
+using erizo::RtpHeader;
+using erizo::VIDEO_PACKET;
+
+static constexpr uint32_t kSsrc = 1;
+static constexpr uint32_t kOtherSsrc = 2;
+
+class PacketBufferServiceTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    clock = std::make_shared<erizo::SimulatedClock>();
+    buffer = std::make_shared<PacketBufferService>(clock, 16, 64, std::chrono::milliseconds(100));
+  }
+
+  std::shared_ptr<DataPacket> insert(uint32_t ssrc, uint16_t seq_num) {
+    RtpHeader header;
+    header.setSSRC(ssrc);
+    header.setSeqNumber(seq_num);
+    auto packet = std::make_shared<DataPacket>(0, reinterpret_cast<char*>(&header), sizeof(RtpHeader), VIDEO_PACKET);
+    buffer->insertPacket(packet);
+    return packet;
+  }
+
+  std::shared_ptr<erizo::SimulatedClock> clock;
+  std::shared_ptr<PacketBufferService> buffer;
+};
+
+TEST_F(PacketBufferServiceTest, getPacket_shouldReturnStoredPackets_perSsrc) {
+  auto packet = insert(kSsrc, 100);
+  auto other_packet = insert(kOtherSsrc, 100);
+
+  EXPECT_THAT(buffer->getPacket(kSsrc, 100), Eq(packet));
+  EXPECT_THAT(buffer->getPacket(kOtherSsrc, 100), Eq(other_packet));
+  EXPECT_THAT(buffer->getPacket(kSsrc, 101), IsNull());
+  EXPECT_THAT(buffer->getHits(), Eq(2u));
+  EXPECT_THAT(buffer->getMisses(), Eq(1u));
+}
+
+TEST_F(PacketBufferServiceTest, getPacket_shouldKeepPacketsAcrossSeqNumRollover) {
+  auto last = insert(kSsrc, 65535);
+  auto first = insert(kSsrc, 0);
+
+  EXPECT_THAT(buffer->getPacket(kSsrc, 65535), Eq(last));
+  EXPECT_THAT(buffer->getPacket(kSsrc, 0), Eq(first));
+}
+
+TEST_F(PacketBufferServiceTest, insertPacket_shouldGrowTheBuffer_whenPacketsAreYoungerThanTheHistory) {
+  auto first = insert(kSsrc, 0);
+  for (uint16_t seq_num = 1; seq_num < 40; seq_num++) {
+    insert(kSsrc, seq_num);
+  }
+
+  EXPECT_THAT(buffer->getPacket(kSsrc, 0), Eq(first));
+}
+
+TEST_F(PacketBufferServiceTest, getPacket_shouldReportTooOld_whenPacketsAreOverwritten) {
+  insert(kSsrc, 0);
+  clock->advanceTime(std::chrono::milliseconds(200));
+  for (uint16_t seq_num = 1; seq_num <= 16; seq_num++) {
+    insert(kSsrc, seq_num);
+  }
+
+  EXPECT_THAT(buffer->getPacket(kSsrc, 0), IsNull());
+  EXPECT_THAT(buffer->getTooOld(), Eq(1u));
+}
+
+TEST_F(PacketBufferServiceTest, getPacket_shouldNotReturnPacketsFromPreviousCycles) {
+  insert(kSsrc, 10);
+  for (uint32_t seq_num = 11; seq_num < 10 + 65536; seq_num++) {
+    clock->advanceTime(std::chrono::milliseconds(200));
+    if (seq_num % 16 != 10) {
+      insert(kSsrc, static_cast<uint16_t>(seq_num));
+    }
+  }
+
+  EXPECT_THAT(buffer->getPacket(kSsrc, 65530), IsNull());
+  EXPECT_THAT(buffer->getPacket(kSsrc, 10), IsNull());
+  EXPECT_THAT(buffer->getMisses(), Eq(2u));
+}
@@ -30,6 +30,8 @@ using erizo::CumulativeStat;
 using erizo::Pipeline;
 using erizo::duration;
 using erizo::LayerInfoChangedEvent;
+using erizo::LayerAvailability;
+using erizo::LayerAvailabilityChangedEvent;
 
 const int kBaseSpatialLayer = 0;
 const int kBaseTemporalLayer = 0;
@@ -114,6 +116,16 @@ class QualityManagerBaseTest : public erizo::BaseHandlerTest{
     quality_manager->notifyEvent(event);
   }
 
+  void notifySharedLayerAvailability(const std::vector<std::vector<uint64_t>> &bitrates) {
+    auto availability = std::make_shared<LayerAvailability>();
+    availability->max_active_spatial_layer = bitrates.size() - 1;
+    availability->max_active_temporal_layer = bitrates.back().size() - 1;
+    availability->bitrates = bitrates;
+    availability->instant_bitrates = bitrates;
+    availability->max_bitrates = bitrates;
+    quality_manager->notifyEvent(std::make_shared<LayerAvailabilityChangedEvent>(availability));
+  }
+
   void setVideoConstraints(int max_width, int max_height, int max_frame_rate) {
     quality_manager->setVideoConstraints(max_width, max_height, max_frame_rate);
   }
@@ -290,6 +302,37 @@ TEST_F(QualityManagerTest, shouldGoBelowMinDesiredSpatialLayerIfNotAvailable) {
   EXPECT_FALSE(quality_manager->getSpatialLayer() == kArbitraryDesiredMinSpatialLayer);
 }
 
+TEST_F(QualityManagerTest, shouldSelectLayersWithSharedAvailability_whenPublisherSharesIt) {
+  const uint64_t kSharedSpatialLayerBitrate = 1000;
+  quality_manager->notifyQualityUpdate();
+  notifySharedLayerAvailability({{kBaseBitrate, kBaseBitrate + 10, kBaseBitrate + 20},
+      {kSharedSpatialLayerBitrate, kSharedSpatialLayerBitrate + 10, kSharedSpatialLayerBitrate + 20}});
+  advanceClock(erizo::QualityManager::kMinLayerSwitchInterval + std::chrono::milliseconds(1));
+
+  setSenderBitrateEstimation(kSharedSpatialLayerBitrate / 2);
+  quality_manager->notifyQualityUpdate();
+
+  EXPECT_TRUE(quality_manager->hasSharedLayerAvailability());
+  EXPECT_EQ(quality_manager->getSpatialLayer(), 0);
+  EXPECT_EQ(quality_manager->getTemporalLayer(), 2);
+  EXPECT_EQ(getStatForLayer(1, 0), kSharedSpatialLayerBitrate);
+}
+
+TEST_F(QualityManagerTest, shouldSwitchLayerImmediately_whenSharedAvailabilityLosesTheLayer) {
+  quality_manager->notifyQualityUpdate();
+  notifySharedLayerAvailability({{kBaseBitrate, kBaseBitrate}, {kBaseBitrate * 2, kBaseBitrate * 2}});
+  setSenderBitrateEstimation(kBaseBitrate * 10);
+  quality_manager->notifyQualityUpdate();
+  quality_manager->setSpatialLayer(1);
+  quality_manager->setTemporalLayer(1);
+
+  notifySharedLayerAvailability({{kBaseBitrate, kBaseBitrate}});
+  quality_manager->notifyQualityUpdate();
+
+  EXPECT_EQ(quality_manager->getSpatialLayer(), 0);
+  EXPECT_EQ(quality_manager->getTemporalLayer(), 1);
+}
+
 class QualityManagerConstraintsTest : public QualityManagerBaseTest,
                            public ::testing::TestWithParam<std::tr1::tuple<int, int, int, int, int>> {
  public:
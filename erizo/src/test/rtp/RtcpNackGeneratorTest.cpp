@@ -205,3 +205,82 @@ TEST_F(RtcpNackGeneratorTest, shouldNotRetransmitNacksMoreThanTwice) {
   receiver_report = generateRrWithNack();
   EXPECT_FALSE(RtcpPacketContainsNackSeqNum(receiver_report, erizo::kArbitrarySeqNumber + 1));
 }
+
+TEST_F(RtcpNackGeneratorTest, shouldNotNackRecoveredPackets) {
+  auto first_packet = erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber, VIDEO_PACKET);
+  auto second_packet = erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber + 3, VIDEO_PACKET);
+  auto recovered_packet = erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber + 1, VIDEO_PACKET);
+  nack_generator.handleRtpPacket(first_packet);
+  nack_generator.handleRtpPacket(second_packet);
+  nack_generator.handleRtpPacket(recovered_packet);
+
+  receiver_report = generateRrWithNack();
+
+  EXPECT_EQ(nack_generator.getPendingNacks(), 1u);
+  EXPECT_FALSE(RtcpPacketContainsNackSeqNum(receiver_report, erizo::kArbitrarySeqNumber + 1));
+  EXPECT_TRUE(RtcpPacketContainsNackSeqNum(receiver_report, erizo::kArbitrarySeqNumber + 2));
+}
+
+TEST_F(RtcpNackGeneratorTest, shouldMeasureTheRtt_fromNackedPacketsThatAreRecovered) {
+  advanceClockMs(1000);
+  nack_generator.handleRtpPacket(erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber, VIDEO_PACKET));
+  nack_generator.handleRtpPacket(erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber + 3, VIDEO_PACKET));
+  EXPECT_EQ(nack_generator.getMeasuredRtt(), 0u);
+
+  receiver_report = generateRrWithNack();
+  advanceClockMs(80);
+  nack_generator.handleRtpPacket(erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber + 1, VIDEO_PACKET));
+  EXPECT_EQ(nack_generator.getMeasuredRtt(), 80u);
+
+  advanceClockMs(80);
+  nack_generator.handleRtpPacket(erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber + 2, VIDEO_PACKET));
+  EXPECT_EQ(nack_generator.getMeasuredRtt(), 90u);
+}
+
+TEST_F(RtcpNackGeneratorTest, shouldWaitForTheRttBeforeRetransmittingNacks) {
+  auto first_packet = erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber, VIDEO_PACKET);
+  auto second_packet = erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber + 2, VIDEO_PACKET);
+  nack_generator.setRtt(200);
+  nack_generator.handleRtpPacket(first_packet);
+  nack_generator.handleRtpPacket(second_packet);
+
+  receiver_report = generateRrWithNack();
+  EXPECT_TRUE(RtcpPacketContainsNackSeqNum(receiver_report, erizo::kArbitrarySeqNumber + 1));
+
+  advanceClockMs(100);
+  receiver_report = generateRrWithNack();
+  EXPECT_FALSE(RtcpPacketContainsNackSeqNum(receiver_report, erizo::kArbitrarySeqNumber + 1));
+
+  advanceClockMs(150);
+  receiver_report = generateRrWithNack();
+  EXPECT_TRUE(RtcpPacketContainsNackSeqNum(receiver_report, erizo::kArbitrarySeqNumber + 1));
+}
+
+TEST_F(RtcpNackGeneratorTest, shouldKeepTheNewestNacksWhenThereAreTooMany) {
+  uint16_t seq_num = kMaxSeqnum - 100;
+  nack_generator.handleRtpPacket(erizo::PacketTools::createDataPacket(seq_num, VIDEO_PACKET));
+  for (int i = 0; i < 200; i++) {
+    seq_num += 2;
+    nack_generator.handleRtpPacket(erizo::PacketTools::createDataPacket(seq_num, VIDEO_PACKET));
+  }
+
+  receiver_report = generateRrWithNack();
+
+  EXPECT_EQ(nack_generator.getPendingNacks(), 150u);
+  EXPECT_TRUE(RtcpPacketContainsNackSeqNum(receiver_report, static_cast<uint16_t>(seq_num - 1)));
+  EXPECT_FALSE(RtcpPacketContainsNackSeqNum(receiver_report, static_cast<uint16_t>(kMaxSeqnum - 99)));
+}
+
+TEST_F(RtcpNackGeneratorTest, shouldOnlyNackTheLastPacketsAfterAHugeGap) {
+  nack_generator.handleRtpPacket(erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber, VIDEO_PACKET));
+  nack_generator.handleRtpPacket(erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber + 2,
+      VIDEO_PACKET));
+  nack_generator.handleRtpPacket(erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber + 5000,
+      VIDEO_PACKET));
+
+  receiver_report = generateRrWithNack();
+
+  EXPECT_EQ(nack_generator.getPendingNacks(), 150u);
+  EXPECT_FALSE(RtcpPacketContainsNackSeqNum(receiver_report, erizo::kArbitrarySeqNumber + 1));
+  EXPECT_TRUE(RtcpPacketContainsNackSeqNum(receiver_report, erizo::kArbitrarySeqNumber + 4999));
+}
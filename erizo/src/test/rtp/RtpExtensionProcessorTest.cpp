@@ -24,6 +24,34 @@ class RtpExtensionProcessorTest : public ::testing::Test {
   virtual void TearDown() {
   }
 
+  std::vector<erizo::SdpMediaInfo> getMedias(const std::vector<std::string> &mids) {
+    std::vector<erizo::SdpMediaInfo> medias;
+    for (const std::string &mid : mids) {
+      medias.push_back(erizo::SdpMediaInfo(mid, "", "", erizo::SENDRECV, "video", "", false, false));
+    }
+    return medias;
+  }
+
+  // A VP8 packet with a single MID extension of any length
+  std::shared_ptr<erizo::DataPacket> createVP8PacketWithMid(const std::string &mid) {
+    erizo::RtpHeader header;
+    header.setPayloadType(96);
+    header.setSeqNumber(erizo::kArbitrarySeqNumber);
+    header.setSSRC(erizo::kVideoSsrc);
+    header.setExtension(1);
+    header.setExtId(0xBEDE);
+    header.setExtLength(2);
+
+    char packet_buffer[200];
+    memset(packet_buffer, 0, sizeof(packet_buffer));
+    memcpy(packet_buffer, reinterpret_cast<char*>(&header), sizeof(header));
+    char *extensions = reinterpret_cast<char*>(&reinterpret_cast<erizo::RtpHeader*>(packet_buffer)->extensions);
+    extensions[0] = (erizo::MID << 4) | (mid.size() - 1);
+    memcpy(extensions + 1, mid.c_str(), mid.size());
+    packet_buffer[header.getHeaderLength()] = 0x10;
+    return std::make_shared<erizo::DataPacket>(0, packet_buffer, sizeof(packet_buffer), erizo::VIDEO_PACKET);
+  }
+
   std::vector<erizo::ExtMap> ext_mappings;
 };
 
@@ -212,3 +240,84 @@ TEST_F(RtpExtensionProcessorTest, shouldResetMidAndRidExtensionDataFromPacket) {
 
   EXPECT_THAT(data_pointer[0], Eq(0x10));
 }
+
+TEST_F(RtpExtensionProcessorTest, shouldSetMidAndNumericRidAsLayerInPacket) {
+  ext_mappings.push_back({erizo::MID, "urn:ietf:params:rtp-hdrext:sdes:mid"});
+  ext_mappings.push_back({erizo::RTP_ID, "urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id"});
+  erizo::RtpExtensionProcessor processor(ext_mappings);
+  processor.setExtension(erizo::VIDEO_TYPE, erizo::MID, erizo::MID);
+  processor.setExtension(erizo::VIDEO_TYPE, erizo::RTP_ID, erizo::RTP_ID);
+  processor.setNegotiatedMids(getMedias({"0", "1"}));
+
+  const auto pkt = erizo::PacketTools::createVP8PacketWithExtensions(erizo::MID, '1', erizo::RTP_ID, '2');
+
+  processor.processRtpExtensions(pkt);
+
+  EXPECT_THAT(pkt->mid, Eq(erizo::StringInterner::intern("1")));
+  EXPECT_THAT(pkt->getMidName(), Eq("1"));
+  EXPECT_THAT(pkt->rid, Eq(2));
+}
+
+TEST_F(RtpExtensionProcessorTest, shouldResolveNonNumericRidUsingTheSdpOrder) {
+  ext_mappings.push_back({erizo::MID, "urn:ietf:params:rtp-hdrext:sdes:mid"});
+  ext_mappings.push_back({erizo::RTP_ID, "urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id"});
+  erizo::RtpExtensionProcessor processor(ext_mappings);
+  auto sdp = std::make_shared<erizo::SdpInfo>(std::vector<erizo::RtpMap>());
+  sdp->rids_.push_back({"l", erizo::RidDirection::SEND});
+  sdp->rids_.push_back({"h", erizo::RidDirection::SEND});
+  processor.setSdpInfo(sdp);
+  processor.setExtension(erizo::VIDEO_TYPE, erizo::MID, erizo::MID);
+  processor.setExtension(erizo::VIDEO_TYPE, erizo::RTP_ID, erizo::RTP_ID);
+
+  const auto low_packet = erizo::PacketTools::createVP8PacketWithExtensions(erizo::MID, '0', erizo::RTP_ID, 'l');
+  const auto high_packet = erizo::PacketTools::createVP8PacketWithExtensions(erizo::MID, '0', erizo::RTP_ID, 'h');
+  const auto unknown_packet = erizo::PacketTools::createVP8PacketWithExtensions(erizo::MID, '0', erizo::RTP_ID, 'x');
+
+  processor.processRtpExtensions(low_packet);
+  processor.processRtpExtensions(high_packet);
+  processor.processRtpExtensions(unknown_packet);
+
+  EXPECT_THAT(low_packet->rid, Eq(1));
+  EXPECT_THAT(high_packet->rid, Eq(2));
+  EXPECT_THAT(unknown_packet->rid, Eq(0));
+}
+
+TEST_F(RtpExtensionProcessorTest, shouldIgnoreMidsThatAreNotNegotiated) {
+  ext_mappings.push_back({erizo::MID, "urn:ietf:params:rtp-hdrext:sdes:mid"});
+  erizo::RtpExtensionProcessor processor(ext_mappings);
+  processor.setExtension(erizo::VIDEO_TYPE, erizo::MID, erizo::MID);
+  processor.setNegotiatedMids(getMedias({"0", "1"}));
+
+  const auto pkt = createVP8PacketWithMid("2");
+
+  processor.processRtpExtensions(pkt);
+
+  EXPECT_THAT(pkt->mid, Eq(erizo::StringInterner::kEmptyId));
+}
+
+TEST_F(RtpExtensionProcessorTest, shouldResolveNegotiatedMids_afterReceivingManyUnknownMids) {
+  ext_mappings.push_back({erizo::MID, "urn:ietf:params:rtp-hdrext:sdes:mid"});
+  erizo::RtpExtensionProcessor processor(ext_mappings);
+  processor.setExtension(erizo::VIDEO_TYPE, erizo::MID, erizo::MID);
+  processor.setNegotiatedMids(getMedias({"0", "1"}));
+
+  size_t resolved_unknown_mids = 0;
+  for (size_t i = 0; i <= erizo::StringInterner::kMaxStrings; i++) {
+    const auto unknown_packet = createVP8PacketWithMid("u" + std::to_string(i));
+    processor.processRtpExtensions(unknown_packet);
+    if (unknown_packet->mid != erizo::StringInterner::kEmptyId) {
+      resolved_unknown_mids++;
+    }
+  }
+  const auto audio_packet = createVP8PacketWithMid("0");
+  const auto video_packet = createVP8PacketWithMid("1");
+  processor.processRtpExtensions(audio_packet);
+  processor.processRtpExtensions(video_packet);
+
+  EXPECT_THAT(resolved_unknown_mids, Eq(0u));
+  EXPECT_THAT(audio_packet->getMidName(), Eq("0"));
+  EXPECT_THAT(video_packet->getMidName(), Eq("1"));
+  EXPECT_THAT(video_packet->mid, Not(Eq(audio_packet->mid)));
+  // Unknown MIDs did not take room in the interner
+  EXPECT_THAT(erizo::StringInterner::intern("rtp_extension_processor_test"), Not(Eq(erizo::StringInterner::kEmptyId)));
+}
@@ -1,7 +1,6 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
-#include <thread/Scheduler.h>
 #include <rtp/RtpRetransmissionHandler.h>
 #include <rtp/RtpHeaders.h>
 #include <stats/StatNode.h>
@@ -154,3 +153,38 @@ TEST_F(RtpRetransmissionHandlerTest, shouldRetransmitPackets_whenReceivingNackWi
     EXPECT_CALL(*reader.get(), read(_, _)).Times(0);
     pipeline->read(nack_packet);
 }
+
+TEST_F(RtpRetransmissionHandlerTest, shouldNotRetransmitPacketsAgainWithinTheRtt) {
+    uint ssrc = media_stream->getVideoSourceSSRC();
+    uint source_ssrc = media_stream->getVideoSinkSSRC();
+    connection->setRtt(100);
+
+    EXPECT_CALL(*writer.get(), write(_, _)).
+      With(Args<1>(erizo::RtpHasSequenceNumber(erizo::kArbitrarySeqNumber))).Times(3);
+    pipeline->write(erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber, VIDEO_PACKET));
+
+    pipeline->read(erizo::PacketTools::createNack(ssrc, source_ssrc, erizo::kArbitrarySeqNumber, VIDEO_PACKET));
+    clock->advanceTime(std::chrono::milliseconds(50));
+    pipeline->read(erizo::PacketTools::createNack(ssrc, source_ssrc, erizo::kArbitrarySeqNumber, VIDEO_PACKET));
+    clock->advanceTime(std::chrono::milliseconds(60));
+    pipeline->read(erizo::PacketTools::createNack(ssrc, source_ssrc, erizo::kArbitrarySeqNumber, VIDEO_PACKET));
+}
+
+TEST_F(RtpRetransmissionHandlerTest, shouldRetransmitAsRtx_whenRtxIsNegotiated) {
+    const uint32_t kRtxSsrc = 5555;
+    const unsigned int kRtxPayloadType = 96;
+    uint ssrc = media_stream->getVideoSourceSSRC();
+    uint source_ssrc = media_stream->getVideoSinkSSRC();
+    media_stream->setVideoSinkRtxSSRC(kRtxSsrc);
+    RtpMap rtx_map{kRtxPayloadType, "rtx", 90000, erizo::VIDEO_TYPE, 1, {}, {{"apt", "0"}}};
+    media_stream->getRemoteSdpInfo()->payloadVector.push_back(rtx_map);
+    auto rtp_packet = erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber, VIDEO_PACKET);
+
+    EXPECT_CALL(*writer.get(), write(_, _)).
+      With(Args<1>(erizo::RtpHasSequenceNumber(erizo::kArbitrarySeqNumber))).Times(1);
+    EXPECT_CALL(*writer.get(), write(_, _)).
+      With(Args<1>(erizo::RtpIsRtx(kRtxSsrc, kRtxPayloadType, erizo::kArbitrarySeqNumber))).Times(1);
+    pipeline->write(rtp_packet);
+
+    pipeline->read(erizo::PacketTools::createNack(ssrc, source_ssrc, erizo::kArbitrarySeqNumber, VIDEO_PACKET));
+}
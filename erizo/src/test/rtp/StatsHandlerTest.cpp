@@ -65,3 +65,15 @@ TEST_F(StatsHandlerTest, basicBehaviourShouldWritePackets) {
       With(Args<1>(erizo::RtpHasSequenceNumber(erizo::kArbitrarySeqNumber))).Times(1);
     pipeline->write(packet);
 }
+
+TEST_F(StatsHandlerTest, shouldCountRetransmissions_whenTheySendOnTheRtxSsrc) {
+    const uint32_t kRtxSsrc = 5555;
+    media_stream->setVideoSinkRtxSSRC(kRtxSsrc);
+    auto packet = erizo::PacketTools::createDataPacket(erizo::kArbitrarySeqNumber, VIDEO_PACKET);
+    reinterpret_cast<erizo::RtpHeader*>(packet->data)->setSSRC(kRtxSsrc);
+
+    EXPECT_CALL(*writer.get(), write(_, _)).Times(1);
+    pipeline->write(packet);
+
+    EXPECT_THAT(stats->getSsrcStats().find(kRtxSsrc), testing::NotNull());
+}
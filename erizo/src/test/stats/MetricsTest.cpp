@@ -0,0 +1,115 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <boost/asio.hpp>
+
+#include <stats/Metrics.h>
+#include <stats/MetricsServer.h>
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::HasSubstr;
+using ::testing::Ne;
+using erizo::MetricHistogram;
+using erizo::WorkerMetrics;
+using erizo::MetricsRegistry;
+using erizo::MetricsServer;
+using erizo::FeedbackMetric;
+using erizo::MetricDirection;
+
+TEST(MetricHistogramTest, shouldCountSamplesInTheirBucket) {
+  MetricHistogram histogram;
+
+  histogram.observe(std::chrono::microseconds(50));
+  histogram.observe(std::chrono::microseconds(100));
+  histogram.observe(std::chrono::milliseconds(3));
+  histogram.observe(std::chrono::seconds(10));
+
+  EXPECT_THAT(histogram.bucketCount(0), Eq(2u));
+  EXPECT_THAT(histogram.bucketCount(3), Eq(1u));
+  EXPECT_THAT(histogram.bucketCount(MetricHistogram::kBuckets - 1), Eq(1u));
+  EXPECT_THAT(histogram.sumUs(), Eq(10003150u));
+}
+
+TEST(WorkerMetricsTest, shouldUseTheSharedMetricsOutsideWorkers) {
+  EXPECT_THAT(&WorkerMetrics::current(), Eq(&MetricsRegistry::instance().sharedShard()));
+
+  WorkerMetrics metrics{"test"};
+  WorkerMetrics::setCurrent(&metrics);
+  WorkerMetrics::current().countFeedback(FeedbackMetric::kPli, MetricDirection::kOut);
+  WorkerMetrics::setCurrent(nullptr);
+
+  EXPECT_THAT(metrics.feedback(FeedbackMetric::kPli, MetricDirection::kOut), Eq(1u));
+  EXPECT_THAT(metrics.feedback(FeedbackMetric::kPli, MetricDirection::kIn), Eq(0u));
+}
+
+TEST(MetricsRegistryTest, shouldKeepHandlerIndexes) {
+  size_t index = MetricsRegistry::instance().handlerIndex("metrics-test-handler");
+
+  EXPECT_THAT(MetricsRegistry::instance().handlerIndex("metrics-test-handler"), Eq(index));
+  EXPECT_THAT(MetricsRegistry::instance().handlerIndex("metrics-test-other-handler"), Ne(index));
+}
+
+TEST(MetricsRegistryTest, shouldRenderWorkerMetrics) {
+  std::shared_ptr<WorkerMetrics> worker = MetricsRegistry::instance().createWorkerMetrics();
+  size_t handler = MetricsRegistry::instance().handlerIndex("metrics-test-handler");
+  worker->countHandlerPacket(handler);
+  worker->countHandlerPacket(handler);
+  worker->retransmissions.add(3);
+  worker->task_duration.observe(std::chrono::milliseconds(2));
+
+  std::string text = MetricsRegistry::instance().toOpenMetrics();
+  std::string label = "worker=\"" + worker->label() + "\"";
+
+  EXPECT_THAT(text, HasSubstr("erizo_handler_packets_total{" + label + ",handler=\"metrics-test-handler\"} 2\n"));
+  EXPECT_THAT(text, HasSubstr("erizo_retransmissions_total{" + label + "} 3\n"));
+  EXPECT_THAT(text, HasSubstr("erizo_task_duration_seconds_bucket{" + label + ",le=\"0.005000\"} 1\n"));
+  EXPECT_THAT(text, HasSubstr("erizo_task_duration_seconds_sum{" + label + "} 0.002000\n"));
+  EXPECT_THAT(text, HasSubstr("erizo_srtp_errors_total{" + label + ",operation=\"unprotect\"} 0\n"));
+  EXPECT_THAT(text.substr(text.size() - 6), Eq("# EOF\n"));
+}
+
+static uint64_t sharedRetransmissions() {
+  std::string text = MetricsRegistry::instance().toOpenMetrics();
+  std::string prefix = "erizo_retransmissions_total{worker=\"shared\"} ";
+  size_t position = text.find(prefix);
+  EXPECT_THAT(position, Ne(std::string::npos));
+  return std::stoull(text.substr(position + prefix.size()));
+}
+
+TEST(MetricsRegistryTest, shouldRenderTheSharedShardsAsASingleWorker) {
+  uint64_t retransmissions = sharedRetransmissions();
+
+  WorkerMetrics::current().retransmissions.add(2);
+  std::thread other_thread([] {
+    WorkerMetrics::current().retransmissions.add(3);
+  });
+  other_thread.join();
+
+  EXPECT_THAT(sharedRetransmissions(), Eq(retransmissions + 5));
+}
+
+TEST(MetricsServerTest, shouldServeMetrics) {
+  MetricsServer server;
+  int port = server.start("127.0.0.1", 0);
+  ASSERT_THAT(port, Ge(1));
+
+  boost::asio::io_service service;
+  boost::asio::ip::tcp::socket socket{service};
+  socket.connect({boost::asio::ip::address::from_string("127.0.0.1"), static_cast<uint16_t>(port)});
+  std::string request = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  boost::asio::write(socket, boost::asio::buffer(request));
+  boost::asio::streambuf response;
+  boost::system::error_code error;
+  boost::asio::read(socket, response, error);
+  std::string text{boost::asio::buffers_begin(response.data()), boost::asio::buffers_end(response.data())};
+
+  EXPECT_THAT(text, HasSubstr("HTTP/1.1 200 OK\r\n"));
+  EXPECT_THAT(text, HasSubstr("application/openmetrics-text"));
+  EXPECT_THAT(text, HasSubstr("# EOF\n"));
+  server.close();
+}
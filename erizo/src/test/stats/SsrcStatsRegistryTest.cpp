@@ -0,0 +1,84 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stats/SsrcStatsRegistry.h>
+#include <stats/StatNode.h>
+#include <lib/Clock.h>
+
+#include <memory>
+#include <string>
+
+using ::testing::Eq;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Not;
+using erizo::StatNode;
+using erizo::PacketStat;
+using erizo::PacketStats;
+using erizo::SsrcStatsRegistry;
+using erizo::SimulatedClock;
+
+class SsrcStatsRegistryTest : public ::testing::Test {
+ public:
+  SsrcStatsRegistryTest()
+      : clock{std::make_shared<SimulatedClock>()},
+        registry{&root, clock} {
+  }
+
+ protected:
+  StatNode root;
+  std::shared_ptr<SimulatedClock> clock;
+  SsrcStatsRegistry registry;
+};
+
+TEST_F(SsrcStatsRegistryTest, shouldNotFindUnknownSsrcs) {
+  EXPECT_THAT(registry.find(1), IsNull());
+  EXPECT_THAT(root.hasChild(1), Eq(false));
+}
+
+TEST_F(SsrcStatsRegistryTest, shouldLinkCreatedStatsIntoTheStatTree) {
+  registry.create(1, "video");
+
+  EXPECT_THAT(registry.find(1), NotNull());
+  EXPECT_THAT(root[1]["type"].toString(), Eq("\"video\""));
+  EXPECT_THAT(root[1].hasChild("bitrateCalculated"), Eq(true));
+  EXPECT_THAT(root[1].hasChild("mediaBitrateCalculated"), Eq(true));
+  EXPECT_THAT(root[1].hasChild("packetsCalculated"), Eq(true));
+  EXPECT_THAT(root[1].hasChild("mediaPacketsCalculated"), Eq(true));
+}
+
+TEST_F(SsrcStatsRegistryTest, shouldNotAddTypeWhenEmpty) {
+  registry.create(1, "");
+
+  EXPECT_THAT(root[1].hasChild("type"), Eq(false));
+}
+
+TEST_F(SsrcStatsRegistryTest, shouldReturnTheSameStatsWhenCreatedTwice) {
+  PacketStats &first = registry.create(1, "audio");
+  registry.create(2, "video");
+
+  EXPECT_THAT(&registry.create(1, "audio"), Eq(&first));
+  EXPECT_THAT(registry.find(1), Eq(&first));
+}
+
+TEST_F(SsrcStatsRegistryTest, shouldReportUpdatesThroughTheStatTree) {
+  PacketStats &stats = registry.create(1, "video");
+
+  stats[PacketStat::kPackets].add(10, registry.now());
+  clock->advanceTime(std::chrono::milliseconds(1000));
+  stats[PacketStat::kPackets].add(10, registry.now());
+
+  EXPECT_THAT(&root[1]["packetsCalculated"], Eq(&stats[PacketStat::kPackets]));
+  EXPECT_THAT(root[1]["packetsCalculated"].value(), Eq(stats[PacketStat::kPackets].value()));
+  EXPECT_THAT(root[1]["packetsCalculated"].value(), Not(Eq(0u)));
+  EXPECT_THAT(root[1]["mediaPacketsCalculated"].value(), Eq(0u));
+}
+
+TEST_F(SsrcStatsRegistryTest, shouldOnlyKeepBitrateAndPacketsInTotal) {
+  registry.total();
+
+  EXPECT_THAT(root["total"].hasChild("bitrateCalculated"), Eq(true));
+  EXPECT_THAT(root["total"].hasChild("packetsCalculated"), Eq(true));
+  EXPECT_THAT(root["total"].hasChild("mediaBitrateCalculated"), Eq(false));
+  EXPECT_THAT(root["total"].hasChild("mediaPacketsCalculated"), Eq(false));
+}
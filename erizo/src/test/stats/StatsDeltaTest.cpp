@@ -0,0 +1,223 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stats/StatNode.h>
+#include <stats/StatsDelta.h>
+#include <Stats.h>
+#include <MediaStream.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+using ::testing::Eq;
+using ::testing::IsEmpty;
+using ::testing::SizeIs;
+using erizo::StatNode;
+using erizo::StringStat;
+using erizo::CumulativeStat;
+using erizo::Stats;
+using erizo::StatsDeltaOp;
+using erizo::StatsDeltaEntry;
+using erizo::StatsDeltaEncoder;
+using erizo::StatsDeltaReader;
+using erizo::StatsDeltaTracker;
+using erizo::MediaStreamStatsListener;
+
+class DeltaStatsListener : public MediaStreamStatsListener {
+ public:
+  void notifyStats(const std::string& message) override {
+    messages.push_back(message);
+  }
+
+  bool wantsStatsDelta() override { return true; }
+
+  bool notifyStatsDelta(const std::string& delta) override {
+    if (keep_deltas) {
+      deltas.push_back(delta);
+    }
+    return keep_deltas;
+  }
+
+  bool keep_deltas = true;
+  std::vector<std::string> messages;
+  std::vector<std::string> deltas;
+};
+
+class StatsDeltaTest : public ::testing::Test {
+ protected:
+  std::vector<StatsDeltaEntry> encode() {
+    std::string delta;
+    encoder.encode(&root, &delta);
+    return read(delta);
+  }
+
+  static std::vector<StatsDeltaEntry> read(const std::string &delta) {
+    std::vector<StatsDeltaEntry> entries;
+    StatsDeltaReader reader{delta};
+    StatsDeltaEntry entry;
+    while (reader.next(&entry)) {
+      entries.push_back(entry);
+    }
+    return entries;
+  }
+
+  StatNode root;
+  StatsDeltaEncoder encoder;
+};
+
+TEST_F(StatsDeltaTest, shouldEncodeEveryStatTheFirstTime) {
+  root[1234].insertStat("type", StringStat{"video"});
+  root[1234].insertStat("packetsLost", CumulativeStat{5});
+  root["total"].insertStat("packetsCalculated", CumulativeStat{300});
+
+  std::vector<StatsDeltaEntry> entries = encode();
+
+  ASSERT_THAT(entries, SizeIs(3));
+  EXPECT_THAT(entries[0].op, Eq(StatsDeltaOp::kNumber));
+  EXPECT_THAT(entries[0].path, Eq("1234.packetsLost"));
+  EXPECT_THAT(entries[0].number, Eq(5u));
+  EXPECT_THAT(entries[1].op, Eq(StatsDeltaOp::kText));
+  EXPECT_THAT(entries[1].path, Eq("1234.type"));
+  EXPECT_THAT(entries[1].text, Eq("video"));
+  EXPECT_THAT(entries[2].path, Eq("total.packetsCalculated"));
+  EXPECT_THAT(entries[2].number, Eq(300u));
+}
+
+TEST_F(StatsDeltaTest, shouldOnlyEncodeChangedStats) {
+  root[1234].insertStat("type", StringStat{"video"});
+  root[1234].insertStat("packetsLost", CumulativeStat{5});
+  encode();
+
+  root[1234]["packetsLost"] += 1000;
+
+  std::vector<StatsDeltaEntry> entries = encode();
+
+  ASSERT_THAT(entries, SizeIs(1));
+  EXPECT_THAT(entries[0].path, Eq("1234.packetsLost"));
+  EXPECT_THAT(entries[0].number, Eq(1005u));
+  EXPECT_THAT(encode(), IsEmpty());
+}
+
+TEST_F(StatsDeltaTest, shouldEncodeRemovedStats) {
+  root[1234].insertStat("packetsLost", CumulativeStat{5});
+  encode();
+
+  root[1234].insertStat("packetsLost", StringStat{"unknown"});
+  root[1234]["other"].insertStat("packetsLost", CumulativeStat{1});
+  std::vector<StatsDeltaEntry> first = encode();
+  root = StatNode{};
+  std::vector<StatsDeltaEntry> second = encode();
+
+  ASSERT_THAT(first, SizeIs(2));
+  EXPECT_THAT(first[1].op, Eq(StatsDeltaOp::kText));
+  ASSERT_THAT(second, SizeIs(2));
+  EXPECT_THAT(second[0].op, Eq(StatsDeltaOp::kRemoved));
+  EXPECT_THAT(second[1].op, Eq(StatsDeltaOp::kRemoved));
+}
+
+TEST_F(StatsDeltaTest, shouldEncodeEverythingAfterReset) {
+  root[1234].insertStat("packetsLost", CumulativeStat{5});
+  encode();
+
+  encoder.reset();
+
+  EXPECT_THAT(encode(), SizeIs(1));
+}
+
+TEST_F(StatsDeltaTest, shouldApplyConcatenatedDeltasInOrder) {
+  std::string delta;
+  root.insertStat("bitrate", CumulativeStat{1});
+  encoder.encode(&root, &delta);
+  root["bitrate"] += 300;
+  encoder.encode(&root, &delta);
+
+  std::map<std::string, uint64_t> values;
+  for (const StatsDeltaEntry &entry : read(delta)) {
+    values[entry.path] = entry.number;
+  }
+
+  EXPECT_THAT(values["bitrate"], Eq(301u));
+}
+
+TEST_F(StatsDeltaTest, shouldReportMissingStatsAsRemoved_whenReadingASnapshot) {
+  StatsDeltaTracker tracker;
+  std::vector<StatsDeltaEntry> entries;
+  std::string delta;
+  root.insertStat("bitrate", CumulativeStat{1});
+  root.insertStat("packetsLost", CumulativeStat{2});
+  encoder.encode(&root, &delta);
+  tracker.read(delta, false, &entries);
+
+  root = StatNode{};
+  root.insertStat("bitrate", CumulativeStat{1});
+  encoder.reset();
+  delta.clear();
+  encoder.encode(&root, &delta);
+  entries.clear();
+  tracker.read(delta, true, &entries);
+
+  ASSERT_THAT(entries, SizeIs(2));
+  EXPECT_THAT(entries[0].path, Eq("bitrate"));
+  EXPECT_THAT(entries[1].op, Eq(StatsDeltaOp::kRemoved));
+  EXPECT_THAT(entries[1].path, Eq("packetsLost"));
+}
+
+TEST_F(StatsDeltaTest, shouldStopReadingMalformedDeltas) {
+  std::string delta;
+  root.insertStat("bitrate", CumulativeStat{1});
+  root.insertStat("text", StringStat{"a long enough text"});
+  encoder.encode(&root, &delta);
+
+  EXPECT_THAT(read(delta.substr(0, delta.size() - 3)), SizeIs(1));
+  EXPECT_THAT(read(std::string(1, '\x09')), IsEmpty());
+}
+
+TEST_F(StatsDeltaTest, shouldSendDeltasToListenersThatWantThem) {
+  Stats stats;
+  DeltaStatsListener listener;
+  stats.setStatsListener(&listener);
+  stats.getNode()[1234].insertStat("packetsLost", CumulativeStat{5});
+
+  stats.sendStats();
+  stats.sendStats();
+  stats.getNode()[1234]["packetsLost"]++;
+  stats.sendStats();
+
+  EXPECT_THAT(listener.messages, IsEmpty());
+  ASSERT_THAT(listener.deltas, SizeIs(2));
+  EXPECT_THAT(read(listener.deltas[1])[0].number, Eq(6u));
+}
+
+TEST_F(StatsDeltaTest, shouldReportTheStatsOfDiscardedDeltas_inTheNextOne) {
+  Stats stats;
+  DeltaStatsListener listener;
+  StatsDeltaTracker tracker;
+  std::vector<StatsDeltaEntry> entries;
+  stats.setStatsListener(&listener);
+  stats.getNode().insertStat("bitrate", CumulativeStat{300});
+  stats.getNode().insertStat("packetsLost", CumulativeStat{5});
+  stats.sendStats();
+  ASSERT_THAT(listener.deltas, SizeIs(1));
+  tracker.read(listener.deltas[0], false, &entries);
+
+  listener.keep_deltas = false;
+  stats.getNode() = StatNode{};
+  stats.getNode().insertStat("bitrate", CumulativeStat{300});
+  stats.getNode().insertStat("codec", StringStat{"VP8"});
+  stats.sendStats();
+  listener.keep_deltas = true;
+  stats.sendStats();
+  ASSERT_THAT(listener.deltas, SizeIs(2));
+  entries.clear();
+  tracker.read(listener.deltas[1], true, &entries);
+
+  std::map<std::string, StatsDeltaEntry> latest;
+  for (const StatsDeltaEntry &entry : entries) {
+    latest[entry.path] = entry;
+  }
+  EXPECT_THAT(latest["codec"].op, Eq(StatsDeltaOp::kText));
+  EXPECT_THAT(latest["codec"].text, Eq("VP8"));
+  EXPECT_THAT(latest["packetsLost"].op, Eq(StatsDeltaOp::kRemoved));
+  EXPECT_THAT(latest["bitrate"].number, Eq(300u));
+}
@@ -0,0 +1,69 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <sched.h>
+
+#include <thread/ThreadPool.h>
+
+#include <chrono>  // NOLINT
+#include <future>  // NOLINT
+#include <memory>
+#include <thread>  // NOLINT
+
+using testing::Eq;
+using erizo::ThreadPool;
+using erizo::Worker;
+
+class ThreadPoolTest : public ::testing::Test {
+ protected:
+  void runAndWait(std::shared_ptr<Worker> worker, std::function<void()> f) {
+    auto promise = std::make_shared<std::promise<void>>();
+    worker->task([f, promise] {
+      f();
+      promise->set_value();
+    });
+    promise->get_future().wait();
+  }
+};
+
+TEST_F(ThreadPoolTest, getLessUsedWorker_shouldBalanceReferences_whenThereIsNoLoad) {
+  ThreadPool pool(2);
+  pool.start();
+
+  std::shared_ptr<Worker> first = pool.getLessUsedWorker();
+  std::shared_ptr<Worker> second = pool.getLessUsedWorker();
+
+  EXPECT_NE(first, second);
+  pool.close();
+}
+
+TEST_F(ThreadPoolTest, getLessUsedWorker_shouldAvoidLoadedWorkers_whenReferencesAreEqual) {
+  ThreadPool pool(2);
+  pool.start();
+  std::shared_ptr<Worker> loaded = pool.getLessUsedWorker();
+  std::shared_ptr<Worker> idle = pool.getLessUsedWorker();
+
+  for (int i = 0; i < 5; i++) {
+    runAndWait(loaded, [] { std::this_thread::sleep_for(std::chrono::milliseconds(15)); });
+  }
+
+  EXPECT_GT(loaded->getLoad(), idle->getLoad());
+  EXPECT_THAT(pool.getLessUsedWorker(), Eq(idle));
+  pool.close();
+}
+
+TEST_F(ThreadPoolTest, workers_shouldBePinnedToOneCpu_whenPinningIsEnabled) {
+  ThreadPool pool(2, true);
+  pool.start();
+
+  int cpus_in_affinity = 0;
+  runAndWait(pool.getLessUsedWorker(), [&cpus_in_affinity] {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    sched_getaffinity(0, sizeof(cpu_set), &cpu_set);
+    cpus_in_affinity = CPU_COUNT(&cpu_set);
+  });
+
+  EXPECT_THAT(cpus_in_affinity, Eq(1));
+  pool.close();
+}
@@ -0,0 +1,106 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <thread/TimerWheel.h>
+
+#include <chrono>  // NOLINT
+#include <vector>
+
+using testing::ElementsAre;
+using testing::Eq;
+using erizo::TimerWheel;
+using erizo::time_point;
+
+class TimerWheelTest : public ::testing::Test {
+ public:
+  TimerWheelTest() : start{std::chrono::steady_clock::now()}, wheel{start} {}
+
+ protected:
+  TimerWheel::Task record(int value) {
+    return [this, value] { executed.push_back(value); };
+  }
+
+  time_point at(int ms) {
+    return start + std::chrono::milliseconds(ms);
+  }
+
+  time_point start;
+  TimerWheel wheel;
+  std::vector<int> executed;
+};
+
+TEST_F(TimerWheelTest, advance_shouldRunExpiredTimersInOrder) {
+  wheel.add(record(2), at(20));
+  wheel.add(record(1), at(10));
+  wheel.add(record(3), at(30));
+
+  EXPECT_THAT(wheel.advance(at(25)), Eq(2u));
+
+  EXPECT_THAT(executed, ElementsAre(1, 2));
+  EXPECT_THAT(wheel.size(), Eq(1u));
+}
+
+TEST_F(TimerWheelTest, advance_shouldRunTimersInUpperLevels_whenTheyAreCascaded) {
+  wheel.add(record(3), at(2 * 60 * 60 * 1000));
+  wheel.add(record(2), at(5000));
+  wheel.add(record(1), at(100));
+
+  wheel.advance(at(4999));
+  EXPECT_THAT(executed, ElementsAre(1));
+
+  wheel.advance(at(5000));
+  EXPECT_THAT(executed, ElementsAre(1, 2));
+
+  wheel.advance(at(2 * 60 * 60 * 1000 - 1));
+  EXPECT_THAT(executed, ElementsAre(1, 2));
+
+  wheel.advance(at(2 * 60 * 60 * 1000));
+  EXPECT_THAT(executed, ElementsAre(1, 2, 3));
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, cancel_shouldRemoveTheTimerImmediately) {
+  TimerWheel::TimerId id = wheel.add(record(1), at(1000));
+
+  EXPECT_TRUE(wheel.cancel(id));
+
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_FALSE(wheel.cancel(id));
+  wheel.advance(at(2000));
+  EXPECT_TRUE(executed.empty());
+}
+
+TEST_F(TimerWheelTest, advance_shouldNotRunTimers_whenCancelledByAnExpiredTimer) {
+  TimerWheel::TimerId second = 0;
+  wheel.add([this, &second] {
+    executed.push_back(1);
+    wheel.cancel(second);
+  }, at(10));
+  second = wheel.add(record(2), at(10));
+
+  wheel.advance(at(10));
+
+  EXPECT_THAT(executed, ElementsAre(1));
+}
+
+TEST_F(TimerWheelTest, add_shouldRunTimersInTheNextTick_whenTheyAreAlreadyExpired) {
+  wheel.add([this] {
+    executed.push_back(1);
+    wheel.add(record(2), at(0));
+  }, at(10));
+
+  wheel.advance(at(10));
+  EXPECT_THAT(executed, ElementsAre(1));
+
+  wheel.advance(at(11));
+  EXPECT_THAT(executed, ElementsAre(1, 2));
+}
+
+TEST_F(TimerWheelTest, nextExpiration_shouldNeverBeLaterThanTheFirstTimer) {
+  wheel.add(record(1), at(30));
+  EXPECT_THAT(wheel.nextExpiration(), Eq(at(30)));
+
+  wheel.add(record(2), at(3000));
+  wheel.advance(at(30));
+  EXPECT_LE(wheel.nextExpiration(), at(3000));
+}
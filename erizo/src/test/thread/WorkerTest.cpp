@@ -0,0 +1,95 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <thread/Worker.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <future>  // NOLINT
+#include <memory>
+
+using testing::Eq;
+using erizo::Worker;
+using erizo::ScheduledTaskReference;
+
+class WorkerTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    worker = std::make_shared<Worker>();
+    worker->start();
+  }
+  virtual void TearDown() {
+    worker->close();
+  }
+
+  std::shared_ptr<Worker> worker;
+};
+
+TEST_F(WorkerTest, scheduleFromNow_shouldRunTasksInOrder) {
+  std::atomic<int> executed{0};
+  std::promise<int> first_executed;
+  std::promise<void> all_executed;
+
+  worker->scheduleFromNow([&] {
+    if (++executed == 2) {
+      all_executed.set_value();
+    }
+  }, std::chrono::milliseconds(40));
+  worker->scheduleFromNow([&] {
+    first_executed.set_value(executed);
+    ++executed;
+  }, std::chrono::milliseconds(10));
+
+  EXPECT_THAT(first_executed.get_future().get(), Eq(0));
+  EXPECT_THAT(all_executed.get_future().wait_for(std::chrono::seconds(1)), Eq(std::future_status::ready));
+}
+
+TEST_F(WorkerTest, unschedule_shouldCancelTheTask) {
+  std::atomic<bool> cancelled_executed{false};
+  std::promise<void> executed;
+
+  std::shared_ptr<ScheduledTaskReference> id = worker->scheduleFromNow([&] {
+    cancelled_executed = true;
+  }, std::chrono::milliseconds(10));
+  worker->unschedule(id);
+  worker->scheduleFromNow([&] { executed.set_value(); }, std::chrono::milliseconds(30));
+
+  executed.get_future().wait();
+  EXPECT_FALSE(cancelled_executed);
+}
+
+TEST_F(WorkerTest, scheduleEvery_shouldRepeatTheTask_untilItReturnsFalse) {
+  std::atomic<int> executions{0};
+  std::promise<void> finished;
+
+  worker->scheduleEvery([&] {
+    if (++executions == 3) {
+      finished.set_value();
+      return false;
+    }
+    return true;
+  }, std::chrono::milliseconds(5));
+
+  EXPECT_THAT(finished.get_future().wait_for(std::chrono::seconds(1)), Eq(std::future_status::ready));
+  EXPECT_THAT(executions.load(), Eq(3));
+}
+
+TEST(WorkerLoadTest, getLoad_shouldDecayWithTime_withoutResettingStats) {
+  auto clock = std::make_shared<erizo::SimulatedClock>();
+  auto worker = std::make_shared<Worker>(clock);
+  worker->start();
+  std::promise<void> busy_task_executed;
+  worker->task([&] {
+    clock->advanceTime(std::chrono::milliseconds(100));
+    busy_task_executed.set_value();
+  });
+  busy_task_executed.get_future().wait();
+  // The task is measured after it runs, closing joins the worker thread so the clock can't move meanwhile
+  worker->close();
+
+  EXPECT_THAT(worker->getLoad(), Eq(100000u));
+  clock->advanceTime(std::chrono::seconds(5));
+  EXPECT_THAT(worker->getLoad(), Eq(50000u));
+  clock->advanceTime(std::chrono::seconds(5));
+  EXPECT_THAT(worker->getLoad(), Eq(25000u));
+}
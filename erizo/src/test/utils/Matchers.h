@@ -22,6 +22,12 @@ MATCHER_P(RtpHasSequenceNumberFromBuffer, seq_num, "") {
 MATCHER_P(RtpHasSequenceNumber, seq_num, "") {
   return (reinterpret_cast<erizo::RtpHeader*>(std::get<0>(arg)->data))->getSeqNumber() == seq_num;
 }
+MATCHER_P3(RtpIsRtx, ssrc, payload_type, original_seq_num, "") {
+  erizo::RtpHeader *head = reinterpret_cast<erizo::RtpHeader*>(std::get<0>(arg)->data);
+  const unsigned char *osn = reinterpret_cast<const unsigned char*>(std::get<0>(arg)->data + head->getHeaderLength());
+  return head->getSSRC() == ssrc && head->getPayloadType() == payload_type &&
+      ((osn[0] << 8) | osn[1]) == original_seq_num;
+}
 MATCHER_P(NackHasSequenceNumber, seq_num, "") {
   return (reinterpret_cast<erizo::RtcpHeader*>(std::get<0>(arg)->data))->getNackPid() == seq_num;
 }
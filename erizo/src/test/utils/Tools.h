@@ -114,7 +114,7 @@ class PacketTools {
     *parsing_pointer = 0x00;
 
     auto packet = std::make_shared<DataPacket>(0, packet_buffer, 200, VIDEO_PACKET);
-    packet->codec = "VP8";
+    packet->codec = StringInterner::kVP8Id;
     packet->is_keyframe = true;
     return packet;
   }
@@ -138,7 +138,7 @@ class PacketTools {
     *parsing_pointer = is_keyframe? 0x00: 0x01;
 
     auto packet = std::make_shared<DataPacket>(0, packet_buffer, 200, VIDEO_PACKET);
-    packet->codec = "VP8";
+    packet->codec = StringInterner::kVP8Id;
     packet->is_keyframe = is_keyframe;
     return packet;
   }
@@ -164,7 +164,7 @@ class PacketTools {
     *parsing_pointer = is_keyframe? 0x00: 0x01;
 
     auto packet = std::make_shared<DataPacket>(0, packet_buffer, 200, VIDEO_PACKET);
-    packet->codec = "VP8";
+    packet->codec = StringInterner::kVP8Id;
     packet->is_keyframe = is_keyframe;
     return packet;
   }
@@ -187,7 +187,7 @@ class PacketTools {
     *parsing_pointer = is_keyframe ? 0x5 : 0x1;
 
     auto packet = std::make_shared<DataPacket>(0, packet_buffer, 200, VIDEO_PACKET);
-    packet->codec = "H264";
+    packet->codec = StringInterner::kH264Id;
     packet->is_keyframe = is_keyframe;
     return packet;
   }
@@ -224,7 +224,7 @@ class PacketTools {
     ptr += nal_2_len;
 
     auto packet = std::make_shared<DataPacket>(0, static_cast<char*>(packet_buffer), packet_length, VIDEO_PACKET);
-    packet->codec = "H264";
+    packet->codec = StringInterner::kH264Id;
 
     return packet;
   }
@@ -253,7 +253,7 @@ class PacketTools {
     *ptr = change_bit(*ptr, 6, is_end);
 
     auto packet = std::make_shared<DataPacket>(0, static_cast<char*>(packet_buffer), packet_length, VIDEO_PACKET);
-    packet->codec = "H264";
+    packet->codec = StringInterner::kH264Id;
 
     return packet;
   }
@@ -275,7 +275,7 @@ class PacketTools {
     *parsing_pointer = is_keyframe? 0x00: 0x40;
 
     auto packet = std::make_shared<DataPacket>(0, packet_buffer, 200, VIDEO_PACKET);
-    packet->codec = "VP9";
+    packet->codec = StringInterner::kVP9Id;
     packet->is_keyframe = is_keyframe;
     return packet;
   }
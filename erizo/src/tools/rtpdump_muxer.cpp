@@ -0,0 +1,26 @@
+/*
+ * rtpdump_muxer.cpp
+ *
+ * Turns a raw RTP dump recorded by ExternalOutput (an output url ending in .rtpdump) into a media
+ * file. The output format is guessed from its extension, e.g. webm or mp4.
+ */
+
+#include <log4cxx/basicconfigurator.h>
+#include <stdio.h>
+
+#include <media/RtpDumpMuxer.h>
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s <input.rtpdump> <output file>\n", argv[0]);
+    return 1;
+  }
+  log4cxx::BasicConfigurator::configure();
+
+  erizo::RtpDumpMuxer muxer(argv[1], argv[2]);
+  if (!muxer.run()) {
+    fprintf(stderr, "Could not convert %s into %s\n", argv[1], argv[2]);
+    return 1;
+  }
+  return 0;
+}
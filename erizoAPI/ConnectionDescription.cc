@@ -67,6 +67,7 @@ NAN_MODULE_INIT(ConnectionDescription::Init) {
   Nan::SetPrototypeMethod(tpl, "getAudioSsrcMap", getAudioSsrcMap);
   Nan::SetPrototypeMethod(tpl, "setVideoSsrcList", setVideoSsrcList);
   Nan::SetPrototypeMethod(tpl, "getVideoSsrcMap", getVideoSsrcMap);
+  Nan::SetPrototypeMethod(tpl, "getVideoRtxSsrcMap", getVideoRtxSsrcMap);
 
   Nan::SetPrototypeMethod(tpl, "getMediaInfos", getMediaInfos);
   Nan::SetPrototypeMethod(tpl, "addMediaInfo", addMediaInfo);
@@ -385,6 +386,19 @@ NAN_METHOD(ConnectionDescription::getVideoSsrcMap) {
   info.GetReturnValue().Set(video_ssrc_map);
 }
 
+NAN_METHOD(ConnectionDescription::getVideoRtxSsrcMap) {
+  GET_SDP();
+  Local<v8::Object> video_rtx_ssrc_map = Nan::New<v8::Object>();
+  for (auto const& rtx_ssrcs : sdp->video_rtx_ssrc_map) {
+    Local<v8::Object> rtx_ssrc_map = Nan::New<v8::Object>();
+    for (auto const& rtx_ssrc : rtx_ssrcs.second) {
+      Nan::Set(rtx_ssrc_map, rtx_ssrc.first, Nan::New(rtx_ssrc.second));
+    }
+    Nan::Set(video_rtx_ssrc_map, Nan::New(rtx_ssrcs.first.c_str()).ToLocalChecked(), rtx_ssrc_map);
+  }
+  info.GetReturnValue().Set(video_rtx_ssrc_map);
+}
+
 NAN_METHOD(ConnectionDescription::setVideoDirection) {
   GET_SDP();
   std::string direction = getString(info[0]);
@@ -45,6 +45,7 @@ class ConnectionDescription : public Nan::ObjectWrap {
     static NAN_METHOD(setVideoSsrcList);
     static NAN_METHOD(getAudioSsrcMap);
     static NAN_METHOD(getVideoSsrcMap);
+    static NAN_METHOD(getVideoRtxSsrcMap);
 
     static NAN_METHOD(getMediaInfos);
     static NAN_METHOD(addMediaInfo);
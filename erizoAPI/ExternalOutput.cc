@@ -132,11 +132,13 @@ NAN_METHOD(ExternalOutput::New) {
 
   bool hasAudio = Nan::To<bool>((info[3])).FromJust();
   bool hasVideo = Nan::To<bool>((info[4])).FromJust();
+  bool direct_io = info.Length() > 5 && Nan::To<bool>((info[5])).FromJust();
 
   std::shared_ptr<erizo::Worker> worker = thread_pool->me->getLessUsedWorker();
 
   ExternalOutput* obj = new ExternalOutput();
-  obj->me = std::make_shared<erizo::ExternalOutput>(worker, url, rtp_mappings, ext_mappings, hasAudio, hasVideo);
+  obj->me = std::make_shared<erizo::ExternalOutput>(worker, url, rtp_mappings, ext_mappings, hasAudio, hasVideo,
+      direct_io);
 
   obj->Wrap(info.This());
   info.GetReturnValue().Set(info.This());
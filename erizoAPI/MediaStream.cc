@@ -4,6 +4,7 @@
 
 #include "MediaStream.h"
 
+#include <algorithm>
 #include <future>  // NOLINT
 
 #include "lib/json.hpp"
@@ -103,6 +104,10 @@ boost::future<void> MediaStream::close() {
   if (me) {
     me->setMediaStreamStatsListener(nullptr);
     me->setMediaStreamEventListener(nullptr);
+    {
+      boost::mutex::scoped_lock lock(mutex);
+      stats_collector_.reset();
+    }
 
     me->close().then([this, close_promise] (boost::future<void>) {
         me.reset();
@@ -141,6 +146,7 @@ NAN_MODULE_INIT(MediaStream::Init) {
   Nan::SetPrototypeMethod(tpl, "generatePLIPacket", generatePLIPacket);
   Nan::SetPrototypeMethod(tpl, "getStats", getStats);
   Nan::SetPrototypeMethod(tpl, "getPeriodicStats", getPeriodicStats);
+  Nan::SetPrototypeMethod(tpl, "collectPeriodicStats", collectPeriodicStats);
   Nan::SetPrototypeMethod(tpl, "setFeedbackReports", setFeedbackReports);
   Nan::SetPrototypeMethod(tpl, "setSlideShowMode", setSlideShowMode);
   Nan::SetPrototypeMethod(tpl, "setPriority", setPriority);
@@ -153,6 +159,7 @@ NAN_MODULE_INIT(MediaStream::Init) {
   Nan::SetPrototypeMethod(tpl, "setMetadata", setMetadata);
   Nan::SetPrototypeMethod(tpl, "setPeriodicKeyframeRequests", setPeriodicKeyframeRequests);
   Nan::SetPrototypeMethod(tpl, "hasPeriodicKeyframeRequests", hasPeriodicKeyframeRequests);
+  Nan::SetPrototypeMethod(tpl, "setMaxFecOverhead", setMaxFecOverhead);
   Nan::SetPrototypeMethod(tpl, "enableHandler", enableHandler);
   Nan::SetPrototypeMethod(tpl, "disableHandler", disableHandler);
   Nan::SetPrototypeMethod(tpl, "getDurationDistribution", getDurationDistribution);
@@ -476,6 +483,17 @@ NAN_METHOD(MediaStream::hasPeriodicKeyframeRequests) {
   info.GetReturnValue().Set(Nan::New(has_periodic_requests));
 }
 
+NAN_METHOD(MediaStream::setMaxFecOverhead) {
+  MediaStream* obj = Nan::ObjectWrap::Unwrap<MediaStream>(info.Holder());
+  std::shared_ptr<erizo::MediaStream> me = obj->me;
+  if (!me || obj->closed_) {
+    return;
+  }
+
+  int percent = Nan::To<int>(info[0]).FromJust();
+  me->setMaxFecOverhead(std::max(percent, 0));
+}
+
 NAN_METHOD(MediaStream::getDurationDistribution) {
   MediaStream* obj = Nan::ObjectWrap::Unwrap<MediaStream>(info.Holder());
   PromiseDurationDistribution duration_distribution = obj->promise_durations_;
@@ -532,6 +550,20 @@ NAN_METHOD(MediaStream::getPeriodicStats) {
   obj->stats_callback_ = new Nan::Callback(info[0].As<Function>());
 }
 
+NAN_METHOD(MediaStream::collectPeriodicStats) {
+  MediaStream* obj = Nan::ObjectWrap::Unwrap<MediaStream>(info.Holder());
+  if (!obj->me || info.Length() != 1 || obj->closed_) {
+    return;
+  }
+  ThreadPool* thread_pool = Nan::ObjectWrap::Unwrap<ThreadPool>(Nan::To<v8::Object>(info[0]).ToLocalChecked());
+  {
+    boost::mutex::scoped_lock lock(obj->mutex);
+    obj->stats_collector_ = std::make_shared<StreamStatsCollector>(obj->id_);
+    thread_pool->addStatsCollector(obj->stats_collector_);
+  }
+  obj->me->setMediaStreamStatsListener(obj);
+}
+
 NAN_METHOD(MediaStream::setFeedbackReports) {
   MediaStream* obj = Nan::ObjectWrap::Unwrap<MediaStream>(info.Holder());
   std::shared_ptr<erizo::MediaStream> me = obj->me;
@@ -568,6 +600,30 @@ void MediaStream::notifyStats(const std::string& message) {
   uv_async_send(async_stats_);
 }
 
+bool MediaStream::wantsStatsDelta() {
+  boost::mutex::scoped_lock lock(mutex);
+  return stats_collector_ != nullptr;
+}
+
+bool MediaStream::notifyStatsDelta(const std::string& delta) {
+  std::shared_ptr<StreamStatsCollector> collector;
+  {
+    boost::mutex::scoped_lock lock(mutex);
+    collector = stats_collector_;
+  }
+  if (!collector) {
+    return true;
+  }
+  boost::mutex::scoped_lock lock(collector->mutex);
+  if (collector->pending_delta.size() + delta.size() > StreamStatsCollector::kMaxPendingDelta) {
+    collector->pending_delta.clear();
+    collector->pending_is_snapshot = true;
+    return false;
+  }
+  collector->pending_delta.append(delta);
+  return true;
+}
+
 void MediaStream::notifyMediaStreamEvent(const std::string& type, const std::string& message) {
   boost::mutex::scoped_lock lock(mutex);
   if (!has_event_callback_) {
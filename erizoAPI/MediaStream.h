@@ -26,6 +26,8 @@ class StatCallWorker : public Nan::AsyncWorker {
   std::string stat_;
 };
 
+class StreamStatsCollector;
+
 typedef std::tuple<Nan::Persistent<v8::Promise::Resolver> *, erizo::time_point, erizo::time_point>
    StreamResultTuple;
 
@@ -66,6 +68,7 @@ class MediaStream : public MediaSink, public erizo::MediaStreamStatsListener, pu
 
     uv_async_t *close_future_async_;
     bool has_stats_callback_;
+    std::shared_ptr<StreamStatsCollector> stats_collector_;
     bool closed_;
     std::string id_;
     std::string label_;
@@ -150,6 +153,14 @@ class MediaStream : public MediaSink, public erizo::MediaStreamStatsListener, pu
      */
     static NAN_METHOD(getPeriodicStats);
 
+    /*
+     * Collects the stats of this MediaStream in a ThreadPool instead of sending them to a callback.
+     * Only the stats changed since the previous report are kept, and ThreadPool.getPeriodicStats
+     * gathers them for every stream at once.
+     * Param: The ThreadPool
+     */
+    static NAN_METHOD(collectPeriodicStats);
+
     /*
      * Sets Metadata that will be logged in every message
      * Param: An object with metadata {key1:value1, key2: value2}
@@ -157,6 +168,11 @@ class MediaStream : public MediaSink, public erizo::MediaStreamStatsListener, pu
     static NAN_METHOD(setMetadata);
     static NAN_METHOD(setPeriodicKeyframeRequests);
     static NAN_METHOD(hasPeriodicKeyframeRequests);
+    /*
+     * Sets the maximum FEC overhead sent to this subscriber
+     * Param: percentage of the video packets, 0 disables FEC
+     */
+    static NAN_METHOD(setMaxFecOverhead);
     /*
      * Enable a specific Handler in the pipeline
      * Param: Name of the handler
@@ -181,6 +197,8 @@ class MediaStream : public MediaSink, public erizo::MediaStreamStatsListener, pu
 
     static NAUV_WORK_CB(statsCallback);
     virtual void notifyStats(const std::string& message);
+    bool wantsStatsDelta() override;
+    bool notifyStatsDelta(const std::string& delta) override;
 
     static NAUV_WORK_CB(eventCallback);
     virtual void notifyMediaStreamEvent(const std::string& type = "",
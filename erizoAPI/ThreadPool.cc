@@ -4,6 +4,8 @@
 
 #include "ThreadPool.h"
 
+#include <stats/StatsDelta.h>
+
 using v8::Local;
 using v8::Value;
 using v8::Function;
@@ -12,6 +14,8 @@ using v8::HandleScope;
 using v8::Exception;
 
 using erizo::DurationDistribution;
+using erizo::StatsDeltaEntry;
+using erizo::StatsDeltaOp;
 
 Nan::Persistent<Function> ThreadPool::constructor;
 
@@ -21,6 +25,10 @@ ThreadPool::ThreadPool() {
 ThreadPool::~ThreadPool() {
 }
 
+void ThreadPool::addStatsCollector(std::weak_ptr<StreamStatsCollector> collector) {
+  stats_collectors_.push_back(collector);
+}
+
 NAN_MODULE_INIT(ThreadPool::Init) {
   // Prepare constructor template
   Local<FunctionTemplate> tpl = Nan::New<FunctionTemplate>(New);
@@ -33,6 +41,8 @@ NAN_MODULE_INIT(ThreadPool::Init) {
   Nan::SetPrototypeMethod(tpl, "getDurationDistribution", getDurationDistribution);
   Nan::SetPrototypeMethod(tpl, "getDelayDistribution", getDelayDistribution);
   Nan::SetPrototypeMethod(tpl, "resetStats", resetStats);
+  Nan::SetPrototypeMethod(tpl, "getPeriodicStats", getPeriodicStats);
+  Nan::SetPrototypeMethod(tpl, "exposeMetrics", exposeMetrics);
 
   constructor.Reset(Nan::GetFunction(tpl).ToLocalChecked());
   Nan::Set(target, Nan::New("ThreadPool").ToLocalChecked(), Nan::GetFunction(tpl).ToLocalChecked());
@@ -44,9 +54,13 @@ NAN_METHOD(ThreadPool::New) {
   }
 
   unsigned int num_workers = Nan::To<unsigned int>(info[0]).FromJust();
+  bool pin_workers = false;
+  if (info.Length() > 1) {
+    pin_workers = Nan::To<bool>(info[1]).FromJust();
+  }
 
   ThreadPool* obj = new ThreadPool();
-  obj->me.reset(new erizo::ThreadPool(num_workers));
+  obj->me.reset(new erizo::ThreadPool(num_workers, pin_workers));
 
   obj->Wrap(info.This());
   info.GetReturnValue().Set(info.This());
@@ -56,6 +70,7 @@ NAN_METHOD(ThreadPool::close) {
   ThreadPool* obj = Nan::ObjectWrap::Unwrap<ThreadPool>(info.Holder());
 
   obj->me->close();
+  obj->metrics_server_.reset();
 }
 
 NAN_METHOD(ThreadPool::start) {
@@ -94,3 +109,69 @@ NAN_METHOD(ThreadPool::resetStats) {
   ThreadPool* obj = Nan::ObjectWrap::Unwrap<ThreadPool>(info.Holder());
   obj->me->resetStats();
 }
+
+NAN_METHOD(ThreadPool::getPeriodicStats) {
+  ThreadPool* obj = Nan::ObjectWrap::Unwrap<ThreadPool>(info.Holder());
+  v8::Local<v8::Object> streams_stats = Nan::New<v8::Object>();
+  std::string delta;
+  std::vector<StatsDeltaEntry> entries;
+  for (auto weak_collector = obj->stats_collectors_.begin(); weak_collector != obj->stats_collectors_.end();) {
+    std::shared_ptr<StreamStatsCollector> collector = weak_collector->lock();
+    if (!collector) {
+      weak_collector = obj->stats_collectors_.erase(weak_collector);
+      continue;
+    }
+    ++weak_collector;
+    delta.clear();
+    bool is_snapshot = false;
+    {
+      boost::mutex::scoped_lock lock(collector->mutex);
+      if (!collector->pending_delta.empty()) {
+        delta.swap(collector->pending_delta);
+        is_snapshot = collector->pending_is_snapshot;
+        collector->pending_is_snapshot = false;
+      }
+    }
+    if (delta.empty()) {
+      continue;
+    }
+    v8::Local<v8::Object> stream_stats = Nan::New<v8::Object>();
+    entries.clear();
+    collector->tracker.read(delta, is_snapshot, &entries);
+    for (const StatsDeltaEntry &entry : entries) {
+      v8::Local<v8::String> path = Nan::New(entry.path).ToLocalChecked();
+      switch (entry.op) {
+        case StatsDeltaOp::kNumber:
+          Nan::Set(stream_stats, path, Nan::New(static_cast<double>(entry.number)));
+          break;
+        case StatsDeltaOp::kText:
+          Nan::Set(stream_stats, path, Nan::New(entry.text).ToLocalChecked());
+          break;
+        case StatsDeltaOp::kRemoved:
+          Nan::Set(stream_stats, path, Nan::Null());
+          break;
+      }
+    }
+    Nan::Set(streams_stats, Nan::New(collector->id).ToLocalChecked(), stream_stats);
+  }
+  info.GetReturnValue().Set(streams_stats);
+}
+
+NAN_METHOD(ThreadPool::exposeMetrics) {
+  ThreadPool* obj = Nan::ObjectWrap::Unwrap<ThreadPool>(info.Holder());
+  if (info.Length() < 1 || obj->metrics_server_) {
+    info.GetReturnValue().Set(Nan::New(-1));
+    return;
+  }
+  unsigned int port = Nan::To<unsigned int>(info[0]).FromJust();
+  unsigned int attempts = 1;
+  if (info.Length() > 1) {
+    attempts = Nan::To<unsigned int>(info[1]).FromJust();
+  }
+  std::unique_ptr<erizo::MetricsServer> server{new erizo::MetricsServer()};
+  int bound_port = server->start("127.0.0.1", port, attempts);
+  if (bound_port >= 0) {
+    obj->metrics_server_ = std::move(server);
+  }
+  info.GetReturnValue().Set(Nan::New(bound_port));
+}
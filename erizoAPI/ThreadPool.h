@@ -3,6 +3,33 @@
 
 #include <nan.h>
 #include <thread/ThreadPool.h>
+#include <stats/MetricsServer.h>
+#include <stats/StatsDelta.h>
+#include <boost/thread/mutex.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Stats deltas of a MediaStream waiting to be gathered by ThreadPool::getPeriodicStats.
+ * Deltas are appended by the erizo worker of the stream, the pending ones are consumed by the Node thread.
+ * If nobody gathers them and they grow over kMaxPendingDelta bytes they are discarded, and the next delta of
+ * the stream is a full snapshot.
+ */
+class StreamStatsCollector {
+ public:
+    static constexpr size_t kMaxPendingDelta = 64 * 1024;
+
+    explicit StreamStatsCollector(const std::string &stream_id) : id{stream_id} {}
+
+    const std::string id;
+    boost::mutex mutex;
+    std::string pending_delta;
+    bool pending_is_snapshot = false;
+    // Only used from the Node thread
+    erizo::StatsDeltaTracker tracker;
+};
 
 
 /*
@@ -16,6 +43,8 @@ class ThreadPool : public Nan::ObjectWrap {
     static NAN_MODULE_INIT(Init);
     std::unique_ptr<erizo::ThreadPool> me;
 
+    void addStatsCollector(std::weak_ptr<StreamStatsCollector> collector);
+
  private:
     ThreadPool();
     ~ThreadPool();
@@ -38,6 +67,25 @@ class ThreadPool : public Nan::ObjectWrap {
     static NAN_METHOD(getDurationDistribution);
     static NAN_METHOD(getDelayDistribution);
     static NAN_METHOD(resetStats);
+    /*
+     * Gathers the stats of every MediaStream collecting them in this ThreadPool, see
+     * MediaStream.collectPeriodicStats.
+     * Returns: An object with the stats changed since the previous call by stream id, as
+     * {streamId: {"<ssrc>.<stat>": value}}. Stats that are gone have a null value.
+     */
+    static NAN_METHOD(getPeriodicStats);
+    /*
+     * Serves the erizo metrics in the OpenMetrics text format on 127.0.0.1.
+     * Param: First port to try
+     * Param: Number of consecutive ports to try, 1 by default
+     * Returns: The port or -1 if none could be used
+     */
+    static NAN_METHOD(exposeMetrics);
+
+    std::unique_ptr<erizo::MetricsServer> metrics_server_;
+
+    // Only used from the Node thread
+    std::vector<std::weak_ptr<StreamStatsCollector>> stats_collectors_;
 
     static Nan::Persistent<v8::Function> constructor;
 };
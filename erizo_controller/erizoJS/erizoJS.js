@@ -15,6 +15,10 @@ global.config = config || {};
 global.config.erizo = global.config.erizo || {};
 global.config.erizo.numWorkers = global.config.erizo.numWorkers || 24;
 global.config.erizo.numIOWorkers = global.config.erizo.numIOWorkers || 1;
+global.config.erizo.pinWorkers = global.config.erizo.pinWorkers || false;
+global.config.erizo.recordingDirectIo = global.config.erizo.recordingDirectIo || false;
+global.config.erizo.metricsPort = global.config.erizo.metricsPort || 0;
+global.config.erizo.metricsPortRange = global.config.erizo.metricsPortRange || 100;
 global.config.erizo.useNicer = global.config.erizo.useNicer;
 global.config.erizo.useConnectionQualityCheck =
   global.config.erizo.useConnectionQualityCheck || false;
@@ -107,9 +111,20 @@ process.on('unhandledRejection', (reason, promise) => {
 });
 
 
-const threadPool = new erizo.ThreadPool(global.config.erizo.numWorkers);
+const threadPool = new erizo.ThreadPool(global.config.erizo.numWorkers,
+  global.config.erizo.pinWorkers);
 threadPool.start();
 
+if (global.config.erizo.metricsPort) {
+  const metricsPort = threadPool.exposeMetrics(global.config.erizo.metricsPort,
+    global.config.erizo.metricsPortRange);
+  if (metricsPort < 0) {
+    log.error(`message: Could not serve erizo metrics, firstPort: ${global.config.erizo.metricsPort}`);
+  } else {
+    log.info(`message: Serving erizo metrics, port: ${metricsPort}`);
+  }
+}
+
 const ioThreadPool = new erizo.IOThreadPool(global.config.erizo.numIOWorkers,
   !global.config.erizo.useNicer);
 
@@ -104,7 +104,8 @@ class Source extends NodeClass {
     log.info(`message: Adding ExternalOutput, id: ${eoId}, url: ${url},`,
       logger.objectToLog(this.options), logger.objectToLog(this.options.metadata));
     const externalOutput = new erizo.ExternalOutput(this.threadPool, url,
-      Helpers.getMediaConfiguration(options.mediaConfiguration), hasAudio, hasVideo);
+      Helpers.getMediaConfiguration(options.mediaConfiguration), hasAudio, hasVideo,
+      global.config.erizo.recordingDirectIo);
     externalOutput.id = eoId;
 
     externalOutput.init();
@@ -9,6 +9,7 @@ const ICEInfo = require('./../../common/semanticSdp/ICEInfo');
 const DTLSInfo = require('./../../common/semanticSdp/DTLSInfo');
 const CodecInfo = require('./../../common/semanticSdp/CodecInfo');
 const SourceInfo = require('./../../common/semanticSdp/SourceInfo');
+const SourceGroupInfo = require('./../../common/semanticSdp/SourceGroupInfo');
 const StreamInfo = require('./../../common/semanticSdp/StreamInfo');
 const TrackInfo = require('./../../common/semanticSdp/TrackInfo');
 const RIDInfo = require('./../../common/semanticSdp/RIDInfo');
@@ -42,6 +43,18 @@ function addSsrc(sources, ssrc, semanticSdpInfo, media, msid = semanticSdpInfo.m
     stream.addTrack(track);
   }
   track.addSSRC(source);
+  return track;
+}
+
+// Announces the RTX SSRC erizo retransmits a video SSRC with, when RTX was negotiated for any codec
+function addRtxSsrc(sources, ssrc, rtxSsrcMap, semanticSdpInfo, media, msid) {
+  const rtxSsrc = rtxSsrcMap[msid] && rtxSsrcMap[msid][ssrc];
+  const hasRtx = Array.from(media.getCodecs().values()).some(codec => codec.hasRTX());
+  if (!rtxSsrc || !hasRtx) {
+    return;
+  }
+  const track = addSsrc(sources, rtxSsrc, semanticSdpInfo, media, msid);
+  track.addSourceGroup(new SourceGroupInfo('FID', [ssrc, rtxSsrc]));
 }
 
 function getMediaInfoFromDescription(connectionDescription, semanticSdpInfo,
@@ -143,6 +156,10 @@ function getMediaInfoFromDescription(connectionDescription, semanticSdpInfo,
     if (sdpMediaInfo.ssrc) {
       addSsrc(sources, sdpMediaInfo.ssrc, semanticSdpInfo, media,
         sdpMediaInfo.senderStreamId, true);
+      if (mediaType === 'video') {
+        addRtxSsrc(sources, sdpMediaInfo.ssrc, connectionDescription.getVideoRtxSsrcMap(),
+          semanticSdpInfo, media, sdpMediaInfo.senderStreamId);
+      }
     }
   } else if (mediaType === 'audio' &&
              audioDirection !== 'recvonly' &&
@@ -156,9 +173,11 @@ function getMediaInfoFromDescription(connectionDescription, semanticSdpInfo,
 
     if (videoDirection !== 'recvonly' && videoDirection !== 'inactive') {
       const videoSsrcMap = connectionDescription.getVideoSsrcMap();
+      const videoRtxSsrcMap = connectionDescription.getVideoRtxSsrcMap();
       Object.keys(videoSsrcMap).forEach((streamLabel) => {
         videoSsrcMap[streamLabel].forEach((ssrc) => {
           addSsrc(sources, ssrc, semanticSdpInfo, media, streamLabel);
+          addRtxSsrc(sources, ssrc, videoRtxSsrcMap, semanticSdpInfo, media, streamLabel);
         });
       });
     }
@@ -197,6 +197,7 @@ module.exports.reset = () => {
     addFeedback: sinon.stub(),
     addExtension: sinon.stub(),
     setAudioSsrc: sinon.stub(),
+    getVideoRtxSsrcMap: sinon.stub().returns({}),
     addMediaInfo: sinon.stub(),
     getMediaInfos: sinon.stub().returns(new Map()),
     postProcessInfo: sinon.stub(),
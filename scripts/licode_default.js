@@ -161,6 +161,17 @@ config.erizo = {};
 // Number of workers that will be used to handle WebRtcConnections
 config.erizo.numWorkers = 24;
 
+// Pin each worker thread to one of the CPUs available to ErizoJS
+config.erizo.pinWorkers = false;
+
+// Serve erizo metrics in the OpenMetrics format on 127.0.0.1, every ErizoJS takes the first free port
+// starting at metricsPort and trying up to metricsPortRange ports. 0 disables it. default value: 0
+config.erizo.metricsPort = 0;
+config.erizo.metricsPortRange = 100;
+
+// Write local recordings with O_DIRECT so they don't fill up the page cache. default value: false
+config.erizo.recordingDirectIo = false;
+
 // Number of workers what will be used for IO (including ICE logic)
 config.erizo.numIOWorkers = 1;
 